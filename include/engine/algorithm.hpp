@@ -46,6 +46,9 @@ template <typename AlgorithmT> struct HasMapMatching final : std::false_type
 template <typename AlgorithmT> struct HasManyToManySearch final : std::false_type
 {
 };
+template <typename AlgorithmT> struct HasRPHASTSearch final : std::false_type
+{
+};
 template <typename AlgorithmT> struct SupportsDistanceAnnotationType final : std::false_type
 {
 };
@@ -72,6 +75,9 @@ template <> struct HasMapMatching<ch::Algorithm> final : std::true_type
 template <> struct HasManyToManySearch<ch::Algorithm> final : std::true_type
 {
 };
+template <> struct HasRPHASTSearch<ch::Algorithm> final : std::true_type
+{
+};
 template <> struct SupportsDistanceAnnotationType<ch::Algorithm> final : std::true_type
 {
 };
@@ -98,6 +104,9 @@ template <> struct HasMapMatching<mld::Algorithm> final : std::true_type
 template <> struct HasManyToManySearch<mld::Algorithm> final : std::true_type
 {
 };
+template <> struct HasRPHASTSearch<mld::Algorithm> final : std::false_type
+{
+};
 template <> struct SupportsDistanceAnnotationType<mld::Algorithm> final : std::false_type
 {
 };
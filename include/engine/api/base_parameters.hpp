@@ -36,6 +36,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <optional>
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 namespace osrm::engine::api
@@ -70,7 +71,8 @@ struct BaseParameters
     enum class OutputFormatType
     {
         JSON,
-        FLATBUFFERS
+        FLATBUFFERS,
+        BINARY // only supported by the table service
     };
 
     std::vector<util::Coordinate> coordinates;
@@ -89,6 +91,10 @@ struct BaseParameters
 
     SnappingType snapping = SnappingType::Default;
 
+    // Point in time after which the engine aborts the request with Status::Timeout. Not part of
+    // the HTTP API, osrm-routed sets its own limit with --max-request-time.
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+
     BaseParameters(std::vector<util::Coordinate> coordinates_ = {},
                    std::vector<std::optional<Hint>> hints_ = {},
                    std::vector<std::optional<double>> radiuses_ = {},
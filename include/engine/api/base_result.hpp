@@ -4,13 +4,25 @@
 #include <flatbuffers/flatbuffers.h>
 #include <variant>
 
+#include <functional>
 #include <string>
+#include <string_view>
 
 #include "util/json_container.hpp"
 
 namespace osrm::engine::api
 {
-using ResultT = std::variant<util::json::Object, std::string, flatbuffers::FlatBufferBuilder>;
+// Raw binary response body, e.g. the matrices of a table request in the binary format
+struct BinaryBuffer
+{
+    std::string data;
+};
+
+using ResultT =
+    std::variant<util::json::Object, std::string, flatbuffers::FlatBufferBuilder, BinaryBuffer>;
+
+// Receives a rendered response in consecutive chunks instead of a complete ResultT
+using ResultStream = std::function<void(std::string_view chunk)>;
 } // namespace osrm::engine::api
 
 #endif
@@ -0,0 +1,99 @@
+#ifndef ENGINE_API_BATCH_MATCH_PARAMETERS_HPP
+#define ENGINE_API_BATCH_MATCH_PARAMETERS_HPP
+
+#include "engine/api/match_parameters.hpp"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace osrm::engine::api
+{
+
+/**
+ * Parameters specific to the OSRM Batch Match service.
+ *
+ * Holds member attributes:
+ *  - trace_sizes: number of coordinates of every trace, the coordinates of the traces follow
+ *                 each other in coordinates. The per-coordinate options (timestamps, radiuses,
+ *                 hints, bearings, approaches) are split the same way.
+ *
+ * All other options apply to every trace like in the Match service, except for waypoints and
+ * sessions which are not supported.
+ *
+ * \see OSRM, Coordinate, Hint, Bearing, RouteParameters, TableParameters,
+ *      NearestParameters, TripParameters, MatchParameters and TileParameters
+ */
+struct BatchMatchParameters : public MatchParameters
+{
+    std::vector<std::size_t> trace_sizes;
+
+    BatchMatchParameters() = default;
+    template <typename... Args>
+    BatchMatchParameters(std::vector<std::size_t> trace_sizes_, Args &&...args_)
+        : MatchParameters{std::forward<Args>(args_)...}, trace_sizes{std::move(trace_sizes_)}
+    {
+    }
+
+    std::size_t NumberOfTraces() const { return trace_sizes.size(); }
+
+    // The parameters of every trace on its own
+    std::vector<MatchParameters> SplitTraces() const
+    {
+        MatchParameters options = *this;
+        options.coordinates.clear();
+        options.hints.clear();
+        options.radiuses.clear();
+        options.bearings.clear();
+        options.approaches.clear();
+        options.timestamps.clear();
+
+        std::vector<MatchParameters> traces(trace_sizes.size(), options);
+        std::size_t begin = 0;
+        for (std::size_t trace_index = 0; trace_index < trace_sizes.size(); ++trace_index)
+        {
+            const auto end = begin + trace_sizes[trace_index];
+            auto &trace = traces[trace_index];
+            const auto slice = [begin, end](const auto &values, auto &trace_values)
+            {
+                if (!values.empty())
+                    trace_values.assign(values.begin() + begin, values.begin() + end);
+            };
+            slice(coordinates, trace.coordinates);
+            slice(hints, trace.hints);
+            slice(radiuses, trace.radiuses);
+            slice(bearings, trace.bearings);
+            slice(approaches, trace.approaches);
+            slice(timestamps, trace.timestamps);
+            begin = end;
+        }
+        return traces;
+    }
+
+    bool IsValid() const
+    {
+        if (!BaseParameters::IsValid())
+            return false;
+
+        if (!waypoints.empty() || session)
+            return false;
+
+        if (!timestamps.empty() && timestamps.size() != coordinates.size())
+            return false;
+
+        // Every trace needs two coordinates and every coordinate belongs to a trace
+        if (trace_sizes.empty() ||
+            std::any_of(begin(trace_sizes),
+                        end(trace_sizes),
+                        [](const std::size_t size) { return size < 2; }))
+            return false;
+
+        return std::accumulate(begin(trace_sizes), end(trace_sizes), std::size_t{0}) ==
+               coordinates.size();
+    }
+};
+} // namespace osrm::engine::api
+
+#endif // ENGINE_API_BATCH_MATCH_PARAMETERS_HPP
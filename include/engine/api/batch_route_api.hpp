@@ -0,0 +1,128 @@
+#ifndef ENGINE_API_BATCH_ROUTE_HPP
+#define ENGINE_API_BATCH_ROUTE_HPP
+
+#include "engine/api/base_api.hpp"
+#include "engine/api/batch_route_parameters.hpp"
+#include "engine/api/json_factory.hpp"
+
+#include "engine/datafacade/datafacade_base.hpp"
+
+#include "engine/guidance/assemble_geometry.hpp"
+#include "engine/guidance/assemble_leg.hpp"
+#include "engine/guidance/assemble_overview.hpp"
+#include "engine/guidance/assemble_route.hpp"
+
+#include "engine/internal_route_result.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/assert.hpp>
+
+#include <vector>
+
+namespace osrm::engine::api
+{
+
+class BatchRouteAPI final : public BaseAPI
+{
+  public:
+    BatchRouteAPI(const datafacade::BaseDataFacade &facade_,
+                  const BatchRouteParameters &parameters_)
+        : BaseAPI(facade_, parameters_), parameters(parameters_)
+    {
+    }
+
+    // Compact summary of one pair, null if there is no route. Only reads shared data, so the
+    // routes of a batch can be rendered in parallel.
+    util::json::Value MakeRoute(const InternalRouteResult &raw_route) const
+    {
+        if (!raw_route.is_valid())
+        {
+            return util::json::Null();
+        }
+        BOOST_ASSERT(raw_route.leg_endpoints.size() == 1);
+
+        const auto &phantoms = raw_route.leg_endpoints.front();
+        const auto &path_data = raw_route.unpacked_path_segments.front();
+        const bool reversed_source = raw_route.source_traversed_in_reverse.front();
+        const bool reversed_target = raw_route.target_traversed_in_reverse.front();
+
+        // same rounding as the route service
+        const auto route = guidance::assembleRoute({guidance::assembleLeg(
+            facade, path_data, phantoms.source_phantom, phantoms.target_phantom, reversed_target)});
+
+        util::json::Object json_route;
+        json_route.values.emplace("duration", route.duration);
+        json_route.values.emplace("distance", route.distance);
+
+        if (parameters.overview != BatchRouteParameters::OverviewType::False)
+        {
+            const std::vector<guidance::LegGeometry> leg_geometries{
+                guidance::assembleGeometry(facade,
+                                           path_data,
+                                           phantoms.source_phantom,
+                                           phantoms.target_phantom,
+                                           reversed_source,
+                                           reversed_target)};
+            const auto overview = guidance::assembleOverview(
+                leg_geometries,
+                parameters.overview == BatchRouteParameters::OverviewType::Simplified);
+            json_route.values.emplace("geometry", MakeGeometry(overview));
+        }
+
+        return json_route;
+    }
+
+    // The routes are in the order of the pairs, waypoints are only snapped once per unique
+    // location and mapped to the coordinates by unique_indices
+    void MakeResponse(std::vector<util::json::Value> routes,
+                      const std::vector<PhantomNodeCandidates> &unique_candidates,
+                      const std::vector<std::size_t> &unique_indices,
+                      util::json::Object &response) const
+    {
+        BOOST_ASSERT(routes.size() == parameters.NumberOfPairs());
+        BOOST_ASSERT(unique_indices.size() == parameters.coordinates.size());
+
+        if (!parameters.skip_waypoints)
+        {
+            util::json::Array waypoints;
+            waypoints.values.reserve(unique_indices.size());
+            for (const auto unique_index : unique_indices)
+            {
+                waypoints.values.push_back(MakeWaypoint(unique_candidates[unique_index]));
+            }
+            response.values.emplace("waypoints", std::move(waypoints));
+        }
+
+        util::json::Array json_routes;
+        json_routes.values = std::move(routes);
+        response.values.emplace("routes", std::move(json_routes));
+        response.values.emplace("code", "Ok");
+        auto data_timestamp = facade.GetTimestamp();
+        if (!data_timestamp.empty())
+        {
+            response.values.emplace("data_version", data_timestamp);
+        }
+    }
+
+  protected:
+    util::json::Value MakeGeometry(const std::vector<util::Coordinate> &overview) const
+    {
+        switch (parameters.geometries)
+        {
+        case BatchRouteParameters::GeometriesType::Polyline:
+            return json::makePolyline<100000>(overview.begin(), overview.end());
+        case BatchRouteParameters::GeometriesType::Polyline6:
+            return json::makePolyline<1000000>(overview.begin(), overview.end());
+        default:
+            BOOST_ASSERT(parameters.geometries == BatchRouteParameters::GeometriesType::GeoJSON);
+            return json::makeGeoJSONGeometry(overview.begin(), overview.end());
+        }
+    }
+
+    const BatchRouteParameters &parameters;
+};
+
+} // namespace osrm::engine::api
+
+#endif
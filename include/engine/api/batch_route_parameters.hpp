@@ -0,0 +1,88 @@
+#ifndef ENGINE_API_BATCH_ROUTE_PARAMETERS_HPP
+#define ENGINE_API_BATCH_ROUTE_PARAMETERS_HPP
+
+#include "engine/api/base_parameters.hpp"
+#include "engine/api/route_parameters.hpp"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace osrm::engine::api
+{
+
+/**
+ * Parameters specific to the OSRM Batch Route service.
+ *
+ * Holds member attributes:
+ *  - sources: indices into coordinates of the origins of the pairs
+ *  - destinations: indices into coordinates of the destinations of the pairs, the n-th source is
+ *                  routed to the n-th destination. No sources and destinations means consecutive
+ *                  coordinates form the pairs (0 to 1, 2 to 3, ...)
+ *  - geometries: route geometry encoded in Polyline, Polyline6 or GeoJSON
+ *  - overview: adds no, a simplified or the full route geometry to every route
+ *
+ * \see OSRM, Coordinate, Hint, Bearing, RouteParameters, TableParameters,
+ *      NearestParameters, TripParameters, MatchParameters and TileParameters
+ */
+struct BatchRouteParameters : public BaseParameters
+{
+    using GeometriesType = RouteParameters::GeometriesType;
+    using OverviewType = RouteParameters::OverviewType;
+
+    std::vector<std::size_t> sources;
+    std::vector<std::size_t> destinations;
+    GeometriesType geometries = GeometriesType::Polyline;
+    OverviewType overview = OverviewType::False;
+
+    BatchRouteParameters() = default;
+    template <typename... Args>
+    BatchRouteParameters(std::vector<std::size_t> sources_,
+                         std::vector<std::size_t> destinations_,
+                         Args &&...args_)
+        : BaseParameters{std::forward<Args>(args_)...}, sources{std::move(sources_)},
+          destinations{std::move(destinations_)}
+    {
+    }
+
+    std::size_t NumberOfPairs() const
+    {
+        return sources.empty() ? coordinates.size() / 2 : sources.size();
+    }
+
+    // Indices of the coordinates of the n-th pair
+    std::pair<std::size_t, std::size_t> GetPair(const std::size_t pair_index) const
+    {
+        if (sources.empty())
+            return {2 * pair_index, 2 * pair_index + 1};
+        return {sources[pair_index], destinations[pair_index]};
+    }
+
+    bool IsValid() const
+    {
+        if (!BaseParameters::IsValid())
+            return false;
+
+        // Every pair needs an origin and a destination
+        if (coordinates.size() < 2 || sources.size() != destinations.size())
+            return false;
+
+        if (sources.empty() && coordinates.size() % 2 != 0)
+            return false;
+
+        const auto not_in_range = [this](const std::size_t x) { return x >= coordinates.size(); };
+
+        if (std::any_of(begin(sources), end(sources), not_in_range))
+            return false;
+
+        if (std::any_of(begin(destinations), end(destinations), not_in_range))
+            return false;
+
+        return true;
+    }
+};
+} // namespace osrm::engine::api
+
+#endif // ENGINE_API_BATCH_ROUTE_PARAMETERS_HPP
@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/route_parameters.hpp"
 
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace osrm::engine::api
@@ -40,6 +42,8 @@ namespace osrm::engine::api
  *
  * Holds member attributes:
  *  - timestamps: timestamp(s) for the corresponding input coordinate(s)
+ *  - session: id of a trace that is matched while it is recorded, the coordinates are added to
+ *             the points that were sent before
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -87,11 +91,15 @@ struct MatchParameters : public RouteParameters
     std::vector<unsigned> timestamps;
     GapsType gaps;
     bool tidy;
+    std::optional<std::string> session;
 
     bool IsValid() const
     {
-        return RouteParameters::IsValid() &&
-               (timestamps.empty() || timestamps.size() == coordinates.size());
+        // a session can be continued with a single coordinate
+        const auto route_params_ok =
+            RouteParameters::IsValid() ||
+            (session && coordinates.size() == 1 && waypoints.empty() && BaseParameters::IsValid());
+        return route_params_ok && (timestamps.empty() || timestamps.size() == coordinates.size());
     }
 };
 } // namespace osrm::engine::api
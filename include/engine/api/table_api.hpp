@@ -16,11 +16,17 @@
 
 #include "engine/internal_route_result.hpp"
 
+#include "util/half_float.hpp"
 #include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <cmath>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <string>
 
 namespace osrm::engine::api
 {
@@ -50,7 +56,13 @@ class TableAPI final : public BaseAPI
                  const std::vector<TableCellRef> &fallback_speed_cells,
                  osrm::engine::api::ResultT &response) const
     {
-        if (std::holds_alternative<flatbuffers::FlatBufferBuilder>(response))
+        // errors are reported in JSON, only the successful response is binary
+        if (parameters.format == BaseParameters::OutputFormatType::BINARY)
+        {
+            response = BinaryBuffer();
+            MakeResponse(tables, candidates, std::get<BinaryBuffer>(response));
+        }
+        else if (std::holds_alternative<flatbuffers::FlatBufferBuilder>(response))
         {
             auto &fb_result = std::get<flatbuffers::FlatBufferBuilder>(response);
             MakeResponse(tables, candidates, fallback_speed_cells, fb_result);
@@ -237,6 +249,193 @@ class TableAPI final : public BaseAPI
         }
     }
 
+    // Binary format, all values are little-endian:
+    //
+    //   char[4]  magic "OSRT"
+    //   uint8    format version (1)
+    //   uint8    encoding of the values, 0: int32, 1: float16
+    //   uint8    annotations, bit 0: durations, bit 1: distances
+    //   uint8    reserved (0)
+    //   uint32   number of sources (rows)
+    //   uint32   number of destinations (columns)
+    //
+    // followed by the duration and then the distance matrix in row-major order, if requested.
+    // int32 values are deciseconds and decimeters with INT32_MAX for unreachable cells, float16
+    // values are seconds and meters with NaN for unreachable cells.
+    virtual void
+    MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                 const std::vector<PhantomNodeCandidates> &candidates,
+                 BinaryBuffer &response) const
+    {
+        const auto number_of_sources =
+            parameters.sources.empty() ? candidates.size() : parameters.sources.size();
+        const auto number_of_destinations =
+            parameters.destinations.empty() ? candidates.size() : parameters.destinations.size();
+        const auto number_of_entries = number_of_sources * number_of_destinations;
+
+        const bool use_durations =
+            parameters.annotations & TableParameters::AnnotationsType::Duration;
+        const bool use_distances =
+            parameters.annotations & TableParameters::AnnotationsType::Distance;
+        const bool use_float16 =
+            parameters.binary_encoding == TableParameters::BinaryEncodingType::Float16;
+
+        auto &data = response.data;
+        const auto value_size = use_float16 ? sizeof(std::uint16_t) : sizeof(std::int32_t);
+        data.reserve(16 + (use_durations + use_distances) * number_of_entries * value_size);
+
+        const auto append = [&data](const std::uint32_t value, const std::size_t bytes)
+        {
+            for (const auto byte : util::irange<std::size_t>(0, bytes))
+                data.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+        };
+
+        data.append("OSRT", 4);
+        append(1, 1);
+        append(use_float16 ? 1 : 0, 1);
+        append((use_durations ? 0x01 : 0) | (use_distances ? 0x02 : 0), 1);
+        append(0, 1);
+        append(number_of_sources, 4);
+        append(number_of_destinations, 4);
+
+        const auto INVALID_INT32_VALUE = std::numeric_limits<std::int32_t>::max();
+        const std::uint16_t INVALID_FLOAT16_VALUE = 0x7E00;
+
+        if (use_durations)
+        {
+            BOOST_ASSERT(tables.first.size() == number_of_entries);
+            for (const auto duration : tables.first)
+            {
+                if (use_float16)
+                {
+                    append(duration == MAXIMAL_EDGE_DURATION
+                               ? INVALID_FLOAT16_VALUE
+                               : util::toHalfFloat(from_alias<float>(duration) / 10.f),
+                           2);
+                }
+                else
+                {
+                    // durations already are deciseconds
+                    append(duration == MAXIMAL_EDGE_DURATION ? INVALID_INT32_VALUE
+                                                             : from_alias<std::int32_t>(duration),
+                           4);
+                }
+            }
+        }
+
+        if (use_distances)
+        {
+            BOOST_ASSERT(tables.second.size() == number_of_entries);
+            for (const auto distance : tables.second)
+            {
+                if (use_float16)
+                {
+                    append(distance == INVALID_EDGE_DISTANCE
+                               ? INVALID_FLOAT16_VALUE
+                               : util::toHalfFloat(from_alias<float>(distance)),
+                           2);
+                }
+                else
+                {
+                    const auto decimeters = std::round(from_alias<double>(distance) * 10);
+                    append(distance == INVALID_EDGE_DISTANCE || decimeters >= INVALID_INT32_VALUE
+                               ? INVALID_INT32_VALUE
+                               : static_cast<std::int32_t>(decimeters),
+                           4);
+                }
+            }
+        }
+    }
+
+    // Renders the JSON response directly into the stream, one matrix row at a time, without
+    // building the util::json::Object of the whole response first. The tables are complete
+    // already, only their rendering is streamed.
+    virtual void
+    MakeResponse(const std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>> &tables,
+                 const std::vector<PhantomNodeCandidates> &candidates,
+                 const std::vector<TableCellRef> &fallback_speed_cells,
+                 const ResultStream &stream) const
+    {
+        // rendered rows are collected and handed out in chunks of about this size
+        const constexpr std::size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+        auto number_of_sources = parameters.sources.empty() ? candidates.size()
+                                                            : parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.empty()
+                                          ? candidates.size()
+                                          : parameters.destinations.size();
+
+        std::string buffer;
+        util::json::Renderer renderer(buffer);
+        const auto flush = [&](const bool force)
+        {
+            if (!buffer.empty() && (force || buffer.size() >= STREAM_CHUNK_SIZE))
+            {
+                stream(buffer);
+                buffer.clear();
+            }
+        };
+
+        buffer += "{\"code\":\"Ok\"";
+        auto data_timestamp = facade.GetTimestamp();
+        if (!data_timestamp.empty())
+        {
+            buffer += ",\"data_version\":";
+            renderer(util::json::String(data_timestamp));
+        }
+
+        if (!parameters.skip_waypoints)
+        {
+            buffer += ",\"sources\":";
+            renderer(parameters.sources.empty() ? MakeWaypoints(candidates)
+                                                : MakeWaypoints(candidates, parameters.sources));
+            flush(false);
+
+            buffer += ",\"destinations\":";
+            renderer(parameters.destinations.empty()
+                         ? MakeWaypoints(candidates)
+                         : MakeWaypoints(candidates, parameters.destinations));
+            flush(false);
+        }
+
+        if (parameters.fallback_speed != from_alias<double>(INVALID_FALLBACK_SPEED) &&
+            parameters.fallback_speed > 0)
+        {
+            buffer += ",\"fallback_speed_cells\":";
+            renderer(MakeEstimatesTable(fallback_speed_cells));
+            flush(false);
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Duration)
+        {
+            buffer += ",\"durations\":[";
+            for (const auto row : util::irange<std::size_t>(0UL, number_of_sources))
+            {
+                if (row > 0)
+                    buffer += ',';
+                renderer(MakeDurationRow(tables.first, row, number_of_destinations));
+                flush(false);
+            }
+            buffer += ']';
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Distance)
+        {
+            buffer += ",\"distances\":[";
+            for (const auto row : util::irange<std::size_t>(0UL, number_of_sources))
+            {
+                if (row > 0)
+                    buffer += ',';
+                renderer(MakeDistanceRow(tables.second, row, number_of_destinations));
+                flush(false);
+            }
+            buffer += ']';
+        }
+
+        buffer += '}';
+        flush(true);
+    }
+
   protected:
     virtual flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<fbresult::Waypoint>>>
     MakeWaypoints(flatbuffers::FlatBufferBuilder &builder,
@@ -356,6 +555,30 @@ class TableAPI final : public BaseAPI
         return json_waypoints;
     }
 
+    virtual util::json::Array MakeDurationRow(const std::vector<EdgeDuration> &values,
+                                              std::size_t row,
+                                              std::size_t number_of_columns) const
+    {
+        util::json::Array json_row;
+        auto row_begin_iterator = values.begin() + (row * number_of_columns);
+        auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
+        json_row.values.resize(number_of_columns);
+        std::transform(row_begin_iterator,
+                       row_end_iterator,
+                       json_row.values.begin(),
+                       [](const EdgeDuration duration)
+                       {
+                           if (duration == MAXIMAL_EDGE_DURATION)
+                           {
+                               return util::json::Value(util::json::Null());
+                           }
+                           // division by 10 because the duration is in deciseconds (10s)
+                           return util::json::Value(
+                               util::json::Number(from_alias<double>(duration) / 10.));
+                       });
+        return json_row;
+    }
+
     virtual util::json::Array MakeDurationTable(const std::vector<EdgeDuration> &values,
                                                 std::size_t number_of_rows,
                                                 std::size_t number_of_columns) const
@@ -363,29 +586,36 @@ class TableAPI final : public BaseAPI
         util::json::Array json_table;
         for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
         {
-            util::json::Array json_row;
-            auto row_begin_iterator = values.begin() + (row * number_of_columns);
-            auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
-            json_row.values.resize(number_of_columns);
-            std::transform(row_begin_iterator,
-                           row_end_iterator,
-                           json_row.values.begin(),
-                           [](const EdgeDuration duration)
-                           {
-                               if (duration == MAXIMAL_EDGE_DURATION)
-                               {
-                                   return util::json::Value(util::json::Null());
-                               }
-                               // division by 10 because the duration is in deciseconds (10s)
-                               return util::json::Value(
-                                   util::json::Number(from_alias<double>(duration) / 10.));
-                           });
-
-            json_table.values.push_back(util::json::Value{json_row});
+            json_table.values.push_back(
+                util::json::Value{MakeDurationRow(values, row, number_of_columns)});
         }
         return json_table;
     }
 
+    virtual util::json::Array MakeDistanceRow(const std::vector<EdgeDistance> &values,
+                                              std::size_t row,
+                                              std::size_t number_of_columns) const
+    {
+        util::json::Array json_row;
+        auto row_begin_iterator = values.begin() + (row * number_of_columns);
+        auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
+        json_row.values.resize(number_of_columns);
+        std::transform(row_begin_iterator,
+                       row_end_iterator,
+                       json_row.values.begin(),
+                       [](const EdgeDistance distance)
+                       {
+                           if (distance == INVALID_EDGE_DISTANCE)
+                           {
+                               return util::json::Value(util::json::Null());
+                           }
+                           // round to single decimal place
+                           return util::json::Value(util::json::Number(
+                               std::round(from_alias<double>(distance) * 10) / 10.));
+                       });
+        return json_row;
+    }
+
     virtual util::json::Array MakeDistanceTable(const std::vector<EdgeDistance> &values,
                                                 std::size_t number_of_rows,
                                                 std::size_t number_of_columns) const
@@ -393,24 +623,8 @@ class TableAPI final : public BaseAPI
         util::json::Array json_table;
         for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
         {
-            util::json::Array json_row;
-            auto row_begin_iterator = values.begin() + (row * number_of_columns);
-            auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
-            json_row.values.resize(number_of_columns);
-            std::transform(row_begin_iterator,
-                           row_end_iterator,
-                           json_row.values.begin(),
-                           [](const EdgeDistance distance)
-                           {
-                               if (distance == INVALID_EDGE_DISTANCE)
-                               {
-                                   return util::json::Value(util::json::Null());
-                               }
-                               // round to single decimal place
-                               return util::json::Value(util::json::Number(
-                                   std::round(from_alias<double>(distance) * 10) / 10.));
-                           });
-            json_table.values.push_back(util::json::Value{json_row});
+            json_table.values.push_back(
+                util::json::Value{MakeDistanceRow(values, row, number_of_columns)});
         }
         return json_table;
     }
@@ -34,6 +34,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
 #include <vector>
 
 namespace osrm::engine::api
@@ -77,6 +78,20 @@ struct TableParameters : public BaseParameters
 
     double scale_factor = 1;
 
+    // Encoding of the matrix values in the binary output format
+    enum class BinaryEncodingType
+    {
+        Int32,  // deciseconds and decimeters
+        Float16 // seconds and meters
+    };
+
+    BinaryEncodingType binary_encoding = BinaryEncodingType::Int32;
+
+    // Cells with a longer duration (in seconds, after scale_factor) or distance (in meters) are
+    // null, the searches do not go further than that
+    std::optional<double> max_duration;
+    std::optional<double> max_distance;
+
     TableParameters() = default;
     template <typename... Args>
     TableParameters(std::vector<std::size_t> sources_,
@@ -139,6 +154,9 @@ struct TableParameters : public BaseParameters
         if (scale_factor <= 0)
             return false;
 
+        if ((max_duration && *max_duration <= 0) || (max_distance && *max_distance <= 0))
+            return false;
+
         return true;
     }
 };
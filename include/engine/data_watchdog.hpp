@@ -14,6 +14,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <functional>
 #include <memory>
 #include <thread>
 
@@ -34,7 +35,8 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
     using Facade = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdogImpl(const std::string &dataset_name) : dataset_name(dataset_name), active(true)
+    DataWatchdogImpl(const std::string &dataset_name, std::function<void()> on_update = {})
+        : dataset_name(dataset_name), on_update(std::move(on_update)), active(true)
     {
         // create the initial facade before launching the watchdog thread
         {
@@ -124,6 +126,12 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
                             std::vector<storage::SharedRegionRegister::ShmKey>{
                                 static_region.shm_key, updatable_region.shm_key}));
             }
+
+            // results computed on the old facades must not be reused
+            if (on_update)
+            {
+                on_update();
+            }
         }
 
         util::Log() << "DataWatchdog thread stopped";
@@ -131,6 +139,7 @@ class DataWatchdogImpl<AlgorithmT, datafacade::ContiguousInternalMemoryDataFacad
 
     mutable boost::shared_mutex factory_mutex;
     const std::string dataset_name;
+    const std::function<void()> on_update;
     storage::SharedMonitor<storage::SharedRegionRegister> barrier;
     std::thread watcher;
     bool active;
@@ -405,6 +405,19 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, approach, max_distance, bearing, use_all_edges);
     }
 
+    std::vector<PhantomCandidateAlternatives> BatchNearestCandidatesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<std::optional<double>> &max_distances,
+        const std::vector<std::optional<Bearing>> &bearings,
+        const std::vector<Approach> &approaches,
+        const bool use_all_edges) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->BatchNearestCandidatesWithAlternativeFromBigComponent(
+            input_coordinates, approaches, max_distances, bearings, use_all_edges);
+    }
+
     std::uint32_t GetCheckSum() const override final { return m_check_sum; }
 
     std::string GetTimestamp() const override final
@@ -145,6 +145,26 @@ class BaseDataFacade
                                                      const Approach approach,
                                                      const bool use_all_edges) const = 0;
 
+    // Snaps many coordinates at once, facades that can share work between nearby coordinates
+    // override this
+    virtual std::vector<PhantomCandidateAlternatives>
+    BatchNearestCandidatesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<std::optional<double>> &max_distances,
+        const std::vector<std::optional<Bearing>> &bearings,
+        const std::vector<Approach> &approaches,
+        const bool use_all_edges) const
+    {
+        std::vector<PhantomCandidateAlternatives> alternatives;
+        alternatives.reserve(input_coordinates.size());
+        for (const auto i : util::irange<std::size_t>(0, input_coordinates.size()))
+        {
+            alternatives.push_back(NearestCandidatesWithAlternativeFromBigComponent(
+                input_coordinates[i], max_distances[i], bearings[i], approaches[i], use_all_edges));
+        }
+        return alternatives;
+    }
+
     virtual bool HasLaneData(const EdgeID edge_based_edge_id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID edge_based_edge_id) const = 0;
     virtual extractor::TurnLaneDescription
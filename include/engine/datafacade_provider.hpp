@@ -80,7 +80,10 @@ class WatchingProvider : public DataFacadeProvider<AlgorithmT, FacadeT>
   public:
     using Facade = typename DataFacadeProvider<AlgorithmT, FacadeT>::Facade;
 
-    WatchingProvider(const std::string &dataset_name) : watchdog(dataset_name) {}
+    WatchingProvider(const std::string &dataset_name, std::function<void()> on_update = {})
+        : watchdog(dataset_name, std::move(on_update))
+    {
+    }
 
     std::shared_ptr<const Facade> Get(const api::TileParameters &params) const override final
     {
@@ -1,6 +1,8 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "engine/api/batch_match_parameters.hpp"
+#include "engine/api/batch_route_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -9,19 +11,25 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/plugins/batch_match.hpp"
+#include "engine/plugins/batch_route.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
 #include "engine/plugins/tile.hpp"
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
+#include "engine/request_deadline.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
 
+#include "util/exception.hpp"
 #include "util/json_container.hpp"
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 namespace osrm::engine
 {
@@ -32,11 +40,21 @@ class EngineInterface
     virtual ~EngineInterface() = default;
     virtual Status Route(const api::RouteParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Table(const api::TableParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters,
+                         api::ResultT &result,
+                         const api::ResultStream &stream) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
                            api::ResultT &result) const = 0;
     virtual Status Trip(const api::TripParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Match(const api::MatchParameters &parameters, api::ResultT &result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, api::ResultT &result) const = 0;
+    virtual Status BatchRoute(const api::BatchRouteParameters &parameters,
+                              api::ResultT &result) const = 0;
+    virtual Status BatchMatch(const api::BatchMatchParameters &parameters,
+                              api::ResultT &result) const = 0;
+    virtual Status BatchMatch(const api::BatchMatchParameters &parameters,
+                              api::ResultT &result,
+                              const api::ResultStream &stream) const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
@@ -45,21 +63,77 @@ template <typename Algorithm> class Engine final : public EngineInterface
     explicit Engine(const EngineConfig &config)
         : route_plugin(config.max_locations_viaroute,
                        config.max_alternatives,
-                       config.default_radius),                                      //
-          table_plugin(config.max_locations_distance_table, config.default_radius), //
+                       config.default_radius,
+                       config.use_parallel_alternatives_search,
+                       config.use_parallel_leg_search), //
+          table_plugin(config.max_locations_distance_table,
+                       config.default_radius,
+                       config.use_parallel_table_search,
+                       config.min_destinations_rphast_table),                       //
           nearest_plugin(config.max_results_nearest, config.default_radius),        //
-          trip_plugin(config.max_locations_trip, config.default_radius),            //
+          trip_plugin(config.max_locations_trip,
+                      config.default_radius,
+                      config.trip_local_search_time), //
           match_plugin(config.max_locations_map_matching,
                        config.max_radius_map_matching,
                        config.default_radius), //
-          tile_plugin()                        //
+          tile_plugin(),                       //
+          batch_route_plugin(config.max_pairs_batch_route, config.default_radius),
+          batch_match_plugin(config.max_traces_batch_match,
+                             config.max_locations_map_matching,
+                             config.max_radius_map_matching,
+                             config.default_radius),
+          max_request_time(config.max_request_time)
 
     {
+        if (config.max_heap_memory_per_thread >= 0)
+        {
+            heaps.max_thread_local_memory_usage =
+                static_cast<std::size_t>(config.max_heap_memory_per_thread) * 1024 * 1024;
+        }
+        if (config.max_table_bucket_cache_size > 0)
+        {
+            bucket_cache = std::make_unique<routing_algorithms::BucketCache>(
+                static_cast<std::size_t>(config.max_table_bucket_cache_size) * 1024 * 1024);
+        }
+        // only contraction hierarchies have shortcuts to unpack
+        if (config.max_shortcut_cache_size > 0 &&
+            std::is_same_v<Algorithm, routing_algorithms::ch::Algorithm>)
+        {
+            shortcut_cache = std::make_unique<routing_algorithms::ShortcutCache>(
+                static_cast<std::size_t>(config.max_shortcut_cache_size) * 1024 * 1024);
+        }
+        // only multi-level dijkstra has overlay edges to unpack
+        if (config.max_clique_arc_cache_size > 0 &&
+            std::is_same_v<Algorithm, routing_algorithms::mld::Algorithm>)
+        {
+            clique_arc_cache = std::make_unique<routing_algorithms::CliqueArcCache>(
+                static_cast<std::size_t>(config.max_clique_arc_cache_size) * 1024 * 1024);
+        }
+        if (config.max_matching_sessions_size > 0)
+        {
+            matching_sessions = std::make_unique<map_matching::MatchingSessions>(
+                static_cast<std::size_t>(config.max_matching_sessions_size) * 1024 * 1024,
+                std::chrono::seconds(config.matching_session_ttl));
+        }
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with name \"" << config.dataset_name
                                 << "\" with algorithm " << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(config.dataset_name);
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                config.dataset_name,
+                [this]
+                {
+                    if (bucket_cache)
+                        bucket_cache->Invalidate();
+                    if (shortcut_cache)
+                        shortcut_cache->Invalidate();
+                    if (clique_arc_cache)
+                        clique_arc_cache->Invalidate();
+                    if (matching_sessions)
+                        matching_sessions->Invalidate();
+                });
         }
         else if (!config.memory_file.empty() || config.use_mmap)
         {
@@ -89,12 +163,29 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Status Route(const api::RouteParameters &params, api::ResultT &result) const override final
     {
-        return route_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&] { return route_plugin.HandleRequest(GetAlgorithms(params), params, result); }));
     }
 
     Status Table(const api::TableParameters &params, api::ResultT &result) const override final
     {
-        return table_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&] { return table_plugin.HandleRequest(GetAlgorithms(params), params, result); }));
+    }
+
+    Status Table(const api::TableParameters &params,
+                 api::ResultT &result,
+                 const api::ResultStream &stream) const override final
+    {
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&]
+            { return table_plugin.HandleRequest(GetAlgorithms(params), params, result, stream); }));
     }
 
     Status Nearest(const api::NearestParameters &params, api::ResultT &result) const override final
@@ -104,12 +195,27 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Status Trip(const api::TripParameters &params, api::ResultT &result) const override final
     {
-        return trip_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&] { return trip_plugin.HandleRequest(GetAlgorithms(params), params, result); }));
     }
 
     Status Match(const api::MatchParameters &params, api::ResultT &result) const override final
     {
-        return match_plugin.HandleRequest(GetAlgorithms(params), params, result);
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&]
+            {
+                // like the caches, the generation is taken before the facade
+                map_matching::MatchingSessionsHandle sessions;
+                if (matching_sessions)
+                {
+                    sessions = {matching_sessions.get(), matching_sessions->GetGeneration()};
+                }
+                return match_plugin.HandleRequest(GetAlgorithms(params), params, result, sessions);
+            }));
     }
 
     Status Tile(const api::TileParameters &params, api::ResultT &result) const override final
@@ -117,11 +223,111 @@ template <typename Algorithm> class Engine final : public EngineInterface
         return tile_plugin.HandleRequest(GetAlgorithms(params), params, result);
     }
 
+    Status BatchRoute(const api::BatchRouteParameters &params,
+                      api::ResultT &result) const override final
+    {
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&]
+            { return batch_route_plugin.HandleRequest(GetAlgorithms(params), params, result); }));
+    }
+
+    Status BatchMatch(const api::BatchMatchParameters &params,
+                      api::ResultT &result) const override final
+    {
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&]
+            { return batch_match_plugin.HandleRequest(GetAlgorithms(params), params, result); }));
+    }
+
+    Status BatchMatch(const api::BatchMatchParameters &params,
+                      api::ResultT &result,
+                      const api::ResultStream &stream) const override final
+    {
+        return ReleaseHeapMemory(HandleWithDeadline(
+            params,
+            result,
+            [&] {
+                return batch_match_plugin.HandleRequest(
+                    GetAlgorithms(params), params, result, stream);
+            }));
+    }
+
   private:
+    // Runs a request that searches the graph with its deadline: the earlier one of the deadline
+    // in its parameters and the configured maximal request time. A search that runs out of time
+    // or is cancelled unwinds to here and the request fails with a Timeout error.
+    template <typename ParametersT, typename HandlerT>
+    Status HandleWithDeadline(const ParametersT &params,
+                              api::ResultT &result,
+                              const HandlerT &handler) const
+    {
+        auto deadline = params.deadline;
+        if (max_request_time >= 0)
+        {
+            const auto limit =
+                RequestDeadline::Clock::now() + std::chrono::milliseconds(max_request_time);
+            if (!deadline || limit < *deadline)
+            {
+                deadline = limit;
+            }
+        }
+
+        try
+        {
+            const RequestDeadline request_deadline(deadline, {});
+            RequestDeadline::CheckNow();
+            return handler();
+        }
+        catch (const util::TimeoutException &exception)
+        {
+            // drop whatever the plugin rendered before it was aborted
+            std::visit([](auto &value) { value = std::decay_t<decltype(value)>(); }, result);
+            std::visit(plugins::BasePlugin::ErrorRenderer("Timeout", exception.what()), result);
+            return Status::Timeout;
+        }
+    }
+
+    // Frees the heaps of the calling thread if they are bigger than the configured budget, so a
+    // single huge query does not pin its memory for the lifetime of the thread
+    Status ReleaseHeapMemory(const Status status) const
+    {
+        heaps.ReleaseThreadLocalStorageOverBudget();
+        return status;
+    }
+
     template <typename ParametersT> auto GetAlgorithms(const ParametersT &params) const
     {
-        return RoutingAlgorithms<Algorithm>{heaps, facade_provider->Get(params)};
+        // The generation is taken before the facade: if the facade is swapped in between,
+        // the request can't add outdated entries to the new generation of the caches
+        routing_algorithms::BucketCacheHandle bucket_cache_handle;
+        if (bucket_cache)
+        {
+            bucket_cache_handle = {bucket_cache.get(), bucket_cache->GetGeneration()};
+        }
+        routing_algorithms::ShortcutCacheHandle shortcut_cache_handle;
+        if (shortcut_cache)
+        {
+            shortcut_cache_handle = {shortcut_cache.get(), shortcut_cache->GetGeneration()};
+        }
+        routing_algorithms::CliqueArcCacheHandle clique_arc_cache_handle;
+        if (clique_arc_cache)
+        {
+            clique_arc_cache_handle = {clique_arc_cache.get(), clique_arc_cache->GetGeneration()};
+        }
+        return RoutingAlgorithms<Algorithm>{heaps,
+                                            facade_provider->Get(params),
+                                            bucket_cache_handle,
+                                            shortcut_cache_handle,
+                                            clique_arc_cache_handle};
     }
+    std::unique_ptr<routing_algorithms::BucketCache> bucket_cache;
+    std::unique_ptr<routing_algorithms::ShortcutCache> shortcut_cache;
+    std::unique_ptr<routing_algorithms::CliqueArcCache> clique_arc_cache;
+    std::unique_ptr<map_matching::MatchingSessions> matching_sessions;
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
 
@@ -131,6 +337,9 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+    const plugins::BatchRoutePlugin batch_route_plugin;
+    const plugins::BatchMatchPlugin batch_match_plugin;
+    const int max_request_time;
 };
 } // namespace osrm::engine
 
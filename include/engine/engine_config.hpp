@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/datasets.hpp"
 
 #include <filesystem>
+#include <istream>
 #include <set>
 #include <string>
 
@@ -50,6 +51,8 @@ namespace osrm::engine
  *  - Table
  *  - Match
  *  - Nearest
+ *  - Batch Route (number of pairs)
+ *  - Batch Match (number of traces)
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
@@ -79,16 +82,36 @@ struct EngineConfig final
     int max_locations_map_matching = -1;
     double max_radius_map_matching = -1.0;
     int max_results_nearest = -1;
+    int max_pairs_batch_route = -1;
+    int max_traces_batch_match = -1;
     double default_radius = -1.0;
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
     bool use_shared_memory = true;
     std::filesystem::path memory_file;
     bool use_mmap = true;
+    bool use_parallel_table_search = false;
+    bool use_parallel_alternatives_search = false;
+    bool use_parallel_leg_search = false;
+    int max_table_bucket_cache_size = 0; // in MiB, 0 disables the cache
+    int max_shortcut_cache_size = 0;     // in MiB, 0 disables the cache
+    int max_clique_arc_cache_size = 0;   // in MiB, 0 disables the cache
+    int max_matching_sessions_size = 0;  // in MiB, 0 disables matching sessions
+    int matching_session_ttl = 300;      // in s
+    int min_destinations_rphast_table = 1000; // -1 disables RPHAST
+    // Budget of the thread-local search heaps kept by request threads and the workers of batch
+    // match, parallel alternatives and parallel MLD route searches. Heaps of parallel table and
+    // CH route searches live for one request and are not limited.
+    int max_heap_memory_per_thread = -1;      // in MiB, -1 never frees the search heaps
+    int max_request_time = -1;                // in ms, -1 disables the limit
+    int trip_local_search_time = 0;           // in ms, 0 disables the local search of trips
     Algorithm algorithm = Algorithm::CH;
     std::vector<storage::FeatureDataset> disable_feature_dataset;
     std::string verbosity;
     std::string dataset_name;
 };
+
+// Parses "ch" or "mld", e.g. for the command line options of the tools
+std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm);
 } // namespace osrm::engine
 
 #endif // SERVER_CONFIG_HPP
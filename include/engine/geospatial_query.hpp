@@ -6,17 +6,21 @@
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/assert.hpp>
+
 #include <optional>
 
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -125,94 +129,150 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         const std::optional<Bearing> bearing_with_range,
         const std::optional<bool> use_all_edges) const
     {
-        bool has_nearest = false;
-        bool has_big_component = false;
-        Coordinate big_component_coord;
-        double big_component_distance = std::numeric_limits<double>::max();
-        Coordinate nearest_coord;
+        BigComponentSearch search{
+            input_coordinate, approach, max_distance, bearing_with_range, use_all_edges};
         auto results = rtree.Nearest(
             input_coordinate,
-            [this,
-             approach,
-             &input_coordinate,
-             &has_nearest,
-             &has_big_component,
-             &nearest_coord,
-             &big_component_coord,
-             &big_component_distance,
-             &use_all_edges,
-             &bearing_with_range](const CandidateSegment &segment)
-            {
-                auto is_big_component = !IsTinyComponent(segment);
-                auto not_nearest =
-                    has_nearest && segment.fixed_projected_coordinate != nearest_coord;
-                auto not_big =
-                    has_big_component && segment.fixed_projected_coordinate != big_component_coord;
+            [this, &search](const CandidateSegment &segment)
+            { return FilterBigComponentCandidate(search, segment); },
+            [this, &search](const std::size_t /*num_results*/, const CandidateSegment &segment)
+            { return TerminateBigComponentSearch(search, segment); });
 
-                /**
-                 *
-                 *  Two reasons why we don't want this candidate:
-                 *  1. A non-big component candidate that is not at the nearest location
-                 *  2. A big component candidate that is not at the big location.
-                 *
-                 *  It's possible that 1. could end up having the same location as the nearest big
-                 *  component node if we have yet to see one. However, we don't know this and it
-                 *  could lead to buffering large numbers of candidates before finding the big
-                 *  component location.
-                 *  By filtering out 1. nodes, this does mean that the alternative list of
-                 *  candidates will not have non-big component candidates. Given the alternative
-                 *  list of big component candidates is meant as a backup choice, this seems
-                 *  reasonable.
-                 */
-                if ((!is_big_component && not_nearest) || (is_big_component && not_big))
-                {
-                    return std::make_pair(false, false);
-                }
-                auto use_candidate =
-                    CheckSegmentExclude(segment) &&
-                    CheckApproach(input_coordinate, segment, approach) &&
-                    (use_all_edges ? HasValidEdge(segment, *use_all_edges)
-                                   : HasValidEdge(segment)) &&
-                    (bearing_with_range ? CheckSegmentBearing(segment, *bearing_with_range)
-                                        : std::make_pair(true, true));
-
-                if (use_candidate.first || use_candidate.second)
-                {
-                    if (!has_nearest)
-                    {
-                        has_nearest = true;
-                        nearest_coord = segment.fixed_projected_coordinate;
-                    }
-                    if (is_big_component && !has_big_component)
-                    {
-                        has_big_component = true;
-                        big_component_coord = segment.fixed_projected_coordinate;
-                        big_component_distance = GetSegmentDistance(input_coordinate, segment);
-                    }
-                }
+        return MakeAlternativeBigCandidates(input_coordinate, search.nearest_coord, results);
+    }
 
-                return use_candidate;
-            },
-            [this, &has_big_component, &max_distance, input_coordinate, &big_component_distance](
-                const std::size_t /*num_results*/, const CandidateSegment &segment)
-            {
-                auto distance = GetSegmentDistance(input_coordinate, segment);
-                auto further_than_big_component = distance > big_component_distance;
-                auto no_more_candidates = has_big_component && further_than_big_component;
-                auto too_far_away =
-                    max_distance && max_distance != -1.0 && distance > *max_distance;
-
-                // Time to terminate the search when:
-                // 1. We've found a node from a big component and the next candidate is further away
-                // than that node.
-                // 2. We're further away from the input then our max allowed distance.
-                return no_more_candidates || too_far_away;
-            });
+    // Same as NearestCandidatesWithAlternativeFromBigComponent for every input coordinate, but
+    // nearby coordinates share the work of exploring the leaves of the RTree.
+    std::vector<PhantomCandidateAlternatives> BatchNearestCandidatesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<Approach> &approaches,
+        const std::vector<std::optional<double>> &max_distances,
+        const std::vector<std::optional<Bearing>> &bearings_with_range,
+        const std::optional<bool> use_all_edges) const
+    {
+        BOOST_ASSERT(approaches.size() == input_coordinates.size());
+        BOOST_ASSERT(max_distances.size() == input_coordinates.size());
+        BOOST_ASSERT(bearings_with_range.size() == input_coordinates.size());
 
-        return MakeAlternativeBigCandidates(input_coordinate, nearest_coord, results);
+        std::vector<BigComponentSearch> searches;
+        searches.reserve(input_coordinates.size());
+        for (const auto i : util::irange<std::size_t>(0, input_coordinates.size()))
+        {
+            searches.push_back({input_coordinates[i],
+                                approaches[i],
+                                max_distances[i],
+                                bearings_with_range[i],
+                                use_all_edges});
+        }
+
+        const auto results = rtree.BatchNearest(
+            input_coordinates,
+            [this, &searches](const std::size_t query, const CandidateSegment &segment)
+            { return FilterBigComponentCandidate(searches[query], segment); },
+            [this, &searches](const std::size_t query,
+                              const std::size_t /*num_results*/,
+                              const CandidateSegment &segment)
+            { return TerminateBigComponentSearch(searches[query], segment); });
+
+        std::vector<PhantomCandidateAlternatives> alternatives;
+        alternatives.reserve(input_coordinates.size());
+        for (const auto i : util::irange<std::size_t>(0, input_coordinates.size()))
+        {
+            alternatives.push_back(MakeAlternativeBigCandidates(
+                input_coordinates[i], searches[i].nearest_coord, results[i]));
+        }
+        return alternatives;
     }
 
   private:
+    // Parameters and state of a search for the nearest candidates and the nearest candidates
+    // from a big component
+    struct BigComponentSearch
+    {
+        util::Coordinate input_coordinate;
+        Approach approach;
+        std::optional<double> max_distance;
+        std::optional<Bearing> bearing_with_range;
+        std::optional<bool> use_all_edges;
+
+        bool has_nearest = false;
+        bool has_big_component = false;
+        Coordinate nearest_coord{};
+        Coordinate big_component_coord{};
+        double big_component_distance = std::numeric_limits<double>::max();
+    };
+
+    std::pair<bool, bool> FilterBigComponentCandidate(BigComponentSearch &search,
+                                                      const CandidateSegment &segment) const
+    {
+        auto is_big_component = !IsTinyComponent(segment);
+        auto not_nearest =
+            search.has_nearest && segment.fixed_projected_coordinate != search.nearest_coord;
+        auto not_big = search.has_big_component &&
+                       segment.fixed_projected_coordinate != search.big_component_coord;
+
+        /**
+         *
+         *  Two reasons why we don't want this candidate:
+         *  1. A non-big component candidate that is not at the nearest location
+         *  2. A big component candidate that is not at the big location.
+         *
+         *  It's possible that 1. could end up having the same location as the nearest big
+         *  component node if we have yet to see one. However, we don't know this and it
+         *  could lead to buffering large numbers of candidates before finding the big
+         *  component location.
+         *  By filtering out 1. nodes, this does mean that the alternative list of
+         *  candidates will not have non-big component candidates. Given the alternative
+         *  list of big component candidates is meant as a backup choice, this seems
+         *  reasonable.
+         */
+        if ((!is_big_component && not_nearest) || (is_big_component && not_big))
+        {
+            return std::make_pair(false, false);
+        }
+        auto use_candidate =
+            CheckSegmentExclude(segment) &&
+            CheckApproach(search.input_coordinate, segment, search.approach) &&
+            (search.use_all_edges ? HasValidEdge(segment, *search.use_all_edges)
+                                  : HasValidEdge(segment)) &&
+            (search.bearing_with_range ? CheckSegmentBearing(segment, *search.bearing_with_range)
+                                       : std::make_pair(true, true));
+
+        if (use_candidate.first || use_candidate.second)
+        {
+            if (!search.has_nearest)
+            {
+                search.has_nearest = true;
+                search.nearest_coord = segment.fixed_projected_coordinate;
+            }
+            if (is_big_component && !search.has_big_component)
+            {
+                search.has_big_component = true;
+                search.big_component_coord = segment.fixed_projected_coordinate;
+                search.big_component_distance =
+                    GetSegmentDistance(search.input_coordinate, segment);
+            }
+        }
+
+        return use_candidate;
+    }
+
+    bool TerminateBigComponentSearch(const BigComponentSearch &search,
+                                     const CandidateSegment &segment) const
+    {
+        auto distance = GetSegmentDistance(search.input_coordinate, segment);
+        auto further_than_big_component = distance > search.big_component_distance;
+        auto no_more_candidates = search.has_big_component && further_than_big_component;
+        auto too_far_away = search.max_distance && search.max_distance != -1.0 &&
+                            distance > *search.max_distance;
+
+        // Time to terminate the search when:
+        // 1. We've found a node from a big component and the next candidate is further away
+        // than that node.
+        // 2. We're further away from the input then our max allowed distance.
+        return no_more_candidates || too_far_away;
+    }
+
     PhantomCandidateAlternatives
     MakeAlternativeBigCandidates(const util::Coordinate input_coordinate,
                                  const Coordinate nearest_coord,
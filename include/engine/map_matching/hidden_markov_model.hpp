@@ -6,9 +6,12 @@
 #include <boost/assert.hpp>
 #include <numbers>
 
+#include <algorithm>
 #include <cmath>
-
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace osrm::engine::map_matching
@@ -44,59 +47,85 @@ struct TransitionLogProbability
     double operator()(const double d_t) const { return -log_beta - d_t / beta; }
 };
 
+// The candidates of one timestamp of a Viterbi lattice, every array has one entry per candidate
+struct LatticeColumn
+{
+    std::size_t size;
+    const double *emission_log_probabilities;
+    double *viterbi;
+    std::pair<unsigned, unsigned> *parents;
+    float *path_distances;
+    std::uint8_t *pruned;
+};
+
+// The Viterbi lattice of a whole trace. The candidates of all timestamps follow each other in
+// every array, the ones of timestamp t start at offsets[t].
 template <class CandidateLists> struct HiddenMarkovModel
 {
-    std::vector<std::vector<double>> viterbi;
-    std::vector<std::vector<bool>> viterbi_reachable;
-    std::vector<std::vector<std::pair<unsigned, unsigned>>> parents;
-    std::vector<std::vector<float>> path_distances;
-    std::vector<std::vector<bool>> pruned;
+    std::vector<std::size_t> offsets;
+    std::vector<double> emission_log_probabilities;
+    std::vector<double> viterbi;
+    std::vector<std::uint8_t> viterbi_reachable;
+    std::vector<std::pair<unsigned, unsigned>> parents;
+    std::vector<float> path_distances;
+    std::vector<std::uint8_t> pruned;
     std::vector<bool> breakage;
 
     const CandidateLists &candidates_list;
-    const std::vector<std::vector<double>> &emission_log_probabilities;
 
-    HiddenMarkovModel(const CandidateLists &candidates_list,
-                      const std::vector<std::vector<double>> &emission_log_probabilities)
-        : breakage(candidates_list.size()), candidates_list(candidates_list),
-          emission_log_probabilities(emission_log_probabilities)
+    // The emission log probabilities have to be set before the model is initialized
+    HiddenMarkovModel(const CandidateLists &candidates_list)
+        : offsets(candidates_list.size() + 1), breakage(candidates_list.size()),
+          candidates_list(candidates_list)
     {
-        viterbi.resize(candidates_list.size());
-        viterbi_reachable.resize(candidates_list.size());
-        parents.resize(candidates_list.size());
-        path_distances.resize(candidates_list.size());
-        pruned.resize(candidates_list.size());
-        breakage.resize(candidates_list.size());
-        for (const auto i : util::irange<std::size_t>(0UL, candidates_list.size()))
+        for (const auto t : util::irange<std::size_t>(0UL, candidates_list.size()))
         {
-            const auto &num_candidates = candidates_list[i].size();
-            // add empty vectors
-            if (num_candidates > 0)
-            {
-                viterbi[i].resize(num_candidates);
-                viterbi_reachable[i].resize(num_candidates);
-                parents[i].resize(num_candidates);
-                path_distances[i].resize(num_candidates);
-                pruned[i].resize(num_candidates);
-            }
+            offsets[t + 1] = offsets[t] + candidates_list[t].size();
         }
 
+        const auto number_of_candidates = offsets.back();
+        emission_log_probabilities.resize(number_of_candidates);
+        viterbi.resize(number_of_candidates);
+        viterbi_reachable.resize(number_of_candidates);
+        parents.resize(number_of_candidates);
+        path_distances.resize(number_of_candidates);
+        pruned.resize(number_of_candidates);
+
         Clear(0);
     }
 
-    void Clear(std::size_t initial_timestamp)
+    std::size_t Index(const std::size_t t, const std::size_t s) const
     {
-        BOOST_ASSERT(viterbi.size() == parents.size() && parents.size() == path_distances.size() &&
-                     path_distances.size() == pruned.size() && pruned.size() == breakage.size());
+        BOOST_ASSERT(offsets[t] + s < offsets[t + 1]);
+        return offsets[t] + s;
+    }
 
-        for (const auto t : util::irange(initial_timestamp, viterbi.size()))
-        {
-            std::fill(viterbi[t].begin(), viterbi[t].end(), IMPOSSIBLE_LOG_PROB);
-            std::fill(viterbi_reachable[t].begin(), viterbi_reachable[t].end(), false);
-            std::fill(parents[t].begin(), parents[t].end(), std::make_pair(0u, 0u));
-            std::fill(path_distances[t].begin(), path_distances[t].end(), 0);
-            std::fill(pruned[t].begin(), pruned[t].end(), true);
-        }
+    std::size_t NumberOfCandidates(const std::size_t t) const
+    {
+        return offsets[t + 1] - offsets[t];
+    }
+
+    LatticeColumn Column(const std::size_t t)
+    {
+        const auto offset = offsets[t];
+        return LatticeColumn{NumberOfCandidates(t),
+                             emission_log_probabilities.data() + offset,
+                             viterbi.data() + offset,
+                             parents.data() + offset,
+                             path_distances.data() + offset,
+                             pruned.data() + offset};
+    }
+
+    void Clear(std::size_t initial_timestamp)
+    {
+        BOOST_ASSERT(offsets.size() == breakage.size() + 1);
+
+        const auto first = offsets[initial_timestamp];
+        std::fill(viterbi.begin() + first, viterbi.end(), IMPOSSIBLE_LOG_PROB);
+        std::fill(viterbi_reachable.begin() + first, viterbi_reachable.end(), false);
+        std::fill(parents.begin() + first, parents.end(), std::make_pair(0u, 0u));
+        std::fill(path_distances.begin() + first, path_distances.end(), 0);
+        std::fill(pruned.begin() + first, pruned.end(), true);
         std::fill(breakage.begin() + initial_timestamp, breakage.end(), true);
     }
 
@@ -107,14 +136,15 @@ template <class CandidateLists> struct HiddenMarkovModel
         {
             BOOST_ASSERT(initial_timestamp < num_points);
 
-            for (const auto s : util::irange<std::size_t>(0UL, viterbi[initial_timestamp].size()))
+            for (const auto index :
+                 util::irange(offsets[initial_timestamp], offsets[initial_timestamp + 1]))
             {
-                viterbi[initial_timestamp][s] = emission_log_probabilities[initial_timestamp][s];
-                parents[initial_timestamp][s] = std::make_pair(initial_timestamp, s);
-                pruned[initial_timestamp][s] = viterbi[initial_timestamp][s] < MINIMAL_LOG_PROB;
+                const auto s = index - offsets[initial_timestamp];
+                viterbi[index] = emission_log_probabilities[index];
+                parents[index] = std::make_pair(initial_timestamp, s);
+                pruned[index] = viterbi[index] < MINIMAL_LOG_PROB;
 
-                breakage[initial_timestamp] =
-                    breakage[initial_timestamp] && pruned[initial_timestamp][s];
+                breakage[initial_timestamp] = breakage[initial_timestamp] && pruned[index];
             }
 
             ++initial_timestamp;
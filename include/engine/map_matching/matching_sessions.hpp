@@ -0,0 +1,180 @@
+#ifndef MAP_MATCHING_MATCHING_SESSIONS_HPP
+#define MAP_MATCHING_MATCHING_SESSIONS_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/map_matching/matching_state.hpp"
+
+#include <boost/assert.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace osrm::engine::map_matching
+{
+
+// Keeps the matching states of the traces that are matched while they are recorded, keyed by
+// a session id chosen by the client, e.g. the id of a vehicle.
+//
+// Sessions that were not updated for the time to live are dropped, and the least recently used
+// sessions are dropped whenever all sessions together take more memory than the budget.
+//
+// Like the caches of the search algorithms, sessions are only valid for one generation of the
+// dataset: their candidates refer to the graph that was searched, so Invalidate() drops all
+// sessions when the facades are swapped.
+class MatchingSessions
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Session
+    {
+        // an update of the session holds the mutex until it is done
+        std::mutex mutex;
+        // the facade the state was matched on, a request with another metric or exclude class
+        // starts over
+        const datafacade::BaseDataFacade *facade = nullptr;
+        MatchingState state;
+    };
+
+    MatchingSessions(const std::size_t max_size_in_bytes, const Clock::duration time_to_live)
+        : max_size_in_bytes(max_size_in_bytes), time_to_live(time_to_live)
+    {
+    }
+
+    std::uint64_t GetGeneration() const { return generation.load(); }
+
+    void Invalidate()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++generation;
+        entries.clear();
+        index.clear();
+        size_in_bytes = 0;
+    }
+
+    // Returns the session with the given id, or a new one if there is none. Requests of an old
+    // generation get a session that is not kept.
+    std::shared_ptr<Session> Get(const std::string &id, const std::uint64_t request_generation)
+    {
+        const auto now = Clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (request_generation != generation)
+        {
+            return std::make_shared<Session>();
+        }
+
+        // the least recently used sessions are the oldest ones
+        while (!entries.empty() && entries.back().last_update + time_to_live < now)
+        {
+            Erase(std::prev(entries.end()));
+        }
+
+        const auto iter = index.find(id);
+        if (iter != index.end())
+        {
+            return iter->second->session;
+        }
+
+        // the new session is dropped again if it doesn't fit on its own, the request still
+        // gets it
+        auto session = std::make_shared<Session>();
+        entries.push_front(Entry{id, session, sizeof(Session), now});
+        index.emplace(id, entries.begin());
+        size_in_bytes += sizeof(Session);
+        EvictUntilFits(entries.begin());
+        return session;
+    }
+
+    // Accounts the memory of a session after an update and drops the least recently used
+    // sessions that don't fit into the budget anymore
+    void Update(const std::string &id,
+                const std::shared_ptr<Session> &session,
+                const std::size_t session_size_in_bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto iter = index.find(id);
+        // the session may have been dropped in the meantime
+        if (iter == index.end() || iter->second->session != session)
+        {
+            return;
+        }
+
+        auto &entry = *iter->second;
+        size_in_bytes = size_in_bytes - entry.size_in_bytes + session_size_in_bytes;
+        entry.size_in_bytes = session_size_in_bytes;
+        entry.last_update = Clock::now();
+        entries.splice(entries.begin(), entries, iter->second);
+        EvictUntilFits(entries.begin());
+    }
+
+    std::size_t GetNumberOfSessions() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return size_in_bytes;
+    }
+
+  private:
+    struct Entry
+    {
+        std::string id;
+        std::shared_ptr<Session> session;
+        std::size_t size_in_bytes;
+        Clock::time_point last_update;
+    };
+
+    void Erase(const std::list<Entry>::iterator iter)
+    {
+        size_in_bytes -= iter->size_in_bytes;
+        index.erase(iter->id);
+        entries.erase(iter);
+    }
+
+    // Drops the least recently used sessions, the given one only if it doesn't fit on its own
+    void EvictUntilFits(const std::list<Entry>::iterator keep)
+    {
+        if (keep->size_in_bytes > max_size_in_bytes)
+        {
+            Erase(keep);
+            return;
+        }
+        while (size_in_bytes > max_size_in_bytes)
+        {
+            BOOST_ASSERT(std::prev(entries.end()) != keep);
+            Erase(std::prev(entries.end()));
+        }
+    }
+
+    const std::size_t max_size_in_bytes;
+    const Clock::duration time_to_live;
+    std::atomic<std::uint64_t> generation{0};
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::size_t size_in_bytes = 0;
+};
+
+// The matching sessions as seen by a single request, an empty handle disables sessions
+struct MatchingSessionsHandle
+{
+    MatchingSessions *sessions = nullptr;
+    std::uint64_t generation = 0;
+
+    explicit operator bool() const { return sessions != nullptr; }
+};
+} // namespace osrm::engine::map_matching
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MAP_MATCHING_MATCHING_STATE_HPP
+#define MAP_MATCHING_MATCHING_STATE_HPP
+
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace osrm::engine::map_matching
+{
+
+// A point of a trace with the parameters that map matching uses
+struct TracePoint
+{
+    util::Coordinate coordinate;
+    // only used if the trace has timestamps
+    unsigned timestamp;
+    std::optional<double> gps_precision;
+};
+
+// The part of the Viterbi lattice of a trace that is matched while it is recorded, e.g. the
+// trace of a vehicle that sends its positions every few seconds.
+//
+// New points extend the lattice. As soon as the Viterbi paths of all candidates of the last
+// point pass through the same candidate of an earlier point, the points up to that one can't
+// change anymore and are finalized: they are returned once and dropped from the lattice,
+// except for the last one, which is where the next finalized points continue.
+struct MatchingState
+{
+    struct Column
+    {
+        TracePoint point;
+        std::vector<PhantomNodeWithDistance> candidates;
+        std::vector<double> emission_log_probabilities;
+        std::vector<double> viterbi;
+        // sequence number of the previous column and candidate of the Viterbi path
+        std::vector<std::pair<unsigned, unsigned>> parents;
+        std::vector<float> path_distances;
+        std::vector<std::uint8_t> pruned;
+        bool breakage;
+    };
+
+    // sequence number of the first column
+    unsigned first_sequence = 0;
+    // the first column was returned with the last finalized points, only its matched candidate
+    // is left
+    bool first_is_final = false;
+    std::deque<Column> columns;
+    // time between the last points, to detect gaps in the trace
+    std::deque<unsigned> sample_times;
+    // unset until the first point was added
+    std::optional<unsigned> last_timestamp;
+
+    bool Empty() const { return columns.empty(); }
+
+    Column &GetColumn(const unsigned sequence)
+    {
+        BOOST_ASSERT(sequence >= first_sequence && sequence - first_sequence < columns.size());
+        return columns[sequence - first_sequence];
+    }
+
+    unsigned GetLastSequence() const
+    {
+        BOOST_ASSERT(!columns.empty());
+        return first_sequence + columns.size() - 1;
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        std::size_t size = sizeof(MatchingState) + sample_times.size() * sizeof(unsigned);
+        for (const auto &column : columns)
+        {
+            size += sizeof(Column) +
+                    column.candidates.size() *
+                        (sizeof(PhantomNodeWithDistance) + 2 * sizeof(double) +
+                         sizeof(std::pair<unsigned, unsigned>) + sizeof(float) +
+                         sizeof(std::uint8_t));
+        }
+        return size;
+    }
+};
+} // namespace osrm::engine::map_matching
+
+#endif
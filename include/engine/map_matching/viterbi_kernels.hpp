@@ -0,0 +1,212 @@
+#ifndef OSRM_ENGINE_MAP_MATCHING_VITERBI_KERNELS_HPP
+#define OSRM_ENGINE_MAP_MATCHING_VITERBI_KERNELS_HPP
+
+#include "engine/map_matching/hidden_markov_model.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OSRM_VITERBI_AVX2
+#include <immintrin.h>
+#endif
+
+namespace osrm::engine::map_matching
+{
+
+// Replaces the distances of the candidates to their trace point with their emission log
+// probabilities
+inline void computeEmissionLogProbabilitiesScalar(const EmissionLogProbability &emission,
+                                                  double *values,
+                                                  const std::size_t size)
+{
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        values[index] = emission(values[index]);
+    }
+}
+
+// Extends the Viterbi path that ends in the source candidate to all candidates of the current
+// column with the network distances of the row. Every candidate keeps the best path, a path is
+// only taken if it is strictly better, so the rows have to be relaxed in the order of the
+// sources. Returns true if any candidate was improved.
+inline bool relaxTransitionsScalar(const TransitionLogProbability &transition,
+                                   const double source_viterbi,
+                                   const std::pair<unsigned, unsigned> source,
+                                   const EdgeDistance *row_distances,
+                                   const double haversine_distance,
+                                   const double max_distance_delta,
+                                   const LatticeColumn &current,
+                                   const std::size_t first = 0)
+{
+    bool improved = false;
+    for (auto index = first; index < current.size; ++index)
+    {
+        const auto network_distance = from_alias<double>(row_distances[index]);
+        // get distance diff between loc1/2 and locs/s_prime
+        const auto d_t = std::abs(network_distance - haversine_distance);
+        const double new_value =
+            source_viterbi + current.emission_log_probabilities[index] + transition(d_t);
+
+        // unreachable candidates and very low probability transitions are pruned
+        const bool valid =
+            row_distances[index] != MAXIMAL_EDGE_DISTANCE && d_t < max_distance_delta;
+        if (valid && new_value > current.viterbi[index])
+        {
+            current.viterbi[index] = new_value;
+            current.parents[index] = source;
+            current.path_distances[index] = network_distance;
+            current.pruned[index] = false;
+            improved = true;
+        }
+    }
+    return improved;
+}
+
+#ifdef OSRM_VITERBI_AVX2
+// Four candidates per iteration. The operations are the same as the ones of the scalar kernels
+// and in the same order, so both give bit-identical results.
+__attribute__((target("avx2"))) inline void computeEmissionLogProbabilitiesAVX2(
+    const EmissionLogProbability &emission, double *values, const std::size_t size)
+{
+    const auto sigma_z = _mm256_set1_pd(emission.sigma_z);
+    const auto log_sigma_z = _mm256_set1_pd(emission.log_sigma_z);
+    const auto log_2_pi_vector = _mm256_set1_pd(log_2_pi);
+    const auto minus_half = _mm256_set1_pd(-0.5);
+
+    std::size_t index = 0;
+    for (; index + 4 <= size; index += 4)
+    {
+        const auto normalized = _mm256_div_pd(_mm256_loadu_pd(values + index), sigma_z);
+        const auto exponent =
+            _mm256_add_pd(log_2_pi_vector, _mm256_mul_pd(normalized, normalized));
+        _mm256_storeu_pd(values + index,
+                         _mm256_sub_pd(_mm256_mul_pd(minus_half, exponent), log_sigma_z));
+    }
+    computeEmissionLogProbabilitiesScalar(emission, values + index, size - index);
+}
+
+// The new path values and their validity are computed in vector registers, only improved
+// candidates are written back
+__attribute__((target("avx2"))) inline bool
+relaxTransitionsAVX2(const TransitionLogProbability &transition,
+                     const double source_viterbi,
+                     const std::pair<unsigned, unsigned> source,
+                     const EdgeDistance *row_distances,
+                     const double haversine_distance,
+                     const double max_distance_delta,
+                     const LatticeColumn &current)
+{
+    static_assert(sizeof(EdgeDistance) == sizeof(float));
+
+    const auto source_value = _mm256_set1_pd(source_viterbi);
+    const auto haversine = _mm256_set1_pd(haversine_distance);
+    const auto max_delta = _mm256_set1_pd(max_distance_delta);
+    const auto unreachable = _mm256_set1_pd(from_alias<double>(MAXIMAL_EDGE_DISTANCE));
+    const auto minus_log_beta = _mm256_set1_pd(-transition.log_beta);
+    const auto beta = _mm256_set1_pd(transition.beta);
+    const auto sign_bit = _mm256_set1_pd(-0.);
+    const auto *distances = reinterpret_cast<const float *>(row_distances);
+
+    bool improved = false;
+    std::size_t index = 0;
+    for (; index + 4 <= current.size; index += 4)
+    {
+        const auto network_distances = _mm256_cvtps_pd(_mm_loadu_ps(distances + index));
+        const auto d_t = _mm256_andnot_pd(sign_bit, _mm256_sub_pd(network_distances, haversine));
+        const auto new_values = _mm256_add_pd(
+            _mm256_add_pd(source_value,
+                          _mm256_loadu_pd(current.emission_log_probabilities + index)),
+            _mm256_sub_pd(minus_log_beta, _mm256_div_pd(d_t, beta)));
+
+        // unreachable candidates and very low probability transitions are pruned
+        const auto valid =
+            _mm256_and_pd(_mm256_cmp_pd(network_distances, unreachable, _CMP_NEQ_OQ),
+                          _mm256_cmp_pd(d_t, max_delta, _CMP_LT_OQ));
+        const auto better = _mm256_and_pd(
+            valid,
+            _mm256_cmp_pd(new_values, _mm256_loadu_pd(current.viterbi + index), _CMP_GT_OQ));
+        auto mask = _mm256_movemask_pd(better);
+        if (mask == 0)
+            continue;
+
+        alignas(32) double lane_values[4];
+        _mm256_store_pd(lane_values, new_values);
+        while (mask != 0)
+        {
+            const auto lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            current.viterbi[index + lane] = lane_values[lane];
+            current.parents[index + lane] = source;
+            current.path_distances[index + lane] = distances[index + lane];
+            current.pruned[index + lane] = false;
+        }
+        improved = true;
+    }
+
+    return relaxTransitionsScalar(transition,
+                                  source_viterbi,
+                                  source,
+                                  row_distances,
+                                  haversine_distance,
+                                  max_distance_delta,
+                                  current,
+                                  index) ||
+           improved;
+}
+#endif
+
+// Picks the widest kernel supported by the CPU at runtime
+inline void computeEmissionLogProbabilities(const EmissionLogProbability &emission,
+                                            double *values,
+                                            const std::size_t size)
+{
+#ifdef OSRM_VITERBI_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+    {
+        computeEmissionLogProbabilitiesAVX2(emission, values, size);
+        return;
+    }
+#endif
+    computeEmissionLogProbabilitiesScalar(emission, values, size);
+}
+
+inline bool relaxTransitions(const TransitionLogProbability &transition,
+                             const double source_viterbi,
+                             const std::pair<unsigned, unsigned> source,
+                             const EdgeDistance *row_distances,
+                             const double haversine_distance,
+                             const double max_distance_delta,
+                             const LatticeColumn &current)
+{
+#ifdef OSRM_VITERBI_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+    {
+        return relaxTransitionsAVX2(transition,
+                                    source_viterbi,
+                                    source,
+                                    row_distances,
+                                    haversine_distance,
+                                    max_distance_delta,
+                                    current);
+    }
+#endif
+    return relaxTransitionsScalar(transition,
+                                  source_viterbi,
+                                  source,
+                                  row_distances,
+                                  haversine_distance,
+                                  max_distance_delta,
+                                  current);
+}
+
+} // namespace osrm::engine::map_matching
+
+#endif // OSRM_ENGINE_MAP_MATCHING_VITERBI_KERNELS_HPP
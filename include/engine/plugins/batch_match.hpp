@@ -0,0 +1,46 @@
+#ifndef BATCH_MATCH_HPP
+#define BATCH_MATCH_HPP
+
+#include "engine/plugins/match.hpp"
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/api/base_result.hpp"
+#include "engine/api/batch_match_parameters.hpp"
+#include "engine/routing_algorithms.hpp"
+
+#include "util/json_container.hpp"
+
+#include <tbb/task_arena.h>
+
+#include <optional>
+
+namespace osrm::engine::plugins
+{
+
+// Matches many independent traces with one request. The traces are matched in parallel in a task
+// arena shared by all batch requests, a streamed response is written in the order of the traces
+// while the later ones are still matched.
+class BatchMatchPlugin final : public BasePlugin
+{
+  public:
+    BatchMatchPlugin(const int max_traces_batch_match,
+                     const int max_locations_map_matching,
+                     const double max_radius_map_matching,
+                     const std::optional<double> default_radius);
+
+    Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                         const api::BatchMatchParameters &params,
+                         osrm::engine::api::ResultT &result,
+                         const osrm::engine::api::ResultStream &stream = {}) const;
+
+  private:
+    util::json::Value MatchTrace(const RoutingAlgorithmsInterface &algorithms,
+                                 const api::MatchParameters &trace) const;
+
+    const int max_traces_batch_match;
+    const MatchPlugin match_plugin;
+    mutable tbb::task_arena arena;
+};
+} // namespace osrm::engine::plugins
+
+#endif // BATCH_MATCH_HPP
@@ -0,0 +1,36 @@
+#ifndef BATCH_ROUTE_HPP
+#define BATCH_ROUTE_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/api/batch_route_parameters.hpp"
+#include "engine/routing_algorithms.hpp"
+
+#include "util/json_container.hpp"
+
+#include <tbb/task_arena.h>
+
+#include <optional>
+
+namespace osrm::engine::plugins
+{
+
+// Routes many independent origin-destination pairs with one request. Every location is only
+// snapped once and the pairs are searched in parallel in a task arena shared by all batch requests.
+class BatchRoutePlugin final : public BasePlugin
+{
+  public:
+    explicit BatchRoutePlugin(const int max_pairs_batch_route,
+                              const std::optional<double> default_radius);
+
+    Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                         const api::BatchRouteParameters &params,
+                         osrm::engine::api::ResultT &result) const;
+
+  private:
+    const int max_pairs_batch_route;
+    mutable tbb::task_arena arena;
+};
+} // namespace osrm::engine::plugins
+
+#endif // BATCH_ROUTE_HPP
@@ -2,6 +2,7 @@
 #define MATCH_HPP
 
 #include "engine/api/match_parameters.hpp"
+#include "engine/map_matching/matching_sessions.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
 
@@ -30,9 +31,17 @@ class MatchPlugin : public BasePlugin
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::MatchParameters &parameters,
-                         osrm::engine::api::ResultT &json_result) const;
+                         osrm::engine::api::ResultT &json_result,
+                         const map_matching::MatchingSessionsHandle &sessions = {}) const;
 
   private:
+    std::vector<double> GetSearchRadiuses(const api::MatchParameters &parameters) const;
+
+    Status HandleSessionRequest(const RoutingAlgorithmsInterface &algorithms,
+                                const api::MatchParameters &parameters,
+                                osrm::engine::api::ResultT &json_result,
+                                const map_matching::MatchingSessionsHandle &sessions) const;
+
     const int max_locations_map_matching;
     const double max_radius_map_matching;
 };
@@ -64,6 +64,8 @@ class BasePlugin
         return false;
     }
 
+  public:
+    // also used by the engine to report requests that ran out of time
     struct ErrorRenderer
     {
         std::string code;
@@ -89,8 +91,13 @@ class BasePlugin
         {
             str_result = str(boost::format("code=%1% message=%2%") % code % message);
         };
+        void operator()(api::BinaryBuffer &binary_result)
+        {
+            binary_result.data = str(boost::format("code=%1% message=%2%") % code % message);
+        };
     };
 
+  protected:
     Status Error(const std::string &code,
                  const std::string &message,
                  osrm::engine::api::ResultT &result) const
@@ -268,6 +275,14 @@ class BasePlugin
         const bool use_all_edges = parameters.snapping == api::BaseParameters::SnappingType::Any;
 
         BOOST_ASSERT(parameters.IsValid());
+
+        // coordinates without a valid hint are snapped together, so that nearby coordinates
+        // share the work of searching the RTree
+        std::vector<std::size_t> snapped_indices;
+        std::vector<util::Coordinate> coordinates;
+        std::vector<std::optional<double>> max_distances;
+        std::vector<std::optional<Bearing>> bearings;
+        std::vector<Approach> approaches;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] && !parameters.hints[i]->segment_hints.empty() &&
@@ -281,14 +296,27 @@ class BasePlugin
                 continue;
             }
 
-            alternatives[i] = facade.NearestCandidatesWithAlternativeFromBigComponent(
-                parameters.coordinates[i],
-                use_radiuses ? parameters.radiuses[i] : default_radius,
-                use_bearings ? parameters.bearings[i] : std::nullopt,
-                use_approaches && parameters.approaches[i] ? parameters.approaches[i].value()
-                                                           : engine::Approach::UNRESTRICTED,
-                use_all_edges);
+            snapped_indices.push_back(i);
+            coordinates.push_back(parameters.coordinates[i]);
+            max_distances.push_back(use_radiuses ? parameters.radiuses[i] : default_radius);
+            bearings.push_back(use_bearings ? parameters.bearings[i] : std::nullopt);
+            approaches.push_back(use_approaches && parameters.approaches[i]
+                                     ? parameters.approaches[i].value()
+                                     : engine::Approach::UNRESTRICTED);
+        }
+
+        if (!snapped_indices.empty())
+        {
+            auto snapped = facade.BatchNearestCandidatesWithAlternativeFromBigComponent(
+                coordinates, max_distances, bearings, approaches, use_all_edges);
+            for (const auto j : util::irange<std::size_t>(0UL, snapped_indices.size()))
+            {
+                alternatives[snapped_indices[j]] = std::move(snapped[j]);
+            }
+        }
 
+        for (const auto i : util::irange<std::size_t>(0UL, alternatives.size()))
+        {
             // we didn't find a fitting node, return error
             if (alternatives[i].first.empty())
             {
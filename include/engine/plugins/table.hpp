@@ -15,14 +15,25 @@ class TablePlugin final : public BasePlugin
 {
   public:
     explicit TablePlugin(const int max_locations_distance_table,
-                         const std::optional<double> default_radius);
+                         const std::optional<double> default_radius,
+                         const bool use_parallel_search,
+                         const int min_destinations_rphast = -1);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::TableParameters &params,
                          osrm::engine::api::ResultT &result) const;
 
+    // Streams the rows of a successful JSON response into `stream`, errors are still
+    // reported through `result`
+    Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                         const api::TableParameters &params,
+                         osrm::engine::api::ResultT &result,
+                         const osrm::engine::api::ResultStream &stream) const;
+
   private:
     const int max_locations_distance_table;
+    const bool use_parallel_search;
+    const int min_destinations_rphast;
 };
 } // namespace osrm::engine::plugins
 
@@ -25,6 +25,7 @@ class TripPlugin final : public BasePlugin
 {
   private:
     const int max_locations_trip;
+    const int local_search_time;
 
     InternalRouteResult ComputeRoute(const RoutingAlgorithmsInterface &algorithms,
                                      const std::vector<PhantomNodeCandidates> &candidates_list,
@@ -32,8 +33,11 @@ class TripPlugin final : public BasePlugin
                                      const bool roundtrip) const;
 
   public:
-    explicit TripPlugin(const int max_locations_trip_, std::optional<double> default_radius)
-        : BasePlugin(default_radius), max_locations_trip(max_locations_trip_)
+    explicit TripPlugin(const int max_locations_trip_,
+                        std::optional<double> default_radius,
+                        const int local_search_time_ = 0)
+        : BasePlugin(default_radius), max_locations_trip(max_locations_trip_),
+          local_search_time(local_search_time_)
     {
     }
 
@@ -23,11 +23,15 @@ class ViaRoutePlugin final : public BasePlugin
   private:
     const int max_locations_viaroute;
     const int max_alternatives;
+    const bool use_parallel_alternatives_search;
+    const bool use_parallel_leg_search;
 
   public:
     explicit ViaRoutePlugin(int max_locations_viaroute,
                             int max_alternatives,
-                            std::optional<double> default_radius);
+                            std::optional<double> default_radius,
+                            const bool use_parallel_alternatives_search,
+                            const bool use_parallel_leg_search);
 
     Status HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                          const api::RouteParameters &route_parameters,
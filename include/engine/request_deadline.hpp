@@ -0,0 +1,107 @@
+#ifndef OSRM_ENGINE_REQUEST_DEADLINE_HPP
+#define OSRM_ENGINE_REQUEST_DEADLINE_HPP
+
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace osrm::engine
+{
+
+// Lets the search loops of a request give up once the request ran past its deadline or was
+// cancelled, e.g. because the client closed the connection.
+//
+// Like the cache handles, the deadline of a request is set for the calling thread by a scope
+// object, so the search loops don't need to know about requests. They call Check() for every
+// settled node, which only looks at the clock every CHECK_INTERVAL calls and throws a
+// util::TimeoutException when the request has to stop. Scopes of a request nest: an inner scope
+// keeps the earlier deadline and is cancelled if the cancellation check of any enclosing scope
+// says so. A task scope replaces the state of the thread instead, a thread that waits for its own
+// parallel search may run the tasks of other requests.
+class RequestDeadline
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    // returns true if the request should be aborted
+    using CancellationCheck = std::function<bool()>;
+
+    static constexpr std::uint32_t CHECK_INTERVAL = 1024;
+
+    struct State
+    {
+        std::optional<Clock::time_point> deadline;
+        CancellationCheck is_cancelled;
+    };
+
+    RequestDeadline(std::optional<Clock::time_point> deadline, CancellationCheck is_cancelled)
+        : previous(std::move(current))
+    {
+        if (previous.deadline && (!deadline || *previous.deadline < *deadline))
+        {
+            deadline = previous.deadline;
+        }
+        if (!is_cancelled)
+        {
+            is_cancelled = previous.is_cancelled;
+        }
+        else if (previous.is_cancelled)
+        {
+            is_cancelled = [outer = previous.is_cancelled, inner = std::move(is_cancelled)]
+            { return outer() || inner(); };
+        }
+        current = {deadline, std::move(is_cancelled)};
+        active = current.deadline || current.is_cancelled;
+    }
+
+    // Continues the request of another thread, e.g. in the tasks of a parallel search. The state
+    // already contains the enclosing scopes of that request.
+    explicit RequestDeadline(State state) : previous(std::move(current))
+    {
+        current = std::move(state);
+        active = current.deadline || current.is_cancelled;
+    }
+
+    ~RequestDeadline()
+    {
+        current = std::move(previous);
+        active = current.deadline || current.is_cancelled;
+    }
+
+    RequestDeadline(const RequestDeadline &) = delete;
+    RequestDeadline &operator=(const RequestDeadline &) = delete;
+
+    static const State &Current() { return current; }
+
+    static void Check()
+    {
+        if (active && ++counter % CHECK_INTERVAL == 0)
+        {
+            CheckNow();
+        }
+    }
+
+    static void CheckNow()
+    {
+        if ((current.deadline && Clock::now() >= *current.deadline) ||
+            (current.is_cancelled && current.is_cancelled()))
+        {
+            throw util::TimeoutException();
+        }
+    }
+
+  private:
+    State previous;
+
+    static inline thread_local State current;
+    static inline thread_local bool active = false;
+    static inline thread_local std::uint32_t counter = 0;
+};
+
+} // namespace osrm::engine
+
+#endif // OSRM_ENGINE_REQUEST_DEADLINE_HPP
@@ -5,9 +5,12 @@
 #include "engine/internal_route_result.hpp"
 #include "engine/phantom_node.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
+#include "engine/routing_algorithms/bucket_cache.hpp"
+#include "engine/routing_algorithms/clique_arc_cache.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/routing_algorithms/shortcut_cache.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
 
@@ -21,11 +24,13 @@ class RoutingAlgorithmsInterface
 
     virtual InternalManyRoutesResult
     AlternativePathSearch(const PhantomEndpointCandidates &endpoint_candidates,
-                          unsigned number_of_alternatives) const = 0;
+                          unsigned number_of_alternatives,
+                          const bool parallel_search) const = 0;
 
     virtual InternalRouteResult
     ShortestPathSearch(const std::vector<PhantomNodeCandidates> &waypoint_candidates,
-                       const std::optional<bool> continue_straight_at_waypoint) const = 0;
+                       const std::optional<bool> continue_straight_at_waypoint,
+                       const bool parallel_search) const = 0;
 
     virtual InternalRouteResult
     DirectShortestPathSearch(const PhantomEndpointCandidates &endpoint_candidates) const = 0;
@@ -34,7 +39,16 @@ class RoutingAlgorithmsInterface
     ManyToManySearch(const std::vector<PhantomNodeCandidates> &candidates_list,
                      const std::vector<std::size_t> &source_indices,
                      const std::vector<std::size_t> &target_indices,
-                     const bool calculate_distance) const = 0;
+                     const bool calculate_distance,
+                     const bool parallel_search,
+                     const routing_algorithms::TableLimits &limits) const = 0;
+
+    virtual std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+    RPHASTSearch(const std::vector<PhantomNodeCandidates> &candidates_list,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const bool parallel_search) const = 0;
 
     virtual routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
@@ -43,17 +57,28 @@ class RoutingAlgorithmsInterface
                 const std::vector<std::optional<double>> &trace_gps_precision,
                 const bool allow_splitting) const = 0;
 
+    virtual routing_algorithms::FinalizedMatching
+    IncrementalMapMatching(map_matching::MatchingState &state,
+                           const routing_algorithms::CandidateLists &candidates_list,
+                           const std::vector<map_matching::TracePoint> &trace_points,
+                           const bool allow_splitting) const = 0;
+
     virtual std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const = 0;
 
     virtual const DataFacadeBase &GetFacade() const = 0;
 
+    // Frees the heaps of the calling thread if they exceed the budget of the engine. Parallel
+    // requests call it on their workers once a task is done with the heaps.
+    virtual void ReleaseHeapMemory() const = 0;
+
     virtual bool HasAlternativePathSearch() const = 0;
     virtual bool HasShortestPathSearch() const = 0;
     virtual bool HasDirectShortestPathSearch() const = 0;
     virtual bool HasMapMatching() const = 0;
     virtual bool HasManyToManySearch() const = 0;
+    virtual bool HasRPHASTSearch() const = 0;
     virtual bool SupportsDistanceAnnotationType() const = 0;
     virtual bool HasGetTileTurns() const = 0;
     virtual bool HasExcludeFlags() const = 0;
@@ -65,8 +90,12 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 {
   public:
     RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
-                      std::shared_ptr<const DataFacade<Algorithm>> facade)
-        : heaps(heaps), facade(facade)
+                      std::shared_ptr<const DataFacade<Algorithm>> facade,
+                      routing_algorithms::BucketCacheHandle bucket_cache = {},
+                      routing_algorithms::ShortcutCacheHandle shortcut_cache = {},
+                      routing_algorithms::CliqueArcCacheHandle clique_arc_cache = {})
+        : heaps(heaps), facade(facade), bucket_cache(bucket_cache),
+          shortcut_cache(shortcut_cache), clique_arc_cache(clique_arc_cache)
     {
     }
 
@@ -74,11 +103,13 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 
     InternalManyRoutesResult
     AlternativePathSearch(const PhantomEndpointCandidates &endpoint_candidates,
-                          unsigned number_of_alternatives) const final override;
+                          unsigned number_of_alternatives,
+                          const bool parallel_search) const final override;
 
-    InternalRouteResult ShortestPathSearch(
-        const std::vector<PhantomNodeCandidates> &waypoint_candidates,
-        const std::optional<bool> continue_straight_at_waypoint) const final override;
+    InternalRouteResult
+    ShortestPathSearch(const std::vector<PhantomNodeCandidates> &waypoint_candidates,
+                       const std::optional<bool> continue_straight_at_waypoint,
+                       const bool parallel_search) const final override;
 
     InternalRouteResult DirectShortestPathSearch(
         const PhantomEndpointCandidates &endpoint_candidates) const final override;
@@ -87,7 +118,16 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
     ManyToManySearch(const std::vector<PhantomNodeCandidates> &candidates_list,
                      const std::vector<std::size_t> &source_indices,
                      const std::vector<std::size_t> &target_indices,
-                     const bool calculate_distance) const final override;
+                     const bool calculate_distance,
+                     const bool parallel_search,
+                     const routing_algorithms::TableLimits &limits) const final override;
+
+    std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+    RPHASTSearch(const std::vector<PhantomNodeCandidates> &candidates_list,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 const bool calculate_distance,
+                 const bool parallel_search) const final override;
 
     routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
@@ -96,12 +136,20 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
                 const std::vector<std::optional<double>> &trace_gps_precision,
                 const bool allow_splitting) const final override;
 
+    routing_algorithms::FinalizedMatching
+    IncrementalMapMatching(map_matching::MatchingState &state,
+                           const routing_algorithms::CandidateLists &candidates_list,
+                           const std::vector<map_matching::TracePoint> &trace_points,
+                           const bool allow_splitting) const final override;
+
     std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const final override;
 
     const DataFacadeBase &GetFacade() const final override { return *facade; }
 
+    void ReleaseHeapMemory() const final override { heaps.ReleaseThreadLocalStorageOverBudget(); }
+
     bool HasAlternativePathSearch() const final override
     {
         return routing_algorithms::HasAlternativePathSearch<Algorithm>::value;
@@ -127,6 +175,11 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
         return routing_algorithms::HasManyToManySearch<Algorithm>::value;
     }
 
+    bool HasRPHASTSearch() const final override
+    {
+        return routing_algorithms::HasRPHASTSearch<Algorithm>::value;
+    }
+
     bool SupportsDistanceAnnotationType() const final override
     {
         return routing_algorithms::SupportsDistanceAnnotationType<Algorithm>::value;
@@ -147,29 +200,41 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
   private:
     SearchEngineData<Algorithm> &heaps;
     std::shared_ptr<const DataFacade<Algorithm>> facade;
+    routing_algorithms::BucketCacheHandle bucket_cache;
+    routing_algorithms::ShortcutCacheHandle shortcut_cache;
+    routing_algorithms::CliqueArcCacheHandle clique_arc_cache;
 };
 
 template <typename Algorithm>
 InternalManyRoutesResult RoutingAlgorithms<Algorithm>::AlternativePathSearch(
-    const PhantomEndpointCandidates &endpoint_candidates, unsigned number_of_alternatives) const
+    const PhantomEndpointCandidates &endpoint_candidates,
+    unsigned number_of_alternatives,
+    const bool parallel_search) const
 {
+    const routing_algorithms::ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+    const routing_algorithms::CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
     return routing_algorithms::alternativePathSearch(
-        heaps, *facade, endpoint_candidates, number_of_alternatives);
+        heaps, *facade, endpoint_candidates, number_of_alternatives, parallel_search);
 }
 
 template <typename Algorithm>
 InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
     const std::vector<PhantomNodeCandidates> &waypoint_candidates,
-    const std::optional<bool> continue_straight_at_waypoint) const
+    const std::optional<bool> continue_straight_at_waypoint,
+    const bool parallel_search) const
 {
+    const routing_algorithms::ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+    const routing_algorithms::CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
     return routing_algorithms::shortestPathSearch(
-        heaps, *facade, waypoint_candidates, continue_straight_at_waypoint);
+        heaps, *facade, waypoint_candidates, continue_straight_at_waypoint, parallel_search);
 }
 
 template <typename Algorithm>
 InternalRouteResult RoutingAlgorithms<Algorithm>::DirectShortestPathSearch(
     const PhantomEndpointCandidates &endpoint_candidates) const
 {
+    const routing_algorithms::ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+    const routing_algorithms::CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
     return routing_algorithms::directShortestPathSearch(heaps, *facade, endpoint_candidates);
 }
 
@@ -181,6 +246,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
     const std::vector<std::optional<double>> &trace_gps_precision,
     const bool allow_splitting) const
 {
+    const routing_algorithms::ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+    const routing_algorithms::CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
     return routing_algorithms::mapMatching(heaps,
                                            *facade,
                                            candidates_list,
@@ -190,13 +257,32 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
                                            allow_splitting);
 }
 
+template <typename Algorithm>
+inline routing_algorithms::FinalizedMatching RoutingAlgorithms<Algorithm>::IncrementalMapMatching(
+    map_matching::MatchingState &state,
+    const routing_algorithms::CandidateLists &candidates_list,
+    const std::vector<map_matching::TracePoint> &trace_points,
+    const bool allow_splitting) const
+{
+    const routing_algorithms::ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+    const routing_algorithms::CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
+    return routing_algorithms::incrementalMapMatching(heaps,
+                                                      *facade,
+                                                      state,
+                                                      candidates_list,
+                                                      trace_points,
+                                                      allow_splitting);
+}
+
 template <typename Algorithm>
 std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
 RoutingAlgorithms<Algorithm>::ManyToManySearch(
     const std::vector<PhantomNodeCandidates> &candidates_list,
     const std::vector<std::size_t> &_source_indices,
     const std::vector<std::size_t> &_target_indices,
-    const bool calculate_distance) const
+    const bool calculate_distance,
+    const bool parallel_search,
+    const routing_algorithms::TableLimits &limits) const
 {
     BOOST_ASSERT(!candidates_list.empty());
 
@@ -214,12 +300,81 @@ RoutingAlgorithms<Algorithm>::ManyToManySearch(
         std::iota(target_indices.begin(), target_indices.end(), 0);
     }
 
-    return routing_algorithms::manyToManySearch(heaps,
+    if (!limits.IsBounded())
+    {
+        return routing_algorithms::manyToManySearch(heaps,
+                                                    *facade,
+                                                    candidates_list,
+                                                    std::move(source_indices),
+                                                    std::move(target_indices),
+                                                    calculate_distance,
+                                                    parallel_search,
+                                                    limits,
+                                                    bucket_cache);
+    }
+
+    // the distances are needed to find the cells beyond a distance limit
+    const bool limit_distance = limits.max_distance != MAXIMAL_EDGE_DISTANCE;
+    auto tables = routing_algorithms::manyToManySearch(heaps,
+                                                       *facade,
+                                                       candidates_list,
+                                                       std::move(source_indices),
+                                                       std::move(target_indices),
+                                                       calculate_distance || limit_distance,
+                                                       parallel_search,
+                                                       limits,
+                                                       bucket_cache);
+    limits.Apply(tables.first, tables.second);
+    if (!calculate_distance)
+    {
+        tables.second.clear();
+    }
+    return tables;
+}
+
+template <typename Algorithm>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+RoutingAlgorithms<Algorithm>::RPHASTSearch(const std::vector<PhantomNodeCandidates> &candidates_list,
+                                           const std::vector<std::size_t> &_source_indices,
+                                           const std::vector<std::size_t> &_target_indices,
+                                           const bool calculate_distance,
+                                           const bool parallel_search) const
+{
+    if constexpr (!routing_algorithms::HasRPHASTSearch<Algorithm>::value)
+    {
+        return ManyToManySearch(candidates_list,
+                                _source_indices,
+                                _target_indices,
+                                calculate_distance,
+                                parallel_search,
+                                {});
+    }
+    else
+    {
+        BOOST_ASSERT(!candidates_list.empty());
+
+        auto source_indices = _source_indices;
+        auto target_indices = _target_indices;
+
+        if (source_indices.empty())
+        {
+            source_indices.resize(candidates_list.size());
+            std::iota(source_indices.begin(), source_indices.end(), 0);
+        }
+        if (target_indices.empty())
+        {
+            target_indices.resize(candidates_list.size());
+            std::iota(target_indices.begin(), target_indices.end(), 0);
+        }
+
+        return routing_algorithms::rphastSearch(heaps,
                                                 *facade,
                                                 candidates_list,
                                                 std::move(source_indices),
                                                 std::move(target_indices),
-                                                calculate_distance);
+                                                calculate_distance,
+                                                parallel_search);
+    }
 }
 
 template <typename Algorithm>
@@ -15,12 +15,15 @@ namespace osrm::engine::routing_algorithms
 InternalManyRoutesResult alternativePathSearch(SearchEngineData<ch::Algorithm> &search_engine_data,
                                                const DataFacade<ch::Algorithm> &facade,
                                                const PhantomEndpointCandidates &endpoint_candidates,
-                                               unsigned number_of_alternatives);
+                                               unsigned number_of_alternatives,
+                                               const bool parallel_search);
 
+// Unpacks the candidate paths in parallel if parallel_search is set
 InternalManyRoutesResult alternativePathSearch(SearchEngineData<mld::Algorithm> &search_engine_data,
                                                const DataFacade<mld::Algorithm> &facade,
                                                const PhantomEndpointCandidates &endpoint_candidates,
-                                               unsigned number_of_alternatives);
+                                               unsigned number_of_alternatives,
+                                               const bool parallel_search);
 
 } // namespace osrm::engine::routing_algorithms
 
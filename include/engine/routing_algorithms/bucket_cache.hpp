@@ -0,0 +1,241 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_CACHE_HPP
+
+#include "engine/phantom_node.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm::engine::routing_algorithms
+{
+
+// Keeps the buckets of many-to-many backward searches across requests, so that targets which
+// show up in many tables (depots, hubs) only cost a lookup.
+//
+// Entries are keyed by the facade that was searched, the search direction and the snapped
+// phantom nodes of the target. They are only valid for one generation of the dataset: whenever
+// the facades are swapped (e.g. by the DataWatchdog) Invalidate() starts a new generation and
+// drops all entries. Requests remember the generation they started in, so buckets computed on
+// an outdated facade are never handed out or stored.
+//
+// The memory used by the buckets is bounded, the least recently used entries are evicted first.
+class BucketCache
+{
+  public:
+    using Buckets = std::vector<NodeBucket>;
+
+    explicit BucketCache(const std::size_t max_size_in_bytes)
+        : max_size_in_bytes(max_size_in_bytes)
+    {
+    }
+
+    std::uint64_t GetGeneration() const { return generation.load(); }
+
+    void Invalidate()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++generation;
+        entries.clear();
+        index.clear();
+        size_in_bytes = 0;
+    }
+
+    std::shared_ptr<const Buckets> Find(const std::uint64_t request_generation,
+                                        const datafacade::BaseDataFacade &facade,
+                                        const bool reversed,
+                                        const PhantomNodeCandidates &candidates)
+    {
+        const Key key{&facade, reversed, candidates};
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (request_generation != generation)
+        {
+            return {};
+        }
+
+        const auto iter = index.find(key);
+        if (iter == index.end())
+        {
+            return {};
+        }
+
+        // mark as most recently used
+        entries.splice(entries.begin(), entries, iter->second);
+        return iter->second->buckets;
+    }
+
+    void Insert(const std::uint64_t request_generation,
+                const datafacade::BaseDataFacade &facade,
+                const bool reversed,
+                const PhantomNodeCandidates &candidates,
+                Buckets buckets)
+    {
+        buckets.shrink_to_fit();
+        // the key is stored twice, in the entry and in the index
+        const auto entry_size = sizeof(Entry) + 2 * candidates.size() * sizeof(PhantomNode) +
+                                buckets.size() * sizeof(NodeBucket);
+        if (entry_size > max_size_in_bytes)
+        {
+            return;
+        }
+
+        Key key{&facade, reversed, candidates};
+        auto shared_buckets = std::make_shared<const Buckets>(std::move(buckets));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (request_generation != generation || index.count(key) > 0)
+        {
+            return;
+        }
+
+        while (size_in_bytes + entry_size > max_size_in_bytes)
+        {
+            BOOST_ASSERT(!entries.empty());
+            size_in_bytes -= entries.back().size_in_bytes;
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+
+        entries.push_front(Entry{std::move(key), std::move(shared_buckets), entry_size});
+        index.emplace(entries.front().key, entries.begin());
+        size_in_bytes += entry_size;
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return size_in_bytes;
+    }
+
+  private:
+    struct Key
+    {
+        const datafacade::BaseDataFacade *facade;
+        bool reversed;
+        PhantomNodeCandidates candidates;
+
+        // the parts of a phantom node that determine the search space of a backward search
+        static auto Snapping(const PhantomNode &node)
+        {
+            return std::make_tuple(NodeID{node.forward_segment_id.id},
+                                   NodeID{node.reverse_segment_id.id},
+                                   node.IsValidForwardSource(),
+                                   node.IsValidForwardTarget(),
+                                   node.IsValidReverseSource(),
+                                   node.IsValidReverseTarget(),
+                                   node.forward_weight,
+                                   node.reverse_weight,
+                                   node.forward_weight_offset,
+                                   node.reverse_weight_offset,
+                                   node.forward_duration,
+                                   node.reverse_duration,
+                                   node.forward_duration_offset,
+                                   node.reverse_duration_offset,
+                                   node.forward_distance,
+                                   node.reverse_distance,
+                                   node.forward_distance_offset,
+                                   node.reverse_distance_offset);
+        }
+
+        bool operator==(const Key &other) const
+        {
+            return facade == other.facade && reversed == other.reversed &&
+                   std::equal(candidates.begin(),
+                              candidates.end(),
+                              other.candidates.begin(),
+                              other.candidates.end(),
+                              [](const PhantomNode &lhs, const PhantomNode &rhs)
+                              { return Snapping(lhs) == Snapping(rhs); });
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const
+        {
+            std::size_t seed = 0;
+            hash_combine(seed, key.facade);
+            hash_combine(seed, key.reversed);
+            for (const auto &node : key.candidates)
+            {
+                hash_combine(seed, static_cast<NodeID>(node.forward_segment_id.id));
+                hash_combine(seed, static_cast<NodeID>(node.reverse_segment_id.id));
+            }
+            return seed;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<const Buckets> buckets;
+        std::size_t size_in_bytes;
+    };
+
+    const std::size_t max_size_in_bytes;
+    std::atomic<std::uint64_t> generation{0};
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::size_t size_in_bytes = 0;
+};
+
+// The bucket cache as seen by a single request, an empty handle disables caching
+struct BucketCacheHandle
+{
+    BucketCache *cache = nullptr;
+    std::uint64_t generation = 0;
+
+    explicit operator bool() const { return cache != nullptr; }
+
+    // Appends the cached buckets of the target for the given column, returns false if the
+    // target needs to be searched
+    bool AppendCached(const datafacade::BaseDataFacade &facade,
+                      const bool reversed,
+                      const PhantomNodeCandidates &candidates,
+                      const unsigned column_index,
+                      std::vector<NodeBucket> &buckets) const
+    {
+        const auto cached_buckets = cache->Find(generation, facade, reversed, candidates);
+        if (!cached_buckets)
+        {
+            return false;
+        }
+
+        buckets.reserve(buckets.size() + cached_buckets->size());
+        for (auto bucket : *cached_buckets)
+        {
+            bucket.column_index = column_index;
+            buckets.push_back(bucket);
+        }
+        return true;
+    }
+
+    // Stores the buckets of a target, the column index of the buckets is ignored
+    void Insert(const datafacade::BaseDataFacade &facade,
+                const bool reversed,
+                const PhantomNodeCandidates &candidates,
+                std::vector<NodeBucket>::const_iterator first,
+                std::vector<NodeBucket>::const_iterator last) const
+    {
+        cache->Insert(generation, facade, reversed, candidates, BucketCache::Buckets(first, last));
+    }
+};
+
+} // namespace osrm::engine::routing_algorithms
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_CACHE_HPP
@@ -0,0 +1,208 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_SCAN_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_SCAN_HPP
+
+#include "engine/routing_algorithms/many_to_many.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OSRM_BUCKET_SCAN_AVX2
+#include <immintrin.h>
+#endif
+
+namespace osrm::engine::routing_algorithms
+{
+
+// Structure-of-arrays copy of sorted buckets, the buckets of a node are contiguous in every
+// array so that a forward step can scan them with vector instructions.
+struct BucketArrays
+{
+    BucketArrays() = default;
+
+    explicit BucketArrays(const std::vector<NodeBucket> &sorted_buckets)
+    {
+        BOOST_ASSERT(std::is_sorted(sorted_buckets.begin(), sorted_buckets.end()));
+
+        nodes.reserve(sorted_buckets.size());
+        columns.reserve(sorted_buckets.size());
+        weights.reserve(sorted_buckets.size());
+        durations.reserve(sorted_buckets.size());
+        distances.reserve(sorted_buckets.size());
+        for (const auto &bucket : sorted_buckets)
+        {
+            nodes.push_back(bucket.middle_node);
+            columns.push_back(bucket.column_index);
+            weights.push_back(bucket.weight);
+            durations.push_back(bucket.duration);
+            distances.push_back(bucket.distance);
+        }
+    }
+
+    // Range [first, last) of the buckets of the node
+    std::pair<std::size_t, std::size_t> Find(const NodeID node) const
+    {
+        const auto range = std::equal_range(nodes.begin(), nodes.end(), node);
+        return {static_cast<std::size_t>(range.first - nodes.begin()),
+                static_cast<std::size_t>(range.second - nodes.begin())};
+    }
+
+    std::vector<NodeID> nodes;
+    std::vector<std::uint32_t> columns;
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeDuration> durations;
+    std::vector<EdgeDistance> distances;
+};
+
+// The part of the result tables that belongs to one source
+struct TableRow
+{
+    EdgeWeight *weights;
+    EdgeDuration *durations;
+    EdgeDistance *distances; // nullptr if no distances are requested
+    NodeID *middle_nodes;
+};
+
+namespace detail
+{
+inline void updateCell(const TableRow &row,
+                       const std::uint32_t column,
+                       const EdgeWeight new_weight,
+                       const EdgeDuration new_duration,
+                       const EdgeDistance new_distance,
+                       const NodeID middle_node)
+{
+    if (std::tie(new_weight, new_duration) < std::tie(row.weights[column], row.durations[column]))
+    {
+        row.weights[column] = new_weight;
+        row.durations[column] = new_duration;
+        if (row.distances)
+            row.distances[column] = new_distance;
+        row.middle_nodes[column] = middle_node;
+    }
+}
+} // namespace detail
+
+// Min-plus update of a row with the buckets [first, last) of a node settled with the given
+// weight, duration and distance. The weight must not be negative, loops at the source phantom
+// nodes need special handling by the caller.
+inline void scanBucketsScalar(const BucketArrays &buckets,
+                              const std::size_t first,
+                              const std::size_t last,
+                              const EdgeWeight weight,
+                              const EdgeDuration duration,
+                              const EdgeDistance distance,
+                              const NodeID middle_node,
+                              const TableRow &row)
+{
+    for (auto index = first; index < last; ++index)
+    {
+        detail::updateCell(row,
+                           buckets.columns[index],
+                           weight + buckets.weights[index],
+                           duration + buckets.durations[index],
+                           distance + buckets.distances[index],
+                           middle_node);
+    }
+}
+
+#ifdef OSRM_BUCKET_SCAN_AVX2
+// Eight buckets per iteration: the current cells are gathered, the comparison is done in
+// vector registers and only improved cells are written back. A node has at most one bucket per
+// column, so the cells of one iteration never collide.
+__attribute__((target("avx2"))) inline void scanBucketsAVX2(const BucketArrays &buckets,
+                                                            const std::size_t first,
+                                                            const std::size_t last,
+                                                            const EdgeWeight weight,
+                                                            const EdgeDuration duration,
+                                                            const EdgeDistance distance,
+                                                            const NodeID middle_node,
+                                                            const TableRow &row)
+{
+    static_assert(sizeof(EdgeWeight) == sizeof(std::int32_t));
+    static_assert(sizeof(EdgeDuration) == sizeof(std::int32_t));
+
+    const auto heap_weight = _mm256_set1_epi32(from_alias<std::int32_t>(weight));
+    const auto heap_duration = _mm256_set1_epi32(from_alias<std::int32_t>(duration));
+    const auto *row_weights = reinterpret_cast<const int *>(row.weights);
+    const auto *row_durations = reinterpret_cast<const int *>(row.durations);
+
+    auto index = first;
+    for (; index + 8 <= last; index += 8)
+    {
+        const auto columns = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(buckets.columns.data() + index));
+        const auto new_weights = _mm256_add_epi32(
+            heap_weight,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buckets.weights.data() + index)));
+        const auto new_durations = _mm256_add_epi32(
+            heap_duration,
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(buckets.durations.data() + index)));
+
+        const auto current_weights = _mm256_i32gather_epi32(row_weights, columns, 4);
+        const auto current_durations = _mm256_i32gather_epi32(row_durations, columns, 4);
+
+        // (new_weight, new_duration) < (current_weight, current_duration)
+        const auto better = _mm256_or_si256(
+            _mm256_cmpgt_epi32(current_weights, new_weights),
+            _mm256_and_si256(_mm256_cmpeq_epi32(current_weights, new_weights),
+                             _mm256_cmpgt_epi32(current_durations, new_durations)));
+        auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(better));
+        if (mask == 0)
+            continue;
+
+        alignas(32) std::int32_t lane_weights[8];
+        alignas(32) std::int32_t lane_durations[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lane_weights), new_weights);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lane_durations), new_durations);
+        while (mask != 0)
+        {
+            const auto lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            const auto column = buckets.columns[index + lane];
+            row.weights[column] = EdgeWeight{lane_weights[lane]};
+            row.durations[column] = EdgeDuration{lane_durations[lane]};
+            if (row.distances)
+                row.distances[column] = distance + buckets.distances[index + lane];
+            row.middle_nodes[column] = middle_node;
+        }
+    }
+
+    scanBucketsScalar(buckets, index, last, weight, duration, distance, middle_node, row);
+}
+#endif
+
+// Picks the widest kernel supported by the CPU at runtime
+inline void scanBuckets(const BucketArrays &buckets,
+                        const std::size_t first,
+                        const std::size_t last,
+                        const EdgeWeight weight,
+                        const EdgeDuration duration,
+                        const EdgeDistance distance,
+                        const NodeID middle_node,
+                        const TableRow &row)
+{
+    BOOST_ASSERT(weight >= EdgeWeight{0});
+#ifdef OSRM_BUCKET_SCAN_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+    {
+        scanBucketsAVX2(buckets, first, last, weight, duration, distance, middle_node, row);
+        return;
+    }
+#endif
+    scanBucketsScalar(buckets, first, last, weight, duration, distance, middle_node, row);
+}
+
+} // namespace osrm::engine::routing_algorithms
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_SCAN_HPP
@@ -0,0 +1,311 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_CLIQUE_ARC_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_CLIQUE_ARC_CACHE_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm::engine::routing_algorithms
+{
+
+// Keeps the unpacked base graph paths of MLD overlay (clique) arcs across requests, so that arcs
+// on popular corridors don't need a search inside their cell every time they are part of a route.
+//
+// Entries are keyed by the facade that was searched, which differs for every metric and exclude
+// class, and by the level, cell, source and target boundary node of the arc. Every level has its
+// own least recently used list and hit counters, all levels share the memory budget: a level that
+// runs out of entries to evict doesn't add new ones until other levels release memory.
+//
+// Like the bucket cache, entries are only valid for one generation of the dataset: whenever the
+// facades are swapped (e.g. after a new customization) Invalidate() starts a new generation and
+// drops all entries.
+class CliqueArcCache
+{
+  public:
+    // the partition supports at most 16 levels
+    static constexpr std::size_t MAX_LEVELS = 16;
+
+    struct Path
+    {
+        std::vector<NodeID> nodes;
+        std::vector<EdgeID> edges;
+    };
+
+    struct Statistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::size_t number_of_entries;
+    };
+
+    explicit CliqueArcCache(const std::size_t max_size_in_bytes)
+        : max_size_in_bytes(max_size_in_bytes)
+    {
+    }
+
+    ~CliqueArcCache() { LogStatistics(); }
+
+    std::uint64_t GetGeneration() const { return generation.load(); }
+
+    void Invalidate()
+    {
+        LogStatistics();
+        // levels are cleared one after another, entries of the old generation that are still
+        // around are never returned to requests of the new generation
+        ++generation;
+        for (auto &level : levels)
+        {
+            std::lock_guard<std::mutex> lock(level.mutex);
+            level.entries.clear();
+            level.index.clear();
+            size_in_bytes -= level.size_in_bytes;
+            level.size_in_bytes = 0;
+            level.hits = 0;
+            level.misses = 0;
+        }
+    }
+
+    std::shared_ptr<const Path> Find(const std::uint64_t request_generation,
+                                     const datafacade::BaseDataFacade &facade,
+                                     const LevelID level_id,
+                                     const CellID cell,
+                                     const NodeID source,
+                                     const NodeID target)
+    {
+        BOOST_ASSERT(level_id < MAX_LEVELS);
+        auto &level = levels[level_id];
+        const Key key{&facade, cell, source, target};
+
+        std::lock_guard<std::mutex> lock(level.mutex);
+        if (request_generation != generation)
+        {
+            return {};
+        }
+
+        const auto iter = level.index.find(key);
+        if (iter == level.index.end() || iter->second->generation != request_generation)
+        {
+            ++level.misses;
+            return {};
+        }
+
+        // mark as most recently used
+        ++level.hits;
+        level.entries.splice(level.entries.begin(), level.entries, iter->second);
+        return iter->second->path;
+    }
+
+    void Insert(const std::uint64_t request_generation,
+                const datafacade::BaseDataFacade &facade,
+                const LevelID level_id,
+                const CellID cell,
+                const NodeID source,
+                const NodeID target,
+                Path path)
+    {
+        BOOST_ASSERT(level_id < MAX_LEVELS);
+        auto &level = levels[level_id];
+
+        path.nodes.shrink_to_fit();
+        path.edges.shrink_to_fit();
+        // the key is stored twice, in the entry and in the index
+        const auto entry_size = sizeof(Entry) + sizeof(Key) + sizeof(Path) +
+                                path.nodes.size() * sizeof(NodeID) +
+                                path.edges.size() * sizeof(EdgeID);
+        if (entry_size > max_size_in_bytes)
+        {
+            return;
+        }
+
+        Key key{&facade, cell, source, target};
+        auto shared_path = std::make_shared<const Path>(std::move(path));
+
+        std::lock_guard<std::mutex> lock(level.mutex);
+        if (request_generation != generation || level.index.count(key) > 0)
+        {
+            return;
+        }
+
+        while (size_in_bytes + entry_size > max_size_in_bytes && !level.entries.empty())
+        {
+            const auto evicted_size = level.entries.back().size_in_bytes;
+            level.size_in_bytes -= evicted_size;
+            size_in_bytes -= evicted_size;
+            level.index.erase(level.entries.back().key);
+            level.entries.pop_back();
+        }
+
+        // other levels may have taken the memory in the meantime
+        if (size_in_bytes.fetch_add(entry_size) + entry_size > max_size_in_bytes)
+        {
+            size_in_bytes -= entry_size;
+            return;
+        }
+
+        level.entries.push_front(
+            Entry{std::move(key), std::move(shared_path), request_generation, entry_size});
+        level.index.emplace(level.entries.front().key, level.entries.begin());
+        level.size_in_bytes += entry_size;
+    }
+
+    Statistics GetStatistics(const LevelID level_id) const
+    {
+        BOOST_ASSERT(level_id < MAX_LEVELS);
+        const auto &level = levels[level_id];
+        std::lock_guard<std::mutex> lock(level.mutex);
+        return {level.hits, level.misses, level.entries.size()};
+    }
+
+    std::size_t GetSizeInBytes() const { return size_in_bytes.load(); }
+
+  private:
+    struct Key
+    {
+        const datafacade::BaseDataFacade *facade;
+        CellID cell;
+        NodeID source;
+        NodeID target;
+
+        bool operator==(const Key &other) const
+        {
+            return std::tie(facade, cell, source, target) ==
+                   std::tie(other.facade, other.cell, other.source, other.target);
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const
+        {
+            std::size_t seed = 0;
+            hash_combine(seed, key.facade);
+            hash_combine(seed, key.cell);
+            hash_combine(seed, key.source);
+            hash_combine(seed, key.target);
+            return seed;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::shared_ptr<const Path> path;
+        std::uint64_t generation;
+        std::size_t size_in_bytes;
+    };
+
+    struct Level
+    {
+        mutable std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        std::size_t size_in_bytes = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    void LogStatistics() const
+    {
+        for (const auto level_id : util::irange<std::size_t>(0, MAX_LEVELS))
+        {
+            const auto statistics = GetStatistics(static_cast<LevelID>(level_id));
+            const auto lookups = statistics.hits + statistics.misses;
+            if (lookups > 0)
+            {
+                util::Log(logDEBUG) << "[clique arc cache] level " << level_id << ": "
+                                    << statistics.hits << " hits, " << statistics.misses
+                                    << " misses (" << (100 * statistics.hits / lookups)
+                                    << "%), " << statistics.number_of_entries << " entries";
+            }
+        }
+    }
+
+    const std::size_t max_size_in_bytes;
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<std::size_t> size_in_bytes{0};
+    std::array<Level, MAX_LEVELS> levels;
+};
+
+// The clique arc cache as seen by a single request, an empty handle disables caching
+struct CliqueArcCacheHandle
+{
+    CliqueArcCache *cache = nullptr;
+    std::uint64_t generation = 0;
+
+    explicit operator bool() const { return cache != nullptr; }
+
+    // Appends the cached path of the arc without its source node, returns false if the arc
+    // needs to be unpacked
+    bool AppendCached(const datafacade::BaseDataFacade &facade,
+                      const LevelID level,
+                      const CellID cell,
+                      const NodeID source,
+                      const NodeID target,
+                      std::vector<NodeID> &nodes,
+                      std::vector<EdgeID> &edges) const
+    {
+        const auto path = cache->Find(generation, facade, level, cell, source, target);
+        if (!path)
+        {
+            return false;
+        }
+
+        BOOST_ASSERT(path->nodes.size() == path->edges.size() + 1);
+        nodes.insert(nodes.end(), std::next(path->nodes.begin()), path->nodes.end());
+        edges.insert(edges.end(), path->edges.begin(), path->edges.end());
+        return true;
+    }
+
+    void Insert(const datafacade::BaseDataFacade &facade,
+                const LevelID level,
+                const CellID cell,
+                const NodeID source,
+                const NodeID target,
+                const std::vector<NodeID> &nodes,
+                const std::vector<EdgeID> &edges) const
+    {
+        cache->Insert(generation, facade, level, cell, source, target, {nodes, edges});
+    }
+};
+
+// Makes the clique arc cache of a request available to the path unpacking of the calling thread,
+// see ShortcutCacheScope.
+class CliqueArcCacheScope
+{
+  public:
+    explicit CliqueArcCacheScope(const CliqueArcCacheHandle handle) : previous(current)
+    {
+        current = handle;
+    }
+
+    ~CliqueArcCacheScope() { current = previous; }
+
+    CliqueArcCacheScope(const CliqueArcCacheScope &) = delete;
+    CliqueArcCacheScope &operator=(const CliqueArcCacheScope &) = delete;
+
+    static const CliqueArcCacheHandle &Current() { return current; }
+
+  private:
+    const CliqueArcCacheHandle previous;
+    static inline thread_local CliqueArcCacheHandle current;
+};
+
+} // namespace osrm::engine::routing_algorithms
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_CLIQUE_ARC_CACHE_HPP
@@ -3,16 +3,88 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/phantom_node.hpp"
 #include "engine/search_engine_data.hpp"
 
 #include "util/typedefs.hpp"
 
+#include <boost/assert.hpp>
+
+#include <algorithm>
 #include <vector>
 
 namespace osrm::engine::routing_algorithms
 {
-namespace
+struct BucketCacheHandle;
+
+// Upper bounds for the durations and distances of a table, cells beyond them are unreachable.
+// Searches do not expand nodes that are already out of range, so their cost depends on the
+// limits instead of on the size of the graph.
+struct TableLimits
 {
+    EdgeDuration max_duration = MAXIMAL_EDGE_DURATION;
+    EdgeDistance max_distance = MAXIMAL_EDGE_DISTANCE;
+
+    bool IsBounded() const
+    {
+        return max_duration != MAXIMAL_EDGE_DURATION || max_distance != MAXIMAL_EDGE_DISTANCE;
+    }
+
+    bool Exceeds(const EdgeDuration duration, const EdgeDistance distance) const
+    {
+        return duration > max_duration || distance > max_distance;
+    }
+
+    // Limits for the partial paths of the two search directions. Searches from the sources
+    // start with the negated length of the source segment up to the phantom node, so a path
+    // of the other direction may be longer than the limit by that much.
+    TableLimits ForSearchSpaces(const std::vector<PhantomNodeCandidates> &candidates_list) const
+    {
+        EdgeDuration duration_slack{0};
+        EdgeDistance distance_slack{0};
+        for (const auto &candidates : candidates_list)
+        {
+            for (const auto &phantom : candidates)
+            {
+                duration_slack = std::max(
+                    {duration_slack, phantom.GetForwardDuration(), phantom.GetReverseDuration()});
+                distance_slack = std::max(
+                    {distance_slack, phantom.GetForwardDistance(), phantom.GetReverseDistance()});
+            }
+        }
+
+        TableLimits search_limits;
+        if (max_duration != MAXIMAL_EDGE_DURATION)
+        {
+            search_limits.max_duration =
+                MAXIMAL_EDGE_DURATION - max_duration > duration_slack
+                    ? max_duration + duration_slack
+                    : MAXIMAL_EDGE_DURATION - EdgeDuration{1};
+        }
+        if (max_distance != MAXIMAL_EDGE_DISTANCE)
+        {
+            search_limits.max_distance = max_distance + distance_slack;
+        }
+        return search_limits;
+    }
+
+    // Marks the cells beyond the limits as unreachable
+    void Apply(std::vector<EdgeDuration> &durations, std::vector<EdgeDistance> &distances) const
+    {
+        BOOST_ASSERT(distances.empty() || distances.size() == durations.size());
+        for (std::size_t index = 0; index < durations.size(); ++index)
+        {
+            const auto distance = distances.empty() ? EdgeDistance{0} : distances[index];
+            if (durations[index] != MAXIMAL_EDGE_DURATION && Exceeds(durations[index], distance))
+            {
+                durations[index] = MAXIMAL_EDGE_DURATION;
+                if (!distances.empty())
+                    distances[index] = MAXIMAL_EDGE_DISTANCE;
+            }
+        }
+    }
+};
+
 struct NodeBucket
 {
     NodeID middle_node;
@@ -84,7 +156,6 @@ struct NodeBucket
         }
     };
 };
-} // namespace
 
 template <typename Algorithm>
 std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
@@ -93,7 +164,22 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                  const std::vector<PhantomNodeCandidates> &candidates_list,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance);
+                 const bool calculate_distance,
+                 const bool parallel_search,
+                 const TableLimits &limits,
+                 const BucketCacheHandle &bucket_cache);
+
+// Same results as manyToManySearch, computed with one linear sweep over the search space of
+// all targets per source (RPHAST). Pays off for tables with very many targets.
+template <typename Algorithm>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+rphastSearch(SearchEngineData<Algorithm> &engine_working_data,
+             const DataFacade<Algorithm> &facade,
+             const std::vector<PhantomNodeCandidates> &candidates_list,
+             const std::vector<std::size_t> &source_indices,
+             const std::vector<std::size_t> &target_indices,
+             const bool calculate_distance,
+             const bool parallel_search);
 
 } // namespace osrm::engine::routing_algorithms
 
@@ -3,6 +3,7 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/map_matching/matching_state.hpp"
 #include "engine/map_matching/sub_matching.hpp"
 #include "engine/search_engine_data.hpp"
 
@@ -27,6 +28,24 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<std::optional<double>> &trace_gps_precision,
                             const bool allow_splitting);
 
+// The points of a matching session that are final, the indices of the sub matchings refer to
+// these points
+struct FinalizedMatching
+{
+    std::vector<map_matching::TracePoint> points;
+    SubMatchingList sub_matchings;
+};
+
+// Adds the points to the lattice of a matching session and returns the points that later
+// points can't change anymore
+template <typename Algorithm>
+FinalizedMatching incrementalMapMatching(SearchEngineData<Algorithm> &engine_working_data,
+                                         const DataFacade<Algorithm> &facade,
+                                         map_matching::MatchingState &state,
+                                         const CandidateLists &candidates_list,
+                                         const std::vector<map_matching::TracePoint> &trace_points,
+                                         const bool allow_splitting);
+
 } // namespace osrm::engine::routing_algorithms
 
 #endif /* MAP_MATCHING_HPP */
@@ -8,6 +8,7 @@
 #include "engine/datafacade.hpp"
 #include "engine/internal_route_result.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/request_deadline.hpp"
 #include "engine/search_engine_data.hpp"
 
 #include "util/coordinate_calculation.hpp"
@@ -346,31 +347,6 @@ void annotatePath(const FacadeT &facade,
     }
 }
 
-template <typename Algorithm>
-double getPathDistance(const DataFacade<Algorithm> &facade,
-                       const std::vector<PathData> &unpacked_path,
-                       const PhantomNode &source_phantom,
-                       const PhantomNode &target_phantom)
-{
-    double distance = 0.0;
-    auto prev_coordinate = source_phantom.location;
-
-    for (const auto &p : unpacked_path)
-    {
-        const auto current_coordinate = facade.GetCoordinateOfNode(p.turn_via_node);
-
-        distance +=
-            util::coordinate_calculation::greatCircleDistance(prev_coordinate, current_coordinate);
-
-        prev_coordinate = current_coordinate;
-    }
-
-    distance +=
-        util::coordinate_calculation::greatCircleDistance(prev_coordinate, target_phantom.location);
-
-    return distance;
-}
-
 template <typename AlgorithmT>
 InternalRouteResult extractRoute(const DataFacade<AlgorithmT> &facade,
                                  const EdgeWeight weight,
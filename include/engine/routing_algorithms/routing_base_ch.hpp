@@ -4,6 +4,7 @@
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/routing_algorithms/shortcut_cache.hpp"
 #include "engine/search_engine_data.hpp"
 
 #include "util/typedefs.hpp"
@@ -114,6 +115,7 @@ void routingStep(const DataFacade<Algorithm> &facade,
                  EdgeWeight min_edge_offset,
                  const std::vector<NodeID> &force_step_nodes)
 {
+    RequestDeadline::Check();
     auto heapNode = forward_heap.DeleteMinGetHeapNode();
     const auto reverseHeapNode = reverse_heap.GetHeapNodeIfWasInserted(heapNode.node);
 
@@ -176,6 +178,93 @@ void routingStep(const DataFacade<Algorithm> &facade,
     relaxOutgoingEdges<DIRECTION>(facade, heapNode, forward_heap);
 }
 
+// Unpacks the path like unpackPath below, but looks up the original edges of shortcuts in the
+// shortcut cache and adds the shortcuts it had to unpack itself. The original edges are collected
+// first because a shortcut is only complete once all of its halves are unpacked.
+template <typename BidirectionalIterator, typename Callback>
+void unpackPathWithShortcutCache(const DataFacade<Algorithm> &facade,
+                                 const ShortcutCacheHandle &shortcut_cache,
+                                 BidirectionalIterator packed_path_begin,
+                                 BidirectionalIterator packed_path_end,
+                                 Callback &&callback)
+{
+    struct StackEntry
+    {
+        NodeID from;
+        NodeID to;
+        // set once the edge was found to be a shortcut that missed the cache: all of its original
+        // edges are unpacked when the entry is popped again and can be added to the cache
+        EdgeID shortcut;
+        bool reversed;
+        std::size_t first_unpacked_edge;
+    };
+    std::stack<StackEntry> recursion_stack;
+    std::vector<ShortcutCache::UnpackedEdge> unpacked_edges;
+
+    // We have to push the path in reverse order onto the stack because it's LIFO.
+    for (auto current = std::prev(packed_path_end); current != packed_path_begin;
+         current = std::prev(current))
+    {
+        recursion_stack.push({*std::prev(current), *current, SPECIAL_EDGEID, false, 0});
+    }
+
+    while (!recursion_stack.empty())
+    {
+        const auto entry = recursion_stack.top();
+        recursion_stack.pop();
+
+        if (entry.shortcut != SPECIAL_EDGEID)
+        {
+            shortcut_cache.Insert(facade,
+                                  entry.shortcut,
+                                  entry.reversed,
+                                  unpacked_edges.cbegin() + entry.first_unpacked_edge,
+                                  unpacked_edges.cend());
+            continue;
+        }
+
+        // Same lookup as in unpackPath, but remember in which direction the edge was found
+        bool reversed = false;
+        EdgeID smaller_edge_id = facade.FindSmallestEdge(
+            entry.from, entry.to, [](const auto &data) { return data.forward; });
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            reversed = true;
+            smaller_edge_id = facade.FindSmallestEdge(
+                entry.to, entry.from, [](const auto &data) { return data.backward; });
+        }
+        BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
+
+        const auto &data = facade.GetEdgeData(smaller_edge_id);
+        BOOST_ASSERT_MSG(data.weight != std::numeric_limits<EdgeWeight>::max(),
+                         "edge weight invalid");
+
+        if (data.shortcut)
+        {
+            if (shortcut_cache.Find(facade, smaller_edge_id, reversed, unpacked_edges))
+                continue;
+
+            const NodeID middle_node_id = data.turn_id;
+            recursion_stack.push(
+                {entry.from, entry.to, smaller_edge_id, reversed, unpacked_edges.size()});
+            recursion_stack.push({middle_node_id, entry.to, SPECIAL_EDGEID, false, 0});
+            recursion_stack.push({entry.from, middle_node_id, SPECIAL_EDGEID, false, 0});
+        }
+        else
+        {
+            unpacked_edges.emplace_back(entry.to, smaller_edge_id);
+        }
+    }
+
+    NodeID from = *packed_path_begin;
+    for (const auto &[to, edge_id] : unpacked_edges)
+    {
+        std::pair<NodeID, NodeID> edge{from, to};
+        std::forward<Callback>(callback)(edge, edge_id);
+        from = to;
+    }
+}
+
 /**
  * Given a sequence of connected `NodeID`s in the CH graph, performs a depth-first unpacking of
  * the shortcut
@@ -206,6 +295,16 @@ void unpackPath(const DataFacade<Algorithm> &facade,
     if (packed_path_begin == packed_path_end)
         return;
 
+    if (const auto &shortcut_cache = ShortcutCacheScope::Current())
+    {
+        unpackPathWithShortcutCache(facade,
+                                    shortcut_cache,
+                                    packed_path_begin,
+                                    packed_path_end,
+                                    std::forward<Callback>(callback));
+        return;
+    }
+
     std::stack<std::pair<NodeID, NodeID>> recursion_stack;
 
     // We have to push the path in reverse order onto the stack because it's LIFO.
@@ -460,17 +559,6 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
                   duration_upper_bound);
 }
 
-// Requires the heaps for be empty
-// If heaps should be adjusted to be initialized outside of this function,
-// the addition of force_step parameters might be required
-double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
-                          const DataFacade<ch::Algorithm> &facade,
-                          SearchEngineData<Algorithm>::QueryHeap &forward_heap,
-                          SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
-                          const PhantomNode &source_phantom,
-                          const PhantomNode &target_phantom,
-                          EdgeWeight duration_upper_bound = INVALID_EDGE_WEIGHT);
-
 template <typename EdgeMetric>
 std::tuple<EdgeMetric, EdgeDistance> getLoopMetric(const DataFacade<Algorithm> &facade, NodeID node)
 {
@@ -3,6 +3,7 @@
 
 #include "engine/algorithm.hpp"
 #include "engine/datafacade.hpp"
+#include "engine/routing_algorithms/clique_arc_cache.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
@@ -301,9 +302,6 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
 
     const auto level = getNodeQueryLevel(partition, heapNode.node, args...);
 
-    static constexpr auto IS_MAP_MATCHING =
-        std::is_same_v<typename SearchEngineData<mld::Algorithm>::MapMatchingQueryHeap, Heap>;
-
     if (level >= 1 && !heapNode.data.from_clique_arc)
     {
         if constexpr (DIRECTION == FORWARD_DIRECTION)
@@ -312,20 +310,6 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
             const auto &cell =
                 cells.GetCell(metric, level, partition.GetCell(level, heapNode.node));
             auto destination = cell.GetDestinationNodes().begin();
-            auto distance = [&cell, node = heapNode.node ]() -> auto
-            {
-                if constexpr (IS_MAP_MATCHING)
-                {
-
-                    return cell.GetOutDistance(node).begin();
-                }
-                else
-                {
-                    boost::ignore_unused(cell, node);
-                    return 0;
-                }
-            }
-            ();
             for (auto shortcut_weight : cell.GetOutWeight(heapNode.node))
             {
                 BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
@@ -336,22 +320,9 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
                     const EdgeWeight to_weight = heapNode.weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= heapNode.weight);
 
-                    if constexpr (IS_MAP_MATCHING)
-                    {
-                        const EdgeDistance to_distance = heapNode.data.distance + *distance;
-                        insertOrUpdate(
-                            forward_heap, to, to_weight, {heapNode.node, true, to_distance});
-                    }
-                    else
-                    {
-                        insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, true});
-                    }
+                    insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, true});
                 }
                 ++destination;
-                if constexpr (IS_MAP_MATCHING)
-                {
-                    ++distance;
-                }
             }
         }
         else
@@ -360,20 +331,6 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
             const auto &cell =
                 cells.GetCell(metric, level, partition.GetCell(level, heapNode.node));
             auto source = cell.GetSourceNodes().begin();
-            auto distance = [&cell, node = heapNode.node ]() -> auto
-            {
-                if constexpr (IS_MAP_MATCHING)
-                {
-
-                    return cell.GetInDistance(node).begin();
-                }
-                else
-                {
-                    boost::ignore_unused(cell, node);
-                    return 0;
-                }
-            }
-            ();
             for (auto shortcut_weight : cell.GetInWeight(heapNode.node))
             {
                 BOOST_ASSERT(source != cell.GetSourceNodes().end());
@@ -383,22 +340,9 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
                 {
                     const EdgeWeight to_weight = heapNode.weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= heapNode.weight);
-                    if constexpr (IS_MAP_MATCHING)
-                    {
-                        const EdgeDistance to_distance = heapNode.data.distance + *distance;
-                        insertOrUpdate(
-                            forward_heap, to, to_weight, {heapNode.node, true, to_distance});
-                    }
-                    else
-                    {
-                        insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, true});
-                    }
+                    insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, true});
                 }
                 ++source;
-                if constexpr (IS_MAP_MATCHING)
-                {
-                    ++distance;
-                }
             }
         }
     }
@@ -425,19 +369,7 @@ void relaxOutgoingEdges(const DataFacade<Algorithm> &facade,
                 const EdgeWeight to_weight =
                     heapNode.weight + node_weight + alias_cast<EdgeWeight>(turn_penalty);
 
-                if constexpr (IS_MAP_MATCHING)
-                {
-                    const auto node_distance =
-                        facade.GetNodeDistance(DIRECTION == FORWARD_DIRECTION ? heapNode.node : to);
-
-                    const EdgeDistance to_distance = heapNode.data.distance + node_distance;
-                    insertOrUpdate(
-                        forward_heap, to, to_weight, {heapNode.node, false, to_distance});
-                }
-                else
-                {
-                    insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, false});
-                }
+                insertOrUpdate(forward_heap, to, to_weight, {heapNode.node, false});
             }
         }
     }
@@ -452,6 +384,7 @@ void routingStep(const DataFacade<Algorithm> &facade,
                  const std::vector<NodeID> &force_step_nodes,
                  const Args &...args)
 {
+    RequestDeadline::Check();
     const auto heapNode = forward_heap.DeleteMinGetHeapNode();
     const auto weight = heapNode.weight;
 
@@ -544,6 +477,80 @@ std::optional<std::pair<NodeID, EdgeWeight>> runSearch(const DataFacade<Algorith
     return {{middle, weight}};
 }
 
+template <typename Algorithm, typename... Args>
+UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
+                    const DataFacade<Algorithm> &facade,
+                    typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const std::vector<NodeID> &force_step_nodes,
+                    EdgeWeight weight_upper_bound,
+                    const Args &...args);
+
+// Appends the base graph path of the overlay edge source -> target on the given level to the
+// unpacked nodes and edges. The path is found by a search restricted to the cell of the edge,
+// unless the clique arc cache of the request already knows it.
+template <typename Algorithm>
+void unpackOverlayEdge(SearchEngineData<Algorithm> &engine_working_data,
+                       const DataFacade<Algorithm> &facade,
+                       typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                       typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                       const std::vector<NodeID> &force_step_nodes,
+                       const LevelID level,
+                       const NodeID source,
+                       const NodeID target,
+                       std::vector<NodeID> &unpacked_nodes,
+                       std::vector<EdgeID> &unpacked_edges)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const CellID parent_cell_id = partition.GetCell(level, source);
+    BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
+
+    // the nodes to force a step at only matter if source and target are the same node
+    const auto &clique_arc_cache = CliqueArcCacheScope::Current();
+    const bool use_cache = clique_arc_cache && source != target;
+    if (use_cache &&
+        clique_arc_cache.AppendCached(
+            facade, level, parent_cell_id, source, target, unpacked_nodes, unpacked_edges))
+    {
+        return;
+    }
+
+    const LevelID sublevel = level - 1;
+
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, {0}, {source});
+    reverse_heap.Insert(target, {0}, {target});
+
+    auto unpacked_subpath = search(engine_working_data,
+                                   facade,
+                                   forward_heap,
+                                   reverse_heap,
+                                   force_step_nodes,
+                                   INVALID_EDGE_WEIGHT,
+                                   sublevel,
+                                   parent_cell_id);
+    BOOST_ASSERT(!unpacked_subpath.edges.empty());
+    BOOST_ASSERT(unpacked_subpath.nodes.size() > 1);
+    BOOST_ASSERT(unpacked_subpath.nodes.front() == source);
+    BOOST_ASSERT(unpacked_subpath.nodes.back() == target);
+    if (use_cache)
+    {
+        clique_arc_cache.Insert(facade,
+                                level,
+                                parent_cell_id,
+                                source,
+                                target,
+                                unpacked_subpath.nodes,
+                                unpacked_subpath.edges);
+    }
+    unpacked_nodes.insert(unpacked_nodes.end(),
+                          std::next(unpacked_subpath.nodes.begin()),
+                          unpacked_subpath.nodes.end());
+    unpacked_edges.insert(
+        unpacked_edges.end(), unpacked_subpath.edges.begin(), unpacked_subpath.edges.end());
+}
+
 template <typename Algorithm, typename... Args>
 UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const DataFacade<Algorithm> &facade,
@@ -589,66 +596,24 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
         }
         else
         { // an overlay graph edge
-            LevelID level = getNodeQueryLevel(partition, source, args...);
-            CellID parent_cell_id = partition.GetCell(level, source);
-            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-            LevelID sublevel = level - 1;
-
+            const LevelID level = getNodeQueryLevel(partition, source, args...);
             // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, {0}, {source});
-            reverse_heap.Insert(target, {0}, {target});
-
-            auto unpacked_subpath = search(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           force_step_nodes,
-                                           INVALID_EDGE_WEIGHT,
-                                           sublevel,
-                                           parent_cell_id);
-            BOOST_ASSERT(!unpacked_subpath.edges.empty());
-            BOOST_ASSERT(unpacked_subpath.nodes.size() > 1);
-            BOOST_ASSERT(unpacked_subpath.nodes.front() == source);
-            BOOST_ASSERT(unpacked_subpath.nodes.back() == target);
-            unpacked_nodes.insert(unpacked_nodes.end(),
-                                  std::next(unpacked_subpath.nodes.begin()),
-                                  unpacked_subpath.nodes.end());
-            unpacked_edges.insert(
-                unpacked_edges.end(), unpacked_subpath.edges.begin(), unpacked_subpath.edges.end());
+            unpackOverlayEdge(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              force_step_nodes,
+                              level,
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
         }
     }
 
     return {weight, std::move(unpacked_nodes), std::move(unpacked_edges)};
 }
 
-template <typename Algorithm, typename... Args>
-EdgeDistance
-searchDistance(SearchEngineData<Algorithm> &,
-               const DataFacade<Algorithm> &facade,
-               typename SearchEngineData<Algorithm>::MapMatchingQueryHeap &forward_heap,
-               typename SearchEngineData<Algorithm>::MapMatchingQueryHeap &reverse_heap,
-               const std::vector<NodeID> &force_step_nodes,
-               EdgeWeight weight_upper_bound,
-               const Args &...args)
-{
-
-    auto searchResult = runSearch(
-        facade, forward_heap, reverse_heap, force_step_nodes, weight_upper_bound, args...);
-    if (!searchResult)
-    {
-        return INVALID_EDGE_DISTANCE;
-    }
-
-    auto [middle, _] = *searchResult;
-
-    auto distance = forward_heap.GetData(middle).distance + reverse_heap.GetData(middle).distance;
-
-    return distance;
-}
-
 // Alias to be compatible with the CH-based search
 template <typename Algorithm, typename PhantomEndpointT>
 inline void search(SearchEngineData<Algorithm> &engine_working_data,
@@ -705,64 +670,6 @@ void unpackPath(const FacadeT &facade,
     annotatePath(facade, route_endpoints, unpacked_nodes, unpacked_edges, unpacked_path);
 }
 
-template <typename Algorithm>
-double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
-                          const DataFacade<Algorithm> &facade,
-                          typename SearchEngineData<Algorithm>::MapMatchingQueryHeap &forward_heap,
-                          typename SearchEngineData<Algorithm>::MapMatchingQueryHeap &reverse_heap,
-                          const PhantomNode &source_phantom,
-                          const PhantomNode &target_phantom,
-                          EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT)
-{
-    forward_heap.Clear();
-    reverse_heap.Clear();
-
-    if (source_phantom.IsValidForwardSource())
-    {
-        forward_heap.Insert(source_phantom.forward_segment_id.id,
-                            EdgeWeight{0} - source_phantom.GetForwardWeightPlusOffset(),
-                            {source_phantom.forward_segment_id.id,
-                             false,
-                             EdgeDistance{0} - source_phantom.GetForwardDistance()});
-    }
-
-    if (source_phantom.IsValidReverseSource())
-    {
-        forward_heap.Insert(source_phantom.reverse_segment_id.id,
-                            EdgeWeight{0} - source_phantom.GetReverseWeightPlusOffset(),
-                            {source_phantom.reverse_segment_id.id,
-                             false,
-                             EdgeDistance{0} - source_phantom.GetReverseDistance()});
-    }
-
-    if (target_phantom.IsValidForwardTarget())
-    {
-        reverse_heap.Insert(
-            target_phantom.forward_segment_id.id,
-            target_phantom.GetForwardWeightPlusOffset(),
-            {target_phantom.forward_segment_id.id, false, target_phantom.GetForwardDistance()});
-    }
-
-    if (target_phantom.IsValidReverseTarget())
-    {
-        reverse_heap.Insert(
-            target_phantom.reverse_segment_id.id,
-            target_phantom.GetReverseWeightPlusOffset(),
-            {target_phantom.reverse_segment_id.id, false, target_phantom.GetReverseDistance()});
-    }
-
-    const PhantomEndpoints endpoints{source_phantom, target_phantom};
-
-    auto distance = searchDistance(
-        engine_working_data, facade, forward_heap, reverse_heap, {}, weight_upper_bound, endpoints);
-
-    if (distance == INVALID_EDGE_DISTANCE)
-    {
-        return std::numeric_limits<double>::max();
-    }
-    return from_alias<double>(distance);
-}
-
 } // namespace osrm::engine::routing_algorithms::mld
 
 #endif // OSRM_ENGINE_ROUTING_BASE_MLD_HPP
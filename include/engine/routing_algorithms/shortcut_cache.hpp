@@ -0,0 +1,217 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_SHORTCUT_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_SHORTCUT_CACHE_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace osrm::engine::routing_algorithms
+{
+
+// Keeps the original edges of CH shortcuts across requests, so that shortcuts which are part of
+// many routes (e.g. on motorways) are not unpacked edge by edge again and again.
+//
+// The cache is a fixed array of slots, a shortcut can only be stored in the slot its key hashes
+// to and replaces the previous entry. Readers never block: every slot is guarded by a sequence
+// counter which is odd while the slot is written. If the counter changed while a reader copied
+// the entry, the lookup is treated as a miss. Writers skip a slot that is being written by
+// another thread.
+//
+// Like the bucket cache, entries are only valid for one generation of the dataset: Invalidate()
+// is called whenever the facades are swapped and requests pass the generation they started in.
+//
+// Only shortcuts with up to MAX_UNPACKED_EDGES original edges are stored, longer shortcuts are
+// split and their halves are looked up instead.
+class ShortcutCache
+{
+  public:
+    // target node and id of an original edge of a shortcut
+    using UnpackedEdge = std::pair<NodeID, EdgeID>;
+
+    static constexpr std::size_t MAX_UNPACKED_EDGES = 30;
+
+    explicit ShortcutCache(const std::size_t max_size_in_bytes)
+        : slots(std::max<std::size_t>(1, max_size_in_bytes / sizeof(Slot)))
+    {
+    }
+
+    std::uint64_t GetGeneration() const { return generation.load(); }
+
+    // Entries of older generations are never returned again, no need to touch the slots
+    void Invalidate() { ++generation; }
+
+    // Appends the original edges of the shortcut to `edges` and returns true on a hit
+    bool Find(const std::uint64_t request_generation,
+              const datafacade::BaseDataFacade &facade,
+              const EdgeID shortcut,
+              const bool reversed,
+              std::vector<UnpackedEdge> &edges) const
+    {
+        const auto key = Key(shortcut, reversed);
+        const auto &slot = GetSlot(facade, key);
+
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence % 2 == 1 ||
+            slot.generation.load(std::memory_order_relaxed) != request_generation ||
+            slot.facade.load(std::memory_order_relaxed) != &facade ||
+            slot.key.load(std::memory_order_relaxed) != key)
+        {
+            return false;
+        }
+
+        const auto size = std::min<std::size_t>(slot.size.load(std::memory_order_relaxed),
+                                                 MAX_UNPACKED_EDGES);
+        const auto old_size = edges.size();
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            const auto edge = slot.edges[index].load(std::memory_order_relaxed);
+            edges.emplace_back(static_cast<NodeID>(edge >> 32), static_cast<EdgeID>(edge));
+        }
+
+        // the slot was overwritten while it was copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            edges.resize(old_size);
+            return false;
+        }
+        return true;
+    }
+
+    void Insert(const std::uint64_t request_generation,
+                const datafacade::BaseDataFacade &facade,
+                const EdgeID shortcut,
+                const bool reversed,
+                std::vector<UnpackedEdge>::const_iterator first,
+                std::vector<UnpackedEdge>::const_iterator last)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        if (size > MAX_UNPACKED_EDGES || request_generation != generation.load())
+        {
+            return;
+        }
+
+        const auto key = Key(shortcut, reversed);
+        auto &slot = GetSlot(facade, key);
+
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        if (sequence % 2 == 1 || !slot.sequence.compare_exchange_strong(
+                                     sequence, sequence + 1, std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.generation.store(request_generation, std::memory_order_relaxed);
+        slot.facade.store(&facade, std::memory_order_relaxed);
+        slot.key.store(key, std::memory_order_relaxed);
+        slot.size.store(static_cast<std::uint32_t>(size), std::memory_order_relaxed);
+        for (std::size_t index = 0; first != last; ++first, ++index)
+        {
+            slot.edges[index].store(static_cast<std::uint64_t>(first->first) << 32 |
+                                        static_cast<std::uint64_t>(first->second),
+                                    std::memory_order_relaxed);
+        }
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    std::size_t GetSizeInBytes() const { return slots.size() * sizeof(Slot); }
+
+  private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> generation{0};
+        std::atomic<const datafacade::BaseDataFacade *> facade{nullptr};
+        std::atomic<std::uint64_t> key{0};
+        std::atomic<std::uint32_t> size{0};
+        std::array<std::atomic<std::uint64_t>, MAX_UNPACKED_EDGES> edges{};
+    };
+
+    static std::uint64_t Key(const EdgeID shortcut, const bool reversed)
+    {
+        // an edge that is valid in both directions unpacks differently when traversed backwards
+        return static_cast<std::uint64_t>(shortcut) << 1 | static_cast<std::uint64_t>(reversed);
+    }
+
+    const Slot &GetSlot(const datafacade::BaseDataFacade &facade, const std::uint64_t key) const
+    {
+        return slots[Hash(facade, key) % slots.size()];
+    }
+
+    Slot &GetSlot(const datafacade::BaseDataFacade &facade, const std::uint64_t key)
+    {
+        return slots[Hash(facade, key) % slots.size()];
+    }
+
+    static std::size_t Hash(const datafacade::BaseDataFacade &facade, const std::uint64_t key)
+    {
+        const auto facade_bits = reinterpret_cast<std::uintptr_t>(&facade);
+        return static_cast<std::size_t>(((key ^ facade_bits) * 0x9E3779B97F4A7C15ull) >> 16);
+    }
+
+    std::vector<Slot> slots;
+    std::atomic<std::uint64_t> generation{0};
+};
+
+// The shortcut cache as seen by a single request, an empty handle disables caching
+struct ShortcutCacheHandle
+{
+    ShortcutCache *cache = nullptr;
+    std::uint64_t generation = 0;
+
+    explicit operator bool() const { return cache != nullptr; }
+
+    bool Find(const datafacade::BaseDataFacade &facade,
+              const EdgeID shortcut,
+              const bool reversed,
+              std::vector<ShortcutCache::UnpackedEdge> &edges) const
+    {
+        return cache->Find(generation, facade, shortcut, reversed, edges);
+    }
+
+    void Insert(const datafacade::BaseDataFacade &facade,
+                const EdgeID shortcut,
+                const bool reversed,
+                std::vector<ShortcutCache::UnpackedEdge>::const_iterator first,
+                std::vector<ShortcutCache::UnpackedEdge>::const_iterator last) const
+    {
+        cache->Insert(generation, facade, shortcut, reversed, first, last);
+    }
+};
+
+// Makes the shortcut cache of a request available to the path unpacking of the calling thread,
+// which is reached through many search functions that don't know about the cache. Like the
+// search heaps the handle is thread local, every RoutingAlgorithms call sets it for its duration.
+class ShortcutCacheScope
+{
+  public:
+    explicit ShortcutCacheScope(const ShortcutCacheHandle handle) : previous(current)
+    {
+        current = handle;
+    }
+
+    ~ShortcutCacheScope() { current = previous; }
+
+    ShortcutCacheScope(const ShortcutCacheScope &) = delete;
+    ShortcutCacheScope &operator=(const ShortcutCacheScope &) = delete;
+
+    static const ShortcutCacheHandle &Current() { return current; }
+
+  private:
+    const ShortcutCacheHandle previous;
+    static inline thread_local ShortcutCacheHandle current;
+};
+
+} // namespace osrm::engine::routing_algorithms
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_SHORTCUT_CACHE_HPP
@@ -1,9 +1,17 @@
 #ifndef OSRM_SHORTEST_PATH_IMPL_HPP
 #define OSRM_SHORTEST_PATH_IMPL_HPP
 
+#include "engine/request_deadline.hpp"
+#include "engine/routing_algorithms/clique_arc_cache.hpp"
+#include "engine/routing_algorithms/shortcut_cache.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 
 #include <boost/assert.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <memory>
 #include <optional>
 
 namespace osrm::engine::routing_algorithms
@@ -220,6 +228,103 @@ inline void initializeHeap<mld::Algorithm>(SearchEngineData<mld::Algorithm> &eng
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(nodes_number, border_nodes_number);
 }
 
+// Heaps for the tasks of a parallel search. The CH heaps only live for one request, so they use
+// a hash map index instead of allocating a dense one.
+template <typename Algorithm> class TaskHeaps
+{
+  public:
+    using QueryHeap = typename SearchEngineData<Algorithm>::QueryHeap;
+
+    struct Heaps
+    {
+        std::unique_ptr<QueryHeap> forward_heap;
+        std::unique_ptr<QueryHeap> reverse_heap;
+    };
+
+    TaskHeaps(SearchEngineData<Algorithm> &, const DataFacade<Algorithm> &facade)
+        : heaps(
+              [&facade]
+              {
+                  const auto number_of_nodes = facade.GetNumberOfNodes();
+                  return Heaps{std::make_unique<QueryHeap>(number_of_nodes, std::size_t{0}),
+                               std::make_unique<QueryHeap>(number_of_nodes, std::size_t{0})};
+              })
+    {
+    }
+
+    Heaps &Local() { return heaps.local(); }
+
+    void Release() {}
+
+  private:
+    tbb::enumerable_thread_specific<Heaps> heaps;
+};
+
+// The MLD heaps are too big to allocate them for every request, the tasks use the task heaps of
+// their threads like parallel alternative path searches
+template <> class TaskHeaps<mld::Algorithm>
+{
+  public:
+    using Heaps = SearchEngineData<mld::Algorithm>::TaskHeaps;
+
+    TaskHeaps(SearchEngineData<mld::Algorithm> &engine_working_data,
+              const DataFacade<mld::Algorithm> &facade)
+        : engine_working_data(engine_working_data), facade(facade)
+    {
+    }
+
+    Heaps &Local()
+    {
+        return engine_working_data.InitializeOrClearTaskThreadLocalStorage(
+            facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+    }
+
+    void Release() { engine_working_data.ReleaseTaskThreadLocalStorageOverBudget(); }
+
+  private:
+    SearchEngineData<mld::Algorithm> &engine_working_data;
+    const DataFacade<mld::Algorithm> &facade;
+};
+
+// Searches all legs of a route with u-turns at the waypoints at once: the legs don't depend on
+// each other, every task searches its legs on heaps of its own.
+template <typename Algorithm>
+void searchLegsWithUTurnInParallel(SearchEngineData<Algorithm> &engine_working_data,
+                                   const DataFacade<Algorithm> &facade,
+                                   const std::vector<PhantomNodeCandidates> &waypoint_candidates,
+                                   std::vector<EdgeWeight> &leg_weights,
+                                   std::vector<std::vector<NodeID>> &packed_legs)
+{
+    TaskHeaps<Algorithm> task_heaps(engine_working_data, facade);
+
+    // the caches and the deadline are only set for the request thread
+    const auto shortcut_cache = ShortcutCacheScope::Current();
+    const auto clique_arc_cache = CliqueArcCacheScope::Current();
+    const auto request_deadline = RequestDeadline::Current();
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, leg_weights.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t> &range)
+                      {
+                          const ShortcutCacheScope shortcut_cache_scope(shortcut_cache);
+                          const CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
+                          const RequestDeadline request_deadline_scope(request_deadline);
+                          auto &heaps = task_heaps.Local();
+                          for (auto leg = range.begin(); leg < range.end(); ++leg)
+                          {
+                              const PhantomEndpointCandidates search_candidates{
+                                  waypoint_candidates[leg], waypoint_candidates[leg + 1]};
+                              searchWithUTurn(engine_working_data,
+                                              facade,
+                                              *heaps.forward_heap,
+                                              *heaps.reverse_heap,
+                                              search_candidates,
+                                              leg_weights[leg],
+                                              packed_legs[leg]);
+                          }
+                          task_heaps.Release();
+                      });
+}
+
 template <typename Algorithm>
 InternalRouteResult
 constructRouteResult(const DataFacade<Algorithm> &facade,
@@ -283,42 +388,66 @@ template <typename Algorithm>
 InternalRouteResult
 shortestPathWithWaypointUTurns(SearchEngineData<Algorithm> &engine_working_data,
                                const DataFacade<Algorithm> &facade,
-                               const std::vector<PhantomNodeCandidates> &waypoint_candidates)
+                               const std::vector<PhantomNodeCandidates> &waypoint_candidates,
+                               const bool parallel_search)
 {
 
     EdgeWeight total_weight = {0};
     std::vector<NodeID> total_packed_path;
     std::vector<std::size_t> packed_leg_begin;
 
-    initializeHeap(engine_working_data, facade);
+    const auto number_of_legs = waypoint_candidates.size() - 1;
+    if (parallel_search && number_of_legs > 1)
+    {
+        std::vector<EdgeWeight> leg_weights(number_of_legs, INVALID_EDGE_WEIGHT);
+        std::vector<std::vector<NodeID>> packed_legs(number_of_legs);
+        searchLegsWithUTurnInParallel(
+            engine_working_data, facade, waypoint_candidates, leg_weights, packed_legs);
 
-    auto &forward_heap = *engine_working_data.forward_heap_1;
-    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+        for (const auto leg : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            if (leg_weights[leg] == INVALID_EDGE_WEIGHT)
+                return {};
 
-    for (const auto i : util::irange<std::size_t>(0UL, waypoint_candidates.size() - 1))
+            packed_leg_begin.push_back(total_packed_path.size());
+            total_packed_path.insert(
+                total_packed_path.end(), packed_legs[leg].begin(), packed_legs[leg].end());
+            total_weight += leg_weights[leg];
+        }
+    }
+    else
     {
-        PhantomEndpointCandidates search_candidates{waypoint_candidates[i],
-                                                    waypoint_candidates[i + 1]};
-        std::vector<NodeID> packed_leg;
-        EdgeWeight leg_weight = INVALID_EDGE_WEIGHT;
-
-        // We have a valid path up to this leg
-        BOOST_ASSERT(total_weight != INVALID_EDGE_WEIGHT);
-        searchWithUTurn(engine_working_data,
-                        facade,
-                        forward_heap,
-                        reverse_heap,
-                        search_candidates,
-                        leg_weight,
-                        packed_leg);
-
-        if (leg_weight == INVALID_EDGE_WEIGHT)
-            return {};
+        initializeHeap(engine_working_data, facade);
 
-        packed_leg_begin.push_back(total_packed_path.size());
-        total_packed_path.insert(total_packed_path.end(), packed_leg.begin(), packed_leg.end());
-        total_weight += leg_weight;
-    };
+        auto &forward_heap = *engine_working_data.forward_heap_1;
+        auto &reverse_heap = *engine_working_data.reverse_heap_1;
+
+        for (const auto i : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            PhantomEndpointCandidates search_candidates{waypoint_candidates[i],
+                                                        waypoint_candidates[i + 1]};
+            std::vector<NodeID> packed_leg;
+            EdgeWeight leg_weight = INVALID_EDGE_WEIGHT;
+
+            // We have a valid path up to this leg
+            BOOST_ASSERT(total_weight != INVALID_EDGE_WEIGHT);
+            searchWithUTurn(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            search_candidates,
+                            leg_weight,
+                            packed_leg);
+
+            if (leg_weight == INVALID_EDGE_WEIGHT)
+                return {};
+
+            packed_leg_begin.push_back(total_packed_path.size());
+            total_packed_path.insert(
+                total_packed_path.end(), packed_leg.begin(), packed_leg.end());
+            total_weight += leg_weight;
+        };
+    }
 
     // Add sentinel
     packed_leg_begin.push_back(total_packed_path.size());
@@ -771,7 +900,8 @@ InternalRouteResult
 shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    const DataFacade<Algorithm> &facade,
                    const std::vector<PhantomNodeCandidates> &waypoint_candidates,
-                   const std::optional<bool> continue_straight_at_waypoint)
+                   const std::optional<bool> continue_straight_at_waypoint,
+                   const bool parallel_search)
 {
     const bool allow_uturn_at_waypoint =
         !(continue_straight_at_waypoint ? *continue_straight_at_waypoint
@@ -779,10 +909,12 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     if (allow_uturn_at_waypoint)
     {
-        return shortestPathWithWaypointUTurns(engine_working_data, facade, waypoint_candidates);
+        return shortestPathWithWaypointUTurns(
+            engine_working_data, facade, waypoint_candidates, parallel_search);
     }
     else
     {
+        // the legs depend on the paths to the previous waypoint, they are always searched in turn
         return shortestPathWithWaypointContinuation(
             engine_working_data, facade, waypoint_candidates);
     }
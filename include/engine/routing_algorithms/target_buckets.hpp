@@ -0,0 +1,121 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_TARGET_BUCKETS_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_TARGET_BUCKETS_HPP
+
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm::engine::routing_algorithms
+{
+
+// Destination (source) phantom segment of a unidirectional search
+struct TargetBucket
+{
+    NodeID node;
+    std::uint32_t column_index;
+    EdgeWeight weight;
+    EdgeDuration duration;
+    EdgeDistance distance;
+    bool reached = false;
+
+    bool operator<(const TargetBucket &rhs) const
+    {
+        return std::tie(node, column_index) < std::tie(rhs.node, rhs.column_index);
+    }
+
+    // functor for equal_range
+    struct Compare
+    {
+        bool operator()(const TargetBucket &lhs, const NodeID &rhs) const
+        {
+            return lhs.node < rhs;
+        }
+
+        bool operator()(const NodeID &lhs, const TargetBucket &rhs) const
+        {
+            return lhs < rhs.node;
+        }
+    };
+};
+
+// The buckets of a one-to-many search in one contiguous array sorted by node id, so there are no
+// per-request node allocations. Almost all settled nodes of a search have no bucket, a bit filter
+// hashed by node id rejects most of them before the binary search.
+class TargetBuckets
+{
+  public:
+    using Range = boost::iterator_range<std::vector<TargetBucket>::iterator>;
+
+    explicit TargetBuckets(std::vector<TargetBucket> buckets_)
+        : buckets(std::move(buckets_)), number_of_pending_buckets(buckets.size())
+    {
+        std::sort(buckets.begin(), buckets.end());
+
+        // 32 bits per bucket keep the false positive rate of the filter at about 3%
+        unsigned filter_bits_log2 = 6;
+        while (filter_bits_log2 < 31 && (std::size_t{1} << filter_bits_log2) < 32 * buckets.size())
+        {
+            ++filter_bits_log2;
+        }
+        filter_shift = 32 - filter_bits_log2;
+        filter.resize((std::size_t{1} << filter_bits_log2) / 64, 0);
+        for (const auto &bucket : buckets)
+        {
+            const auto bit = FilterBit(bucket.node);
+            filter[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    // The buckets of the node, reached buckets included
+    Range Find(const NodeID node)
+    {
+        const auto bit = FilterBit(node);
+        if ((filter[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0)
+        {
+            return {buckets.end(), buckets.end()};
+        }
+        const auto range =
+            std::equal_range(buckets.begin(), buckets.end(), node, TargetBucket::Compare());
+        return {range.first, range.second};
+    }
+
+    bool HasPendingBucket(const NodeID node)
+    {
+        const auto range = Find(node);
+        return std::any_of(
+            range.begin(), range.end(), [](const auto &bucket) { return !bucket.reached; });
+    }
+
+    void MarkReached(TargetBucket &bucket)
+    {
+        BOOST_ASSERT(!bucket.reached);
+        bucket.reached = true;
+        --number_of_pending_buckets;
+    }
+
+    std::size_t NumberOfPendingBuckets() const { return number_of_pending_buckets; }
+
+  private:
+    std::uint32_t FilterBit(const NodeID node) const
+    {
+        // Fibonacci hashing spreads the ids of nearby nodes over the filter
+        return (static_cast<std::uint32_t>(node) * 0x9E3779B9u) >> filter_shift;
+    }
+
+    std::vector<TargetBucket> buckets;
+    std::vector<std::uint64_t> filter;
+    unsigned filter_shift;
+    std::size_t number_of_pending_buckets;
+};
+
+} // namespace osrm::engine::routing_algorithms
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_TARGET_BUCKETS_HPP
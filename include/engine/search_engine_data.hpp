@@ -5,6 +5,10 @@
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <tbb/enumerable_thread_specific.h>
+
+#include <optional>
+
 namespace osrm::engine
 {
 
@@ -16,6 +20,10 @@ template <typename Algorithm> struct SearchEngineData
 {
 };
 
+// Priority queue of all query heaps, util::BoostDAryHeap and util::RadixHeap can be swapped in.
+// The radix heap requires monotone searches and does not break ties by insertion order.
+template <typename T> using QueryHeapPriorityQueue = util::DAryHeap<T>;
+
 struct HeapData
 {
     NodeID parent;
@@ -34,14 +42,23 @@ struct ManyToManyHeapData : HeapData
 
 template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
 {
-    using QueryHeap = util::
-        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+    using QueryHeap = util::QueryHeap<NodeID,
+                                      NodeID,
+                                      EdgeWeight,
+                                      HeapData,
+                                      util::ArrayOrMapStorage<NodeID, int>,
+                                      QueryHeapPriorityQueue>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::ArrayOrMapStorage<NodeID, int>,
+                                                QueryHeapPriorityQueue>;
+
+    // Graphs up to this size use a dense heap index (8 bytes per node and heap), bigger graphs
+    // fall back to a hash map to keep the memory of the seven heaps per thread bounded
+    static constexpr std::size_t MAX_ARRAY_HEAP_NODES = 8 * 1024 * 1024;
 
     using SearchEngineHeapPtr = std::unique_ptr<QueryHeap>;
 
@@ -54,10 +71,6 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     static thread_local SearchEngineHeapPtr forward_heap_3;
     static thread_local SearchEngineHeapPtr reverse_heap_3;
     static thread_local ManyToManyHeapPtr many_to_many_heap;
-    static thread_local SearchEngineHeapPtr map_matching_forward_heap_1;
-    static thread_local SearchEngineHeapPtr map_matching_reverse_heap_1;
-
-    void InitializeOrClearMapMatchingThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
@@ -66,6 +79,20 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Approximate memory in bytes of the heaps of the calling thread
+    std::size_t GetThreadLocalMemoryUsage() const;
+
+    // Frees the heaps of the calling thread, they are allocated again by the next search
+    void ReleaseThreadLocalStorage();
+
+    // Frees the heaps of the calling thread if they use more than max_thread_local_memory_usage
+    // and logs their memory if there is a budget. Must not be called while a search of the thread
+    // still uses its heaps.
+    void ReleaseThreadLocalStorageOverBudget();
+
+    // Bytes of heaps a thread may keep after a query, no heaps are freed if unset
+    std::optional<std::size_t> max_thread_local_memory_usage;
 };
 
 struct MultiLayerDijkstraHeapData
@@ -76,19 +103,6 @@ struct MultiLayerDijkstraHeapData
     MultiLayerDijkstraHeapData(NodeID p, bool from) : parent(p), from_clique_arc(from) {}
 };
 
-struct MapMatchingMultiLayerDijkstraHeapData
-{
-    NodeID parent;
-    bool from_clique_arc;
-    EdgeDistance distance = {0};
-    MapMatchingMultiLayerDijkstraHeapData(NodeID p) : parent(p), from_clique_arc(false) {}
-    MapMatchingMultiLayerDijkstraHeapData(NodeID p, bool from) : parent(p), from_clique_arc(from) {}
-    MapMatchingMultiLayerDijkstraHeapData(NodeID p, bool from, EdgeDistance d)
-        : parent(p), from_clique_arc(from), distance(d)
-    {
-    }
-};
-
 struct ManyToManyMultiLayerDijkstraHeapData : MultiLayerDijkstraHeapData
 {
     EdgeDuration duration;
@@ -112,37 +126,59 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
                                       NodeID,
                                       EdgeWeight,
                                       MultiLayerDijkstraHeapData,
-                                      util::TwoLevelStorage<NodeID, int>>;
+                                      util::TwoLevelStorage<NodeID, int>,
+                                      QueryHeapPriorityQueue>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyMultiLayerDijkstraHeapData,
-                                                util::TwoLevelStorage<NodeID, int>>;
-    using MapMatchingQueryHeap = util::QueryHeap<NodeID,
-                                                 NodeID,
-                                                 EdgeWeight,
-                                                 MapMatchingMultiLayerDijkstraHeapData,
-                                                 util::TwoLevelStorage<NodeID, int>>;
+                                                util::TwoLevelStorage<NodeID, int>,
+                                                QueryHeapPriorityQueue>;
 
     using SearchEngineHeapPtr = std::unique_ptr<QueryHeap>;
     using ManyToManyHeapPtr = std::unique_ptr<ManyToManyQueryHeap>;
-    using MapMatchingHeapPtr = std::unique_ptr<MapMatchingQueryHeap>;
 
     static thread_local SearchEngineHeapPtr forward_heap_1;
     static thread_local SearchEngineHeapPtr reverse_heap_1;
-    static thread_local MapMatchingHeapPtr map_matching_forward_heap_1;
-    static thread_local MapMatchingHeapPtr map_matching_reverse_heap_1;
 
     static thread_local ManyToManyHeapPtr many_to_many_heap;
 
+    // Heaps of the tasks of parallel alternative path and route searches, the thread of the
+    // request keeps using forward_heap_1 and reverse_heap_1 while it runs tasks
+    struct TaskHeaps
+    {
+        SearchEngineHeapPtr forward_heap;
+        SearchEngineHeapPtr reverse_heap;
+    };
+    mutable tbb::enumerable_thread_specific<TaskHeaps> task_heaps;
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes,
                                                   unsigned number_of_boundary_nodes);
-    void InitializeOrClearMapMatchingThreadLocalStorage(unsigned number_of_nodes,
-                                                        unsigned number_of_boundary_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes,
                                                        unsigned number_of_boundary_nodes);
+
+    TaskHeaps &InitializeOrClearTaskThreadLocalStorage(unsigned number_of_nodes,
+                                                       unsigned number_of_boundary_nodes);
+
+    // Approximate memory in bytes of the heaps of the calling thread
+    std::size_t GetThreadLocalMemoryUsage() const;
+
+    // Frees the heaps of the calling thread, they are allocated again by the next search
+    void ReleaseThreadLocalStorage();
+
+    // Frees the task heaps of the calling thread if they use more than
+    // max_thread_local_memory_usage, the other heaps of the thread may still be in use
+    void ReleaseTaskThreadLocalStorageOverBudget();
+
+    // Frees the heaps of the calling thread if they use more than max_thread_local_memory_usage
+    // and logs their memory if there is a budget. Must not be called while a search of the thread
+    // still uses its heaps.
+    void ReleaseThreadLocalStorageOverBudget();
+
+    // Bytes of heaps a thread may keep after a query, no heaps are freed if unset
+    std::optional<std::size_t> max_thread_local_memory_usage;
 };
 } // namespace osrm::engine
 
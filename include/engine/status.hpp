@@ -38,7 +38,9 @@ namespace osrm::engine
 enum class Status
 {
     Ok,
-    Error
+    Error,
+    // the request ran past its deadline or was cancelled
+    Timeout
 };
 } // namespace osrm::engine
 
@@ -0,0 +1,281 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace osrm::engine::trip
+{
+
+// Improves a round trip with 2-opt and Or-opt moves until no move shortens it any more.
+//
+// The duration table does not have to be symmetric, the trip plugin even sets some entries to
+// zero or INVALID_EDGE_DURATION to turn trips with a fixed start or end into round trips. So a
+// 2-opt move that reverses a part of the trip also changes the durations inside of that part,
+// which are summed up from prefix sums of both directions of the trip. Or-opt moves a part of up
+// to three locations to another place of the trip without reversing it.
+class TripLocalSearch
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::int64_t;
+
+    static constexpr std::size_t MAX_OR_OPT_LENGTH = 3;
+    // Every thread of the local search gets at least that many locations of the trip, small trips
+    // don't take the threads of other requests
+    static constexpr std::size_t LOCATIONS_PER_START = 25;
+
+    explicit TripLocalSearch(const util::DistTableWrapper<EdgeDuration> &dist_table)
+        : dist_table(dist_table)
+    {
+    }
+
+    // Connections that are not possible are so expensive that no move ever adds one
+    Duration operator()(const NodeID from, const NodeID to) const
+    {
+        const auto duration = dist_table(from, to);
+        return duration == INVALID_EDGE_DURATION ? INVALID_DURATION
+                                                 : from_alias<Duration>(duration);
+    }
+
+    Duration TripDuration(const std::vector<NodeID> &trip) const
+    {
+        Duration duration = 0;
+        for (std::size_t index = 0; index < trip.size(); ++index)
+        {
+            duration += (*this)(trip[index], trip[(index + 1) % trip.size()]);
+        }
+        return duration;
+    }
+
+    // Stops early once the end is reached, the trip is then improved but not a local optimum
+    Duration Improve(std::vector<NodeID> &trip, const Clock::time_point end)
+    {
+        bool improved = true;
+        while (improved && Clock::now() < end)
+        {
+            improved = TwoOpt(trip, end);
+            improved = OrOpt(trip, end) || improved;
+        }
+        return TripDuration(trip);
+    }
+
+    // Applies the first improving reversal of every position of the trip
+    bool TwoOpt(std::vector<NodeID> &trip, const Clock::time_point end)
+    {
+        const auto size = trip.size();
+        if (size < 4)
+            return false;
+
+        bool improved = false;
+        UpdatePrefixDurations(trip);
+        for (std::size_t first = 0; first + 2 < size; ++first)
+        {
+            if (Clock::now() >= end)
+                break;
+
+            for (auto last = first + 2; last < size; ++last)
+            {
+                // reverses the part from first + 1 to last
+                const auto before = trip[first];
+                const auto after = trip[(last + 1) % size];
+                const auto forward = forward_prefix[last] - forward_prefix[first + 1];
+                const auto backward = backward_prefix[last] - backward_prefix[first + 1];
+                const auto delta = (*this)(before, trip[last]) + backward +
+                                   (*this)(trip[first + 1], after) -
+                                   (*this)(before, trip[first + 1]) - forward -
+                                   (*this)(trip[last], after);
+                if (delta < 0)
+                {
+                    std::reverse(trip.begin() + first + 1, trip.begin() + last + 1);
+                    UpdatePrefixDurations(trip);
+                    improved = true;
+                }
+            }
+        }
+        return improved;
+    }
+
+    // Applies the first improving move of every part of the trip
+    bool OrOpt(std::vector<NodeID> &trip, const Clock::time_point end)
+    {
+        const auto size = trip.size();
+        bool improved = false;
+        for (std::size_t length = 1; length <= MAX_OR_OPT_LENGTH && length + 3 <= size; ++length)
+        {
+            for (std::size_t first = 0; first < size; ++first)
+            {
+                if (Clock::now() >= end)
+                    return improved;
+
+                const auto last = (first + length - 1) % size;
+                const auto before = trip[(first + size - 1) % size];
+                const auto after = trip[(last + 1) % size];
+                const auto removal_delta = (*this)(before, after) - (*this)(before, trip[first]) -
+                                           (*this)(trip[last], after);
+
+                // the part can go between any two locations of the rest of the trip
+                for (std::size_t offset = 0; offset + length + 1 < size; ++offset)
+                {
+                    const auto from = (last + 1 + offset) % size;
+                    const auto to = (from + 1) % size;
+                    const auto delta = removal_delta + (*this)(trip[from], trip[first]) +
+                                       (*this)(trip[last], trip[to]) -
+                                       (*this)(trip[from], trip[to]);
+                    if (delta < 0)
+                    {
+                        MovePart(trip, first, length, offset);
+                        improved = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return improved;
+    }
+
+  private:
+    // small enough that the few impossible connections of a trip can be summed up
+    static constexpr Duration INVALID_DURATION = std::numeric_limits<Duration>::max() / 1024;
+
+    void UpdatePrefixDurations(const std::vector<NodeID> &trip)
+    {
+        forward_prefix.resize(trip.size());
+        backward_prefix.resize(trip.size());
+        forward_prefix[0] = 0;
+        backward_prefix[0] = 0;
+        for (std::size_t index = 1; index < trip.size(); ++index)
+        {
+            forward_prefix[index] =
+                forward_prefix[index - 1] + (*this)(trip[index - 1], trip[index]);
+            backward_prefix[index] =
+                backward_prefix[index - 1] + (*this)(trip[index], trip[index - 1]);
+        }
+    }
+
+    // Moves the part of the given length that starts at first behind the location that follows
+    // the part after offset other locations
+    void MovePart(std::vector<NodeID> &trip,
+                  const std::size_t first,
+                  const std::size_t length,
+                  const std::size_t offset)
+    {
+        const auto size = trip.size();
+        buffer.clear();
+        for (std::size_t index = 0; index <= offset; ++index)
+        {
+            buffer.push_back(trip[(first + length + index) % size]);
+        }
+        for (std::size_t index = 0; index < length; ++index)
+        {
+            buffer.push_back(trip[(first + index) % size]);
+        }
+        for (auto index = offset + 1; index + length < size; ++index)
+        {
+            buffer.push_back(trip[(first + length + index) % size]);
+        }
+        BOOST_ASSERT(buffer.size() == size);
+        trip.swap(buffer);
+    }
+
+    const util::DistTableWrapper<EdgeDuration> &dist_table;
+    std::vector<Duration> forward_prefix;
+    std::vector<Duration> backward_prefix;
+    std::vector<NodeID> buffer;
+};
+
+// Improves the round trip of the given start, e.g. of the farthest insertion heuristic. Every
+// thread runs its own local search: the first one starts from the given trip, the others from a
+// perturbed copy of it. Afterwards they perturb their best trip with a random double bridge move
+// and improve it again, which gets them out of the local optima of 2-opt and Or-opt. A thread
+// stops once the end is reached or after max_kicks_without_improvement perturbations that didn't
+// shorten its best trip. The shortest trip of all threads is returned, which is never longer than
+// the given one.
+inline std::vector<NodeID> LocalSearchTrip(const util::DistTableWrapper<EdgeDuration> &dist_table,
+                                           std::vector<NodeID> start,
+                                           const TripLocalSearch::Clock::time_point end,
+                                           const std::size_t max_kicks_without_improvement)
+{
+    using Duration = TripLocalSearch::Duration;
+    const auto size = start.size();
+    if (size < 8)
+        return start;
+
+    // A B C D -> A C B D, keeps the direction of all parts
+    const auto double_bridge = [size](std::vector<NodeID> &trip, std::mt19937 &generator)
+    {
+        std::uniform_int_distribution<std::size_t> position(1, size - 1);
+        std::size_t cuts[3] = {position(generator), position(generator), position(generator)};
+        std::sort(std::begin(cuts), std::end(cuts));
+        std::rotate(trip.begin() + cuts[0], trip.begin() + cuts[1], trip.begin() + cuts[2]);
+    };
+
+    const auto number_of_starts = std::clamp<std::size_t>(
+        size / TripLocalSearch::LOCATIONS_PER_START,
+        1,
+        static_cast<std::size_t>(std::max(1, tbb::this_task_arena::max_concurrency())));
+    std::vector<std::vector<NodeID>> best_trips(number_of_starts, start);
+    std::vector<Duration> best_durations(number_of_starts, std::numeric_limits<Duration>::max());
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_starts, 1),
+        [&](const tbb::blocked_range<std::size_t> &range)
+        {
+            for (auto start_index = range.begin(); start_index != range.end(); ++start_index)
+            {
+                TripLocalSearch search(dist_table);
+                std::mt19937 generator(static_cast<std::mt19937::result_type>(start_index));
+
+                auto &best_trip = best_trips[start_index];
+                if (start_index > 0)
+                    double_bridge(best_trip, generator);
+                auto &best_duration = best_durations[start_index];
+                best_duration = search.Improve(best_trip, end);
+
+                auto trip = best_trip;
+                std::size_t kicks_without_improvement = 0;
+                while (kicks_without_improvement < max_kicks_without_improvement &&
+                       TripLocalSearch::Clock::now() < end)
+                {
+                    trip = best_trip;
+                    double_bridge(trip, generator);
+                    const auto duration = search.Improve(trip, end);
+                    if (duration < best_duration)
+                    {
+                        best_duration = duration;
+                        best_trip.swap(trip);
+                        kicks_without_improvement = 0;
+                    }
+                    else
+                    {
+                        ++kicks_without_improvement;
+                    }
+                }
+            }
+        });
+
+    const auto best = std::distance(best_durations.begin(),
+                                    std::min_element(best_durations.begin(), best_durations.end()));
+    TripLocalSearch search(dist_table);
+    if (best_durations[best] < search.TripDuration(start))
+        return std::move(best_trips[best]);
+    return start;
+}
+
+} // namespace osrm::engine::trip
+
+#endif // TRIP_LOCAL_SEARCH_HPP
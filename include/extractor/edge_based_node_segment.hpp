@@ -2,12 +2,15 @@
 #define OSRM_EXTRACT_EDGE_BASED_NODE_SEGMENT_HPP
 
 #include "extractor/travel_mode.hpp"
+#include "util/packed_rtree_leaves.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
 #include "osrm/coordinate.hpp"
 
+#include <array>
+#include <cstdint>
 #include <limits>
 
 namespace osrm::extractor
@@ -48,4 +51,50 @@ struct EdgeBasedNodeSegment
 };
 } // namespace osrm::extractor
 
+namespace osrm::util
+{
+// Fields of the segments in the packed r-tree leaves: the forward and reverse segment ids, the
+// node ids, the segment position and a bit set of the flags.
+template <> struct RTreeLeafFields<extractor::EdgeBasedNodeSegment>
+{
+    static constexpr std::size_t NUMBER_OF_FIELDS = 6;
+
+    static constexpr std::array<std::uint32_t, NUMBER_OF_FIELDS> SPECIAL_VALUES = {
+        SPECIAL_SEGMENTID,
+        SPECIAL_SEGMENTID,
+        SPECIAL_NODEID,
+        SPECIAL_NODEID,
+        // the position and flags have no special value
+        std::numeric_limits<std::uint32_t>::max(),
+        std::numeric_limits<std::uint32_t>::max()};
+
+    static std::array<std::uint32_t, NUMBER_OF_FIELDS>
+    Split(const extractor::EdgeBasedNodeSegment &segment)
+    {
+        const std::uint32_t flags = (segment.forward_segment_id.enabled ? 1 : 0) |
+                                    (segment.reverse_segment_id.enabled ? 2 : 0) |
+                                    (segment.is_startpoint ? 4 : 0);
+        return {segment.forward_segment_id.id,
+                segment.reverse_segment_id.id,
+                segment.u,
+                segment.v,
+                segment.fwd_segment_position,
+                flags};
+    }
+
+    static extractor::EdgeBasedNodeSegment
+    Join(const std::array<std::uint32_t, NUMBER_OF_FIELDS> &fields)
+    {
+        extractor::EdgeBasedNodeSegment segment;
+        segment.forward_segment_id = SegmentID{fields[0], (fields[5] & 1) != 0};
+        segment.reverse_segment_id = SegmentID{fields[1], (fields[5] & 2) != 0};
+        segment.u = fields[2];
+        segment.v = fields[3];
+        segment.fwd_segment_position = static_cast<unsigned short>(fields[4]);
+        segment.is_startpoint = (fields[5] & 4) != 0;
+        return segment;
+    }
+};
+} // namespace osrm::util
+
 #endif // OSRM_EXTRACT_EDGE_BASED_NODE_SEGMENT_HPP
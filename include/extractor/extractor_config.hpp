@@ -58,6 +58,7 @@ struct ExtractorConfig final : storage::IOConfig
                ".osrm.ebg",
                ".osrm.ramIndex",
                ".osrm.fileIndex",
+               ".osrm.packedIndex",
                ".osrm.turn_duration_penalties",
                ".osrm.turn_weight_penalties",
                ".osrm.turn_penalties_index",
@@ -87,6 +88,7 @@ struct ExtractorConfig final : storage::IOConfig
     bool parse_conditionals = false;
     bool use_locations_cache = true;
     bool dump_nbg_graph = false;
+    bool compress_rtree_leaves = false;
 };
 } // namespace osrm::extractor
 
@@ -94,7 +94,7 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
     BOOST_ASSERT(code_iter != end_iter);
 
-    if (result_status == osrm::Status::Error)
+    if (result_status != osrm::Status::Ok)
     {
         throw std::logic_error(std::get<osrm::json::String>(code_iter->second).value.c_str());
     }
@@ -113,7 +113,7 @@ inline void ParseResult(const osrm::Status &result_status,
 {
     auto fbs_result = osrm::engine::api::fbresult::GetFBResult(fbs_builder.GetBufferPointer());
 
-    if (result_status == osrm::Status::Error)
+    if (result_status != osrm::Status::Ok)
     {
         BOOST_ASSERT(fbs_result->code());
         throw std::logic_error(fbs_result->code()->message()->c_str());
@@ -39,6 +39,8 @@ namespace osrm
 {
 namespace json = util::json;
 using engine::EngineConfig;
+using engine::api::BatchMatchParameters;
+using engine::api::BatchRouteParameters;
 using engine::api::MatchParameters;
 using engine::api::NearestParameters;
 using engine::api::RouteParameters;
@@ -57,6 +59,8 @@ using engine::api::TripParameters;
  *  - Trip: shortest round trip between coordinates
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
+ *  - BatchRoute: shortest paths of many independent origin-destination pairs
+ *  - BatchMatch: snaps many independent coordinate traces to the road network
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
  */
@@ -97,6 +101,19 @@ class OSRM final
     Status Table(const TableParameters &parameters, json::Object &result) const;
     Status Table(const TableParameters &parameters, engine::api::ResultT &result) const;
 
+    /**
+     * Distance tables for coordinates, streamed row by row.
+     *
+     * A successful JSON response is rendered into `stream` in consecutive chunks while
+     * `result` is left untouched, errors are reported through `result` as usual.
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and engine::api::ResultStream
+     */
+    Status Table(const TableParameters &parameters,
+                 engine::api::ResultT &result,
+                 const engine::api::ResultStream &stream) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -137,6 +154,32 @@ class OSRM final
     Status Tile(const TileParameters &parameters, std::string &result) const;
     Status Tile(const TileParameters &parameters, engine::api::ResultT &result) const;
 
+    /**
+     * BatchRoute: shortest paths of many independent origin-destination pairs
+     *
+     * \param parameters batch route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, BatchRouteParameters and json::Object
+     */
+    Status BatchRoute(const BatchRouteParameters &parameters, json::Object &result) const;
+    Status BatchRoute(const BatchRouteParameters &parameters, engine::api::ResultT &result) const;
+
+    /**
+     * BatchMatch: snaps many independent coordinate traces to the road network
+     *
+     * The traces are matched in parallel. With a stream, the response is handed out in chunks
+     * while the traces are matched.
+     *
+     * \param parameters batch match query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, BatchMatchParameters and json::Object
+     */
+    Status BatchMatch(const BatchMatchParameters &parameters, json::Object &result) const;
+    Status BatchMatch(const BatchMatchParameters &parameters, engine::api::ResultT &result) const;
+    Status BatchMatch(const BatchMatchParameters &parameters,
+                      engine::api::ResultT &result,
+                      const engine::api::ResultStream &stream) const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
 };
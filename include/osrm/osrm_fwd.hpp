@@ -49,6 +49,8 @@ struct NearestParameters;
 struct TripParameters;
 struct MatchParameters;
 struct TileParameters;
+struct BatchRouteParameters;
+struct BatchMatchParameters;
 } // namespace api
 
 class EngineInterface;
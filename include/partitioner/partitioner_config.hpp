@@ -14,7 +14,7 @@ struct PartitionerConfig final : storage::IOConfig
 {
     PartitionerConfig()
         : IOConfig({".osrm.fileIndex", ".osrm.ebg_nodes", ".osrm.enw"},
-                   {".osrm.hsgr", ".osrm.cnbg"},
+                   {".osrm.hsgr", ".osrm.cnbg", ".osrm.packedIndex"},
                    {".osrm.ebg",
                     ".osrm.cnbg",
                     ".osrm.cnbg_to_ebg",
@@ -0,0 +1,44 @@
+#ifndef BATCH_MATCH_PARAMETERS_GRAMMAR_HPP
+#define BATCH_MATCH_PARAMETERS_GRAMMAR_HPP
+
+#include "server/api/match_parameter_grammar.hpp"
+#include "engine/api/batch_match_parameters.hpp"
+
+#include <boost/phoenix.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+namespace osrm::server::api
+{
+
+namespace
+{
+namespace ph = boost::phoenix;
+namespace qi = boost::spirit::qi;
+} // namespace
+
+template <typename Iterator = std::string::iterator,
+          typename Signature = void(engine::api::BatchMatchParameters &)>
+struct BatchMatchParametersGrammar final : public MatchParametersGrammar<Iterator, Signature>
+{
+    using BaseGrammar = MatchParametersGrammar<Iterator, Signature>;
+
+    BatchMatchParametersGrammar() : BaseGrammar(root_rule)
+    {
+        traces_rule =
+            qi::lit("traces=") >
+            (BaseGrammar::size_t_ %
+             ';')[ph::bind(&engine::api::BatchMatchParameters::trace_sizes, qi::_r1) = qi::_1];
+
+        root_rule = BaseGrammar::query_rule(qi::_r1) > BaseGrammar::format_rule(qi::_r1) >
+                    -('?' > (traces_rule(qi::_r1) | BaseGrammar::match_rule(qi::_r1) |
+                             BaseGrammar::base_rule(qi::_r1)) %
+                                '&');
+    }
+
+  private:
+    qi::rule<Iterator, Signature> root_rule;
+    qi::rule<Iterator, Signature> traces_rule;
+};
+} // namespace osrm::server::api
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef BATCH_ROUTE_PARAMETERS_GRAMMAR_HPP
+#define BATCH_ROUTE_PARAMETERS_GRAMMAR_HPP
+
+#include "server/api/base_parameters_grammar.hpp"
+#include "engine/api/batch_route_parameters.hpp"
+
+#include <boost/phoenix.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+namespace osrm::server::api
+{
+
+namespace
+{
+namespace ph = boost::phoenix;
+namespace qi = boost::spirit::qi;
+} // namespace
+
+template <typename Iterator = std::string::iterator,
+          typename Signature = void(engine::api::BatchRouteParameters &)>
+struct BatchRouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature>
+{
+    using BaseGrammar = BaseParametersGrammar<Iterator, Signature>;
+
+    BatchRouteParametersGrammar() : BaseGrammar(root_rule)
+    {
+#ifdef BOOST_HAS_LONG_LONG
+        if (std::is_same<std::size_t, unsigned long long>::value)
+            size_t_ = qi::ulong_long;
+        else
+            size_t_ = qi::ulong_;
+#else
+        size_t_ = qi::ulong_;
+#endif
+
+        geometries_type.add("geojson",
+                            engine::api::BatchRouteParameters::GeometriesType::GeoJSON)(
+            "polyline", engine::api::BatchRouteParameters::GeometriesType::Polyline)(
+            "polyline6", engine::api::BatchRouteParameters::GeometriesType::Polyline6);
+
+        overview_type.add("simplified",
+                          engine::api::BatchRouteParameters::OverviewType::Simplified)(
+            "full", engine::api::BatchRouteParameters::OverviewType::Full)(
+            "false", engine::api::BatchRouteParameters::OverviewType::False);
+
+        sources_rule =
+            qi::lit("sources=") >
+            (size_t_ %
+             ';')[ph::bind(&engine::api::BatchRouteParameters::sources, qi::_r1) = qi::_1];
+
+        destinations_rule =
+            qi::lit("destinations=") >
+            (size_t_ %
+             ';')[ph::bind(&engine::api::BatchRouteParameters::destinations, qi::_r1) = qi::_1];
+
+        batch_route_rule =
+            sources_rule(qi::_r1) | destinations_rule(qi::_r1) |
+            (qi::lit("geometries=") >
+             geometries_type[ph::bind(&engine::api::BatchRouteParameters::geometries, qi::_r1) =
+                                 qi::_1]) |
+            (qi::lit("overview=") >
+             overview_type[ph::bind(&engine::api::BatchRouteParameters::overview, qi::_r1) =
+                               qi::_1]);
+
+        root_rule = BaseGrammar::query_rule(qi::_r1) > BaseGrammar::format_rule(qi::_r1) >
+                    -('?' > (batch_route_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
+    }
+
+  private:
+    qi::rule<Iterator, Signature> root_rule;
+    qi::rule<Iterator, Signature> batch_route_rule;
+    qi::rule<Iterator, Signature> sources_rule;
+    qi::rule<Iterator, Signature> destinations_rule;
+    qi::rule<Iterator, std::size_t()> size_t_;
+
+    qi::symbols<char, engine::api::BatchRouteParameters::GeometriesType> geometries_type;
+    qi::symbols<char, engine::api::BatchRouteParameters::OverviewType> overview_type;
+};
+} // namespace osrm::server::api
+
+#endif
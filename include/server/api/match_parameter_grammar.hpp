@@ -18,11 +18,17 @@ namespace qi = boost::spirit::qi;
 
 template <typename Iterator = std::string::iterator,
           typename Signature = void(engine::api::MatchParameters &)>
-struct MatchParametersGrammar final : public RouteParametersGrammar<Iterator, Signature>
+struct MatchParametersGrammar : public RouteParametersGrammar<Iterator, Signature>
 {
     using BaseGrammar = RouteParametersGrammar<Iterator, Signature>;
 
-    MatchParametersGrammar() : BaseGrammar(root_rule)
+    MatchParametersGrammar() : MatchParametersGrammar(root_rule)
+    {
+        root_rule = BaseGrammar::query_rule(qi::_r1) > BaseGrammar::format_rule(qi::_r1) >
+                    -('?' > (match_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
+    }
+
+    MatchParametersGrammar(qi::rule<Iterator, Signature> &root_rule_) : BaseGrammar(root_rule_)
     {
 #ifdef BOOST_HAS_LONG_LONG
         if (std::is_same<std::size_t, unsigned long long>::value)
@@ -41,20 +47,24 @@ struct MatchParametersGrammar final : public RouteParametersGrammar<Iterator, Si
         gaps_type.add("split", engine::api::MatchParameters::GapsType::Split)(
             "ignore", engine::api::MatchParameters::GapsType::Ignore);
 
-        root_rule =
-            BaseGrammar::query_rule(qi::_r1) > BaseGrammar::format_rule(qi::_r1) >
-            -('?' > (timestamps_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1) |
-                     (qi::lit("gaps=") >
-                      gaps_type[ph::bind(&engine::api::MatchParameters::gaps, qi::_r1) = qi::_1]) |
-                     (qi::lit("tidy=") >
-                      qi::bool_[ph::bind(&engine::api::MatchParameters::tidy, qi::_r1) = qi::_1])) %
-                        '&');
+        match_rule =
+            timestamps_rule(qi::_r1) |
+            (qi::lit("gaps=") >
+             gaps_type[ph::bind(&engine::api::MatchParameters::gaps, qi::_r1) = qi::_1]) |
+            (qi::lit("tidy=") >
+             qi::bool_[ph::bind(&engine::api::MatchParameters::tidy, qi::_r1) = qi::_1]) |
+            (qi::lit("session=") >
+             qi::as_string[+qi::char_("a-zA-Z0-9_.~-")]
+                          [ph::bind(&engine::api::MatchParameters::session, qi::_r1) = qi::_1]);
     }
 
+  protected:
+    qi::rule<Iterator, Signature> match_rule;
+    qi::rule<Iterator, std::size_t()> size_t_;
+
   private:
     qi::rule<Iterator, Signature> root_rule;
     qi::rule<Iterator, Signature> timestamps_rule;
-    qi::rule<Iterator, std::size_t()> size_t_;
 
     qi::symbols<char, engine::api::MatchParameters::GapsType> gaps_type;
 };
@@ -56,11 +56,31 @@ struct TableParametersGrammar : public BaseParametersGrammar<Iterator, Signature
             qi::lit("scale_factor=") >
             (double_)[ph::bind(&engine::api::TableParameters::scale_factor, qi::_r1) = qi::_1];
 
+        max_duration_rule =
+            qi::lit("max_duration=") >
+            (double_)[ph::bind(&engine::api::TableParameters::max_duration, qi::_r1) = qi::_1];
+
+        max_distance_rule =
+            qi::lit("max_distance=") >
+            (double_)[ph::bind(&engine::api::TableParameters::max_distance, qi::_r1) = qi::_1];
+
+        BaseGrammar::format_type.add(".binary",
+                                     engine::api::BaseParameters::OutputFormatType::BINARY);
+
+        binary_encoding_type.add("int32", engine::api::TableParameters::BinaryEncodingType::Int32)(
+            "float16", engine::api::TableParameters::BinaryEncodingType::Float16);
+
+        binary_encoding_rule =
+            qi::lit("binary_encoding=") >
+            binary_encoding_type[ph::bind(&engine::api::TableParameters::binary_encoding,
+                                          qi::_r1) = qi::_1];
+
         table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1);
 
         root_rule = BaseGrammar::query_rule(qi::_r1) > BaseGrammar::format_rule(qi::_r1) >
                     -('?' > (table_rule(qi::_r1) | base_rule(qi::_r1) | scale_factor_rule(qi::_r1) |
-                             fallback_speed_rule(qi::_r1) |
+                             fallback_speed_rule(qi::_r1) | binary_encoding_rule(qi::_r1) |
+                             max_duration_rule(qi::_r1) | max_distance_rule(qi::_r1) |
                              (qi::lit("fallback_coordinate=") >
                               fallback_coordinate_type
                                   [ph::bind(&engine::api::TableParameters::fallback_coordinate_type,
@@ -95,11 +115,15 @@ struct TableParametersGrammar : public BaseParametersGrammar<Iterator, Signature
     qi::rule<Iterator, Signature> destinations_rule;
     qi::rule<Iterator, Signature> fallback_speed_rule;
     qi::rule<Iterator, Signature> scale_factor_rule;
+    qi::rule<Iterator, Signature> binary_encoding_rule;
+    qi::rule<Iterator, Signature> max_duration_rule;
+    qi::rule<Iterator, Signature> max_distance_rule;
     qi::rule<Iterator, std::size_t()> size_t_;
     qi::symbols<char, engine::api::TableParameters::AnnotationsType> annotations;
     qi::rule<Iterator, engine::api::TableParameters::AnnotationsType()> annotations_list;
     qi::symbols<char, engine::api::TableParameters::FallbackCoordinateType>
         fallback_coordinate_type;
+    qi::symbols<char, engine::api::TableParameters::BinaryEncodingType> binary_encoding_type;
     qi::real_parser<double, json_policy> double_;
 };
 } // namespace osrm::server::api
@@ -12,6 +12,7 @@
 #include <boost/version.hpp>
 
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace osrm::server
@@ -25,7 +26,9 @@ class Connection : public std::enable_shared_from_this<Connection>
   public:
     explicit Connection(boost::asio::io_context &io_context,
                         RequestHandler &handler,
-                        short keepalive_timeout);
+                        short keepalive_timeout,
+                        bool stream_responses = false,
+                        bool keep_half_closed_requests = false);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -45,6 +48,19 @@ class Connection : public std::enable_shared_from_this<Connection>
 
     void handle_shutdown();
 
+    void add_keep_alive_headers();
+
+    /// Checks without blocking whether the client closed or reset the connection, safe to call
+    /// from the worker threads of a request
+    bool is_closed_by_client();
+
+    /// Write one chunk of a streamed response from the thread of the request, headers go out with
+    /// the first one
+    void write_chunk(std::string_view chunk);
+
+    /// Write synchronously, but fail once the client doesn't accept data for the keepalive timeout
+    void write_with_timeout(std::string_view data);
+
     std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
                                        const http::compression_type compression_type);
 
@@ -63,6 +79,15 @@ class Connection : public std::enable_shared_from_this<Connection>
     bool keep_alive = false;
     short processed_requests = 512;
     short keepalive_timeout = 5; // In seconds
+
+    // Chunked responses support
+    bool stream_responses = false;
+    bool response_streamed = false;
+    boost::system::error_code stream_error;
+
+    // Requests have no body, so a closed sending side of the client is taken as a cancellation
+    // unless half-closed connections are kept
+    bool keep_half_closed_requests = false;
 };
 } // namespace osrm::server
 
@@ -17,10 +17,13 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        internal_server_error = 500,
+        service_unavailable = 503
     } status;
 
     std::vector<header> headers;
+    // the body is sent with chunked transfer encoding, which needs a HTTP/1.1 status line
+    bool chunked = false;
     std::vector<boost::asio::const_buffer> to_buffers();
     std::vector<boost::asio::const_buffer> headers_to_buffers();
     std::vector<char> content;
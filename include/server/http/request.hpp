@@ -14,6 +14,8 @@ struct request
     std::string referrer;
     std::string agent;
     std::string connection;
+    unsigned http_version_major = 0;
+    unsigned http_version_minor = 0;
     boost::asio::ip::address endpoint;
 };
 } // namespace osrm::server::http
@@ -26,6 +26,12 @@ class RequestHandler
 
     void HandleRequest(const http::request &current_request, http::reply &current_reply);
 
+    // Like above, but a successful response of a streaming service is passed to `write_chunk`
+    // piece by piece. In that case `current_reply` only carries the headers of the response.
+    void HandleRequest(const http::request &current_request,
+                       http::reply &current_reply,
+                       const engine::api::ResultStream &write_chunk);
+
   private:
     std::unique_ptr<ServiceHandlerInterface> service_handler;
 };
@@ -34,21 +34,34 @@ class Server
     static std::shared_ptr<Server> CreateServer(std::string &ip_address,
                                                 int ip_port,
                                                 unsigned requested_num_threads,
-                                                short keepalive_timeout)
+                                                short keepalive_timeout,
+                                                bool stream_responses = false,
+                                                bool keep_half_closed_requests = false)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads, keepalive_timeout);
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_threads,
+                                        keepalive_timeout,
+                                        stream_responses,
+                                        keep_half_closed_requests);
     }
 
     explicit Server(const std::string &address,
                     const int port,
                     const unsigned thread_pool_size,
-                    const short keepalive_timeout)
+                    const short keepalive_timeout,
+                    const bool stream_responses = false,
+                    const bool keep_half_closed_requests = false)
         : thread_pool_size(thread_pool_size), keepalive_timeout(keepalive_timeout),
-          acceptor(io_context), new_connection(std::make_shared<Connection>(
-                                    io_context, request_handler, keepalive_timeout))
+          stream_responses(stream_responses), keep_half_closed_requests(keep_half_closed_requests),
+          acceptor(io_context), new_connection(std::make_shared<Connection>(io_context,
+                                                                            request_handler,
+                                                                            keepalive_timeout,
+                                                                            stream_responses,
+                                                                            keep_half_closed_requests))
     {
         const auto port_string = std::to_string(port);
 
@@ -100,8 +113,11 @@ class Server
         if (!e)
         {
             new_connection->start();
-            new_connection =
-                std::make_shared<Connection>(io_context, request_handler, keepalive_timeout);
+            new_connection = std::make_shared<Connection>(io_context,
+                                                          request_handler,
+                                                          keepalive_timeout,
+                                                          stream_responses,
+                                                          keep_half_closed_requests);
             acceptor.async_accept(
                 new_connection->socket(),
                 boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
@@ -115,6 +131,8 @@ class Server
     RequestHandler request_handler;
     unsigned thread_pool_size;
     short keepalive_timeout;
+    bool stream_responses;
+    bool keep_half_closed_requests;
     boost::asio::io_context io_context;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
@@ -22,6 +22,16 @@ class BaseService
     virtual engine::Status
     RunQuery(std::size_t prefix_length, std::string &query, osrm::engine::api::ResultT &result) = 0;
 
+    // Services that can render a successful response incrementally write it into `stream`,
+    // all others ignore the stream and fill `result`
+    virtual engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                             std::string &query,
+                                             osrm::engine::api::ResultT &result,
+                                             const osrm::engine::api::ResultStream &)
+    {
+        return RunQuery(prefix_length, query, result);
+    }
+
     virtual unsigned GetVersion() = 0;
 
   protected:
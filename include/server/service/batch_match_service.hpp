@@ -0,0 +1,34 @@
+#ifndef SERVER_SERVICE_BATCH_MATCH_SERVICE_HPP
+#define SERVER_SERVICE_BATCH_MATCH_SERVICE_HPP
+
+#include "server/service/base_service.hpp"
+
+#include "engine/status.hpp"
+#include "osrm/osrm.hpp"
+#include "util/coordinate.hpp"
+
+#include <string>
+#include <vector>
+
+namespace osrm::server::service
+{
+
+class BatchMatchService final : public BaseService
+{
+  public:
+    BatchMatchService(OSRM &routing_machine) : BaseService(routing_machine) {}
+
+    engine::Status RunQuery(std::size_t prefix_length,
+                            std::string &query,
+                            osrm::engine::api::ResultT &result) final override;
+
+    engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                     std::string &query,
+                                     osrm::engine::api::ResultT &result,
+                                     const osrm::engine::api::ResultStream &stream) final override;
+
+    unsigned GetVersion() final override { return 1; }
+};
+} // namespace osrm::server::service
+
+#endif
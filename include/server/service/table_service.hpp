@@ -22,6 +22,11 @@ class TableService final : public BaseService
                             std::string &query,
                             osrm::engine::api::ResultT &result) final override;
 
+    engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                     std::string &query,
+                                     osrm::engine::api::ResultT &result,
+                                     const osrm::engine::api::ResultStream &stream) final override;
+
     unsigned GetVersion() final override { return 1; }
 };
 } // namespace osrm::server::service
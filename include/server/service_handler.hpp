@@ -27,6 +27,9 @@ class ServiceHandlerInterface
     virtual ~ServiceHandlerInterface() {}
     virtual engine::Status RunQuery(api::ParsedURL parsed_url,
                                     osrm::engine::api::ResultT &result) = 0;
+    virtual engine::Status RunQuery(api::ParsedURL parsed_url,
+                                    osrm::engine::api::ResultT &result,
+                                    const osrm::engine::api::ResultStream &stream) = 0;
 };
 
 class ServiceHandler final : public ServiceHandlerInterface
@@ -36,6 +39,9 @@ class ServiceHandler final : public ServiceHandlerInterface
     using ResultT = osrm::engine::api::ResultT;
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+    virtual engine::Status RunQuery(api::ParsedURL parsed_url,
+                                    ResultT &result,
+                                    const osrm::engine::api::ResultStream &stream) override;
 
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
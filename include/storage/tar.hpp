@@ -157,12 +157,15 @@ class FileReader
 
     template <typename OutIter> void List(OutIter out)
     {
+        auto ret = mtar_rewind(&handle);
+        detail::checkMTarError(ret, path, "");
+
         mtar_header_t header;
         while (mtar_read_header(&handle, &header) != MTAR_ENULLRECORD)
         {
             if (header.type == MTAR_TREG)
             {
-                int ret = mtar_read_data(&handle, nullptr, 0);
+                ret = mtar_read_data(&handle, nullptr, 0);
                 detail::checkMTarError(ret, path, header.name);
 
                 auto offset = handle.pos;
@@ -110,6 +110,19 @@ class DisabledDatasetException : public exception
     }
 };
 
+// Thrown by the searches of a request that ran past its deadline or was cancelled
+class TimeoutException : public exception
+{
+  public:
+    TimeoutException() : exception("The request ran out of time and was aborted") {}
+
+  private:
+    // This function exists to 'anchor' the class, and stop the compiler from
+    // copying vtable and RTTI info into every object file that includes
+    // this header. (Caught by -Wweak-vtables under Clang.)
+    virtual void anchor() const override;
+};
+
 class RuntimeError : public exception
 {
     using Base = exception;
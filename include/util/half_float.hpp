@@ -0,0 +1,62 @@
+#ifndef OSRM_UTIL_HALF_FLOAT_HPP
+#define OSRM_UTIL_HALF_FLOAT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace osrm::util
+{
+
+// Converts to the bits of an IEEE 754 binary16 value, rounding to nearest even. Values beyond
+// the largest half float (65504) become infinity.
+inline std::uint16_t toHalfFloat(const float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const std::uint16_t sign = (bits >> 16) & 0x8000;
+    const std::uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    // infinity or NaN
+    if (magnitude >= 0x7F800000)
+        return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 : 0);
+
+    // rounds to 65520 or more
+    if (magnitude >= 0x477FF000)
+        return sign | 0x7C00;
+
+    // below the smallest normal half float 2^-14, counted in multiples of 2^-24
+    if (magnitude < 0x38800000)
+        return sign | static_cast<std::uint16_t>(std::nearbyint(std::fabs(value) * 16777216.f));
+
+    // rebias the exponent from 127 to 15 and drop 13 bits of the mantissa, a carry out of the
+    // mantissa correctly increments the exponent
+    std::uint32_t half = (magnitude - 0x38000000) >> 13;
+    const std::uint32_t remainder = magnitude & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        ++half;
+    return sign | static_cast<std::uint16_t>(half);
+}
+
+// Converts the bits of an IEEE 754 binary16 value back to a float
+inline float fromHalfFloat(const std::uint16_t half)
+{
+    const bool negative = half & 0x8000;
+    const std::uint32_t exponent = (half >> 10) & 0x1F;
+    const std::uint32_t mantissa = half & 0x3FF;
+
+    float value;
+    if (exponent == 0)
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+    else if (exponent == 0x1F)
+        value = mantissa == 0 ? INFINITY : NAN;
+    else
+        value = std::ldexp(static_cast<float>(mantissa | 0x400), static_cast<int>(exponent) - 25);
+
+    return negative ? -value : value;
+}
+
+} // namespace osrm::util
+
+#endif // OSRM_UTIL_HALF_FLOAT_HPP
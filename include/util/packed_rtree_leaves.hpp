@@ -0,0 +1,354 @@
+#ifndef OSRM_UTIL_PACKED_RTREE_LEAVES_HPP
+#define OSRM_UTIL_PACKED_RTREE_LEAVES_HPP
+
+#include "storage/io.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
+#include "util/mmap_file.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace osrm::util
+{
+
+// Splits the objects stored in the leaves of a StaticRTree into unsigned fields of up to 32 bit
+// and joins them again. Needs to be specialized for the leaf type with
+//
+//   static constexpr std::size_t NUMBER_OF_FIELDS;
+//   // a value per field that marks missing data, e.g. SPECIAL_NODEID
+//   static constexpr std::array<std::uint32_t, NUMBER_OF_FIELDS> SPECIAL_VALUES;
+//   static std::array<std::uint32_t, NUMBER_OF_FIELDS> Split(const EdgeDataT &object);
+//   static EdgeDataT Join(const std::array<std::uint32_t, NUMBER_OF_FIELDS> &fields);
+template <typename EdgeDataT> struct RTreeLeafFields;
+
+// The leaf pages of a StaticRTree with frame-of-reference coding: every field of the objects on
+// a page is stored as the difference to the smallest value of the field on the page, with as few
+// bits as the range of the page needs. Objects on a page are close to each other and so are
+// their node and segment ids. The special value of a field is coded as all ones, so that
+// e.g. disabled segments don't widen the range.
+//
+// A page starts with the number of objects and the base value, bit width and a special value
+// flag of every field, followed by the values of one field after another. Pages are decoded
+// while searching their leaf, single objects when they are returned.
+//
+// The pages are stored in a .osrm.packedIndex file next to the .osrm.fileIndex and mmapped like
+// it. The file starts with the fingerprint, the format version and the number of packed objects,
+// followed by the bit offsets of the pages and the words of the pages.
+template <typename EdgeDataT> class PackedRTreeLeaves
+{
+    using Fields = RTreeLeafFields<EdgeDataT>;
+    using FieldValues = std::array<std::uint32_t, Fields::NUMBER_OF_FIELDS>;
+
+    // needs to be increased with every change of the page or file layout
+    static constexpr std::uint64_t FORMAT_VERSION = 1;
+
+    static constexpr std::uint32_t COUNT_BITS = 16;
+    static constexpr std::uint32_t BASE_BITS = 32;
+    static constexpr std::uint32_t WIDTH_BITS = 6;
+
+    struct PageHeader
+    {
+        std::uint32_t count;
+        FieldValues bases;
+        FieldValues widths;
+        std::array<bool, Fields::NUMBER_OF_FIELDS> has_special;
+        // bit offset of the first value of every field
+        std::array<std::uint64_t, Fields::NUMBER_OF_FIELDS> offsets;
+    };
+
+    struct FileHeader
+    {
+        std::uint64_t version;
+        std::uint64_t number_of_objects;
+        std::uint64_t number_of_page_offsets;
+        std::uint64_t number_of_words;
+    };
+
+  public:
+    PackedRTreeLeaves() = default;
+    PackedRTreeLeaves(const PackedRTreeLeaves &) = delete;
+    PackedRTreeLeaves &operator=(const PackedRTreeLeaves &) = delete;
+    PackedRTreeLeaves(PackedRTreeLeaves &&) = default;
+    PackedRTreeLeaves &operator=(PackedRTreeLeaves &&) = default;
+
+    // Maps the packed leaves of objects, the leaves of the .fileIndex they were packed from.
+    // Throws if the file was written by another version or from other objects.
+    template <typename ObjectsT>
+    PackedRTreeLeaves(const std::filesystem::path &path, const ObjectsT &objects)
+    {
+        const auto mismatch = [&]
+        {
+            return util::exception(path.string() + " does not match the .osrm.fileIndex, " +
+                                   "run osrm-extract --compress-rtree-leaves again" + SOURCE_REF);
+        };
+
+        FileHeader header;
+        {
+            storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+            reader.ReadInto(header);
+        }
+        if (header.version != FORMAT_VERSION || header.number_of_objects != objects.size())
+        {
+            throw mismatch();
+        }
+
+        const auto data = mmapFile<std::uint64_t>(path, region);
+        const std::size_t first_offset =
+            (sizeof(FingerPrint) + sizeof(FileHeader)) / sizeof(std::uint64_t);
+        if (data.size() != first_offset + header.number_of_page_offsets + header.number_of_words)
+        {
+            throw util::exception(path.string() + " is truncated" + SOURCE_REF);
+        }
+        page_offsets = {data.data() + first_offset, header.number_of_page_offsets};
+        words = {data.data() + first_offset + header.number_of_page_offsets,
+                 header.number_of_words};
+
+        // the segments of a renumbered .fileIndex keep their number, compare the outer pages
+        if (!empty() && !(MatchesPage(0, objects, 0) &&
+                          MatchesPage(NumberOfPages() - 1,
+                                      objects,
+                                      objects.size() - ReadHeader(NumberOfPages() - 1).count)))
+        {
+            throw mismatch();
+        }
+    }
+
+    // Packs pages of page_size consecutive objects into a file, the last page may be smaller
+    template <typename ObjectsT>
+    static void Write(const std::filesystem::path &path,
+                      const ObjectsT &objects,
+                      const std::size_t page_size)
+    {
+        BOOST_ASSERT(page_size > 0 && page_size < (1u << COUNT_BITS));
+
+        std::vector<std::uint64_t> page_offsets;
+        std::vector<std::uint64_t> words;
+        std::uint64_t offset = 0;
+        std::vector<FieldValues> page;
+        for (std::size_t first = 0; first < objects.size(); first += page_size)
+        {
+            page.clear();
+            for (const auto index :
+                 irange<std::size_t>(first, std::min(first + page_size, objects.size())))
+            {
+                page.push_back(Fields::Split(objects[index]));
+            }
+            page_offsets.push_back(offset);
+            PackPage(page, offset, words);
+        }
+        page_offsets.push_back(offset);
+
+        storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+        writer.WriteFrom(
+            FileHeader{FORMAT_VERSION, objects.size(), page_offsets.size(), words.size()});
+        writer.WriteFrom(page_offsets);
+        writer.WriteFrom(words);
+    }
+
+    bool empty() const { return page_offsets.empty(); }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return (page_offsets.size() + words.size()) * sizeof(std::uint64_t);
+    }
+
+    void DecodePage(const std::size_t page, std::vector<EdgeDataT> &objects) const
+    {
+        const auto header = ReadHeader(page);
+        objects.clear();
+        for (const auto index : irange<std::uint32_t>(0, header.count))
+        {
+            objects.push_back(DecodeObject(header, index));
+        }
+    }
+
+    EdgeDataT Decode(const std::size_t page, const std::uint32_t index) const
+    {
+        const auto header = ReadHeader(page);
+        BOOST_ASSERT(index < header.count);
+        return DecodeObject(header, index);
+    }
+
+  private:
+    std::size_t NumberOfPages() const { return page_offsets.size() - 1; }
+
+    template <typename ObjectsT>
+    bool MatchesPage(const std::size_t page, const ObjectsT &objects, const std::size_t first) const
+    {
+        const auto header = ReadHeader(page);
+        if (first + header.count > objects.size())
+        {
+            return false;
+        }
+        for (const auto index : irange<std::uint32_t>(0, header.count))
+        {
+            if (Fields::Split(DecodeObject(header, index)) != Fields::Split(objects[first + index]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void PackPage(const std::vector<FieldValues> &page,
+                         std::uint64_t &offset,
+                         std::vector<std::uint64_t> &words)
+    {
+        PageHeader header;
+        header.count = page.size();
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            const auto special = Fields::SPECIAL_VALUES[field];
+            std::uint32_t min_value = std::numeric_limits<std::uint32_t>::max();
+            std::uint32_t max_value = 0;
+            bool has_regular = false;
+            header.has_special[field] = false;
+            for (const auto &values : page)
+            {
+                if (values[field] == special)
+                {
+                    header.has_special[field] = true;
+                    continue;
+                }
+                has_regular = true;
+                min_value = std::min(min_value, values[field]);
+                max_value = std::max(max_value, values[field]);
+            }
+
+            const std::uint64_t number_of_codes =
+                (has_regular ? std::uint64_t{max_value} - min_value + 1 : 0) +
+                (header.has_special[field] ? 1 : 0);
+            std::uint32_t width = 0;
+            while ((std::uint64_t{1} << width) < number_of_codes)
+            {
+                ++width;
+            }
+            header.bases[field] = has_regular ? min_value : 0;
+            header.widths[field] = width;
+        }
+
+        Append(words, offset, header.count, COUNT_BITS);
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            Append(words, offset, header.bases[field], BASE_BITS);
+            Append(words, offset, header.widths[field], WIDTH_BITS);
+            Append(words, offset, header.has_special[field], 1);
+        }
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            const auto width = header.widths[field];
+            for (const auto &values : page)
+            {
+                const auto code = header.has_special[field] &&
+                                          values[field] == Fields::SPECIAL_VALUES[field]
+                                      ? AllOnes(width)
+                                      : values[field] - header.bases[field];
+                Append(words, offset, code, width);
+            }
+        }
+    }
+
+    PageHeader ReadHeader(const std::size_t page) const
+    {
+        BOOST_ASSERT(page + 1 < page_offsets.size());
+        PageHeader header;
+        auto offset = page_offsets[page];
+        header.count = Read(offset, COUNT_BITS);
+        offset += COUNT_BITS;
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            header.bases[field] = Read(offset, BASE_BITS);
+            header.widths[field] = Read(offset + BASE_BITS, WIDTH_BITS);
+            header.has_special[field] = Read(offset + BASE_BITS + WIDTH_BITS, 1) != 0;
+            offset += BASE_BITS + WIDTH_BITS + 1;
+        }
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            header.offsets[field] = offset;
+            offset += std::uint64_t{header.count} * header.widths[field];
+        }
+        BOOST_ASSERT(offset == page_offsets[page + 1]);
+        return header;
+    }
+
+    EdgeDataT DecodeObject(const PageHeader &header, const std::uint32_t index) const
+    {
+        FieldValues values;
+        for (const auto field : irange<std::size_t>(0, Fields::NUMBER_OF_FIELDS))
+        {
+            const auto width = header.widths[field];
+            const auto code = Read(header.offsets[field] + std::uint64_t{index} * width, width);
+            values[field] = header.has_special[field] && code == AllOnes(width)
+                                ? Fields::SPECIAL_VALUES[field]
+                                : header.bases[field] + code;
+        }
+        return Fields::Join(values);
+    }
+
+    static std::uint32_t AllOnes(const std::uint32_t width)
+    {
+        return static_cast<std::uint32_t>((std::uint64_t{1} << width) - 1);
+    }
+
+    static void Append(std::vector<std::uint64_t> &words,
+                       std::uint64_t &offset,
+                       const std::uint32_t value,
+                       const std::uint32_t width)
+    {
+        BOOST_ASSERT(width <= 32);
+        BOOST_ASSERT(std::uint64_t{value} <= AllOnes(width));
+        if (width == 0)
+        {
+            return;
+        }
+
+        const auto word = offset / 64;
+        const auto shift = offset % 64;
+        words.resize((offset + width + 63) / 64, 0);
+        words[word] |= std::uint64_t{value} << shift;
+        if (shift + width > 64)
+        {
+            words[word + 1] |= std::uint64_t{value} >> (64 - shift);
+        }
+        offset += width;
+    }
+
+    std::uint32_t Read(const std::uint64_t offset, const std::uint32_t width) const
+    {
+        BOOST_ASSERT(width <= 32);
+        if (width == 0)
+        {
+            return 0;
+        }
+
+        const auto word = offset / 64;
+        const auto shift = offset % 64;
+        auto value = words[word] >> shift;
+        if (shift + width > 64)
+        {
+            value |= words[word + 1] << (64 - shift);
+        }
+        return static_cast<std::uint32_t>(value) & AllOnes(width);
+    }
+
+    // mmap'd .packedIndex file
+    boost::iostreams::mapped_file_source region;
+    // bit offset of every page in words, followed by the end of the last page
+    util::vector_view<const std::uint64_t> page_offsets;
+    util::vector_view<const std::uint64_t> words;
+};
+
+} // namespace osrm::util
+
+#endif // OSRM_UTIL_PACKED_RTREE_LEAVES_HPP
@@ -1,15 +1,18 @@
 #ifndef OSRM_UTIL_QUERY_HEAP_HPP
 #define OSRM_UTIL_QUERY_HEAP_HPP
 
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/assert.hpp>
 #include <boost/heap/d_ary_heap.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <limits>
 #include <map>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm::util
@@ -26,6 +29,8 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     void Clear() {}
 
+    std::size_t MemoryUsage() const { return positions.capacity() * sizeof(Key); }
+
   private:
     std::vector<Key> positions;
 };
@@ -55,10 +60,118 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // approximated by the buckets and one allocated node per entry
+    std::size_t MemoryUsage() const
+    {
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(std::pair<const NodeID, Key>) + 2 * sizeof(void *));
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Dense index where every entry is stamped with the generation it was written in. Clearing only
+// starts a new generation, entries of older generations read as not inserted.
+template <typename NodeID, typename Key> class GenerationArrayStorage
+{
+  public:
+    explicit GenerationArrayStorage(std::size_t size) : entries(size) {}
+
+    Key &operator[](const NodeID node)
+    {
+        // the graph can grow when a new dataset is loaded
+        if (node >= entries.size())
+        {
+            entries.resize(node + 1);
+        }
+        auto &entry = entries[node];
+        entry.generation = generation;
+        return entry.key;
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        if (node >= entries.size() || entries[node].generation != generation)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return entries[node].key;
+    }
+
+    Key const &operator[](const NodeID node) const
+    {
+        BOOST_ASSERT(entries[node].generation == generation);
+        return entries[node].key;
+    }
+
+    void Clear()
+    {
+        // generation 0 marks entries that were never written
+        if (++generation == 0)
+        {
+            std::fill(entries.begin(), entries.end(), Entry{});
+            generation = 1;
+        }
+    }
+
+    std::size_t MemoryUsage() const { return entries.capacity() * sizeof(Entry); }
+
+  private:
+    struct Entry
+    {
+        Key key = std::numeric_limits<Key>::max();
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<Entry> entries;
+    std::uint32_t generation = 1;
+};
+
+// Uses a dense generation-stamped index if it is not bigger than max_array_size entries and a
+// hash map otherwise, so that the memory of the heaps of large graphs stays bounded
+template <typename NodeID, typename Key> class ArrayOrMapStorage
+{
+  public:
+    ArrayOrMapStorage(std::size_t size, std::size_t max_array_size)
+        : use_array(size <= max_array_size), array(use_array ? size : 0), map(size)
+    {
+    }
+
+    Key &operator[](const NodeID node) { return use_array ? array[node] : map[node]; }
+
+    Key peek_index(const NodeID node) const
+    {
+        return use_array ? array.peek_index(node) : map.peek_index(node);
+    }
+
+    Key const &operator[](const NodeID node) const
+    {
+        return use_array ? std::as_const(array)[node] : std::as_const(map)[node];
+    }
+
+    void Clear()
+    {
+        if (use_array)
+        {
+            array.Clear();
+        }
+        else
+        {
+            map.Clear();
+        }
+    }
+
+    bool UsesArray() const { return use_array; }
+
+    std::size_t MemoryUsage() const { return array.MemoryUsage() + map.MemoryUsage(); }
+
+  private:
+    const bool use_array;
+    GenerationArrayStorage<NodeID, Key> array;
+    UnorderedMapStorage<NodeID, Key> map;
+};
+
 template <typename NodeID,
           typename Key,
           template <typename N, typename K> class BaseIndexStorage = UnorderedMapStorage,
@@ -114,17 +227,357 @@ class TwoLevelStorage
         overlay.Clear();
     }
 
+    std::size_t MemoryUsage() const { return base.MemoryUsage() + overlay.MemoryUsage(); }
+
   private:
     const std::size_t number_of_overlay_nodes;
     BaseIndexStorage<NodeID, Key> base;
     OverlayIndexStorage<NodeID, Key> overlay;
 };
 
+// Priority queues of QueryHeap. They store entries with a weight and a unique index (the
+// position in the inserted nodes of the heap) and are ordered by operator>. A priority queue
+// provides push (returning a handle), top, pop, decrease, get (entry of a handle), none (a handle
+// that is never returned by push), clear, empty, size and memory_usage.
+
+// Mutable 4-ary heap of boost
+template <typename T> class BoostDAryHeap
+{
+    using HeapContainer = boost::heap::d_ary_heap<T,
+                                                  boost::heap::arity<4>,
+                                                  boost::heap::mutable_<true>,
+                                                  boost::heap::compare<std::greater<T>>>;
+
+  public:
+    using handle_type = typename HeapContainer::handle_type;
+
+    handle_type push(const T &value) { return heap.push(value); }
+
+    const T &top() const { return heap.top(); }
+
+    void pop() { heap.pop(); }
+
+    void decrease(const handle_type handle, const T &value) { heap.increase(handle, value); }
+
+    const T &get(const handle_type handle) const { return *handle; }
+
+    handle_type none() const
+    {
+        // Use end iterator as a reliable "non-existent" handle.
+        // Default-constructed handles are singular and
+        // can only be checked-compared to another singular instance.
+        // Behaviour investigated at https://lists.boost.org/boost-users/2017/08/87787.php,
+        // eventually confirmation at https://stackoverflow.com/a/45622940/151641.
+        // Corrected in https://github.com/Project-OSRM/osrm-backend/pull/4396
+        auto const end_it = const_cast<HeapContainer &>(heap).end(); // non-const iterator
+        return heap.s_handle_from_iterator(end_it);                  // from non-const iterator
+    }
+
+    void clear() { heap.clear(); }
+
+    bool empty() const { return heap.empty(); }
+
+    std::size_t size() const { return heap.size(); }
+
+    // approximated by the entry, its list node and its slot in the array of the d-ary heap
+    std::size_t memory_usage() const { return heap.size() * (sizeof(T) + 4 * sizeof(void *)); }
+
+  private:
+    HeapContainer heap;
+};
+
+// 4-ary heap with the children of every entry in one cache line. The handle of an entry is its
+// index, the position of an index in the heap is tracked in a separate array.
+template <typename T> class DAryHeap
+{
+    static constexpr std::size_t ARITY = 4;
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    // entry i is stored at i + ARITY - 1, so all siblings start at a multiple of ARITY
+    static constexpr std::size_t OFFSET = ARITY - 1;
+
+  public:
+    using handle_type = std::uint32_t;
+
+    DAryHeap() : heap(OFFSET) {}
+
+    handle_type push(const T &value)
+    {
+        const auto handle = static_cast<handle_type>(value.index);
+        if (handle >= positions.size())
+        {
+            positions.resize(handle + 1, none());
+        }
+        heap.push_back(value);
+        siftUp(size() - 1);
+        return handle;
+    }
+
+    const T &top() const
+    {
+        BOOST_ASSERT(!empty());
+        return at(0);
+    }
+
+    void pop()
+    {
+        BOOST_ASSERT(!empty());
+        positions[static_cast<handle_type>(at(0).index)] = none();
+        const auto last = heap.back();
+        heap.pop_back();
+        if (!empty())
+        {
+            at(0) = last;
+            siftDown(0);
+        }
+    }
+
+    void decrease(const handle_type handle, const T &value)
+    {
+        BOOST_ASSERT(positions[handle] != none());
+        const auto position = positions[handle];
+        at(position) = value;
+        siftUp(position);
+    }
+
+    const T &get(const handle_type handle) const { return at(positions[handle]); }
+
+    handle_type none() const { return std::numeric_limits<handle_type>::max(); }
+
+    void clear()
+    {
+        heap.resize(OFFSET);
+        positions.clear();
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t size() const { return heap.size() - OFFSET; }
+
+    std::size_t memory_usage() const
+    {
+        return heap.capacity() * sizeof(T) + positions.capacity() * sizeof(handle_type);
+    }
+
+  private:
+    T &at(const std::size_t position) { return heap[position + OFFSET]; }
+    const T &at(const std::size_t position) const { return heap[position + OFFSET]; }
+
+    void place(const std::size_t position, const T &value)
+    {
+        at(position) = value;
+        positions[static_cast<handle_type>(value.index)] = static_cast<handle_type>(position);
+    }
+
+    void siftUp(std::size_t position)
+    {
+        const auto value = at(position);
+        while (position > 0)
+        {
+            const auto parent = (position - 1) / ARITY;
+            if (!(at(parent) > value))
+            {
+                break;
+            }
+            place(position, at(parent));
+            position = parent;
+        }
+        place(position, value);
+    }
+
+    void siftDown(std::size_t position)
+    {
+        const auto value = at(position);
+        const auto heap_size = size();
+        while (true)
+        {
+            const auto first_child = position * ARITY + 1;
+            if (first_child >= heap_size)
+            {
+                break;
+            }
+            const auto last_child = std::min(first_child + ARITY, heap_size);
+            auto min_child = first_child;
+            for (auto child = first_child + 1; child < last_child; ++child)
+            {
+                if (at(min_child) > at(child))
+                {
+                    min_child = child;
+                }
+            }
+            if (!(value > at(min_child)))
+            {
+                break;
+            }
+            place(position, at(min_child));
+            position = min_child;
+        }
+        place(position, value);
+    }
+
+    std::vector<T, boost::alignment::aligned_allocator<T, CACHE_LINE_SIZE>> heap;
+    std::vector<handle_type> positions;
+};
+
+// Radix heap for monotone searches: an entry must not be lighter than the last minimum, which
+// holds for Dijkstra searches with non-negative edge weights. Weights must convert to int32.
+// Decreasing a key adds a new entry, outdated entries are skipped when they surface. Unlike the
+// d-ary heaps, entries of equal weight are not ordered by index.
+template <typename T> class RadixHeap
+{
+    static constexpr std::size_t NUMBER_OF_BUCKETS = 33;
+
+  public:
+    using handle_type = std::uint32_t;
+
+    handle_type push(const T &value)
+    {
+        const auto handle = static_cast<handle_type>(value.index);
+        if (handle >= entries.size())
+        {
+            entries.resize(handle + 1);
+        }
+        entries[handle] = {value, true};
+        insert(value);
+        ++number_of_entries;
+        return handle;
+    }
+
+    const T &top() const
+    {
+        BOOST_ASSERT(!empty());
+        normalize();
+        return buckets[0].back();
+    }
+
+    void pop()
+    {
+        BOOST_ASSERT(!empty());
+        normalize();
+        entries[static_cast<handle_type>(buckets[0].back().index)].queued = false;
+        buckets[0].pop_back();
+        --number_of_entries;
+    }
+
+    void decrease(const handle_type handle, const T &value)
+    {
+        BOOST_ASSERT(entries[handle].queued);
+        entries[handle].value = value;
+        insert(value);
+    }
+
+    const T &get(const handle_type handle) const { return entries[handle].value; }
+
+    handle_type none() const { return std::numeric_limits<handle_type>::max(); }
+
+    void clear()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        entries.clear();
+        number_of_entries = 0;
+        last_minimum = 0;
+    }
+
+    bool empty() const { return number_of_entries == 0; }
+
+    std::size_t size() const { return number_of_entries; }
+
+    std::size_t memory_usage() const
+    {
+        std::size_t usage = entries.capacity() * sizeof(Entry);
+        for (const auto &bucket : buckets)
+        {
+            usage += bucket.capacity() * sizeof(T);
+        }
+        return usage;
+    }
+
+  private:
+    struct Entry
+    {
+        T value;
+        bool queued;
+    };
+
+    // maps the weight to an unsigned key with the same order
+    static std::uint32_t key(const T &value)
+    {
+        return static_cast<std::uint32_t>(static_cast<std::int32_t>(value.weight)) ^ 0x80000000u;
+    }
+
+    std::size_t bucketOf(const std::uint32_t key) const
+    {
+        return key == last_minimum ? 0 : 32 - __builtin_clz(key ^ last_minimum);
+    }
+
+    bool isOutdated(const T &value) const
+    {
+        const auto &entry = entries[static_cast<handle_type>(value.index)];
+        return !entry.queued || key(entry.value) != key(value);
+    }
+
+    void insert(const T &value) const
+    {
+        BOOST_ASSERT(key(value) >= last_minimum);
+        buckets[bucketOf(key(value))].push_back(value);
+    }
+
+    // moves the entries of the minimum weight to the first bucket
+    void normalize() const
+    {
+        auto &first = buckets[0];
+        while (!first.empty() && isOutdated(first.back()))
+        {
+            first.pop_back();
+        }
+
+        while (first.empty())
+        {
+            auto bucket = std::find_if(buckets.begin() + 1,
+                                       buckets.end(),
+                                       [](const auto &bucket) { return !bucket.empty(); });
+            BOOST_ASSERT(bucket != buckets.end());
+
+            auto minimum = std::numeric_limits<std::uint32_t>::max();
+            for (const auto &value : *bucket)
+            {
+                if (!isOutdated(value))
+                {
+                    minimum = std::min(minimum, key(value));
+                }
+            }
+
+            if (minimum != std::numeric_limits<std::uint32_t>::max())
+            {
+                last_minimum = minimum;
+                for (const auto &value : *bucket)
+                {
+                    if (!isOutdated(value))
+                    {
+                        insert(value);
+                    }
+                }
+            }
+            bucket->clear();
+        }
+    }
+
+    // buckets[i] holds the entries whose key differs from last_minimum in bit i - 1 as the
+    // highest bit, normalize() keeps them sorted lazily and is called from const accessors
+    mutable std::array<std::vector<T>, NUMBER_OF_BUCKETS> buckets;
+    mutable std::uint32_t last_minimum = 0;
+    std::vector<Entry> entries;
+    std::size_t number_of_entries = 0;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
           typename Data,
-          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          template <typename> class PriorityQueue = BoostDAryHeap>
 class QueryHeap
 {
   private:
@@ -142,10 +595,7 @@ class QueryHeap
             return weight > other.weight;
         }
     };
-    using HeapContainer = boost::heap::d_ary_heap<HeapData,
-                                                  boost::heap::arity<4>,
-                                                  boost::heap::mutable_<true>,
-                                                  boost::heap::compare<std::greater<HeapData>>>;
+    using HeapContainer = PriorityQueue<HeapData>;
     using HeapHandle = typename HeapContainer::handle_type;
 
   public:
@@ -174,13 +624,20 @@ class QueryHeap
 
     std::size_t Size() const { return heap.size(); }
 
+    // Approximate number of bytes allocated by the heap, memory is kept when clearing it
+    std::size_t MemoryUsage() const
+    {
+        return inserted_nodes.capacity() * sizeof(HeapNode) + heap.memory_usage() +
+               node_index.MemoryUsage();
+    }
+
     bool Empty() const { return 0 == Size(); }
 
     void Insert(NodeID node, Weight weight, const Data &data)
     {
         BOOST_ASSERT(node < std::numeric_limits<NodeID>::max());
         const auto index = static_cast<Key>(inserted_nodes.size());
-        const auto handle = heap.emplace(HeapData{weight, index});
+        const auto handle = heap.push(HeapData{weight, index});
         inserted_nodes.emplace_back(HeapNode{handle, node, weight, data});
         node_index[node] = index;
     }
@@ -216,16 +673,7 @@ class QueryHeap
     {
         BOOST_ASSERT(WasInserted(node));
         const Key index = node_index.peek_index(node);
-
-        // Use end iterator as a reliable "non-existent" handle.
-        // Default-constructed handles are singular and
-        // can only be checked-compared to another singular instance.
-        // Behaviour investigated at https://lists.boost.org/boost-users/2017/08/87787.php,
-        // eventually confirmation at https://stackoverflow.com/a/45622940/151641.
-        // Corrected in https://github.com/Project-OSRM/osrm-backend/pull/4396
-        auto const end_it = const_cast<HeapContainer &>(heap).end();  // non-const iterator
-        auto const none_handle = heap.s_handle_from_iterator(end_it); // from non-const iterator
-        return inserted_nodes[index].handle == none_handle;
+        return inserted_nodes[index].handle == heap.none();
     }
 
     bool WasInserted(const NodeID node) const
@@ -277,7 +725,7 @@ class QueryHeap
         BOOST_ASSERT(!heap.empty());
         const Key removedIndex = heap.top().index;
         heap.pop();
-        inserted_nodes[removedIndex].handle = heap.s_handle_from_iterator(heap.end());
+        inserted_nodes[removedIndex].handle = heap.none();
         return inserted_nodes[removedIndex].node;
     }
 
@@ -286,13 +734,13 @@ class QueryHeap
         BOOST_ASSERT(!heap.empty());
         const Key removedIndex = heap.top().index;
         heap.pop();
-        inserted_nodes[removedIndex].handle = heap.s_handle_from_iterator(heap.end());
+        inserted_nodes[removedIndex].handle = heap.none();
         return inserted_nodes[removedIndex];
     }
 
     void DeleteAll()
     {
-        auto const none_handle = heap.s_handle_from_iterator(heap.end());
+        auto const none_handle = heap.none();
         std::for_each(inserted_nodes.begin(),
                       inserted_nodes.end(),
                       [&none_handle](auto &node) { node.handle = none_handle; });
@@ -305,13 +753,13 @@ class QueryHeap
         const auto index = node_index.peek_index(node);
         auto &reference = inserted_nodes[index];
         reference.weight = weight;
-        heap.increase(reference.handle, HeapData{weight, static_cast<Key>(index)});
+        heap.decrease(reference.handle, HeapData{weight, static_cast<Key>(index)});
     }
 
     void DecreaseKey(const HeapNode &heapNode)
     {
         BOOST_ASSERT(!WasRemoved(heapNode.node));
-        heap.increase(heapNode.handle, HeapData{heapNode.weight, (*heapNode.handle).index});
+        heap.decrease(heapNode.handle, HeapData{heapNode.weight, heap.get(heapNode.handle).index});
     }
 
   private:
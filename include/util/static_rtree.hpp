@@ -11,6 +11,7 @@
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
 #include "util/mmap_file.hpp"
+#include "util/packed_rtree_leaves.hpp"
 #include "util/rectangle.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
@@ -36,6 +37,11 @@
 #include <string>
 #include <vector>
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OSRM_STATIC_RTREE_AVX2
+#include <immintrin.h>
+#endif
+
 namespace osrm::util
 {
 template <class EdgeDataT,
@@ -260,6 +266,9 @@ class StaticRTree
     boost::iostreams::mapped_file_source m_objects_region;
     // This is a view of the EdgeDataT data mmap'd from the .fileIndex file
     util::vector_view<const EdgeDataT> m_objects;
+    // Optional packed copy of the leaves mmap'd from the .packedIndex file, if present the
+    // .fileIndex is not read while searching
+    PackedRTreeLeaves<EdgeDataT> m_packed_leaves;
 
   public:
     StaticRTree() = default;
@@ -469,7 +478,8 @@ class StaticRTree
      * Constructs an r-tree from blocks of memory loaded by someone else
      * (usually a shared memory block created by osrm-datastore)
      * These memory blocks basically just contain the files read into RAM,
-     * excep the .fileIndex file always stays on disk, and we mmap() it as usual
+     * excep the .fileIndex file always stays on disk, and we mmap() it as usual.
+     * If there is a .packedIndex file next to it, it is mmap'd and searched instead.
      */
     explicit StaticRTree(Vector<TreeNode> search_tree_,
                          Vector<std::uint64_t> tree_level_starts,
@@ -481,8 +491,33 @@ class StaticRTree
     {
         BOOST_ASSERT(m_tree_level_starts.size() >= 2);
         m_objects = mmapFile<EdgeDataT>(on_disk_file_name, m_objects_region);
+
+        const auto packed_leaves_path = GetPackedLeavesPath(on_disk_file_name);
+        if (std::filesystem::exists(packed_leaves_path))
+        {
+            m_packed_leaves = PackedRTreeLeaves<EdgeDataT>(packed_leaves_path, m_objects);
+        }
     }
 
+    // The .packedIndex file that belongs to a .fileIndex file
+    static std::filesystem::path GetPackedLeavesPath(const std::filesystem::path &on_disk_file_name)
+    {
+        return std::filesystem::path{on_disk_file_name}.replace_extension(".packedIndex");
+    }
+
+    // Packs the leaves read from the .fileIndex into the .packedIndex file, see
+    // PackedRTreeLeaves. Searches then read the packed leaves instead, which take about half of
+    // the space.
+    void PackLeaves(const std::filesystem::path &packed_leaves_path)
+    {
+        PackedRTreeLeaves<EdgeDataT>::Write(packed_leaves_path, m_objects, LEAF_NODE_SIZE);
+        m_packed_leaves = PackedRTreeLeaves<EdgeDataT>(packed_leaves_path, m_objects);
+    }
+
+    bool HasPackedLeaves() const { return !m_packed_leaves.empty(); }
+
+    std::size_t GetPackedLeavesSizeInBytes() const { return m_packed_leaves.GetSizeInBytes(); }
+
     /* Returns all features inside the bounding box.
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
@@ -548,10 +583,140 @@ class StaticRTree
     std::vector<CandidateSegment> Nearest(const Coordinate input_coordinate,
                                           const FilterT filter,
                                           const TerminationT terminate) const
+    {
+        ProjectedSegments projected_segments;
+        return SearchNearest(web_mercator::fromWGS84(input_coordinate),
+                             filter,
+                             terminate,
+                             [this, &projected_segments](const TreeIndex &leaf_id) -> const auto &
+                             {
+                                 ProjectLeafSegments(leaf_id, projected_segments);
+                                 return projected_segments;
+                             });
+    }
+
+    // Answers the nearest queries of many coordinates at once, with the same results as single
+    // queries. The queries are answered in the order of the Hilbert values of their coordinates,
+    // so that nearby queries follow each other and share the projected segments of the leaf pages
+    // they explore: projecting the segments is the expensive part of exploring a leaf.
+    // The filter and termination functions also get the index of the query.
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<CandidateSegment>>
+    BatchNearest(const std::vector<Coordinate> &input_coordinates,
+                 const FilterT filter,
+                 const TerminationT terminate) const
+    {
+        std::vector<FloatCoordinate> projected_coordinates;
+        std::vector<WrappedInputElement> query_order;
+        projected_coordinates.reserve(input_coordinates.size());
+        query_order.reserve(input_coordinates.size());
+        for (const auto query : irange<std::uint32_t>(0, input_coordinates.size()))
+        {
+            projected_coordinates.push_back(web_mercator::fromWGS84(input_coordinates[query]));
+            query_order.emplace_back(GetHilbertCode(Coordinate{projected_coordinates.back()}),
+                                     query);
+        }
+        std::sort(query_order.begin(), query_order.end());
+
+        LeafCache leaf_cache;
+        leaf_cache.fill({INVALID_LEAF_OFFSET, {}});
+        const auto project_leaf = [this, &leaf_cache](const TreeIndex &leaf_id) -> const auto &
+        {
+            auto &[cached_offset, projected_segments] =
+                leaf_cache[leaf_id.offset % leaf_cache.size()];
+            if (cached_offset != leaf_id.offset)
+            {
+                cached_offset = leaf_id.offset;
+                ProjectLeafSegments(leaf_id, projected_segments);
+            }
+            return projected_segments;
+        };
+
+        std::vector<std::vector<CandidateSegment>> results(input_coordinates.size());
+        for (const auto &element : query_order)
+        {
+            const auto query = element.m_original_index;
+            results[query] = SearchNearest(
+                projected_coordinates[query],
+                [&filter, query](const CandidateSegment &segment)
+                { return filter(query, segment); },
+                [&terminate, query](const std::size_t num_results, const CandidateSegment &segment)
+                { return terminate(query, num_results, segment); },
+                project_leaf);
+        }
+        return results;
+    }
+
+  private:
+    // Projected end points of the segments in a leaf page
+    using ProjectedSegments = std::vector<std::pair<FloatCoordinate, FloatCoordinate>>;
+    // Direct-mapped by leaf offset, holds the projected segments of recently explored leaves
+    static constexpr std::size_t LEAF_CACHE_SIZE = 64;
+    static constexpr std::uint32_t INVALID_LEAF_OFFSET = std::numeric_limits<std::uint32_t>::max();
+    using LeafCache = std::array<std::pair<std::uint32_t, ProjectedSegments>, LEAF_CACHE_SIZE>;
+
+    void ProjectLeafSegments(const TreeIndex &leaf_id, ProjectedSegments &projected_segments) const
+    {
+        BOOST_ASSERT(is_leaf(leaf_id));
+
+        static thread_local std::vector<EdgeDataT> decoded_objects;
+
+        projected_segments.clear();
+        ForEachLeafObject(leaf_id,
+                          decoded_objects,
+                          [&](const std::size_t, const EdgeDataT &current_edge)
+                          {
+                              projected_segments.emplace_back(
+                                  web_mercator::fromWGS84(m_coordinate_list[current_edge.u]),
+                                  web_mercator::fromWGS84(m_coordinate_list[current_edge.v]));
+                          });
+    }
+
+    // Calls callback(index, object) for the objects of a leaf, where index is the position of
+    // the object in m_objects. Packed leaves are decoded into decoded_objects first.
+    template <typename Callback>
+    void ForEachLeafObject(const TreeIndex &leaf_id,
+                           std::vector<EdgeDataT> &decoded_objects,
+                           Callback &&callback) const
+    {
+        BOOST_ASSERT(is_leaf(leaf_id));
+
+        if (m_packed_leaves.empty())
+        {
+            for (const auto i : child_indexes(leaf_id))
+            {
+                callback(i, m_objects[i]);
+            }
+            return;
+        }
+
+        m_packed_leaves.DecodePage(leaf_id.offset, decoded_objects);
+        const std::size_t first_child = std::size_t{leaf_id.offset} * LEAF_NODE_SIZE;
+        BOOST_ASSERT(decoded_objects.size() == child_indexes(leaf_id).size());
+        for (const auto i : irange<std::size_t>(0, decoded_objects.size()))
+        {
+            callback(first_child + i, decoded_objects[i]);
+        }
+    }
+
+    EdgeDataT GetLeafObject(const std::uint32_t index) const
+    {
+        if (m_packed_leaves.empty())
+        {
+            return m_objects[index];
+        }
+        return m_packed_leaves.Decode(index / LEAF_NODE_SIZE, index % LEAF_NODE_SIZE);
+    }
+
+    // project_leaf returns the projected segments of a leaf page, see ProjectLeafSegments
+    template <typename FilterT, typename TerminationT, typename ProjectLeafT>
+    std::vector<CandidateSegment> SearchNearest(const FloatCoordinate &projected_coordinate,
+                                                const FilterT filter,
+                                                const TerminationT terminate,
+                                                const ProjectLeafT &project_leaf) const
     {
         std::vector<CandidateSegment> results;
 
-        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
         Coordinate fixed_projected_coordinate{projected_coordinate};
 
         // we re-use queue for each query to avoid re-allocating memory
@@ -572,6 +737,7 @@ class StaticRTree
                 if (is_leaf(current_tree_index))
                 {
                     ExploreLeafNode(current_tree_index,
+                                    project_leaf(current_tree_index),
                                     fixed_projected_coordinate,
                                     projected_coordinate,
                                     traversal_queue);
@@ -584,10 +750,10 @@ class StaticRTree
             }
             else
             { // current candidate is an actual road segment
-                const auto &edge_data = m_objects[current_query_node.segment_index];
                 // We deliberately make an edge data copy here, we mutate the value below
-                CandidateSegment current_candidate{current_query_node.fixed_projected_coordinate,
-                                                   edge_data};
+                CandidateSegment current_candidate{
+                    current_query_node.fixed_projected_coordinate,
+                    GetLeafObject(current_query_node.segment_index)};
 
                 // to allow returns of no-results if too restrictive filtering, this needs to be
                 // done here even though performance would indicate that we want to stop after
@@ -613,7 +779,6 @@ class StaticRTree
         return results;
     }
 
-  private:
     template <typename Callback>
     void SearchInBox(const Rectangle &search_rectangle, Callback &&callback) const
     {
@@ -626,6 +791,7 @@ class StaticRTree
                 web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.max_lat)))})};
         std::queue<TreeIndex> traversal_queue;
         traversal_queue.push(TreeIndex{});
+        std::vector<EdgeDataT> decoded_objects;
 
         while (!traversal_queue.empty())
         {
@@ -636,30 +802,28 @@ class StaticRTree
             // element array
             if (is_leaf(current_tree_index))
             {
-
-                // Note: irange is [start,finish), so we need to +1 to make sure we visit the
-                // last
-                for (const auto current_child_index : child_indexes(current_tree_index))
-                {
-                    const auto &current_edge = m_objects[current_child_index];
-
-                    // we don't need to project the coordinates here,
-                    // because we use the unprojected rectangle to test against
-                    const Rectangle bbox{std::min(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::max(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::min(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat),
-                                         std::max(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat)};
-
-                    // use the _unprojected_ input rectangle here
-                    if (bbox.Intersects(search_rectangle))
+                ForEachLeafObject(
+                    current_tree_index,
+                    decoded_objects,
+                    [&](const std::size_t, const EdgeDataT &current_edge)
                     {
-                        callback(current_edge);
-                    }
-                }
+                        // we don't need to project the coordinates here,
+                        // because we use the unprojected rectangle to test against
+                        const Rectangle bbox{std::min(m_coordinate_list[current_edge.u].lon,
+                                                      m_coordinate_list[current_edge.v].lon),
+                                             std::max(m_coordinate_list[current_edge.u].lon,
+                                                      m_coordinate_list[current_edge.v].lon),
+                                             std::min(m_coordinate_list[current_edge.u].lat,
+                                                      m_coordinate_list[current_edge.v].lat),
+                                             std::max(m_coordinate_list[current_edge.u].lat,
+                                                      m_coordinate_list[current_edge.v].lat)};
+
+                        // use the _unprojected_ input rectangle here
+                        if (bbox.Intersects(search_rectangle))
+                        {
+                            callback(current_edge);
+                        }
+                    });
             }
             else
             {
@@ -689,6 +853,7 @@ class StaticRTree
      */
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
+                         const ProjectedSegments &projected_segments,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
                          QueueT &traversal_queue) const
@@ -696,12 +861,12 @@ class StaticRTree
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(is_leaf(leaf_id));
 
-        for (const auto i : child_indexes(leaf_id))
+        const auto leaf_children = child_indexes(leaf_id);
+        const auto first_child = *leaf_children.begin();
+        BOOST_ASSERT(projected_segments.size() == leaf_children.size());
+        for (const auto i : leaf_children)
         {
-            const auto &current_edge = m_objects[i];
-
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
+            const auto &[projected_u, projected_v] = projected_segments[i - first_child];
 
             FloatCoordinate projected_nearest;
             std::tie(std::ignore, projected_nearest) =
@@ -738,20 +903,124 @@ class StaticRTree
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(!is_leaf(parent));
 
-        for (const auto child_index : child_indexes(parent))
-        {
-            const auto &child = m_search_tree[child_index];
+        const auto children = child_indexes(parent);
+        const auto first_child = *children.begin();
+        BOOST_ASSERT(children.size() <= BRANCHING_FACTOR);
 
-            const auto squared_lower_bound_to_element =
-                child.minimum_bounding_rectangle.GetMinSquaredDist(
-                    fixed_projected_input_coordinate);
+        std::array<std::uint64_t, BRANCHING_FACTOR> squared_lower_bounds;
+        GetMinSquaredDists(&m_search_tree[first_child],
+                           children.size(),
+                           fixed_projected_input_coordinate,
+                           squared_lower_bounds.data());
 
+        for (const auto child_index : children)
+        {
             traversal_queue.emplace(QueryCandidate{
-                squared_lower_bound_to_element,
+                squared_lower_bounds[child_index - first_child],
                 TreeIndex(parent.level + 1, child_index - m_tree_level_starts[parent.level + 1])});
         }
     }
 
+  public:
+    // Squared distances of the location to the bounding rectangles of consecutive tree nodes,
+    // the same as RectangleInt2D::GetMinSquaredDist. The kernels don't depend on the tree, they
+    // are public to test them against each other.
+    static void GetMinSquaredDistsScalar(const TreeNode *nodes,
+                                         const std::size_t count,
+                                         const Coordinate location,
+                                         std::uint64_t *squared_distances)
+    {
+        for (const auto index : irange<std::size_t>(0, count))
+        {
+            squared_distances[index] =
+                nodes[index].minimum_bounding_rectangle.GetMinSquaredDist(location);
+        }
+    }
+
+#ifdef OSRM_STATIC_RTREE_AVX2
+    // Eight rectangles per iteration: they are transposed in registers into vectors of their
+    // bounds, so that the distance to each rectangle is the distance of the location to the
+    // bounds clamped at zero. Both coordinates of projected locations stay within +-180 degrees,
+    // their differences fit into 32 bit and are squared into 64 bit.
+    __attribute__((target("avx2"))) static void
+    GetMinSquaredDistsAVX2(const TreeNode *nodes,
+                           const std::size_t count,
+                           const Coordinate location,
+                           std::uint64_t *squared_distances)
+    {
+        static_assert(sizeof(TreeNode) == 4 * sizeof(std::int32_t));
+
+        const auto lon = _mm256_set1_epi32(from_alias<std::int32_t>(location.lon));
+        const auto lat = _mm256_set1_epi32(from_alias<std::int32_t>(location.lat));
+        const auto zero = _mm256_setzero_si256();
+
+        std::size_t index = 0;
+        for (; index + 8 <= count; index += 8)
+        {
+            // two rectangles per register, each as min_lon, max_lon, min_lat, max_lat
+            const auto *data = reinterpret_cast<const __m256i *>(nodes + index);
+            const auto rectangles_01 = _mm256_loadu_si256(data);
+            const auto rectangles_23 = _mm256_loadu_si256(data + 1);
+            const auto rectangles_45 = _mm256_loadu_si256(data + 2);
+            const auto rectangles_67 = _mm256_loadu_si256(data + 3);
+
+            // the lanes hold the rectangles 0, 2, 4, 6, 1, 3, 5, 7 from here on
+            const auto lons_0213 = _mm256_unpacklo_epi32(rectangles_01, rectangles_23);
+            const auto lats_0213 = _mm256_unpackhi_epi32(rectangles_01, rectangles_23);
+            const auto lons_4657 = _mm256_unpacklo_epi32(rectangles_45, rectangles_67);
+            const auto lats_4657 = _mm256_unpackhi_epi32(rectangles_45, rectangles_67);
+            const auto min_lon = _mm256_unpacklo_epi64(lons_0213, lons_4657);
+            const auto max_lon = _mm256_unpackhi_epi64(lons_0213, lons_4657);
+            const auto min_lat = _mm256_unpacklo_epi64(lats_0213, lats_4657);
+            const auto max_lat = _mm256_unpackhi_epi64(lats_0213, lats_4657);
+
+            const auto d_lon = _mm256_max_epi32(
+                _mm256_max_epi32(_mm256_sub_epi32(min_lon, lon), _mm256_sub_epi32(lon, max_lon)),
+                zero);
+            const auto d_lat = _mm256_max_epi32(
+                _mm256_max_epi32(_mm256_sub_epi32(min_lat, lat), _mm256_sub_epi32(lat, max_lat)),
+                zero);
+
+            // squares of the even lanes (rectangles 0, 4, 1, 5) and the odd lanes (2, 6, 3, 7)
+            const auto even = _mm256_add_epi64(_mm256_mul_epu32(d_lon, d_lon),
+                                               _mm256_mul_epu32(d_lat, d_lat));
+            const auto d_lon_odd = _mm256_srli_epi64(d_lon, 32);
+            const auto d_lat_odd = _mm256_srli_epi64(d_lat, 32);
+            const auto odd = _mm256_add_epi64(_mm256_mul_epu32(d_lon_odd, d_lon_odd),
+                                              _mm256_mul_epu32(d_lat_odd, d_lat_odd));
+
+            // back to the order of the rectangles: 0, 1, 4, 5 and 2, 3, 6, 7
+            const auto even_ordered = _mm256_permute4x64_epi64(even, 0b11011000);
+            const auto odd_ordered = _mm256_permute4x64_epi64(odd, 0b11011000);
+            auto *output = reinterpret_cast<__m256i *>(squared_distances + index);
+            _mm256_storeu_si256(output, _mm256_permute2x128_si256(even_ordered, odd_ordered, 0x20));
+            _mm256_storeu_si256(output + 1,
+                                _mm256_permute2x128_si256(even_ordered, odd_ordered, 0x31));
+        }
+
+        GetMinSquaredDistsScalar(
+            nodes + index, count - index, location, squared_distances + index);
+    }
+#endif
+
+    // Picks the widest kernel supported by the CPU at runtime
+    static void GetMinSquaredDists(const TreeNode *nodes,
+                                   const std::size_t count,
+                                   const Coordinate location,
+                                   std::uint64_t *squared_distances)
+    {
+#ifdef OSRM_STATIC_RTREE_AVX2
+        static const bool has_avx2 = __builtin_cpu_supports("avx2");
+        if (has_avx2)
+        {
+            GetMinSquaredDistsAVX2(nodes, count, location, squared_distances);
+            return;
+        }
+#endif
+        GetMinSquaredDistsScalar(nodes, count, location, squared_distances);
+    }
+
+  private:
     std::uint64_t GetLevelSize(const std::size_t level) const
     {
         BOOST_ASSERT(m_tree_level_starts.size() > level + 1);
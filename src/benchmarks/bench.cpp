@@ -556,11 +556,14 @@ void runTableBenchmark(const OSRM &osrm, const GPSTraces &gpsTraces, int iterati
     {
         std::string name;
         size_t coordinates;
+        std::optional<size_t> sources = std::nullopt;
     };
 
     std::vector<Benchmark> benchmarks = {{"250 tables, 3 coordinates", 3},
                                          {"250 tables, 25 coordinates", 25},
-                                         {"250 tables, 50 coordinates", 50}};
+                                         {"250 tables, 50 coordinates", 50},
+                                         {"250 tables, 1 source, 500 destinations", 501, 1},
+                                         {"250 tables, 1 source, 2000 destinations", 2001, 1}};
 
     runBenchmarks(benchmarks,
                   iterations,
@@ -581,6 +584,17 @@ void runTableBenchmark(const OSRM &osrm, const GPSTraces &gpsTraces, int iterati
                           params.coordinates.push_back(gpsTraces.getRandomCoordinate());
                       }
 
+                      if (benchmark.sources)
+                      {
+                          for (size_t i = 0; i < benchmark.coordinates; ++i)
+                          {
+                              if (i < *benchmark.sources)
+                                  params.sources.push_back(i);
+                              else
+                                  params.destinations.push_back(i);
+                          }
+                      }
+
                       TIMER_START(table);
                       const auto rc = osrm.Table(params, result);
                       TIMER_STOP(table);
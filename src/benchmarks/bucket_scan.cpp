@@ -0,0 +1,124 @@
+#include "engine/routing_algorithms/bucket_scan.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+struct Table
+{
+    explicit Table(const std::size_t number_of_targets)
+        : weights(number_of_targets, INVALID_EDGE_WEIGHT),
+          durations(number_of_targets, MAXIMAL_EDGE_DURATION),
+          distances(number_of_targets, MAXIMAL_EDGE_DISTANCE),
+          middle_nodes(number_of_targets, SPECIAL_NODEID)
+    {
+    }
+
+    TableRow Row()
+    {
+        return {weights.data(), durations.data(), distances.data(), middle_nodes.data()};
+    }
+
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeDuration> durations;
+    std::vector<EdgeDistance> distances;
+    std::vector<NodeID> middle_nodes;
+};
+} // namespace
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto num_rounds = 20;
+    const auto num_nodes = 20000;
+    const auto num_targets = 1000;
+    const auto max_buckets_per_node = 200;
+
+    // Synthetic buckets of a wide table, every node reaches a random subset of the targets
+    std::mt19937 g(1337);
+    std::uniform_int_distribution<int> number_of_buckets(0, max_buckets_per_node);
+    std::uniform_int_distribution<std::int32_t> weight(0, 100000);
+    std::vector<unsigned> columns(num_targets);
+    std::iota(columns.begin(), columns.end(), 0);
+
+    std::vector<NodeBucket> search_space_with_buckets;
+    for (auto node : util::irange<NodeID>(0, num_nodes))
+    {
+        std::shuffle(columns.begin(), columns.end(), g);
+        const auto count = number_of_buckets(g);
+        for (auto index : util::irange(0, count))
+        {
+            search_space_with_buckets.emplace_back(node,
+                                                   node,
+                                                   columns[index],
+                                                   EdgeWeight{weight(g)},
+                                                   EdgeDuration{weight(g)},
+                                                   EdgeDistance{static_cast<float>(weight(g))});
+        }
+    }
+    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    const BucketArrays buckets(search_space_with_buckets);
+    std::cout << "buckets: " << buckets.nodes.size() << std::endl;
+
+    // Settle the nodes in random order with increasing weights, like a forward search does
+    std::vector<NodeID> nodes(num_nodes);
+    std::iota(nodes.begin(), nodes.end(), 0);
+    std::shuffle(nodes.begin(), nodes.end(), g);
+
+    auto run = [&](Table &table, auto scan)
+    {
+        for (auto round : util::irange(0, num_rounds))
+        {
+            (void)round;
+            table = Table(num_targets);
+            auto row = table.Row();
+            EdgeWeight heap_weight{0};
+            for (const auto node : nodes)
+            {
+                const auto [first, last] = buckets.Find(node);
+                scan(buckets,
+                     first,
+                     last,
+                     heap_weight,
+                     EdgeDuration{from_alias<std::int32_t>(heap_weight)},
+                     EdgeDistance{0},
+                     node,
+                     row);
+                heap_weight += EdgeWeight{5};
+            }
+        }
+    };
+
+    Table scalar_table(num_targets);
+    TIMER_START(scalar);
+    run(scalar_table, scanBucketsScalar);
+    TIMER_STOP(scalar);
+    std::cout << "scalar: " << TIMER_MSEC(scalar) << "ms" << std::endl;
+
+    Table dispatched_table(num_targets);
+    TIMER_START(dispatched);
+    run(dispatched_table, scanBuckets);
+    TIMER_STOP(dispatched);
+    std::cout << "dispatched: " << TIMER_MSEC(dispatched) << "ms" << std::endl;
+
+    if (scalar_table.weights != dispatched_table.weights ||
+        scalar_table.durations != dispatched_table.durations ||
+        scalar_table.distances != dispatched_table.distances ||
+        scalar_table.middle_nodes != dispatched_table.middle_nodes)
+    {
+        std::cout << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,426 @@
+#include "util/log.hpp"
+#include "util/query_heap.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <osmium/geom/haversine.hpp>
+#include <osmium/handler.hpp>
+#include <osmium/io/pbf_input.hpp>
+#include <osmium/visitor.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+struct HeapData
+{
+    NodeID parent;
+};
+
+// Grid graph with random weights, a stand-in for the upward graph of a CH
+struct Graph
+{
+    Graph(const unsigned width, const unsigned height) : width(width), height(height)
+    {
+        std::mt19937 g(1337);
+        std::uniform_int_distribution<int> weight(1, 100);
+        weights.resize(static_cast<std::size_t>(width) * height * 4);
+        for (auto &w : weights)
+            w = weight(g);
+    }
+
+    template <typename Callback> void ForEachEdge(const NodeID node, Callback callback) const
+    {
+        const auto x = node % width;
+        const auto y = node / width;
+        const auto *w = &weights[static_cast<std::size_t>(node) * 4];
+        if (x > 0)
+            callback(node - 1, w[0]);
+        if (x + 1 < width)
+            callback(node + 1, w[1]);
+        if (y > 0)
+            callback(node - width, w[2]);
+        if (y + 1 < height)
+            callback(node + width, w[3]);
+    }
+
+    unsigned NumberOfNodes() const { return width * height; }
+
+    const unsigned width;
+    const unsigned height;
+    std::vector<int> weights;
+};
+
+// Settles a fixed number of nodes, CH searches settle a few hundred to a few thousand nodes
+template <typename Graph, typename Heap>
+std::uint64_t search(const Graph &graph, Heap &heap, const NodeID source, const unsigned settled)
+{
+    heap.Clear();
+    heap.Insert(source, 0, HeapData{source});
+    std::uint64_t checksum = 0;
+    for (unsigned count = 0; count < settled && !heap.Empty(); ++count)
+    {
+        const auto weight = heap.MinKey();
+        const auto node = heap.DeleteMin();
+        checksum += weight;
+        graph.ForEachEdge(node,
+                          [&](const NodeID to, const int edge_weight)
+                          {
+                              const auto to_weight = weight + edge_weight;
+                              const auto *to_node = heap.GetHeapNodeIfWasInserted(to);
+                              if (!to_node)
+                              {
+                                  heap.Insert(to, to_weight, HeapData{node});
+                              }
+                              else if (to_weight < to_node->weight)
+                              {
+                                  heap.GetData(to).parent = node;
+                                  heap.DecreaseKey(to, to_weight);
+                              }
+                          });
+    }
+    return checksum;
+}
+
+template <typename Graph, typename Heap>
+std::uint64_t run(const std::string &name,
+                  const Graph &graph,
+                  Heap &heap,
+                  const std::vector<NodeID> &sources,
+                  const unsigned settled_per_search = 2000)
+{
+    std::uint64_t checksum = 0;
+    TIMER_START(searches);
+    for (const auto source : sources)
+    {
+        checksum += search(graph, heap, source, settled_per_search);
+    }
+    TIMER_STOP(searches);
+    std::cout << name << ": " << TIMER_MSEC(searches) << "ms, "
+              << TIMER_MSEC(searches) * 1000 / sources.size() << "us per search" << std::endl;
+    return checksum;
+}
+
+// Heap operations of a search, recorded once and replayed with every priority queue so that
+// only the cost of the heap is measured
+struct Trace
+{
+    enum class Operation : std::uint8_t
+    {
+        Clear,
+        Insert,
+        DecreaseKey,
+        DeleteMin
+    };
+    struct Step
+    {
+        Operation operation;
+        NodeID node;
+        int weight;
+    };
+
+    std::vector<Step> steps;
+    unsigned number_of_nodes;
+};
+
+template <typename Graph>
+Trace record(const Graph &graph, const std::vector<NodeID> &sources, const unsigned settled)
+{
+    Trace trace{{}, graph.NumberOfNodes()};
+    util::QueryHeap<NodeID, NodeID, int, HeapData, util::GenerationArrayStorage<NodeID, int>>
+        heap(graph.NumberOfNodes());
+    for (const auto source : sources)
+    {
+        heap.Clear();
+        trace.steps.push_back({Trace::Operation::Clear, source, 0});
+        heap.Insert(source, 0, HeapData{source});
+        trace.steps.push_back({Trace::Operation::Insert, source, 0});
+        for (unsigned count = 0; count < settled && !heap.Empty(); ++count)
+        {
+            const auto weight = heap.MinKey();
+            const auto node = heap.DeleteMin();
+            trace.steps.push_back({Trace::Operation::DeleteMin, node, weight});
+            graph.ForEachEdge(node,
+                              [&](const NodeID to, const int edge_weight)
+                              {
+                                  const auto to_weight = weight + edge_weight;
+                                  const auto *to_node = heap.GetHeapNodeIfWasInserted(to);
+                                  if (!to_node)
+                                  {
+                                      heap.Insert(to, to_weight, HeapData{node});
+                                      trace.steps.push_back(
+                                          {Trace::Operation::Insert, to, to_weight});
+                                  }
+                                  else if (to_weight < to_node->weight)
+                                  {
+                                      heap.DecreaseKey(to, to_weight);
+                                      trace.steps.push_back(
+                                          {Trace::Operation::DecreaseKey, to, to_weight});
+                                  }
+                              });
+        }
+    }
+    return trace;
+}
+
+template <template <typename> class PriorityQueue>
+void replay(const std::string &name, const Trace &trace)
+{
+    util::QueryHeap<NodeID,
+                    NodeID,
+                    int,
+                    HeapData,
+                    util::GenerationArrayStorage<NodeID, int>,
+                    PriorityQueue>
+        heap(trace.number_of_nodes);
+
+    // edge weights are positive, so only the order of equal weights can differ
+    std::uint64_t checksum = 0;
+    TIMER_START(replay);
+    for (const auto &step : trace.steps)
+    {
+        switch (step.operation)
+        {
+        case Trace::Operation::Clear:
+            heap.Clear();
+            break;
+        case Trace::Operation::Insert:
+            heap.Insert(step.node, step.weight, HeapData{step.node});
+            break;
+        case Trace::Operation::DecreaseKey:
+            heap.DecreaseKey(step.node, step.weight);
+            break;
+        case Trace::Operation::DeleteMin:
+            checksum += heap.MinKey();
+            heap.DeleteMin();
+            break;
+        }
+    }
+    TIMER_STOP(replay);
+    std::cout << "  " << name << ": " << TIMER_MSEC(replay) << "ms (checksum " << checksum << ")"
+              << std::endl;
+}
+
+// Sparse random graph with shortcuts of varying length, a stand-in for the CH search graph
+struct RandomGraph
+{
+    RandomGraph(const unsigned number_of_nodes, const unsigned degree)
+        : number_of_nodes(number_of_nodes), degree(degree)
+    {
+        std::mt19937 g(1337);
+        std::uniform_int_distribution<NodeID> node(0, number_of_nodes - 1);
+        std::uniform_int_distribution<int> weight(1, 10000);
+        for (unsigned i = 0; i < number_of_nodes * degree; ++i)
+            edges.emplace_back(node(g), weight(g));
+    }
+
+    template <typename Callback> void ForEachEdge(const NodeID node, Callback callback) const
+    {
+        for (auto edge = node * degree; edge < (node + 1) * degree; ++edge)
+            callback(edges[edge].first, edges[edge].second);
+    }
+
+    unsigned NumberOfNodes() const { return number_of_nodes; }
+
+    const unsigned number_of_nodes;
+    const unsigned degree;
+    std::vector<std::pair<NodeID, int>> edges;
+};
+
+// Road network of an OSM extract with car travel times in deciseconds as edge weights, so that
+// the priority queues can be compared on the heap operations of real searches
+struct RoadGraph
+{
+    explicit RoadGraph(const std::string &path)
+    {
+        struct Handler : osmium::handler::Handler
+        {
+            void node(const osmium::Node &node) { locations[node.id()] = node.location(); }
+
+            void way(const osmium::Way &way)
+            {
+                const auto speed = Speed(way.tags()["highway"]);
+                if (speed == 0 || way.nodes().size() < 2)
+                    return;
+                const char *oneway = way.tags().get_value_by_key("oneway", "");
+                const bool forward = std::strcmp(oneway, "-1") != 0;
+                const bool backward = !forward || !(std::strcmp(oneway, "yes") == 0 ||
+                                                    way.tags().has_tag("junction", "roundabout") ||
+                                                    way.tags().has_tag("highway", "motorway"));
+
+                for (std::size_t index = 1; index < way.nodes().size(); ++index)
+                {
+                    const auto from = locations.find(way.nodes()[index - 1].ref());
+                    const auto to = locations.find(way.nodes()[index].ref());
+                    if (from == locations.end() || to == locations.end())
+                        continue;
+                    const auto meters = osmium::geom::haversine::distance(
+                        osmium::geom::Coordinates{from->second},
+                        osmium::geom::Coordinates{to->second});
+                    const auto weight = std::max(1, static_cast<int>(meters * 36. / speed));
+                    const auto from_node = Node(from->first);
+                    const auto to_node = Node(to->first);
+                    if (forward)
+                        edges.emplace_back(from_node, to_node, weight);
+                    if (backward)
+                        edges.emplace_back(to_node, from_node, weight);
+                }
+            }
+
+            // km/h of the car profile on the road classes it uses, 0 for all others
+            static int Speed(const char *highway)
+            {
+                if (!highway)
+                    return 0;
+                const std::string road_class = highway;
+                static const std::unordered_map<std::string, int> speeds = {
+                    {"motorway", 90},
+                    {"trunk", 85},
+                    {"primary", 65},
+                    {"secondary", 55},
+                    {"tertiary", 40},
+                    {"unclassified", 25},
+                    {"residential", 25},
+                    {"living_street", 10},
+                    {"service", 15},
+                    {"motorway_link", 45},
+                    {"trunk_link", 40},
+                    {"primary_link", 30},
+                    {"secondary_link", 25},
+                    {"tertiary_link", 20}};
+                const auto speed = speeds.find(road_class);
+                return speed == speeds.end() ? 0 : speed->second;
+            }
+
+            NodeID Node(const osmium::object_id_type id)
+            {
+                return node_ids.emplace(id, static_cast<NodeID>(node_ids.size())).first->second;
+            }
+
+            std::unordered_map<osmium::object_id_type, osmium::Location> locations;
+            std::unordered_map<osmium::object_id_type, NodeID> node_ids;
+            std::vector<std::tuple<NodeID, NodeID, int>> edges;
+        } handler;
+
+        osmium::io::Reader reader(path,
+                                  osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+        osmium::apply(reader, handler);
+        reader.close();
+
+        number_of_nodes = handler.node_ids.size();
+        std::sort(handler.edges.begin(), handler.edges.end());
+        first_edge.resize(number_of_nodes + 1, 0);
+        for (const auto &edge : handler.edges)
+        {
+            ++first_edge[std::get<0>(edge) + 1];
+            targets.emplace_back(std::get<1>(edge), std::get<2>(edge));
+        }
+        for (std::size_t node = 0; node < number_of_nodes; ++node)
+            first_edge[node + 1] += first_edge[node];
+    }
+
+    template <typename Callback> void ForEachEdge(const NodeID node, Callback callback) const
+    {
+        for (auto edge = first_edge[node]; edge < first_edge[node + 1]; ++edge)
+            callback(targets[edge].first, targets[edge].second);
+    }
+
+    unsigned NumberOfNodes() const { return number_of_nodes; }
+    std::size_t NumberOfEdges() const { return targets.size(); }
+
+    unsigned number_of_nodes;
+    std::vector<std::size_t> first_edge;
+    std::vector<std::pair<NodeID, int>> targets;
+};
+
+void comparePriorityQueues(const std::string &name, const Trace &trace)
+{
+    std::cout << name << " trace, " << trace.steps.size() << " operations" << std::endl;
+    replay<util::BoostDAryHeap>("boost d-ary heap", trace);
+    replay<util::DAryHeap>("4-ary heap", trace);
+    replay<util::RadixHeap>("radix heap", trace);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    if (argc > 1)
+    {
+        // Unbounded searches on a road network, e.g. test/data/monaco.osm.pbf, settle all nodes
+        // like the searches of a small dataset
+        const RoadGraph road_graph(argv[1]);
+        std::cout << argv[1] << ": " << road_graph.NumberOfNodes() << " nodes, "
+                  << road_graph.NumberOfEdges() << " edges" << std::endl;
+
+        const auto num_nodes = road_graph.NumberOfNodes();
+        std::mt19937 g(42);
+        std::uniform_int_distribution<NodeID> node(0, num_nodes - 1);
+        std::vector<NodeID> sources(1000);
+        for (auto &source : sources)
+            source = node(g);
+
+        util::QueryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>
+            map_heap(num_nodes);
+        util::QueryHeap<NodeID, NodeID, int, HeapData, util::GenerationArrayStorage<NodeID, int>>
+            generation_heap(num_nodes);
+        const auto map_checksum = run("unordered map", road_graph, map_heap, sources, num_nodes);
+        const auto generation_checksum =
+            run("generation array", road_graph, generation_heap, sources, num_nodes);
+        if (map_checksum != generation_checksum)
+        {
+            std::cout << "results differ" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        comparePriorityQueues("road network", record(road_graph, sources, num_nodes));
+        return EXIT_SUCCESS;
+    }
+
+    const auto num_searches = 5000;
+    const Graph graph(2048, 2048);
+    const auto num_nodes = graph.NumberOfNodes();
+
+    std::mt19937 g(42);
+    std::uniform_int_distribution<NodeID> node(0, num_nodes - 1);
+    std::vector<NodeID> sources(num_searches);
+    for (auto &source : sources)
+        source = node(g);
+
+    util::QueryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>
+        map_heap(num_nodes);
+    util::QueryHeap<NodeID, NodeID, int, HeapData, util::ArrayStorage<NodeID, int>> array_heap(
+        num_nodes);
+    util::QueryHeap<NodeID, NodeID, int, HeapData, util::GenerationArrayStorage<NodeID, int>>
+        generation_heap(num_nodes);
+
+    const auto map_checksum = run("unordered map", graph, map_heap, sources);
+    const auto array_checksum = run("array", graph, array_heap, sources);
+    const auto generation_checksum = run("generation array", graph, generation_heap, sources);
+
+    if (map_checksum != array_checksum || map_checksum != generation_checksum)
+    {
+        std::cout << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // CH searches settle few nodes with many edges, MLD searches settle more nodes of the
+    // cells with a road-like degree
+    const RandomGraph random_graph(num_nodes, 8);
+    comparePriorityQueues("CH-like", record(random_graph, sources, 500));
+    const std::vector<NodeID> mld_sources(sources.begin(), sources.begin() + num_searches / 10);
+    comparePriorityQueues("MLD-like", record(graph, mld_sources, 20000));
+}
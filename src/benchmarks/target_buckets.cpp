@@ -0,0 +1,191 @@
+#include "engine/routing_algorithms/target_buckets.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+// Compares the lookups of the targets of the MLD one-to-many search: the hash multimap that was
+// used before, a plain binary search in the sorted array and the TargetBuckets of the search.
+// Every settled node of the search looks up its targets, reached targets are erased or flagged.
+namespace
+{
+struct Query
+{
+    // two segments per target like the forward and reverse segment of a phantom node
+    std::vector<NodeID> target_nodes;
+    std::vector<NodeID> settled_nodes;
+};
+
+std::vector<Query> makeQueries(const std::size_t number_of_queries,
+                               const std::size_t number_of_targets,
+                               const std::size_t number_of_settled_nodes)
+{
+    std::mt19937 g(1337);
+    std::uniform_int_distribution<NodeID> node(0, 10 * number_of_settled_nodes);
+    std::vector<Query> queries(number_of_queries);
+    for (auto &query : queries)
+    {
+        for (auto index : util::irange<std::size_t>(0, number_of_targets))
+        {
+            (void)index;
+            const auto target = node(g);
+            query.target_nodes.push_back(target);
+            query.target_nodes.push_back(target + 1);
+        }
+        query.settled_nodes = query.target_nodes;
+        while (query.settled_nodes.size() < number_of_settled_nodes)
+        {
+            query.settled_nodes.push_back(node(g));
+        }
+        std::shuffle(query.settled_nodes.begin(), query.settled_nodes.end(), g);
+    }
+    return queries;
+}
+
+EdgeWeight runMultimap(const std::vector<Query> &queries)
+{
+    EdgeWeight checksum{0};
+    for (const auto &query : queries)
+    {
+        std::unordered_multimap<NodeID, std::tuple<std::size_t, EdgeWeight>> target_nodes_index;
+        target_nodes_index.reserve(query.target_nodes.size());
+        for (const auto index : util::irange<std::size_t>(0, query.target_nodes.size()))
+        {
+            target_nodes_index.insert(
+                {query.target_nodes[index], std::make_tuple(index / 2, EdgeWeight{1})});
+        }
+
+        for (const auto node : query.settled_nodes)
+        {
+            if (target_nodes_index.empty())
+                break;
+            auto candidates = target_nodes_index.equal_range(node);
+            for (auto it = candidates.first; it != candidates.second;)
+            {
+                checksum += std::get<1>(it->second);
+                it = target_nodes_index.erase(it);
+            }
+        }
+    }
+    return checksum;
+}
+
+std::vector<TargetBucket> makeBuckets(const Query &query)
+{
+    std::vector<TargetBucket> target_buckets;
+    target_buckets.reserve(query.target_nodes.size());
+    for (const auto index : util::irange<std::size_t>(0, query.target_nodes.size()))
+    {
+        target_buckets.push_back({query.target_nodes[index],
+                                  static_cast<std::uint32_t>(index / 2),
+                                  {1},
+                                  {1},
+                                  {1}});
+    }
+    return target_buckets;
+}
+
+EdgeWeight runBinarySearch(const std::vector<Query> &queries)
+{
+    EdgeWeight checksum{0};
+    for (const auto &query : queries)
+    {
+        auto target_buckets = makeBuckets(query);
+        std::sort(target_buckets.begin(), target_buckets.end());
+        auto number_of_pending_buckets = target_buckets.size();
+
+        for (const auto node : query.settled_nodes)
+        {
+            if (number_of_pending_buckets == 0)
+                break;
+            const auto buckets = std::equal_range(
+                target_buckets.begin(), target_buckets.end(), node, TargetBucket::Compare());
+            for (auto bucket = buckets.first; bucket != buckets.second; ++bucket)
+            {
+                if (bucket->reached)
+                    continue;
+                checksum += bucket->weight;
+                bucket->reached = true;
+                --number_of_pending_buckets;
+            }
+        }
+    }
+    return checksum;
+}
+
+EdgeWeight runTargetBuckets(const std::vector<Query> &queries)
+{
+    EdgeWeight checksum{0};
+    for (const auto &query : queries)
+    {
+        TargetBuckets target_buckets(makeBuckets(query));
+
+        for (const auto node : query.settled_nodes)
+        {
+            if (target_buckets.NumberOfPendingBuckets() == 0)
+                break;
+            for (auto &bucket : target_buckets.Find(node))
+            {
+                if (bucket.reached)
+                    continue;
+                checksum += bucket.weight;
+                target_buckets.MarkReached(bucket);
+            }
+        }
+    }
+    return checksum;
+}
+} // namespace
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto num_queries = 250;
+    const auto num_settled_nodes = 100000;
+
+    for (const auto num_targets : {500, 2000})
+    {
+        const auto queries = makeQueries(num_queries, num_targets, num_settled_nodes);
+
+        TIMER_START(multimap);
+        const auto multimap_checksum = runMultimap(queries);
+        TIMER_STOP(multimap);
+
+        TIMER_START(binary_search);
+        const auto binary_search_checksum = runBinarySearch(queries);
+        TIMER_STOP(binary_search);
+
+        TIMER_START(target_buckets);
+        const auto target_buckets_checksum = runTargetBuckets(queries);
+        TIMER_STOP(target_buckets);
+
+        std::cout << num_queries << " queries, 1 source, " << num_targets << " destinations"
+                  << std::endl;
+        std::cout << "  unordered_multimap: " << TIMER_MSEC(multimap) / num_queries
+                  << "ms/query" << std::endl;
+        std::cout << "  binary search: " << TIMER_MSEC(binary_search) / num_queries
+                  << "ms/query" << std::endl;
+        std::cout << "  filtered binary search: " << TIMER_MSEC(target_buckets) / num_queries
+                  << "ms/query" << std::endl;
+
+        if (multimap_checksum != binary_search_checksum ||
+            multimap_checksum != target_buckets_checksum)
+        {
+            std::cout << "results differ" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+}
@@ -1,4 +1,11 @@
 #include "engine/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <istream>
+#include <string>
 
 namespace osrm::engine
 {
@@ -18,10 +25,34 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              unlimited_or_more_than(default_radius, 0) && max_alternatives >= 0;
+                              unlimited_or_more_than(max_pairs_batch_route, 0) &&
+                              unlimited_or_more_than(max_traces_batch_match, 0) &&
+                              unlimited_or_more_than(default_radius, 0) && max_alternatives >= 0 &&
+                              max_table_bucket_cache_size >= 0 &&
+                              max_shortcut_cache_size >= 0 && max_clique_arc_cache_size >= 0 &&
+                              max_matching_sessions_size >= 0 && matching_session_ttl > 0 &&
+                              unlimited_or_more_than(min_destinations_rphast_table, 0) &&
+                              max_heap_memory_per_thread >= -1 &&
+                              unlimited_or_more_than(max_request_time, 0) &&
+                              trip_local_search_time >= 0;
 
     return ((use_shared_memory && all_path_are_empty) || (use_mmap && storage_config.IsValid()) ||
             storage_config.IsValid()) &&
            limits_valid;
 }
+
+std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
+{
+    std::string token;
+    in >> token;
+    boost::to_lower(token);
+
+    if (token == "ch")
+        algorithm = EngineConfig::Algorithm::CH;
+    else if (token == "mld")
+        algorithm = EngineConfig::Algorithm::MLD;
+    else
+        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
+    return in;
+}
 } // namespace osrm::engine
@@ -0,0 +1,199 @@
+#include "engine/plugins/batch_match.hpp"
+
+#include "engine/api/batch_match_parameters.hpp"
+#include "engine/request_deadline.hpp"
+#include "engine/routing_algorithms.hpp"
+#include "engine/status.hpp"
+
+#include "util/exception.hpp"
+#include "util/json_renderer.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_pipeline.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace osrm::engine::plugins
+{
+
+namespace
+{
+// rendered traces are collected and handed out in chunks of about this size
+const constexpr std::size_t STREAM_CHUNK_SIZE = 64 * 1024;
+} // namespace
+
+BatchMatchPlugin::BatchMatchPlugin(const int max_traces_batch_match,
+                                   const int max_locations_map_matching,
+                                   const double max_radius_map_matching,
+                                   const std::optional<double> default_radius)
+    : BasePlugin(default_radius), max_traces_batch_match(max_traces_batch_match),
+      match_plugin(max_locations_map_matching, max_radius_map_matching, default_radius)
+{
+}
+
+// A trace that fails has its error in place of the matching, the other traces are still matched.
+// This also holds for traces that run out of time: the ones that were done before the deadline
+// are returned, the remaining ones fail with a Timeout error. Other exceptions are returned as an
+// InternalError of the trace.
+util::json::Value BatchMatchPlugin::MatchTrace(const RoutingAlgorithmsInterface &algorithms,
+                                               const api::MatchParameters &trace) const
+{
+    osrm::engine::api::ResultT trace_result = util::json::Object();
+    try
+    {
+        RequestDeadline::CheckNow();
+        match_plugin.HandleRequest(algorithms, trace, trace_result);
+    }
+    catch (const util::TimeoutException &exception)
+    {
+        trace_result = util::json::Object();
+        std::visit(ErrorRenderer("Timeout", exception.what()), trace_result);
+    }
+    catch (const std::exception &exception)
+    {
+        util::Log(logWARNING) << "Batch match trace failed: " << exception.what();
+        trace_result = util::json::Object();
+        std::visit(ErrorRenderer("InternalError", exception.what()), trace_result);
+    }
+    // the heaps of the worker outlive the request, the engine only releases the request thread
+    algorithms.ReleaseHeapMemory();
+
+    // the data version is only returned once for the whole batch
+    auto &trace_object = std::get<util::json::Object>(trace_result);
+    trace_object.values.erase("data_version");
+    return std::move(trace_object);
+}
+
+Status BatchMatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                       const api::BatchMatchParameters &params,
+                                       osrm::engine::api::ResultT &result,
+                                       const osrm::engine::api::ResultStream &stream) const
+{
+    BOOST_ASSERT(params.IsValid());
+
+    if (!algorithms.HasMapMatching())
+    {
+        return Error("NotImplemented",
+                     "Map matching is not implemented for the chosen search algorithm.",
+                     result);
+    }
+
+    const auto number_of_traces = params.NumberOfTraces();
+    if (max_traces_batch_match > 0 &&
+        number_of_traces > static_cast<std::size_t>(max_traces_batch_match))
+    {
+        return Error("TooBig",
+                     "Number of traces " + std::to_string(number_of_traces) +
+                         " is higher than current maximum (" +
+                         std::to_string(max_traces_batch_match) + ")",
+                     result);
+    }
+
+    if (!std::holds_alternative<util::json::Object>(result))
+    {
+        return Error("InvalidOptions", "The batch match service only supports json.", result);
+    }
+
+    if (!CheckAlgorithms(params, algorithms, result))
+        return Status::Error;
+
+    TIMER_START(batch_match);
+    const auto traces = params.SplitTraces();
+    const auto data_timestamp = algorithms.GetFacade().GetTimestamp();
+
+    std::string buffer;
+    util::json::Renderer renderer(buffer);
+    util::json::Array matched_traces;
+    if (stream)
+    {
+        buffer += "{\"code\":\"Ok\"";
+        if (!data_timestamp.empty())
+        {
+            buffer += ",\"data_version\":";
+            renderer(util::json::String(data_timestamp));
+        }
+        buffer += ",\"traces\":[";
+    }
+    else
+    {
+        matched_traces.values.reserve(number_of_traces);
+    }
+
+    // The traces are matched in parallel and handed to the output in order. The number of tokens
+    // bounds the matchings that wait for an earlier trace, so a streamed response never holds
+    // more than a few matchings per thread. The heaps of the searches are thread-local.
+    const auto request_deadline = RequestDeadline::Current();
+    std::size_t next_trace_index = 0;
+    tbb::filter<void, std::size_t> next_trace(
+        tbb::filter_mode::serial_in_order,
+        [&](tbb::flow_control &control) -> std::size_t
+        {
+            if (next_trace_index == number_of_traces)
+            {
+                control.stop();
+                return 0;
+            }
+            return next_trace_index++;
+        });
+    tbb::filter<std::size_t, util::json::Value> match_trace(
+        tbb::filter_mode::parallel,
+        [&](const std::size_t trace_index)
+        {
+            const RequestDeadline request_deadline_scope(request_deadline);
+            return MatchTrace(algorithms, traces[trace_index]);
+        });
+    std::size_t number_of_written_traces = 0;
+    tbb::filter<util::json::Value, void> write_trace(
+        tbb::filter_mode::serial_in_order,
+        [&](util::json::Value matching)
+        {
+            if (!stream)
+            {
+                matched_traces.values.push_back(std::move(matching));
+                return;
+            }
+
+            if (number_of_written_traces++ > 0)
+                buffer += ',';
+            std::visit(renderer, matching);
+            if (buffer.size() >= STREAM_CHUNK_SIZE)
+            {
+                stream(buffer);
+                buffer.clear();
+            }
+        });
+    arena.execute(
+        [&]
+        {
+            tbb::parallel_pipeline(2 * tbb::this_task_arena::max_concurrency(),
+                                   next_trace & match_trace & write_trace);
+        });
+    TIMER_STOP(batch_match);
+
+    const auto elapsed_seconds = TIMER_SEC(batch_match);
+    util::Log(logDEBUG) << "Matched " << number_of_traces << " traces in " << elapsed_seconds
+                        << "s (" << (elapsed_seconds > 0 ? number_of_traces / elapsed_seconds : 0.)
+                        << " traces/s)";
+
+    if (stream)
+    {
+        buffer += "]}";
+        stream(buffer);
+        return Status::Ok;
+    }
+
+    auto &json_result = std::get<util::json::Object>(result);
+    json_result.values["code"] = "Ok";
+    if (!data_timestamp.empty())
+    {
+        json_result.values["data_version"] = data_timestamp;
+    }
+    json_result.values["traces"] = std::move(matched_traces);
+    return Status::Ok;
+}
+} // namespace osrm::engine::plugins
@@ -0,0 +1,173 @@
+#include "engine/plugins/batch_route.hpp"
+
+#include "engine/api/batch_route_api.hpp"
+#include "engine/api/batch_route_parameters.hpp"
+#include "engine/request_deadline.hpp"
+#include "engine/routing_algorithms.hpp"
+#include "engine/status.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm::engine::plugins
+{
+
+namespace
+{
+// Coordinates are snapped to the same phantom nodes if their location and snapping options are
+// the same. Hints are not compared, coordinates with hints are always snapped on their own.
+bool haveSameSnapping(const api::BaseParameters &params,
+                      const std::size_t lhs,
+                      const std::size_t rhs)
+{
+    return params.coordinates[lhs] == params.coordinates[rhs] &&
+           (params.hints.empty() || (!params.hints[lhs] && !params.hints[rhs])) &&
+           (params.radiuses.empty() || params.radiuses[lhs] == params.radiuses[rhs]) &&
+           (params.bearings.empty() || params.bearings[lhs] == params.bearings[rhs]) &&
+           (params.approaches.empty() || params.approaches[lhs] == params.approaches[rhs]);
+}
+} // namespace
+
+BatchRoutePlugin::BatchRoutePlugin(const int max_pairs_batch_route,
+                                   const std::optional<double> default_radius)
+    : BasePlugin(default_radius), max_pairs_batch_route(max_pairs_batch_route)
+{
+}
+
+Status BatchRoutePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                       const api::BatchRouteParameters &params,
+                                       osrm::engine::api::ResultT &result) const
+{
+    BOOST_ASSERT(params.IsValid());
+
+    if (!algorithms.HasDirectShortestPathSearch())
+    {
+        return Error(
+            "NotImplemented",
+            "Direct shortest path search is not implemented for the chosen search algorithm.",
+            result);
+    }
+
+    const auto number_of_pairs = params.NumberOfPairs();
+    if (max_pairs_batch_route > 0 &&
+        number_of_pairs > static_cast<std::size_t>(max_pairs_batch_route))
+    {
+        return Error("TooBig",
+                     "Number of pairs " + std::to_string(number_of_pairs) +
+                         " is higher than current maximum (" +
+                         std::to_string(max_pairs_batch_route) + ")",
+                     result);
+    }
+
+    if (!CheckAllCoordinates(params.coordinates))
+    {
+        return Error("InvalidValue", "Invalid coordinate value.", result);
+    }
+
+    if (!CheckAlgorithms(params, algorithms, result))
+        return Status::Error;
+
+    // Snap every location only once, even if it is used by many pairs
+    std::vector<std::size_t> unique_indices(params.coordinates.size());
+    std::vector<std::size_t> first_coordinates;
+    api::BaseParameters unique_params = params;
+    unique_params.coordinates.clear();
+    unique_params.hints.clear();
+    unique_params.radiuses.clear();
+    unique_params.bearings.clear();
+    unique_params.approaches.clear();
+    {
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> unique_by_location;
+        for (const auto index : util::irange<std::size_t>(0UL, params.coordinates.size()))
+        {
+            const auto &coordinate = params.coordinates[index];
+            const auto location =
+                (static_cast<std::uint64_t>(from_alias<std::uint32_t>(coordinate.lon)) << 32) |
+                from_alias<std::uint32_t>(coordinate.lat);
+
+            auto &candidates = unique_by_location[location];
+            const auto duplicate =
+                std::find_if(candidates.begin(),
+                             candidates.end(),
+                             [&](const std::size_t unique_index) {
+                                 return haveSameSnapping(
+                                     params, first_coordinates[unique_index], index);
+                             });
+            if (duplicate != candidates.end())
+            {
+                unique_indices[index] = *duplicate;
+                continue;
+            }
+
+            unique_indices[index] = first_coordinates.size();
+            candidates.push_back(first_coordinates.size());
+            first_coordinates.push_back(index);
+
+            unique_params.coordinates.push_back(coordinate);
+            if (!params.hints.empty())
+                unique_params.hints.push_back(params.hints[index]);
+            if (!params.radiuses.empty())
+                unique_params.radiuses.push_back(params.radiuses[index]);
+            if (!params.bearings.empty())
+                unique_params.bearings.push_back(params.bearings[index]);
+            if (!params.approaches.empty())
+                unique_params.approaches.push_back(params.approaches[index]);
+        }
+    }
+
+    const auto &facade = algorithms.GetFacade();
+    auto phantom_node_pairs = GetPhantomNodes(facade, unique_params);
+    if (phantom_node_pairs.size() != unique_params.coordinates.size())
+    {
+        const auto missing_index = std::distance(
+            phantom_node_pairs.begin(),
+            std::find_if(phantom_node_pairs.begin(),
+                         phantom_node_pairs.end(),
+                         [](const auto &alternatives) { return alternatives.first.empty(); }));
+        return Error("NoSegment",
+                     std::string("Could not find a matching segment for coordinate ") +
+                         std::to_string(first_coordinates[missing_index]),
+                     result);
+    }
+    const auto snapped_phantoms = SnapPhantomNodes(std::move(phantom_node_pairs));
+
+    api::BatchRouteAPI batch_route_api{facade, params};
+
+    // Every pair only writes its own route, the heaps of the searches are thread-local
+    std::vector<util::json::Value> routes(number_of_pairs);
+    const auto request_deadline = RequestDeadline::Current();
+    arena.execute(
+        [&]
+        {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, number_of_pairs),
+                [&](const tbb::blocked_range<std::size_t> &range)
+                {
+                    const RequestDeadline request_deadline_scope(request_deadline);
+                    for (auto pair_index = range.begin(); pair_index != range.end(); ++pair_index)
+                    {
+                        const auto [source, target] = params.GetPair(pair_index);
+                        const auto route = algorithms.DirectShortestPathSearch(
+                            {snapped_phantoms[unique_indices[source]],
+                             snapped_phantoms[unique_indices[target]]});
+                        routes[pair_index] = batch_route_api.MakeRoute(route);
+                    }
+                });
+        });
+
+    auto &json_result = std::get<util::json::Object>(result);
+    batch_route_api.MakeResponse(std::move(routes), snapped_phantoms, unique_indices, json_result);
+
+    return Status::Ok;
+}
+} // namespace osrm::engine::plugins
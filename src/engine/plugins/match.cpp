@@ -102,9 +102,73 @@ void filterCandidates(const std::vector<util::Coordinate> &coordinates,
     }
 }
 
+// Routes along the matched candidates of a sub matching
+InternalRouteResult routeSubMatching(const RoutingAlgorithmsInterface &algorithms,
+                                     const map_matching::SubMatching &sub_matching)
+{
+    BOOST_ASSERT(sub_matching.nodes.size() > 1);
+    BOOST_ASSERT(std::all_of(sub_matching.nodes.begin(),
+                             sub_matching.nodes.end(),
+                             [](const auto &phantom) { return phantom.IsValid(); }));
+
+    // FIXME we only run this to obtain the geometry
+    // The clean way would be to get this directly from the map matching plugin
+    std::vector<PhantomNodeCandidates> waypoint_candidates;
+    waypoint_candidates.reserve(sub_matching.nodes.size());
+    std::transform(sub_matching.nodes.begin(),
+                   sub_matching.nodes.end(),
+                   std::back_inserter(waypoint_candidates),
+                   [](const auto &phantom) { return PhantomNodeCandidates{phantom}; });
+
+    // force uturns to be on
+    // we split the phantom nodes anyway and only have bi-directional phantom nodes for
+    // possible uturns
+    auto route = algorithms.ShortestPathSearch(waypoint_candidates, {false}, false);
+    BOOST_ASSERT(route.shortest_path_weight != INVALID_EDGE_WEIGHT);
+    return route;
+}
+
+std::vector<double> MatchPlugin::GetSearchRadiuses(const api::MatchParameters &parameters) const
+{
+    // assuming radius is the standard deviation of a normal distribution
+    // that models GPS noise (in this model), x3 should give us the correct
+    // search radius with > 99% confidence
+    std::vector<double> search_radiuses;
+    if (parameters.radiuses.empty())
+    {
+        search_radiuses.resize(parameters.coordinates.size(),
+                               default_radius.has_value() && *default_radius != -1.0
+                                   ? *default_radius
+                                   : routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER);
+    }
+    else
+    {
+        search_radiuses.resize(parameters.coordinates.size());
+        std::transform(
+            parameters.radiuses.begin(),
+            parameters.radiuses.end(),
+            search_radiuses.begin(),
+            [default_radius = this->default_radius](const std::optional<double> &maybe_radius)
+            {
+                if (maybe_radius)
+                {
+                    return *maybe_radius * RADIUS_MULTIPLIER;
+                }
+                else
+                {
+                    return default_radius.has_value() && *default_radius != -1.0
+                               ? *default_radius
+                               : routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER;
+                }
+            });
+    }
+    return search_radiuses;
+}
+
 Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::MatchParameters &parameters,
-                                  osrm::engine::api::ResultT &result) const
+                                  osrm::engine::api::ResultT &result,
+                                  const map_matching::MatchingSessionsHandle &sessions) const
 {
     if (!algorithms.HasMapMatching())
     {
@@ -154,6 +218,11 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         return Error("InvalidValue", "Timestamps need to be monotonically increasing.", result);
     }
 
+    if (parameters.session)
+    {
+        return HandleSessionRequest(algorithms, parameters, result, sessions);
+    }
+
     SubMatchingList sub_matchings;
     api::tidy::Result tidied;
     if (parameters.tidy)
@@ -176,38 +245,7 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
             "InvalidValue", "First and last coordinates must be specified as waypoints.", result);
     }
 
-    // assuming radius is the standard deviation of a normal distribution
-    // that models GPS noise (in this model), x3 should give us the correct
-    // search radius with > 99% confidence
-    std::vector<double> search_radiuses;
-    if (tidied.parameters.radiuses.empty())
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size(),
-                               default_radius.has_value() && *default_radius != -1.0
-                                   ? *default_radius
-                                   : routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER);
-    }
-    else
-    {
-        search_radiuses.resize(tidied.parameters.coordinates.size());
-        std::transform(
-            tidied.parameters.radiuses.begin(),
-            tidied.parameters.radiuses.end(),
-            search_radiuses.begin(),
-            [default_radius = this->default_radius](const std::optional<double> &maybe_radius)
-            {
-                if (maybe_radius)
-                {
-                    return *maybe_radius * RADIUS_MULTIPLIER;
-                }
-                else
-                {
-                    return default_radius.has_value() && *default_radius != -1.0
-                               ? *default_radius
-                               : routing_algorithms::DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER;
-                }
-            });
-    }
+    const auto search_radiuses = GetSearchRadiuses(tidied.parameters);
 
     auto candidates_lists =
         GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses, true);
@@ -266,31 +304,7 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
     for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
     {
-        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
-
-        // FIXME we only run this to obtain the geometry
-        // The clean way would be to get this directly from the map matching plugin
-        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
-        {
-            PhantomEndpoints current_endpoints{sub_matchings[index].nodes[i],
-                                               sub_matchings[index].nodes[i + 1]};
-            BOOST_ASSERT(current_endpoints.source_phantom.IsValid());
-            BOOST_ASSERT(current_endpoints.target_phantom.IsValid());
-            sub_routes[index].leg_endpoints.push_back(current_endpoints);
-        }
-
-        std::vector<PhantomNodeCandidates> waypoint_candidates;
-        waypoint_candidates.reserve(sub_matchings[index].nodes.size());
-        std::transform(sub_matchings[index].nodes.begin(),
-                       sub_matchings[index].nodes.end(),
-                       std::back_inserter(waypoint_candidates),
-                       [](const auto &phantom) { return PhantomNodeCandidates{phantom}; });
-
-        // force uturns to be on
-        // we split the phantom nodes anyway and only have bi-directional phantom nodes for
-        // possible uturns
-        sub_routes[index] = algorithms.ShortestPathSearch(waypoint_candidates, {false});
-        BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
+        sub_routes[index] = routeSubMatching(algorithms, sub_matchings[index]);
         if (collapse_legs)
         {
             std::vector<bool> waypoint_legs;
@@ -317,4 +331,130 @@ Status MatchPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     return Status::Ok;
 }
+
+// Adds the coordinates to the trace of a matching session and returns the points that are final
+Status MatchPlugin::HandleSessionRequest(const RoutingAlgorithmsInterface &algorithms,
+                                         const api::MatchParameters &parameters,
+                                         osrm::engine::api::ResultT &result,
+                                         const map_matching::MatchingSessionsHandle &sessions) const
+{
+    BOOST_ASSERT(parameters.session);
+
+    if (!sessions)
+    {
+        return Error("InvalidOptions", "Matching sessions are not enabled.", result);
+    }
+
+    if (!parameters.waypoints.empty() || parameters.tidy)
+    {
+        return Error("InvalidOptions",
+                     "The waypoints and tidy parameters are not supported for matching sessions.",
+                     result);
+    }
+
+    // repeated points are only recognized by their timestamps
+    if (parameters.timestamps.empty())
+    {
+        return Error("InvalidOptions", "Matching sessions require timestamps.", result);
+    }
+
+    const auto &facade = algorithms.GetFacade();
+    const auto session = sessions.sessions->Get(*parameters.session, sessions.generation);
+    std::lock_guard<std::mutex> lock(session->mutex);
+
+    // The request works on a copy of the state that replaces the one of the session once the
+    // response is complete. A request that times out leaves the session as it was, so it can be
+    // retried with the same points.
+    auto state = session->state;
+    // the candidates of the state don't fit to other metrics or exclude classes
+    if (session->facade != &facade)
+    {
+        state = map_matching::MatchingState{};
+    }
+
+    // points that were sent before are skipped, e.g. if a request is repeated
+    std::vector<std::size_t> new_points;
+    for (const auto index : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+    {
+        if (!state.last_timestamp || parameters.timestamps[index] > *state.last_timestamp)
+        {
+            new_points.push_back(index);
+        }
+    }
+
+    api::MatchParameters new_parameters = parameters;
+    const auto select = [&new_points](auto &values)
+    {
+        if (values.empty())
+        {
+            return;
+        }
+        std::remove_reference_t<decltype(values)> selected;
+        selected.reserve(new_points.size());
+        for (const auto index : new_points)
+        {
+            selected.push_back(values[index]);
+        }
+        values = std::move(selected);
+    };
+    select(new_parameters.coordinates);
+    select(new_parameters.hints);
+    select(new_parameters.radiuses);
+    select(new_parameters.bearings);
+    select(new_parameters.approaches);
+    select(new_parameters.timestamps);
+
+    auto candidates_lists = GetPhantomNodesInRange(
+        facade, new_parameters, GetSearchRadiuses(new_parameters), true);
+    filterCandidates(new_parameters.coordinates, candidates_lists);
+
+    std::vector<map_matching::TracePoint> trace_points;
+    trace_points.reserve(new_points.size());
+    for (const auto index : util::irange<std::size_t>(0UL, new_points.size()))
+    {
+        trace_points.push_back(map_matching::TracePoint{
+            new_parameters.coordinates[index],
+            new_parameters.timestamps[index],
+            new_parameters.radiuses.empty() ? std::nullopt : new_parameters.radiuses[index]});
+    }
+
+    auto finalized =
+        algorithms.IncrementalMapMatching(state,
+                                          candidates_lists,
+                                          trace_points,
+                                          parameters.gaps == api::MatchParameters::GapsType::Split);
+
+    // the response describes the finalized points instead of the coordinates of the request
+    api::MatchParameters response_parameters = parameters;
+    response_parameters.coordinates.clear();
+    response_parameters.timestamps.clear();
+    response_parameters.radiuses.clear();
+    response_parameters.hints.clear();
+    response_parameters.bearings.clear();
+    response_parameters.approaches.clear();
+    for (const auto &point : finalized.points)
+    {
+        response_parameters.coordinates.push_back(point.coordinate);
+        response_parameters.radiuses.push_back(point.gps_precision);
+        response_parameters.timestamps.push_back(point.timestamp);
+    }
+    const auto tidied = api::tidy::keep_all(response_parameters);
+
+    std::vector<InternalRouteResult> sub_routes;
+    sub_routes.reserve(finalized.sub_matchings.size());
+    for (const auto &sub_matching : finalized.sub_matchings)
+    {
+        sub_routes.push_back(routeSubMatching(algorithms, sub_matching));
+    }
+
+    api::MatchAPI match_api{facade, response_parameters, tidied};
+    match_api.MakeResponse(finalized.sub_matchings, sub_routes, result);
+
+    const auto state_size_in_bytes = state.GetSizeInBytes();
+    session->state = std::move(state);
+    session->facade = &facade;
+    sessions.sessions->Update(*parameters.session, session, state_size_in_bytes);
+
+    return Status::Ok;
+}
 } // namespace osrm::engine::plugins
@@ -5,6 +5,7 @@
 #include "util/coordinate_calculation.hpp"
 #include "util/string_util.hpp"
 
+#include <cmath>
 #include <cstdlib>
 
 #include <vector>
@@ -15,14 +16,25 @@ namespace osrm::engine::plugins
 {
 
 TablePlugin::TablePlugin(const int max_locations_distance_table,
-                         const std::optional<double> default_radius)
-    : BasePlugin(default_radius), max_locations_distance_table(max_locations_distance_table)
+                         const std::optional<double> default_radius,
+                         const bool use_parallel_search,
+                         const int min_destinations_rphast)
+    : BasePlugin(default_radius), max_locations_distance_table(max_locations_distance_table),
+      use_parallel_search(use_parallel_search), min_destinations_rphast(min_destinations_rphast)
 {
 }
 
 Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
                                   osrm::engine::api::ResultT &result) const
+{
+    return HandleRequest(algorithms, params, result, {});
+}
+
+Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
+                                  const api::TableParameters &params,
+                                  osrm::engine::api::ResultT &result,
+                                  const osrm::engine::api::ResultStream &stream) const
 {
     if (!algorithms.HasManyToManySearch())
     {
@@ -75,8 +87,38 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     bool request_distance = params.annotations & api::TableParameters::AnnotationsType::Distance;
     bool request_duration = params.annotations & api::TableParameters::AnnotationsType::Duration;
 
-    auto result_tables_pair = algorithms.ManyToManySearch(
-        snapped_phantoms, params.sources, params.destinations, request_distance);
+    // The duration limit applies to the scaled durations
+    routing_algorithms::TableLimits limits;
+    if (params.max_duration)
+    {
+        const auto max_duration = std::floor(*params.max_duration * 10. / params.scale_factor);
+        if (max_duration < from_alias<double>(MAXIMAL_EDGE_DURATION))
+        {
+            limits.max_duration = to_alias<EdgeDuration>(max_duration);
+        }
+    }
+    if (params.max_distance)
+    {
+        limits.max_distance = to_alias<EdgeDistance>(*params.max_distance);
+    }
+
+    // Tables with very many destinations are faster with linear sweeps than with bucket scans,
+    // unless the searches are bounded
+    const bool use_rphast = algorithms.HasRPHASTSearch() && min_destinations_rphast > 0 &&
+                            num_destinations >= static_cast<std::size_t>(min_destinations_rphast) &&
+                            !limits.IsBounded();
+
+    auto result_tables_pair = use_rphast ? algorithms.RPHASTSearch(snapped_phantoms,
+                                                                   params.sources,
+                                                                   params.destinations,
+                                                                   request_distance,
+                                                                   use_parallel_search)
+                                         : algorithms.ManyToManySearch(snapped_phantoms,
+                                                                       params.sources,
+                                                                       params.destinations,
+                                                                       request_distance,
+                                                                       use_parallel_search,
+                                                                       limits);
 
     if ((request_duration && result_tables_pair.first.empty()) ||
         (request_distance && result_tables_pair.second.empty()))
@@ -116,15 +158,22 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
                                   candidatesSnappedLocation(source),
                                   candidatesSnappedLocation(destination));
 
-                    result_tables_pair.first[table_index] =
+                    const auto duration_estimate =
                         to_alias<EdgeDuration>(distance_estimate / params.fallback_speed);
-                    if (!result_tables_pair.second.empty())
+
+                    // estimates are subject to the limits as well
+                    if (!limits.Exceeds(duration_estimate,
+                                        to_alias<EdgeDistance>(distance_estimate)))
                     {
-                        result_tables_pair.second[table_index] =
-                            to_alias<EdgeDistance>(distance_estimate);
+                        result_tables_pair.first[table_index] = duration_estimate;
+                        if (!result_tables_pair.second.empty())
+                        {
+                            result_tables_pair.second[table_index] =
+                                to_alias<EdgeDistance>(distance_estimate);
+                        }
+
+                        estimated_pairs.emplace_back(row, column);
                     }
-
-                    estimated_pairs.emplace_back(row, column);
                 }
                 if (params.scale_factor > 0 && params.scale_factor != 1 &&
                     result_tables_pair.first[table_index] != MAXIMAL_EDGE_DURATION &&
@@ -149,8 +198,17 @@ Status TablePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
         }
     }
 
+    // the rows are only streamed once the whole table is computed and the fallbacks are applied
     api::TableAPI table_api{facade, params};
-    table_api.MakeResponse(result_tables_pair, snapped_phantoms, estimated_pairs, result);
+    if (stream && std::holds_alternative<util::json::Object>(result) &&
+        params.format != api::BaseParameters::OutputFormatType::BINARY)
+    {
+        table_api.MakeResponse(result_tables_pair, snapped_phantoms, estimated_pairs, stream);
+    }
+    else
+    {
+        table_api.MakeResponse(result_tables_pair, snapped_phantoms, estimated_pairs, result);
+    }
 
     return Status::Ok;
 }
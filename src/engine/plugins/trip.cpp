@@ -2,13 +2,16 @@
 
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/request_deadline.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
 #include <utility>
 #include <vector>
@@ -57,7 +60,7 @@ TripPlugin::ComputeRoute(const RoutingAlgorithmsInterface &algorithms,
         BOOST_ASSERT(trip_candidates.size() == trip.size());
     }
 
-    auto min_route = algorithms.ShortestPathSearch(trip_candidates, {false});
+    auto min_route = algorithms.ShortestPathSearch(trip_candidates, {false}, false);
     BOOST_ASSERT_MSG(min_route.shortest_path_weight < INVALID_EDGE_WEIGHT, "unroutable route");
     return min_route;
 }
@@ -215,7 +218,14 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
 
     // compute the duration table of all phantom nodes
     auto result_duration_table = util::DistTableWrapper<EdgeDuration>(
-        algorithms.ManyToManySearch(snapped_phantoms, {}, {}, /*requestDistance*/ false).first,
+        algorithms
+            .ManyToManySearch(snapped_phantoms,
+                              {},
+                              {},
+                              /*requestDistance*/ false,
+                              /*parallelSearch*/ false,
+                              /*limits*/ {})
+            .first,
         number_of_locations);
 
     if (result_duration_table.size() == 0)
@@ -255,6 +265,23 @@ Status TripPlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithms,
     else
     {
         duration_trip = trip::FarthestInsertionTrip(number_of_locations, result_duration_table);
+
+        // shorten the trip for at most the local search time, but leave at least half of the
+        // remaining request time to computing the route of the trip
+        if (local_search_time > 0)
+        {
+            const auto now = RequestDeadline::Clock::now();
+            auto end = now + std::chrono::milliseconds(local_search_time);
+            const auto &request_deadline = RequestDeadline::Current().deadline;
+            if (request_deadline && now + (*request_deadline - now) / 2 < end)
+            {
+                end = now + (*request_deadline - now) / 2;
+            }
+            // a search gives up after as many perturbations without improvement as there are
+            // locations
+            duration_trip = trip::LocalSearchTrip(
+                result_duration_table, std::move(duration_trip), end, number_of_locations);
+        }
     }
 
     if (!fixed_end || fixed_start)
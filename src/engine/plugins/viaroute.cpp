@@ -17,9 +17,13 @@ namespace osrm::engine::plugins
 
 ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute,
                                int max_alternatives,
-                               std::optional<double> default_radius)
+                               std::optional<double> default_radius,
+                               const bool use_parallel_alternatives_search,
+                               const bool use_parallel_leg_search)
     : BasePlugin(default_radius), max_locations_viaroute(max_locations_viaroute),
-      max_alternatives(max_alternatives)
+      max_alternatives(max_alternatives),
+      use_parallel_alternatives_search(use_parallel_alternatives_search),
+      use_parallel_leg_search(use_parallel_leg_search)
 {
 }
 
@@ -110,7 +114,8 @@ Status ViaRoutePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithm
     if (2 == snapped_phantoms.size() && algorithms.HasAlternativePathSearch() && wants_alternatives)
     {
         routes = algorithms.AlternativePathSearch({snapped_phantoms[0], snapped_phantoms[1]},
-                                                  number_of_alternatives);
+                                                  number_of_alternatives,
+                                                  use_parallel_alternatives_search);
     }
     else if (2 == snapped_phantoms.size() && algorithms.HasDirectShortestPathSearch())
     {
@@ -118,8 +123,8 @@ Status ViaRoutePlugin::HandleRequest(const RoutingAlgorithmsInterface &algorithm
     }
     else
     {
-        routes =
-            algorithms.ShortestPathSearch(snapped_phantoms, route_parameters.continue_straight);
+        routes = algorithms.ShortestPathSearch(
+            snapped_phantoms, route_parameters.continue_straight, use_parallel_leg_search);
     }
 
     // The post condition for all path searches is we have at least one route in our result.
@@ -58,6 +58,7 @@ void alternativeRoutingStep(const DataFacade<Algorithm> &facade,
     QueryHeap &forward_heap = DIRECTION == FORWARD_DIRECTION ? heap1 : heap2;
     QueryHeap &reverse_heap = DIRECTION == FORWARD_DIRECTION ? heap2 : heap1;
 
+    RequestDeadline::Check();
     // Take a copy (no ref &) of the extracted node because otherwise could be modified later if
     // toHeapNode is the same
     const auto heapNode = forward_heap.DeleteMinGetHeapNode();
@@ -549,7 +550,8 @@ bool viaNodeCandidatePassesTTest(SearchEngineData<Algorithm> &engine_working_dat
 InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
                                                const DataFacade<Algorithm> &facade,
                                                const PhantomEndpointCandidates &endpoint_candidates,
-                                               unsigned /*number_of_alternatives*/)
+                                               unsigned /*number_of_alternatives*/,
+                                               const bool /*parallel_search*/)
 {
     InternalRouteResult primary_route;
     InternalRouteResult secondary_route;
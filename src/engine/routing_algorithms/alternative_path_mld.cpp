@@ -15,6 +15,9 @@
 
 #include <boost/iterator/function_output_iterator.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace osrm::engine::routing_algorithms
 {
 
@@ -545,6 +548,83 @@ RandIt filterAnnotatedRoutesByStretch(RandIt first,
     return std::remove_if(first, last, over_duration_limit);
 }
 
+// Unpacks a WeightedViaNodePackedPath into a WeightedViaNodeUnpackedPath.
+// Note: destroys the heaps for recursive unpacking. Extract heap data you need before.
+WeightedViaNodeUnpackedPath unpackPackedPath(const WeightedViaNodePackedPath &weighted_packed_path,
+                                             SearchEngineData<Algorithm> &search_engine_data,
+                                             Heap &forward_heap,
+                                             Heap &reverse_heap,
+                                             const Facade &facade,
+                                             const PhantomEndpointCandidates &endpoint_candidates)
+{
+    const Partition &partition = facade.GetMultiLevelPartition();
+
+    const auto packed_path_weight = weighted_packed_path.via.weight;
+    const auto packed_path_via = weighted_packed_path.via.node;
+
+    const auto &packed_path = weighted_packed_path.path;
+
+    //
+    // Todo: dup. code with mld::search except for level entry: we run a slight mld::search
+    //       adaption here and then dispatch to mld::search for recursively descending down.
+    //
+
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    unpacked_nodes.reserve(packed_path.size());
+    unpacked_edges.reserve(packed_path.size());
+
+    // Beware the edge case when start, via, end are all the same.
+    // In this case we return a single node, no edges. We also don't unpack.
+    if (packed_path.empty())
+    {
+        const auto source_node = packed_path_via;
+        unpacked_nodes.push_back(source_node);
+    }
+    else
+    {
+        const auto source_node = std::get<0>(packed_path.front());
+        unpacked_nodes.push_back(source_node);
+    }
+
+    for (auto const &packed_edge : packed_path)
+    {
+        NodeID source, target;
+        bool overlay_edge;
+        std::tie(source, target, overlay_edge) = packed_edge;
+        if (!overlay_edge)
+        { // a base graph edge
+            unpacked_nodes.push_back(target);
+            unpacked_edges.push_back(facade.FindEdge(source, target));
+        }
+        else
+        { // an overlay graph edge
+            const LevelID level =
+                getNodeQueryLevel(partition, source, endpoint_candidates); // XXX
+
+            BOOST_ASSERT(!facade.ExcludeNode(source));
+            BOOST_ASSERT(!facade.ExcludeNode(target));
+
+            // Here heaps can be reused, let's go deeper!
+            unpackOverlayEdge(search_engine_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              {},
+                              level,
+                              source,
+                              target,
+                              unpacked_nodes,
+                              unpacked_edges);
+        }
+    }
+
+    return WeightedViaNodeUnpackedPath{0.0,
+                                       WeightedViaNode{packed_path_via, packed_path_weight},
+                                       std::move(unpacked_nodes),
+                                       std::move(unpacked_edges)};
+}
+
 // Unpacks a range of WeightedViaNodePackedPaths into a range of WeightedViaNodeUnpackedPaths.
 // Note: destroys search engine heaps for recursive unpacking. Extract heap data you need before.
 template <typename InputIt, typename OutIt>
@@ -553,103 +633,55 @@ void unpackPackedPaths(InputIt first,
                        OutIt out,
                        SearchEngineData<Algorithm> &search_engine_data,
                        const Facade &facade,
-                       const PhantomEndpointCandidates &endpoint_candidates)
+                       const PhantomEndpointCandidates &endpoint_candidates,
+                       const bool parallel_search)
 {
-    util::static_assert_iter_category<InputIt, std::input_iterator_tag>();
+    util::static_assert_iter_category<InputIt, std::random_access_iterator_tag>();
     util::static_assert_iter_category<OutIt, std::output_iterator_tag>();
     util::static_assert_iter_value<InputIt, WeightedViaNodePackedPath>();
 
-    const Partition &partition = facade.GetMultiLevelPartition();
-
-    Heap &forward_heap = *search_engine_data.forward_heap_1;
-    Heap &reverse_heap = *search_engine_data.reverse_heap_1;
+    const auto number_of_packed_paths = static_cast<std::size_t>(std::distance(first, last));
 
-    for (auto it = first; it != last; ++it, ++out)
+    if (!parallel_search || number_of_packed_paths < 2)
     {
-        const auto packed_path_weight = it->via.weight;
-        const auto packed_path_via = it->via.node;
-
-        const auto &packed_path = it->path;
+        Heap &forward_heap = *search_engine_data.forward_heap_1;
+        Heap &reverse_heap = *search_engine_data.reverse_heap_1;
 
-        //
-        // Todo: dup. code with mld::search except for level entry: we run a slight mld::search
-        //       adaption here and then dispatch to mld::search for recursively descending down.
-        //
-
-        std::vector<NodeID> unpacked_nodes;
-        std::vector<EdgeID> unpacked_edges;
-        unpacked_nodes.reserve(packed_path.size());
-        unpacked_edges.reserve(packed_path.size());
-
-        // Beware the edge case when start, via, end are all the same.
-        // In this case we return a single node, no edges. We also don't unpack.
-        if (packed_path.empty())
+        for (auto it = first; it != last; ++it, ++out)
         {
-            const auto source_node = packed_path_via;
-            unpacked_nodes.push_back(source_node);
+            out = unpackPackedPath(
+                *it, search_engine_data, forward_heap, reverse_heap, facade, endpoint_candidates);
         }
-        else
-        {
-            const auto source_node = std::get<0>(packed_path.front());
-            unpacked_nodes.push_back(source_node);
-        }
-
-        for (auto const &packed_edge : packed_path)
-        {
-            NodeID source, target;
-            bool overlay_edge;
-            std::tie(source, target, overlay_edge) = packed_edge;
-            if (!overlay_edge)
-            { // a base graph edge
-                unpacked_nodes.push_back(target);
-                unpacked_edges.push_back(facade.FindEdge(source, target));
-            }
-            else
-            { // an overlay graph edge
-                LevelID level = getNodeQueryLevel(partition, source, endpoint_candidates); // XXX
-                CellID parent_cell_id = partition.GetCell(level, source);
-                BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-                LevelID sublevel = level - 1;
-
-                // Here heaps can be reused, let's go deeper!
-                forward_heap.Clear();
-                reverse_heap.Clear();
-                forward_heap.Insert(source, {0}, {source});
-                reverse_heap.Insert(target, {0}, {target});
-
-                BOOST_ASSERT(!facade.ExcludeNode(source));
-                BOOST_ASSERT(!facade.ExcludeNode(target));
-
-                auto unpacked_subpath = search(search_engine_data,
-                                               facade,
-                                               forward_heap,
-                                               reverse_heap,
-                                               {},
-                                               INVALID_EDGE_WEIGHT,
-                                               sublevel,
-                                               parent_cell_id);
-                BOOST_ASSERT(!unpacked_subpath.edges.empty());
-                BOOST_ASSERT(unpacked_subpath.nodes.size() > 1);
-                BOOST_ASSERT(unpacked_subpath.nodes.front() == source);
-                BOOST_ASSERT(unpacked_subpath.nodes.back() == target);
-                unpacked_nodes.insert(unpacked_nodes.end(),
-                                      std::next(unpacked_subpath.nodes.begin()),
-                                      unpacked_subpath.nodes.end());
-                unpacked_edges.insert(unpacked_edges.end(),
-                                      unpacked_subpath.edges.begin(),
-                                      unpacked_subpath.edges.end());
-            }
-        }
-
-        WeightedViaNodeUnpackedPath unpacked_path{
-            0.0,
-            WeightedViaNode{packed_path_via, packed_path_weight},
-            std::move(unpacked_nodes),
-            std::move(unpacked_edges)};
-
-        out = std::move(unpacked_path);
+        return;
     }
+
+    // The paths are unpacked independently of each other, each task on the task heaps of its
+    // thread. They are kept for the next request unless they exceed the heap budget.
+    // the cache and the deadline are only set for the request thread
+    const auto clique_arc_cache = CliqueArcCacheScope::Current();
+    const auto request_deadline = RequestDeadline::Current();
+
+    std::vector<WeightedViaNodeUnpackedPath> unpacked_paths(number_of_packed_paths);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_packed_paths, 1),
+                      [&](const tbb::blocked_range<std::size_t> &range)
+                      {
+                          const CliqueArcCacheScope clique_arc_cache_scope(clique_arc_cache);
+                          const RequestDeadline request_deadline_scope(request_deadline);
+                          auto &heaps = search_engine_data.InitializeOrClearTaskThreadLocalStorage(
+                              facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+                          for (auto index = range.begin(); index < range.end(); ++index)
+                          {
+                              unpacked_paths[index] = unpackPackedPath(first[index],
+                                                                       search_engine_data,
+                                                                       *heaps.forward_heap,
+                                                                       *heaps.reverse_heap,
+                                                                       facade,
+                                                                       endpoint_candidates);
+                          }
+                          search_engine_data.ReleaseTaskThreadLocalStorageOverBudget();
+                      });
+
+    std::move(unpacked_paths.begin(), unpacked_paths.end(), out);
 }
 
 // Generates via candidate nodes from the overlap of the two search spaces from s and t.
@@ -778,7 +810,8 @@ makeCandidateVias(SearchEngineData<Algorithm> &search_engine_data,
 InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &search_engine_data,
                                                const Facade &facade,
                                                const PhantomEndpointCandidates &endpoint_candidates,
-                                               unsigned number_of_alternatives)
+                                               unsigned number_of_alternatives,
+                                               const bool parallel_search)
 {
     Parameters parameters = parametersFromRequest(endpoint_candidates);
 
@@ -902,7 +935,8 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
                       std::back_inserter(unpacked_paths),
                       search_engine_data,
                       facade,
-                      endpoint_candidates);
+                      endpoint_candidates,
+                      parallel_search);
 
     //
     // Filter and rank a second time. This time instead of being fast and doing
@@ -1,11 +1,19 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/bucket_cache.hpp"
+#include "engine/routing_algorithms/bucket_scan.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
 #include <limits>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace osrm::engine::routing_algorithms
@@ -40,14 +48,14 @@ inline bool addLoopWeight(const DataFacade<ch::Algorithm> &facade,
     return false;
 }
 
-template <bool DIRECTION>
+template <bool DIRECTION, bool STALLING = true>
 void relaxOutgoingEdges(
     const DataFacade<Algorithm> &facade,
     const typename SearchEngineData<Algorithm>::ManyToManyQueryHeap::HeapNode &heapNode,
     typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
     const PhantomNodeCandidates &)
 {
-    if (stallAtNode<DIRECTION>(facade, heapNode, query_heap))
+    if (STALLING && stallAtNode<DIRECTION>(facade, heapNode, query_heap))
     {
         return;
     }
@@ -90,60 +98,89 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         const std::size_t row_index,
                         const std::size_t number_of_targets,
                         typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
-                        const std::vector<NodeBucket> &search_space_with_buckets,
+                        const BucketArrays &search_space_with_buckets,
                         std::vector<EdgeWeight> &weights_table,
                         std::vector<EdgeDuration> &durations_table,
                         std::vector<EdgeDistance> &distances_table,
                         std::vector<NodeID> &middle_nodes_table,
-                        const PhantomNodeCandidates &candidates)
+                        const PhantomNodeCandidates &candidates,
+                        const TableLimits &limits)
 {
+    RequestDeadline::Check();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Every path over an out of range node is out of range as well
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+    {
+        return;
+    }
+
+    const TableRow row{weights_table.data() + row_index * number_of_targets,
+                       durations_table.data() + row_index * number_of_targets,
+                       distances_table.empty()
+                           ? nullptr
+                           : distances_table.data() + row_index * number_of_targets,
+                       middle_nodes_table.data() + row_index * number_of_targets};
+
     // Check if each encountered node has an entry
-    const auto &bucket_list = std::equal_range(search_space_with_buckets.begin(),
-                                               search_space_with_buckets.end(),
-                                               heapNode.node,
-                                               NodeBucket::Compare());
-    for (const auto &current_bucket : boost::make_iterator_range(bucket_list))
+    const auto [first_bucket, last_bucket] = search_space_with_buckets.Find(heapNode.node);
+
+    // Only the phantom nodes of the source are settled with a negative weight, their buckets
+    // may need a loop and are checked one by one
+    if (heapNode.weight >= EdgeWeight{0})
     {
-        // Get target id from bucket entry
-        const auto column_index = current_bucket.column_index;
-        const auto target_weight = current_bucket.weight;
-        const auto target_duration = current_bucket.duration;
-        const auto target_distance = current_bucket.distance;
+        scanBuckets(search_space_with_buckets,
+                    first_bucket,
+                    last_bucket,
+                    heapNode.weight,
+                    heapNode.data.duration,
+                    heapNode.data.distance,
+                    heapNode.node,
+                    row);
+    }
+    else
+    {
+        for (auto bucket = first_bucket; bucket < last_bucket; ++bucket)
+        {
+            // Get target id from bucket entry
+            const auto column_index = search_space_with_buckets.columns[bucket];
+            const auto target_weight = search_space_with_buckets.weights[bucket];
+            const auto target_duration = search_space_with_buckets.durations[bucket];
+            const auto target_distance = search_space_with_buckets.distances[bucket];
 
-        auto &current_weight = weights_table[row_index * number_of_targets + column_index];
+            auto &current_weight = row.weights[column_index];
 
-        EdgeDistance nulldistance = {0};
+            EdgeDistance nulldistance = {0};
 
-        auto &current_duration = durations_table[row_index * number_of_targets + column_index];
-        auto &current_distance =
-            distances_table.empty() ? nulldistance
-                                    : distances_table[row_index * number_of_targets + column_index];
+            auto &current_duration = row.durations[column_index];
+            auto &current_distance =
+                row.distances == nullptr ? nulldistance : row.distances[column_index];
 
-        // Check if new weight is better
-        auto new_weight = heapNode.weight + target_weight;
-        auto new_duration = heapNode.data.duration + target_duration;
-        auto new_distance = heapNode.data.distance + target_distance;
+            // Check if new weight is better
+            auto new_weight = heapNode.weight + target_weight;
+            auto new_duration = heapNode.data.duration + target_duration;
+            auto new_distance = heapNode.data.distance + target_distance;
 
-        if (new_weight < EdgeWeight{0})
-        {
-            if (addLoopWeight(facade, heapNode.node, new_weight, new_duration, new_distance))
+            if (new_weight < EdgeWeight{0})
             {
-                current_weight = std::min(current_weight, new_weight);
-                current_duration = std::min(current_duration, new_duration);
-                current_distance = std::min(current_distance, new_distance);
-                middle_nodes_table[row_index * number_of_targets + column_index] = heapNode.node;
+                if (addLoopWeight(facade, heapNode.node, new_weight, new_duration, new_distance))
+                {
+                    current_weight = std::min(current_weight, new_weight);
+                    current_duration = std::min(current_duration, new_duration);
+                    current_distance = std::min(current_distance, new_distance);
+                    row.middle_nodes[column_index] = heapNode.node;
+                }
+            }
+            else if (std::tie(new_weight, new_duration) <
+                     std::tie(current_weight, current_duration))
+            {
+                current_weight = new_weight;
+                current_duration = new_duration;
+                current_distance = new_distance;
+                row.middle_nodes[column_index] = heapNode.node;
             }
-        }
-        else if (std::tie(new_weight, new_duration) < std::tie(current_weight, current_duration))
-        {
-            current_weight = new_weight;
-            current_duration = new_duration;
-            current_distance = new_distance;
-            middle_nodes_table[row_index * number_of_targets + column_index] = heapNode.node;
         }
     }
 
@@ -154,12 +191,19 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
                          const unsigned column_index,
                          typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
                          std::vector<NodeBucket> &search_space_with_buckets,
-                         const PhantomNodeCandidates &candidates)
+                         const PhantomNodeCandidates &candidates,
+                         const TableLimits &limits)
 {
+    RequestDeadline::Check();
     // Take a copy (no ref &) of the extracted node because otherwise could be modified later if
     // toHeapNode is the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+    {
+        return;
+    }
+
     // Store settled nodes in search space bucket
     search_space_with_buckets.emplace_back(heapNode.node,
                                            heapNode.data.parent,
@@ -171,6 +215,270 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
     relaxOutgoingEdges<REVERSE_DIRECTION>(facade, heapNode, query_heap, candidates);
 }
 
+// The part of the contracted graph that is reachable from the targets by backward edges,
+// numbered in sweep order: every node comes after all nodes above it.
+struct RestrictedGraph
+{
+    // downward edge to a node of the restricted graph
+    struct Edge
+    {
+        std::uint32_t from;
+        EdgeWeight weight;
+        EdgeDuration duration;
+        EdgeDistance distance;
+    };
+
+    // start of a backward search at a node of the restricted graph
+    struct Target
+    {
+        std::uint32_t column_index;
+        EdgeWeight weight;
+        EdgeDuration duration;
+        EdgeDistance distance;
+    };
+
+    std::vector<NodeID> nodes;
+    std::unordered_map<NodeID, std::uint32_t> node_index;
+    std::vector<std::uint32_t> edge_offsets;
+    std::vector<Edge> edges;
+    std::vector<std::uint32_t> target_offsets;
+    std::vector<Target> targets;
+};
+
+RestrictedGraph selectRestrictedGraph(const DataFacade<Algorithm> &facade,
+                                      const std::vector<PhantomNodeCandidates> &candidates_list,
+                                      const std::vector<std::size_t> &target_indices)
+{
+    RestrictedGraph graph;
+    const constexpr auto IN_PROGRESS = std::numeric_limits<std::uint32_t>::max();
+
+    std::unordered_map<NodeID, std::vector<RestrictedGraph::Target>> node_targets;
+    for (std::uint32_t column_index = 0; column_index < target_indices.size(); ++column_index)
+    {
+        for (const auto &phantom_node : candidates_list[target_indices[column_index]])
+        {
+            if (phantom_node.IsValidForwardTarget())
+            {
+                node_targets[phantom_node.forward_segment_id.id].push_back(
+                    {column_index,
+                     phantom_node.GetForwardWeightPlusOffset(),
+                     phantom_node.GetForwardDuration(),
+                     phantom_node.GetForwardDistance()});
+            }
+            if (phantom_node.IsValidReverseTarget())
+            {
+                node_targets[phantom_node.reverse_segment_id.id].push_back(
+                    {column_index,
+                     phantom_node.GetReverseWeightPlusOffset(),
+                     phantom_node.GetReverseDuration(),
+                     phantom_node.GetReverseDistance()});
+            }
+        }
+    }
+
+    // Depth-first search along the backward edges, which all point upwards. A node is finished
+    // after all nodes above it, so the finishing order is a topological order of the sweep.
+    std::vector<std::pair<NodeID, bool>> stack;
+    for (const auto &node_and_targets : node_targets)
+    {
+        stack.emplace_back(node_and_targets.first, false);
+        while (!stack.empty())
+        {
+            const auto [node, expanded] = stack.back();
+            stack.pop_back();
+
+            if (expanded)
+            {
+                graph.node_index[node] = graph.nodes.size();
+                graph.nodes.push_back(node);
+                continue;
+            }
+
+            if (!graph.node_index.emplace(node, IN_PROGRESS).second)
+            {
+                continue;
+            }
+
+            stack.emplace_back(node, true);
+            for (const auto edge : facade.GetAdjacentEdgeRange(node))
+            {
+                if (facade.GetEdgeData(edge).backward &&
+                    graph.node_index.count(facade.GetTarget(edge)) == 0)
+                {
+                    stack.emplace_back(facade.GetTarget(edge), false);
+                }
+            }
+        }
+    }
+
+    graph.edge_offsets.reserve(graph.nodes.size() + 1);
+    graph.target_offsets.reserve(graph.nodes.size() + 1);
+    for (std::uint32_t index = 0; index < graph.nodes.size(); ++index)
+    {
+        const auto node = graph.nodes[index];
+
+        graph.edge_offsets.push_back(graph.edges.size());
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (data.backward)
+            {
+                const auto from = graph.node_index.at(facade.GetTarget(edge));
+                BOOST_ASSERT(from < index);
+                graph.edges.push_back(
+                    {from, data.weight, to_alias<EdgeDuration>(data.duration), data.distance});
+            }
+        }
+
+        graph.target_offsets.push_back(graph.targets.size());
+        const auto targets = node_targets.find(node);
+        if (targets != node_targets.end())
+        {
+            graph.targets.insert(
+                graph.targets.end(), targets->second.begin(), targets->second.end());
+        }
+    }
+    graph.edge_offsets.push_back(graph.edges.size());
+    graph.target_offsets.push_back(graph.targets.size());
+
+    return graph;
+}
+
+// Per-thread storage of the values of one downward sweep
+struct SweepData
+{
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeDuration> durations;
+    std::vector<EdgeDistance> distances;
+};
+
+void downwardSweep(const DataFacade<Algorithm> &facade,
+                   const RestrictedGraph &graph,
+                   const std::size_t row_index,
+                   const std::size_t number_of_targets,
+                   typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                   const PhantomNodeCandidates &source_candidates,
+                   SweepData &sweep,
+                   std::vector<EdgeWeight> &weights_table,
+                   std::vector<EdgeDuration> &durations_table,
+                   std::vector<EdgeDistance> &distances_table)
+{
+    const auto number_of_nodes = graph.nodes.size();
+    sweep.weights.assign(number_of_nodes, INVALID_EDGE_WEIGHT);
+    sweep.durations.assign(number_of_nodes, MAXIMAL_EDGE_DURATION);
+    sweep.distances.assign(number_of_nodes, MAXIMAL_EDGE_DISTANCE);
+
+    // Upward search from the source, it only initializes the sweep
+    insertSourceInHeap(query_heap, source_candidates);
+    while (!query_heap.Empty())
+    {
+        RequestDeadline::Check();
+        const auto heapNode = query_heap.DeleteMinGetHeapNode();
+
+        // A stalled node is reached on a shorter path from a higher node, which the sweep pulls
+        // down to it. It neither initializes the sweep nor continues the search. The phantom
+        // nodes of the source may need a loop at their own node and are never stalled.
+        if (heapNode.weight >= EdgeWeight{0} &&
+            stallAtNode<FORWARD_DIRECTION>(facade, heapNode, query_heap))
+        {
+            continue;
+        }
+
+        const auto index = graph.node_index.find(heapNode.node);
+        if (index != graph.node_index.end())
+        {
+            sweep.weights[index->second] = heapNode.weight;
+            sweep.durations[index->second] = heapNode.data.duration;
+            sweep.distances[index->second] = heapNode.data.distance;
+        }
+
+        relaxOutgoingEdges<FORWARD_DIRECTION, false>(
+            facade, heapNode, query_heap, source_candidates);
+    }
+
+    const auto update_cell = [&](const std::size_t column_index,
+                                 const EdgeWeight weight,
+                                 const EdgeDuration duration,
+                                 const EdgeDistance distance)
+    {
+        const auto cell = row_index * number_of_targets + column_index;
+        if (std::tie(weight, duration) < std::tie(weights_table[cell], durations_table[cell]))
+        {
+            weights_table[cell] = weight;
+            durations_table[cell] = duration;
+            if (!distances_table.empty())
+                distances_table[cell] = distance;
+        }
+    };
+
+    for (std::uint32_t index = 0; index < number_of_nodes; ++index)
+    {
+        // Best path that reaches the node from above
+        auto pulled_weight = INVALID_EDGE_WEIGHT;
+        auto pulled_duration = MAXIMAL_EDGE_DURATION;
+        auto pulled_distance = MAXIMAL_EDGE_DISTANCE;
+        for (auto edge = graph.edge_offsets[index]; edge < graph.edge_offsets[index + 1]; ++edge)
+        {
+            const auto &data = graph.edges[edge];
+            if (sweep.weights[data.from] == INVALID_EDGE_WEIGHT)
+                continue;
+
+            const auto weight = sweep.weights[data.from] + data.weight;
+            const auto duration = sweep.durations[data.from] + data.duration;
+            if (std::tie(weight, duration) < std::tie(pulled_weight, pulled_duration))
+            {
+                pulled_weight = weight;
+                pulled_duration = duration;
+                pulled_distance = sweep.distances[data.from] + data.distance;
+            }
+        }
+
+        for (auto target = graph.target_offsets[index]; target < graph.target_offsets[index + 1];
+             ++target)
+        {
+            const auto &data = graph.targets[target];
+            if (pulled_weight != INVALID_EDGE_WEIGHT)
+            {
+                update_cell(data.column_index,
+                            pulled_weight + data.weight,
+                            pulled_duration + data.duration,
+                            pulled_distance + data.distance);
+            }
+
+            // Source and target meet at this node, same as a bucket hit of the forward search
+            if (sweep.weights[index] == INVALID_EDGE_WEIGHT)
+                continue;
+
+            auto new_weight = sweep.weights[index] + data.weight;
+            auto new_duration = sweep.durations[index] + data.duration;
+            auto new_distance = sweep.distances[index] + data.distance;
+            if (new_weight < EdgeWeight{0})
+            {
+                if (addLoopWeight(facade, graph.nodes[index], new_weight, new_duration, new_distance))
+                {
+                    const auto cell = row_index * number_of_targets + data.column_index;
+                    weights_table[cell] = std::min(weights_table[cell], new_weight);
+                    durations_table[cell] = std::min(durations_table[cell], new_duration);
+                    if (!distances_table.empty())
+                        distances_table[cell] = std::min(distances_table[cell], new_distance);
+                }
+            }
+            else
+            {
+                update_cell(data.column_index, new_weight, new_duration, new_distance);
+            }
+        }
+
+        if (std::tie(pulled_weight, pulled_duration) <
+            std::tie(sweep.weights[index], sweep.durations[index]))
+        {
+            sweep.weights[index] = pulled_weight;
+            sweep.durations[index] = pulled_duration;
+            sweep.distances[index] = pulled_distance;
+        }
+    }
+}
+
 } // namespace ch
 
 template <>
@@ -180,8 +488,15 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                  const std::vector<PhantomNodeCandidates> &candidates_list,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+                 const bool calculate_distance,
+                 const bool parallel_search,
+                 const TableLimits &limits,
+                 const BucketCacheHandle &bucket_cache)
 {
+    using ManyToManyQueryHeap = SearchEngineData<ch::Algorithm>::ManyToManyQueryHeap;
+
+    const auto search_limits = limits.ForSearchSpaces(candidates_list);
+
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
@@ -193,39 +508,44 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
     std::vector<NodeID> middle_nodes_table(number_of_entries, SPECIAL_NODEID);
 
     std::vector<NodeBucket> search_space_with_buckets;
+    BucketArrays sorted_buckets;
 
-    // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_index = 0; column_index < target_indices.size(); ++column_index)
+    // Populate buckets with paths from all accessible nodes to destination via backward search,
+    // targets already searched by an earlier request are taken from the bucket cache
+    auto backward_search = [&](ManyToManyQueryHeap &query_heap,
+                               const std::uint32_t column_index,
+                               std::vector<NodeBucket> &buckets)
     {
-        const auto index = target_indices[column_index];
-        const auto &target_candidates = candidates_list[index];
+        const auto &target_candidates = candidates_list[target_indices[column_index]];
+        if (bucket_cache &&
+            bucket_cache.AppendCached(facade, false, target_candidates, column_index, buckets))
+        {
+            return;
+        }
 
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes());
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        const auto first_bucket = buckets.size();
         insertTargetInHeap(query_heap, target_candidates);
 
         // Explore search space
         while (!query_heap.Empty())
         {
             backwardRoutingStep(
-                facade, column_index, query_heap, search_space_with_buckets, target_candidates);
+                facade, column_index, query_heap, buckets, target_candidates, search_limits);
         }
-    }
 
-    // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        // bounded searches miss buckets that unbounded requests need
+        if (bucket_cache && !limits.IsBounded())
+        {
+            bucket_cache.Insert(
+                facade, false, target_candidates, buckets.begin() + first_bucket, buckets.end());
+        }
+    };
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_index = 0; row_index < source_indices.size(); ++row_index)
+    // Find shortest paths from source to all accessible nodes, only the row of the
+    // result tables that belongs to the source is written
+    auto forward_search = [&](ManyToManyQueryHeap &query_heap, const std::uint32_t row_index)
     {
-        const auto source_index = source_indices[row_index];
-        const auto &source_candidates = candidates_list[source_index];
-
-        // Clear heap and insert source nodes
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes());
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        const auto &source_candidates = candidates_list[source_indices[row_index]];
         insertSourceInHeap(query_heap, source_candidates);
 
         // Explore search space
@@ -235,12 +555,166 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                                row_index,
                                number_of_targets,
                                query_heap,
-                               search_space_with_buckets,
+                               sorted_buckets,
                                weights_table,
                                durations_table,
                                distances_table,
                                middle_nodes_table,
-                               source_candidates);
+                               source_candidates,
+                               search_limits);
+        }
+    };
+
+    if (parallel_search)
+    {
+        // Every task uses its own heap, the thread-local heaps of the engine belong to the
+        // request thread and must not be shared with the TBB workers. These heaps only live for
+        // one request, so they use a hash map index instead of allocating a dense one.
+        tbb::enumerable_thread_specific<ManyToManyQueryHeap> query_heaps(
+            facade.GetNumberOfNodes(), std::size_t{0});
+        tbb::enumerable_thread_specific<std::vector<NodeBucket>> task_buckets;
+        // the tasks continue the deadline of the request thread
+        const auto request_deadline = RequestDeadline::Current();
+
+        tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, number_of_targets),
+                          [&](const tbb::blocked_range<std::uint32_t> &range)
+                          {
+                              const RequestDeadline request_deadline_scope(request_deadline);
+                              auto &query_heap = query_heaps.local();
+                              auto &buckets = task_buckets.local();
+                              for (auto column_index = range.begin(); column_index < range.end();
+                                   ++column_index)
+                              {
+                                  query_heap.Clear();
+                                  backward_search(query_heap, column_index, buckets);
+                              }
+                          });
+
+        for (auto &buckets : task_buckets)
+        {
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
+        }
+
+        // Order lookup buckets
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        sorted_buckets = BucketArrays(search_space_with_buckets);
+        std::vector<NodeBucket>().swap(search_space_with_buckets);
+
+        tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, number_of_sources),
+                          [&](const tbb::blocked_range<std::uint32_t> &range)
+                          {
+                              const RequestDeadline request_deadline_scope(request_deadline);
+                              auto &query_heap = query_heaps.local();
+                              for (auto row_index = range.begin(); row_index < range.end();
+                                   ++row_index)
+                              {
+                                  query_heap.Clear();
+                                  forward_search(query_heap, row_index);
+                              }
+                          });
+    }
+    else
+    {
+        for (std::uint32_t column_index = 0; column_index < number_of_targets; ++column_index)
+        {
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            backward_search(
+                *engine_working_data.many_to_many_heap, column_index, search_space_with_buckets);
+        }
+
+        // Order lookup buckets
+        std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        sorted_buckets = BucketArrays(search_space_with_buckets);
+        std::vector<NodeBucket>().swap(search_space_with_buckets);
+
+        for (std::uint32_t row_index = 0; row_index < number_of_sources; ++row_index)
+        {
+            // Clear heap and insert source nodes
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            forward_search(*engine_working_data.many_to_many_heap, row_index);
+        }
+    }
+
+    return std::make_pair(std::move(durations_table), std::move(distances_table));
+}
+
+// RPHAST: the backward search spaces of all targets are selected once and ordered from top
+// to bottom, then every source only needs its upward search followed by a linear sweep over
+// the selected nodes instead of bucket lookups for each settled node.
+template <>
+std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
+rphastSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+             const DataFacade<ch::Algorithm> &facade,
+             const std::vector<PhantomNodeCandidates> &candidates_list,
+             const std::vector<std::size_t> &source_indices,
+             const std::vector<std::size_t> &target_indices,
+             const bool calculate_distance,
+             const bool parallel_search)
+{
+    using ManyToManyQueryHeap = SearchEngineData<ch::Algorithm>::ManyToManyQueryHeap;
+
+    const auto number_of_sources = source_indices.size();
+    const auto number_of_targets = target_indices.size();
+    const auto number_of_entries = number_of_sources * number_of_targets;
+
+    std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeDuration> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
+    std::vector<EdgeDistance> distances_table(calculate_distance ? number_of_entries : 0,
+                                              MAXIMAL_EDGE_DISTANCE);
+
+    const auto graph = ch::selectRestrictedGraph(facade, candidates_list, target_indices);
+
+    if (parallel_search)
+    {
+        tbb::enumerable_thread_specific<ManyToManyQueryHeap> query_heaps(
+            facade.GetNumberOfNodes(), std::size_t{0});
+        tbb::enumerable_thread_specific<ch::SweepData> sweeps;
+        // the tasks continue the deadline of the request thread
+        const auto request_deadline = RequestDeadline::Current();
+
+        tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, number_of_sources),
+                          [&](const tbb::blocked_range<std::uint32_t> &range)
+                          {
+                              const RequestDeadline request_deadline_scope(request_deadline);
+                              auto &query_heap = query_heaps.local();
+                              auto &sweep = sweeps.local();
+                              for (auto row_index = range.begin(); row_index < range.end();
+                                   ++row_index)
+                              {
+                                  query_heap.Clear();
+                                  ch::downwardSweep(facade,
+                                                    graph,
+                                                    row_index,
+                                                    number_of_targets,
+                                                    query_heap,
+                                                    candidates_list[source_indices[row_index]],
+                                                    sweep,
+                                                    weights_table,
+                                                    durations_table,
+                                                    distances_table);
+                              }
+                          });
+    }
+    else
+    {
+        ch::SweepData sweep;
+        for (std::uint32_t row_index = 0; row_index < number_of_sources; ++row_index)
+        {
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            ch::downwardSweep(facade,
+                              graph,
+                              row_index,
+                              number_of_targets,
+                              *engine_working_data.many_to_many_heap,
+                              candidates_list[source_indices[row_index]],
+                              sweep,
+                              weights_table,
+                              durations_table,
+                              distances_table);
         }
     }
 
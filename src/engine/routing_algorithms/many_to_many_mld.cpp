@@ -1,12 +1,20 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/bucket_cache.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/routing_algorithms/target_buckets.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <tuple>
 #include <vector>
 
 namespace osrm::engine::routing_algorithms
@@ -216,17 +224,19 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                 const std::vector<PhantomNodeCandidates> &candidates_list,
                 std::size_t source_index,
                 const std::vector<std::size_t> &target_indices,
-                const bool calculate_distance)
+                const bool calculate_distance,
+                const TableLimits &limits)
 {
+    const auto search_limits = limits.ForSearchSpaces(candidates_list);
+
     std::vector<EdgeWeight> weights_table(target_indices.size(), INVALID_EDGE_WEIGHT);
     std::vector<EdgeDuration> durations_table(target_indices.size(), MAXIMAL_EDGE_DURATION);
     std::vector<EdgeDistance> distances_table(calculate_distance ? target_indices.size() : 0,
                                               MAXIMAL_EDGE_DISTANCE);
 
-    // Collect destination (source) nodes into a map
-    std::unordered_multimap<NodeID, std::tuple<std::size_t, EdgeWeight, EdgeDuration, EdgeDistance>>
-        target_nodes_index;
-    target_nodes_index.reserve(target_indices.size());
+    // Collect destination (source) nodes into a flat array sorted by node id
+    std::vector<TargetBucket> target_buckets;
+    target_buckets.reserve(2 * target_indices.size());
     for (std::size_t index = 0; index < target_indices.size(); ++index)
     {
         const auto &target_candidates = candidates_list[target_indices[index]];
@@ -236,41 +246,40 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
             if (DIRECTION == FORWARD_DIRECTION)
             {
                 if (phantom_node.IsValidForwardTarget())
-                    target_nodes_index.insert(
-                        {phantom_node.forward_segment_id.id,
-                         std::make_tuple(index,
-                                         phantom_node.GetForwardWeightPlusOffset(),
-                                         phantom_node.GetForwardDuration(),
-                                         phantom_node.GetForwardDistance())});
+                    target_buckets.push_back({phantom_node.forward_segment_id.id,
+                                              static_cast<std::uint32_t>(index),
+                                              phantom_node.GetForwardWeightPlusOffset(),
+                                              phantom_node.GetForwardDuration(),
+                                              phantom_node.GetForwardDistance()});
 
                 if (phantom_node.IsValidReverseTarget())
-                    target_nodes_index.insert(
-                        {phantom_node.reverse_segment_id.id,
-                         std::make_tuple(index,
-                                         phantom_node.GetReverseWeightPlusOffset(),
-                                         phantom_node.GetReverseDuration(),
-                                         phantom_node.GetReverseDistance())});
+                    target_buckets.push_back({phantom_node.reverse_segment_id.id,
+                                              static_cast<std::uint32_t>(index),
+                                              phantom_node.GetReverseWeightPlusOffset(),
+                                              phantom_node.GetReverseDuration(),
+                                              phantom_node.GetReverseDistance()});
             }
             else if (DIRECTION == REVERSE_DIRECTION)
             {
                 if (phantom_node.IsValidForwardSource())
-                    target_nodes_index.insert(
+                    target_buckets.push_back(
                         {phantom_node.forward_segment_id.id,
-                         std::make_tuple(index,
-                                         EdgeWeight{0} - phantom_node.GetForwardWeightPlusOffset(),
-                                         EdgeDuration{0} - phantom_node.GetForwardDuration(),
-                                         EdgeDistance{0} - phantom_node.GetForwardDistance())});
+                         static_cast<std::uint32_t>(index),
+                         EdgeWeight{0} - phantom_node.GetForwardWeightPlusOffset(),
+                         EdgeDuration{0} - phantom_node.GetForwardDuration(),
+                         EdgeDistance{0} - phantom_node.GetForwardDistance()});
 
                 if (phantom_node.IsValidReverseSource())
-                    target_nodes_index.insert(
+                    target_buckets.push_back(
                         {phantom_node.reverse_segment_id.id,
-                         std::make_tuple(index,
-                                         EdgeWeight{0} - phantom_node.GetReverseWeightPlusOffset(),
-                                         EdgeDuration{0} - phantom_node.GetReverseDuration(),
-                                         EdgeDistance{0} - phantom_node.GetReverseDistance())});
+                         static_cast<std::uint32_t>(index),
+                         EdgeWeight{0} - phantom_node.GetReverseWeightPlusOffset(),
+                         EdgeDuration{0} - phantom_node.GetReverseDuration(),
+                         EdgeDistance{0} - phantom_node.GetReverseDistance()});
             }
         }
     }
+    TargetBuckets target_nodes_index(std::move(target_buckets));
 
     // Initialize query heap
     engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
@@ -281,20 +290,17 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
     auto update_values =
         [&](NodeID node, EdgeWeight weight, EdgeDuration duration, EdgeDistance distance)
     {
-        auto candidates = target_nodes_index.equal_range(node);
-        for (auto it = candidates.first; it != candidates.second;)
+        for (auto &bucket : target_nodes_index.Find(node))
         {
-            std::size_t index;
-            EdgeWeight target_weight;
-            EdgeDuration target_duration;
-            EdgeDistance target_distance;
-            std::tie(index, target_weight, target_duration, target_distance) = it->second;
+            if (bucket.reached)
+                continue;
 
-            const auto path_weight = weight + target_weight;
+            const auto index = bucket.column_index;
+            const auto path_weight = weight + bucket.weight;
             if (path_weight >= EdgeWeight{0})
             {
-                const auto path_duration = duration + target_duration;
-                const auto path_distance = distance + target_distance;
+                const auto path_duration = duration + bucket.duration;
+                const auto path_distance = distance + bucket.distance;
 
                 EdgeDistance nulldistance = {0};
                 auto &current_distance =
@@ -309,11 +315,7 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                 }
 
                 // Remove node from destinations list
-                it = target_nodes_index.erase(it);
-            }
-            else
-            {
-                ++it;
+                target_nodes_index.MarkReached(bucket);
             }
         }
     };
@@ -323,7 +325,7 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                            EdgeDuration initial_duration,
                            EdgeDistance initial_distance)
     {
-        if (target_nodes_index.contains(node))
+        if (target_nodes_index.HasPendingBucket(node))
         {
             // Source and target on the same edge node. If target is not reachable directly via
             // the node (e.g destination is before source on oneway segment) we want to allow
@@ -383,12 +385,17 @@ oneToManySearch(SearchEngineData<Algorithm> &engine_working_data,
         }
     }
 
-    while (!query_heap.Empty() && !target_nodes_index.empty())
+    while (!query_heap.Empty() && target_nodes_index.NumberOfPendingBuckets() > 0)
     {
+        RequestDeadline::Check();
         // Extract node from the heap. Take a copy (no ref) because otherwise can be modified later
         // if toHeapNode is the same
         const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+        // Every path over an out of range node is out of range as well
+        if (search_limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+            continue;
+
         // Update values
         update_values(
             heapNode.node, heapNode.weight, heapNode.data.duration, heapNode.data.distance);
@@ -415,12 +422,18 @@ void forwardRoutingStep(const DataFacade<Algorithm> &facade,
                         std::vector<EdgeDuration> &durations_table,
                         std::vector<EdgeDistance> &distances_table,
                         std::vector<NodeID> &middle_nodes_table,
-                        const PhantomNodeCandidates &candidates)
+                        const PhantomNodeCandidates &candidates,
+                        const TableLimits &limits)
 {
+    RequestDeadline::Check();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    // Every path over an out of range node is out of range as well
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+        return;
+
     // Check if each encountered node has an entry
     const auto &bucket_list = std::equal_range(search_space_with_buckets.begin(),
                                                search_space_with_buckets.end(),
@@ -470,12 +483,17 @@ void backwardRoutingStep(const DataFacade<Algorithm> &facade,
                          const unsigned column_idx,
                          typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
                          std::vector<NodeBucket> &search_space_with_buckets,
-                         const PhantomNodeCandidates &candidates)
+                         const PhantomNodeCandidates &candidates,
+                         const TableLimits &limits)
 {
+    RequestDeadline::Check();
     // Take a copy of the extracted node because otherwise could be modified later if toHeapNode is
     // the same
     const auto heapNode = query_heap.DeleteMinGetHeapNode();
 
+    if (limits.Exceeds(heapNode.data.duration, heapNode.data.distance))
+        return;
+
     // Store settled nodes in search space bucket
     search_space_with_buckets.emplace_back(heapNode.node,
                                            heapNode.data.parent,
@@ -534,8 +552,15 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                  const std::vector<PhantomNodeCandidates> &candidates_list,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+                 const bool calculate_distance,
+                 const bool parallel_search,
+                 const TableLimits &limits,
+                 const BucketCacheHandle &bucket_cache)
 {
+    using ManyToManyQueryHeap = SearchEngineData<Algorithm>::ManyToManyQueryHeap;
+
+    const auto search_limits = limits.ForSearchSpaces(candidates_list);
+
     const auto number_of_sources = source_indices.size();
     const auto number_of_targets = target_indices.size();
     const auto number_of_entries = number_of_sources * number_of_targets;
@@ -548,16 +573,21 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
 
     std::vector<NodeBucket> search_space_with_buckets;
 
-    // Populate buckets with paths from all accessible nodes to destinations via backward searches
-    for (std::uint32_t column_idx = 0; column_idx < target_indices.size(); ++column_idx)
+    // Populate buckets with paths from all accessible nodes to destination via backward search,
+    // targets already searched by an earlier request are taken from the bucket cache
+    auto backward_search = [&](ManyToManyQueryHeap &query_heap,
+                               const std::uint32_t column_idx,
+                               std::vector<NodeBucket> &buckets)
     {
-        const auto index = target_indices[column_idx];
-        const auto &target_candidates = candidates_list[index];
-
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        const auto &target_candidates = candidates_list[target_indices[column_idx]];
+        const bool reversed = DIRECTION == REVERSE_DIRECTION;
+        if (bucket_cache &&
+            bucket_cache.AppendCached(facade, reversed, target_candidates, column_idx, buckets))
+        {
+            return;
+        }
 
+        const auto first_bucket = buckets.size();
         if (DIRECTION == FORWARD_DIRECTION)
             insertTargetInHeap(query_heap, target_candidates);
         else
@@ -567,24 +597,22 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
         while (!query_heap.Empty())
         {
             backwardRoutingStep<DIRECTION>(
-                facade, column_idx, query_heap, search_space_with_buckets, target_candidates);
+                facade, column_idx, query_heap, buckets, target_candidates, search_limits);
         }
-    }
 
-    // Order lookup buckets
-    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        // bounded searches miss buckets that unbounded requests need
+        if (bucket_cache && !limits.IsBounded())
+        {
+            bucket_cache.Insert(
+                facade, reversed, target_candidates, buckets.begin() + first_bucket, buckets.end());
+        }
+    };
 
-    // Find shortest paths from sources to all accessible nodes
-    for (std::uint32_t row_idx = 0; row_idx < source_indices.size(); ++row_idx)
+    // Find shortest paths from source to all accessible nodes, only the row (column for
+    // the reversed direction) of the result tables that belongs to the source is written
+    auto forward_search = [&](ManyToManyQueryHeap &query_heap, const std::uint32_t row_idx)
     {
-        const auto source_index = source_indices[row_idx];
-        const auto &source_candidates = candidates_list[source_index];
-
-        // Clear heap and insert source nodes
-        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
-            facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
-
-        auto &query_heap = *(engine_working_data.many_to_many_heap);
+        const auto &source_candidates = candidates_list[source_indices[row_idx]];
 
         if (DIRECTION == FORWARD_DIRECTION)
             insertSourceInHeap(query_heap, source_candidates);
@@ -604,7 +632,75 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                                           durations_table,
                                           distances_table,
                                           middle_nodes_table,
-                                          source_candidates);
+                                          source_candidates,
+                                          search_limits);
+        }
+    };
+
+    if (parallel_search)
+    {
+        // Every task uses its own heap, the thread-local heaps of the engine belong to the
+        // request thread and must not be shared with the TBB workers
+        tbb::enumerable_thread_specific<ManyToManyQueryHeap> query_heaps(
+            facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+        tbb::enumerable_thread_specific<std::vector<NodeBucket>> task_buckets;
+        // the tasks continue the deadline of the request thread
+        const auto request_deadline = RequestDeadline::Current();
+
+        tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, number_of_targets),
+                          [&](const tbb::blocked_range<std::uint32_t> &range)
+                          {
+                              const RequestDeadline request_deadline_scope(request_deadline);
+                              auto &query_heap = query_heaps.local();
+                              auto &buckets = task_buckets.local();
+                              for (auto column_idx = range.begin(); column_idx < range.end();
+                                   ++column_idx)
+                              {
+                                  query_heap.Clear();
+                                  backward_search(query_heap, column_idx, buckets);
+                              }
+                          });
+
+        for (auto &buckets : task_buckets)
+        {
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
+        }
+
+        // Order lookup buckets
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+
+        tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, number_of_sources),
+                          [&](const tbb::blocked_range<std::uint32_t> &range)
+                          {
+                              const RequestDeadline request_deadline_scope(request_deadline);
+                              auto &query_heap = query_heaps.local();
+                              for (auto row_idx = range.begin(); row_idx < range.end(); ++row_idx)
+                              {
+                                  query_heap.Clear();
+                                  forward_search(query_heap, row_idx);
+                              }
+                          });
+    }
+    else
+    {
+        for (std::uint32_t column_idx = 0; column_idx < number_of_targets; ++column_idx)
+        {
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+            backward_search(
+                *engine_working_data.many_to_many_heap, column_idx, search_space_with_buckets);
+        }
+
+        // Order lookup buckets
+        std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+
+        for (std::uint32_t row_idx = 0; row_idx < number_of_sources; ++row_idx)
+        {
+            // Clear heap and insert source nodes
+            engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                facade.GetNumberOfNodes(), facade.GetMaxBorderNodeID() + 1);
+            forward_search(*engine_working_data.many_to_many_heap, row_idx);
         }
     }
 
@@ -625,6 +721,11 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
 //   when number of sources is less than targets. If number of targets is less than sources
 //   then search is performed on a reversed graph with phantom nodes with flipped roles and
 //   returning a transposed matrix.
+//
+// With `parallel_search` the backward and forward searches of many-to-many tasks are spread
+// over TBB tasks, one-to-many tasks consist of a single search and always run sequentially.
+// Only the bucket lists of many-to-many tasks are kept in the `bucket_cache`, and only if the
+// searches are not bounded by `limits`.
 template <>
 std::pair<std::vector<EdgeDuration>, std::vector<EdgeDistance>>
 manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
@@ -632,7 +733,10 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                  const std::vector<PhantomNodeCandidates> &candidates_list,
                  const std::vector<std::size_t> &source_indices,
                  const std::vector<std::size_t> &target_indices,
-                 const bool calculate_distance)
+                 const bool calculate_distance,
+                 const bool parallel_search,
+                 const TableLimits &limits,
+                 const BucketCacheHandle &bucket_cache)
 {
     if (source_indices.size() == 1)
     { // TODO: check if target_indices.size() == 1 and do a bi-directional search
@@ -641,7 +745,8 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                        candidates_list,
                                                        source_indices.front(),
                                                        target_indices,
-                                                       calculate_distance);
+                                                       calculate_distance,
+                                                       limits);
     }
 
     if (target_indices.size() == 1)
@@ -651,7 +756,8 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                        candidates_list,
                                                        target_indices.front(),
                                                        source_indices,
-                                                       calculate_distance);
+                                                       calculate_distance,
+                                                       limits);
     }
 
     if (target_indices.size() < source_indices.size())
@@ -661,7 +767,10 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                         candidates_list,
                                                         target_indices,
                                                         source_indices,
-                                                        calculate_distance);
+                                                        calculate_distance,
+                                                        parallel_search,
+                                                        limits,
+                                                        bucket_cache);
     }
 
     return mld::manyToManySearch<FORWARD_DIRECTION>(engine_working_data,
@@ -669,7 +778,10 @@ manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                                                     candidates_list,
                                                     source_indices,
                                                     target_indices,
-                                                    calculate_distance);
+                                                    calculate_distance,
+                                                    parallel_search,
+                                                    limits,
+                                                    bucket_cache);
 }
 
 } // namespace osrm::engine::routing_algorithms
@@ -1,10 +1,11 @@
 #include "engine/routing_algorithms/map_matching.hpp"
-#include "engine/routing_algorithms/routing_base_ch.hpp"
-#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/routing_algorithms/bucket_cache.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
 
 #include "engine/map_matching/hidden_markov_model.hpp"
 #include "engine/map_matching/matching_confidence.hpp"
 #include "engine/map_matching/sub_matching.hpp"
+#include "engine/map_matching/viterbi_kernels.hpp"
 
 #include "util/coordinate_calculation.hpp"
 #include "util/for_each_pair.hpp"
@@ -43,24 +44,149 @@ unsigned getMedianSampleTime(const std::vector<unsigned> &timestamps)
     return *median;
 }
 
+// Network distances from the source to the target candidates of a transition as a row major
+// table, pairs beyond the limits are MAXIMAL_EDGE_DISTANCE. CH needs a backward search for
+// every target, so all sources share one table.
 template <typename Algorithm>
-inline void initializeHeap(SearchEngineData<Algorithm> &engine_working_data,
-                           const DataFacade<Algorithm> &facade)
+std::vector<EdgeDistance>
+getTransitionDistances(SearchEngineData<Algorithm> &engine_working_data,
+                       const DataFacade<Algorithm> &facade,
+                       const std::vector<PhantomNodeCandidates> &candidates,
+                       const std::vector<std::size_t> &source_indices,
+                       const std::vector<std::size_t> &target_indices,
+                       const TableLimits &limits)
 {
-
-    const auto nodes_number = facade.GetNumberOfNodes();
-    engine_working_data.InitializeOrClearMapMatchingThreadLocalStorage(nodes_number);
+    auto [durations, distances] = manyToManySearch(engine_working_data,
+                                                   facade,
+                                                   candidates,
+                                                   source_indices,
+                                                   target_indices,
+                                                   true,
+                                                   false,
+                                                   limits,
+                                                   BucketCacheHandle{});
+    limits.Apply(durations, distances);
+    return distances;
 }
 
+// MLD runs a one-to-many search per source instead, which stops as soon as all targets are
+// settled or the limits are reached.
 template <>
-inline void initializeHeap<mld::Algorithm>(SearchEngineData<mld::Algorithm> &engine_working_data,
-                                           const DataFacade<mld::Algorithm> &facade)
+std::vector<EdgeDistance>
+getTransitionDistances<mld::Algorithm>(SearchEngineData<mld::Algorithm> &engine_working_data,
+                                       const DataFacade<mld::Algorithm> &facade,
+                                       const std::vector<PhantomNodeCandidates> &candidates,
+                                       const std::vector<std::size_t> &source_indices,
+                                       const std::vector<std::size_t> &target_indices,
+                                       const TableLimits &limits)
+{
+    std::vector<EdgeDistance> distances;
+    distances.reserve(source_indices.size() * target_indices.size());
+    for (const auto source_index : source_indices)
+    {
+        auto [row_durations, row_distances] = manyToManySearch(engine_working_data,
+                                                               facade,
+                                                               candidates,
+                                                               {source_index},
+                                                               target_indices,
+                                                               true,
+                                                               false,
+                                                               limits,
+                                                               BucketCacheHandle{});
+        limits.Apply(row_durations, row_distances);
+        distances.insert(distances.end(), row_distances.begin(), row_distances.end());
+    }
+    return distances;
+}
+
+// The candidates of the previous and the current timestamp of a transition
+struct TransitionBuffers
+{
+    std::vector<PhantomNodeCandidates> candidates;
+    std::vector<std::size_t> sources;
+    std::vector<std::size_t> targets;
+};
+
+// Sets the emission log probabilities of the candidates of a trace point
+void setEmissionLogProbabilities(const CandidateList &candidates,
+                                 const std::optional<double> &gps_precision,
+                                 double *emission_log_probabilities)
 {
+    const map_matching::EmissionLogProbability emission_log_probability(
+        gps_precision.value_or(DEFAULT_GPS_PRECISION));
+    std::transform(candidates.begin(),
+                   candidates.end(),
+                   emission_log_probabilities,
+                   [](const PhantomNodeWithDistance &candidate) { return candidate.distance; });
+    map_matching::computeEmissionLogProbabilities(
+        emission_log_probability, emission_log_probabilities, candidates.size());
+}
 
-    const auto nodes_number = facade.GetNumberOfNodes();
-    const auto border_nodes_number = facade.GetMaxBorderNodeID() + 1;
-    engine_working_data.InitializeOrClearMapMatchingThreadLocalStorage(nodes_number,
-                                                                       border_nodes_number);
+// Extends the Viterbi paths of the previous unbroken timestamp to the candidates of the current
+// one. Returns false if none of them can be reached, which is a breakage of the trace. The lattice
+// is either the one of a whole trace or the one of a matching session.
+template <typename Algorithm>
+bool updateViterbi(SearchEngineData<Algorithm> &engine_working_data,
+                   const DataFacade<Algorithm> &facade,
+                   TransitionBuffers &buffers,
+                   const CandidateList &prev_candidates,
+                   const map_matching::LatticeColumn &prev,
+                   const unsigned prev_timestamp,
+                   const CandidateList &current_candidates,
+                   const map_matching::LatticeColumn &current,
+                   const double haversine_distance,
+                   const double max_distance_delta)
+{
+    const map_matching::TransitionLogProbability transition_log_probability(MATCHING_BETA);
+
+    // all transitions of this timestamp are searched at once, paths longer than
+    // haversine_distance + max_distance_delta are pruned below anyway
+    buffers.candidates.clear();
+    buffers.sources.clear();
+    buffers.targets.clear();
+    for (const auto s : util::irange<std::size_t>(0UL, prev.size))
+    {
+        if (!prev.pruned[s])
+        {
+            buffers.sources.push_back(buffers.candidates.size());
+            buffers.candidates.push_back({prev_candidates[s].phantom_node});
+        }
+    }
+    for (const auto &candidate : current_candidates)
+    {
+        buffers.targets.push_back(buffers.candidates.size());
+        buffers.candidates.push_back({candidate.phantom_node});
+    }
+    TableLimits limits;
+    limits.max_distance = to_alias<EdgeDistance>(haversine_distance + max_distance_delta);
+    const auto network_distances = getTransitionDistances(engine_working_data,
+                                                          facade,
+                                                          buffers.candidates,
+                                                          buffers.sources,
+                                                          buffers.targets,
+                                                          limits);
+
+    // max-plus update of the current column with one row of the distance table per source, the
+    // rows are relaxed in the order of the sources to keep the first of equally good paths
+    bool reachable = false;
+    std::size_t row = 0;
+    for (const auto s : util::irange<std::size_t>(0UL, prev.size))
+    {
+        if (prev.pruned[s])
+        {
+            continue;
+        }
+        const auto *row_distances = network_distances.data() + row++ * current.size;
+        reachable = map_matching::relaxTransitions(transition_log_probability,
+                                                   prev.viterbi[s],
+                                                   std::make_pair(prev_timestamp, s),
+                                                   row_distances,
+                                                   haversine_distance,
+                                                   max_distance_delta,
+                                                   current) ||
+                    reachable;
+    }
+    return reachable;
 }
 } // namespace
 
@@ -74,8 +200,6 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const bool allow_splitting)
 {
     map_matching::MatchingConfidence confidence;
-    map_matching::EmissionLogProbability default_emission_log_probability(DEFAULT_GPS_PRECISION);
-    map_matching::TransitionLogProbability transition_log_probability(MATCHING_BETA);
 
     SubMatchingList sub_matchings;
 
@@ -97,56 +221,22 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     }();
     const auto max_broken_time = median_sample_time * MAX_BROKEN_STATES;
 
-    std::vector<std::vector<double>> emission_log_probabilities(trace_coordinates.size());
-    if (trace_gps_precision.empty())
-    {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
-        {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            std::transform(candidates_list[t].begin(),
-                           candidates_list[t].end(),
-                           emission_log_probabilities[t].begin(),
-                           [&](const PhantomNodeWithDistance &candidate)
-                           { return default_emission_log_probability(candidate.distance); });
-        }
-    }
-    else
+    HMM model(candidates_list);
+    for (const auto t : util::irange<std::size_t>(0UL, candidates_list.size()))
     {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
-        {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            if (trace_gps_precision[t])
-            {
-                map_matching::EmissionLogProbability emission_log_probability(
-                    *trace_gps_precision[t]);
-                std::transform(candidates_list[t].begin(),
-                               candidates_list[t].end(),
-                               emission_log_probabilities[t].begin(),
-                               [&emission_log_probability](const PhantomNodeWithDistance &candidate)
-                               { return emission_log_probability(candidate.distance); });
-            }
-            else
-            {
-                std::transform(candidates_list[t].begin(),
-                               candidates_list[t].end(),
-                               emission_log_probabilities[t].begin(),
-                               [&](const PhantomNodeWithDistance &candidate)
-                               { return default_emission_log_probability(candidate.distance); });
-            }
-        }
+        setEmissionLogProbabilities(candidates_list[t],
+                                    trace_gps_precision.empty() ? std::nullopt
+                                                                : trace_gps_precision[t],
+                                    model.emission_log_probabilities.data() + model.offsets[t]);
     }
 
-    HMM model(candidates_list, emission_log_probabilities);
-
     std::size_t initial_timestamp = model.initialize(0);
     if (initial_timestamp == map_matching::INVALID_STATE)
     {
         return sub_matchings;
     }
 
-    initializeHeap(engine_working_data, facade);
-    auto &forward_heap = *engine_working_data.map_matching_forward_heap_1;
-    auto &reverse_heap = *engine_working_data.map_matching_reverse_heap_1;
+    TransitionBuffers transition_buffers;
 
     std::size_t breakage_begin = map_matching::INVALID_STATE;
     std::vector<std::size_t> split_points;
@@ -199,71 +289,27 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             BOOST_ASSERT(!prev_unbroken_timestamps.empty());
             const std::size_t prev_unbroken_timestamp = prev_unbroken_timestamps.back();
 
-            const auto &prev_viterbi = model.viterbi[prev_unbroken_timestamp];
-            const auto &prev_pruned = model.pruned[prev_unbroken_timestamp];
             const auto &prev_unbroken_timestamps_list = candidates_list[prev_unbroken_timestamp];
             const auto &prev_coordinate = trace_coordinates[prev_unbroken_timestamp];
 
-            auto &current_viterbi = model.viterbi[t];
-            auto &current_pruned = model.pruned[t];
-            auto &current_parents = model.parents[t];
-            auto &current_lengths = model.path_distances[t];
             const auto &current_timestamps_list = candidates_list[t];
             const auto &current_coordinate = trace_coordinates[t];
 
             const auto haversine_distance = util::coordinate_calculation::greatCircleDistance(
                 prev_coordinate, current_coordinate);
-            // assumes minumum of 4 m/s
-            const EdgeWeight weight_upper_bound = to_alias<EdgeWeight>(
-                ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier());
 
-            // compute d_t for this timestamp and the next one
-            for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
+            if (updateViterbi(engine_working_data,
+                              facade,
+                              transition_buffers,
+                              prev_unbroken_timestamps_list,
+                              model.Column(prev_unbroken_timestamp),
+                              prev_unbroken_timestamp,
+                              current_timestamps_list,
+                              model.Column(t),
+                              haversine_distance,
+                              max_distance_delta))
             {
-                if (prev_pruned[s])
-                {
-                    continue;
-                }
-
-                for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
-                {
-                    const double emission_pr = emission_log_probabilities[t][s_prime];
-                    double new_value = prev_viterbi[s] + emission_pr;
-                    if (current_viterbi[s_prime] > new_value)
-                    {
-                        continue;
-                    }
-
-                    double network_distance =
-                        getNetworkDistance(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           prev_unbroken_timestamps_list[s].phantom_node,
-                                           current_timestamps_list[s_prime].phantom_node,
-                                           weight_upper_bound);
-
-                    // get distance diff between loc1/2 and locs/s_prime
-                    const auto d_t = std::abs(network_distance - haversine_distance);
-
-                    // very low probability transition -> prune
-                    if (d_t >= max_distance_delta)
-                    {
-                        continue;
-                    }
-
-                    const double transition_pr = transition_log_probability(d_t);
-                    new_value += transition_pr;
-
-                    if (new_value > current_viterbi[s_prime])
-                    {
-                        current_viterbi[s_prime] = new_value;
-                        current_parents[s_prime] = std::make_pair(prev_unbroken_timestamp, s);
-                        current_lengths[s_prime] = network_distance;
-                        current_pruned[s_prime] = false;
-                        model.breakage[t] = false;
-                    }
-                }
+                model.breakage[t] = false;
             }
 
             if (model.breakage[t])
@@ -347,19 +393,19 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
         }
 
         // loop through the columns, and only compare the last entry
-        const auto max_element_iter =
-            std::max_element(model.viterbi[parent_timestamp_index].begin(),
-                             model.viterbi[parent_timestamp_index].end());
+        const auto last_viterbi = model.viterbi.begin() + model.offsets[parent_timestamp_index];
+        const auto max_element_iter = std::max_element(
+            last_viterbi, last_viterbi + model.NumberOfCandidates(parent_timestamp_index));
 
-        std::size_t parent_candidate_index =
-            std::distance(model.viterbi[parent_timestamp_index].begin(), max_element_iter);
+        std::size_t parent_candidate_index = std::distance(last_viterbi, max_element_iter);
 
         std::deque<std::pair<std::size_t, std::size_t>> reconstructed_indices;
         while (parent_timestamp_index > sub_matching_begin)
         {
             reconstructed_indices.emplace_front(parent_timestamp_index, parent_candidate_index);
-            model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] = true;
-            const auto &next = model.parents[parent_timestamp_index][parent_candidate_index];
+            const auto index = model.Index(parent_timestamp_index, parent_candidate_index);
+            model.viterbi_reachable[index] = true;
+            const auto &next = model.parents[index];
             // make sure we can never get stuck in this loop
             if (parent_timestamp_index == next.first)
             {
@@ -369,7 +415,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             parent_candidate_index = next.second;
         }
         reconstructed_indices.emplace_front(parent_timestamp_index, parent_candidate_index);
-        model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] = true;
+        model.viterbi_reachable[model.Index(parent_timestamp_index, parent_candidate_index)] =
+            true;
         if (reconstructed_indices.size() < 2)
         {
             sub_matching_begin = sub_matching_end;
@@ -378,23 +425,24 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
 
         // fill viterbi reachability matrix
         for (const auto s_last :
-             util::irange<std::size_t>(0UL, model.viterbi[sub_matching_last_timestamp].size()))
+             util::irange<std::size_t>(0UL, model.NumberOfCandidates(sub_matching_last_timestamp)))
         {
             parent_timestamp_index = sub_matching_last_timestamp;
             parent_candidate_index = s_last;
             while (parent_timestamp_index > sub_matching_begin)
             {
-                if (model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] ||
-                    model.pruned[parent_timestamp_index][parent_candidate_index])
+                const auto index = model.Index(parent_timestamp_index, parent_candidate_index);
+                if (model.viterbi_reachable[index] || model.pruned[index])
                 {
                     break;
                 }
-                model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] = true;
-                const auto &next = model.parents[parent_timestamp_index][parent_candidate_index];
+                model.viterbi_reachable[index] = true;
+                const auto &next = model.parents[index];
                 parent_timestamp_index = next.first;
                 parent_candidate_index = next.second;
             }
-            model.viterbi_reachable[parent_timestamp_index][parent_candidate_index] = true;
+            model.viterbi_reachable[model.Index(parent_timestamp_index, parent_candidate_index)] =
+                true;
         }
 
         auto matching_distance = 0.0;
@@ -409,14 +457,14 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
 
             matching.indices.push_back(timestamp_index);
             matching.nodes.push_back(candidates_list[timestamp_index][location_index].phantom_node);
-            auto const routes_count =
-                std::accumulate(model.viterbi_reachable[timestamp_index].begin(),
-                                model.viterbi_reachable[timestamp_index].end(),
-                                0);
+            const auto reachable = model.viterbi_reachable.begin() + model.offsets[timestamp_index];
+            auto const routes_count = std::accumulate(
+                reachable, reachable + model.NumberOfCandidates(timestamp_index), 0);
             BOOST_ASSERT(routes_count > 0);
             // we don't count the current route in the "alternatives_count" parameter
             matching.alternatives_count.push_back(routes_count - 1);
-            matching_distance += model.path_distances[timestamp_index][location_index];
+            matching_distance +=
+                model.path_distances[model.Index(timestamp_index, location_index)];
         }
         util::for_each_pair(
             reconstructed_indices,
@@ -454,6 +502,335 @@ template SubMatchingList mapMatching(SearchEngineData<mld::Algorithm> &engine_wo
                                      const std::vector<std::optional<double>> &trace_gps_precision,
                                      const bool allow_splitting);
 
+namespace
+{
+constexpr static const std::size_t MAX_SAMPLE_TIMES = 64;
+// finalize the best path if the candidates of a session don't converge for this many points
+constexpr static const std::size_t MAX_PENDING_POINTS = 100;
+
+std::vector<double> getEmissionLogProbabilities(const CandidateList &candidates,
+                                                const std::optional<double> &gps_precision)
+{
+    std::vector<double> emission_log_probabilities(candidates.size());
+    setEmissionLogProbabilities(candidates, gps_precision, emission_log_probabilities.data());
+    return emission_log_probabilities;
+}
+
+map_matching::LatticeColumn makeLatticeColumn(map_matching::MatchingState::Column &column)
+{
+    return map_matching::LatticeColumn{column.candidates.size(),
+                                       column.emission_log_probabilities.data(),
+                                       column.viterbi.data(),
+                                       column.parents.data(),
+                                       column.path_distances.data(),
+                                       column.pruned.data()};
+}
+
+std::size_t getLastUnbrokenColumn(const map_matching::MatchingState &state)
+{
+    BOOST_ASSERT(!state.Empty());
+    auto column = state.columns.size() - 1;
+    while (column > 0 && state.columns[column].breakage)
+    {
+        --column;
+    }
+    BOOST_ASSERT(!state.columns[column].breakage);
+    return column;
+}
+
+std::size_t getBestCandidate(const map_matching::MatchingState::Column &column)
+{
+    return std::distance(column.viterbi.begin(),
+                         std::max_element(column.viterbi.begin(), column.viterbi.end()));
+}
+
+// Returns the points of the state up to the given column with the Viterbi path that ends in the
+// given candidate and drops them from the state, except for the last one
+void finalizeColumns(map_matching::MatchingState &state,
+                     const std::size_t last_column,
+                     const std::size_t last_candidate,
+                     FinalizedMatching &finalized)
+{
+    // the point was returned before and there is nothing to add
+    if (last_column == 0 && state.first_is_final)
+    {
+        return;
+    }
+
+    map_matching::MatchingConfidence confidence;
+
+    std::deque<std::pair<unsigned, unsigned>> reconstructed_indices;
+    unsigned sequence = state.first_sequence + last_column;
+    unsigned candidate = last_candidate;
+    while (true)
+    {
+        reconstructed_indices.emplace_front(sequence, candidate);
+        const auto &next = state.GetColumn(sequence).parents[candidate];
+        // make sure we can never get stuck in this loop
+        if (next.first == sequence)
+        {
+            break;
+        }
+        sequence = next.first;
+        candidate = next.second;
+    }
+    BOOST_ASSERT(reconstructed_indices.front().first == state.first_sequence);
+
+    const auto first_index = finalized.points.size();
+    for (const auto column : util::irange<std::size_t>(0UL, last_column + 1))
+    {
+        finalized.points.push_back(state.columns[column].point);
+    }
+
+    if (reconstructed_indices.size() >= 2)
+    {
+        map_matching::SubMatching matching;
+        auto matching_distance = 0.0;
+        auto trace_distance = 0.0;
+        for (const auto &[path_sequence, path_candidate] : reconstructed_indices)
+        {
+            const auto &column = state.GetColumn(path_sequence);
+            matching.indices.push_back(first_index + path_sequence - state.first_sequence);
+            matching.nodes.push_back(column.candidates[path_candidate].phantom_node);
+            // the other candidates are gone once the points are final
+            matching.alternatives_count.push_back(0);
+            if (path_sequence != state.first_sequence)
+            {
+                matching_distance += column.path_distances[path_candidate];
+            }
+        }
+        util::for_each_pair(reconstructed_indices,
+                            [&](const std::pair<unsigned, unsigned> &prev,
+                                const std::pair<unsigned, unsigned> &curr)
+                            {
+                                trace_distance += util::coordinate_calculation::greatCircleDistance(
+                                    state.GetColumn(prev.first).point.coordinate,
+                                    state.GetColumn(curr.first).point.coordinate);
+                            });
+        matching.confidence = confidence(trace_distance, matching_distance);
+        finalized.sub_matchings.push_back(std::move(matching));
+    }
+
+    state.columns.erase(state.columns.begin(), state.columns.begin() + last_column);
+    state.first_sequence += last_column;
+    state.first_is_final = true;
+
+    // later paths have to continue with the finalized candidate
+    auto &first = state.columns.front();
+    for (const auto s : util::irange<std::size_t>(0UL, first.candidates.size()))
+    {
+        if (s != last_candidate)
+        {
+            first.viterbi[s] = map_matching::IMPOSSIBLE_LOG_PROB;
+            first.pruned[s] = true;
+        }
+    }
+    first.parents[last_candidate] = std::make_pair(state.first_sequence, last_candidate);
+}
+
+// Starts the lattice with the given point, returns false if it has no candidate
+bool initializeState(map_matching::MatchingState &state,
+                     const unsigned sequence,
+                     map_matching::MatchingState::Column column)
+{
+    for (const auto s : util::irange<std::size_t>(0UL, column.candidates.size()))
+    {
+        column.viterbi[s] = column.emission_log_probabilities[s];
+        column.parents[s] = std::make_pair(sequence, s);
+        column.pruned[s] = column.viterbi[s] < map_matching::MINIMAL_LOG_PROB;
+        column.breakage = column.breakage && column.pruned[s];
+    }
+    if (column.breakage)
+    {
+        return false;
+    }
+
+    state.columns.clear();
+    state.columns.push_back(std::move(column));
+    state.first_sequence = sequence;
+    state.first_is_final = false;
+    return true;
+}
+} // namespace
+
+template <typename Algorithm>
+FinalizedMatching incrementalMapMatching(SearchEngineData<Algorithm> &engine_working_data,
+                                         const DataFacade<Algorithm> &facade,
+                                         map_matching::MatchingState &state,
+                                         const CandidateLists &candidates_list,
+                                         const std::vector<map_matching::TracePoint> &trace_points,
+                                         const bool allow_splitting)
+{
+    BOOST_ASSERT(candidates_list.size() == trace_points.size());
+
+    FinalizedMatching finalized;
+    TransitionBuffers transition_buffers;
+
+    for (const auto index : util::irange<std::size_t>(0UL, trace_points.size()))
+    {
+        const auto &point = trace_points[index];
+        const auto &candidates = candidates_list[index];
+        const auto number_of_candidates = candidates.size();
+
+        map_matching::MatchingState::Column column{
+            point,
+            candidates,
+            getEmissionLogProbabilities(candidates, point.gps_precision),
+            std::vector<double>(number_of_candidates, map_matching::IMPOSSIBLE_LOG_PROB),
+            std::vector<std::pair<unsigned, unsigned>>(number_of_candidates),
+            std::vector<float>(number_of_candidates, 0),
+            std::vector<std::uint8_t>(number_of_candidates, true),
+            true};
+
+        if (state.last_timestamp)
+        {
+            state.sample_times.push_back(point.timestamp - *state.last_timestamp);
+            if (state.sample_times.size() > MAX_SAMPLE_TIMES)
+            {
+                state.sample_times.pop_front();
+            }
+        }
+        state.last_timestamp = point.timestamp;
+
+        if (state.Empty())
+        {
+            // points before the first one with candidates can't be matched
+            if (!initializeState(state, state.first_sequence, std::move(column)))
+            {
+                finalized.points.push_back(point);
+                ++state.first_sequence;
+            }
+            continue;
+        }
+
+        const unsigned sequence = state.GetLastSequence() + 1;
+        const auto prev_column = getLastUnbrokenColumn(state);
+        auto &prev = state.columns[prev_column];
+        const unsigned prev_sequence = state.first_sequence + prev_column;
+
+        const auto step_time = point.timestamp - prev.point.timestamp;
+        const auto max_distance_delta = step_time * facade.GetMapMatchingMaxSpeed();
+
+        const bool gap_in_trace = [&]()
+        {
+            if (allow_splitting && !state.sample_times.empty())
+            {
+                std::vector<unsigned> sample_times(state.sample_times.begin(),
+                                                   state.sample_times.end());
+                const auto median = sample_times.begin() + sample_times.size() / 2;
+                std::nth_element(sample_times.begin(), median, sample_times.end());
+                return step_time > std::max(1u, *median) * MAX_BROKEN_STATES;
+            }
+            else
+            {
+                return sequence - prev_sequence > MAX_BROKEN_STATES;
+            }
+        }();
+
+        if (gap_in_trace)
+        {
+            finalizeColumns(state, prev_column, getBestCandidate(prev), finalized);
+            // the broken points after the last matched one
+            for (const auto broken : util::irange<std::size_t>(1UL, state.columns.size()))
+            {
+                finalized.points.push_back(state.columns[broken].point);
+            }
+            state.columns.clear();
+            state.first_sequence = sequence;
+            if (!initializeState(state, sequence, std::move(column)))
+            {
+                finalized.points.push_back(point);
+                ++state.first_sequence;
+            }
+            continue;
+        }
+
+        const auto haversine_distance = util::coordinate_calculation::greatCircleDistance(
+            prev.point.coordinate, point.coordinate);
+        column.breakage = !updateViterbi(engine_working_data,
+                                         facade,
+                                         transition_buffers,
+                                         prev.candidates,
+                                         makeLatticeColumn(prev),
+                                         prev_sequence,
+                                         column.candidates,
+                                         makeLatticeColumn(column),
+                                         haversine_distance,
+                                         max_distance_delta);
+        state.columns.push_back(std::move(column));
+    }
+
+    if (state.Empty())
+    {
+        return finalized;
+    }
+
+    // Points are final as soon as the Viterbi paths of all candidates of the last matched point
+    // go through the same candidate of a point
+    const auto last_column = getLastUnbrokenColumn(state);
+    std::vector<unsigned> path_candidates;
+    for (const auto s : util::irange<std::size_t>(0UL, state.columns[last_column].pruned.size()))
+    {
+        if (!state.columns[last_column].pruned[s])
+        {
+            path_candidates.push_back(s);
+        }
+    }
+    auto column = last_column;
+    while (path_candidates.size() > 1 && column > 0)
+    {
+        const auto &parents = state.columns[column].parents;
+        for (auto &candidate : path_candidates)
+        {
+            column = parents[candidate].first - state.first_sequence;
+            candidate = parents[candidate].second;
+        }
+        std::sort(path_candidates.begin(), path_candidates.end());
+        path_candidates.erase(std::unique(path_candidates.begin(), path_candidates.end()),
+                              path_candidates.end());
+    }
+    if (path_candidates.size() == 1 && column > 0)
+    {
+        finalizeColumns(state, column, path_candidates.front(), finalized);
+    }
+    else if (state.columns.size() > MAX_PENDING_POINTS)
+    {
+        finalizeColumns(
+            state, last_column, getBestCandidate(state.columns[last_column]), finalized);
+    }
+
+    // only differences of the Viterbi values matter, keep them from drifting
+    const auto &last = state.columns[getLastUnbrokenColumn(state)].viterbi;
+    const auto max_viterbi = *std::max_element(last.begin(), last.end());
+    for (auto &state_column : state.columns)
+    {
+        for (auto &value : state_column.viterbi)
+        {
+            value -= max_viterbi;
+        }
+    }
+
+    return finalized;
+}
+
+// CH
+template FinalizedMatching
+incrementalMapMatching(SearchEngineData<ch::Algorithm> &engine_working_data,
+                       const DataFacade<ch::Algorithm> &facade,
+                       map_matching::MatchingState &state,
+                       const CandidateLists &candidates_list,
+                       const std::vector<map_matching::TracePoint> &trace_points,
+                       const bool allow_splitting);
+
+// MLD
+template FinalizedMatching
+incrementalMapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
+                       const DataFacade<mld::Algorithm> &facade,
+                       map_matching::MatchingState &state,
+                       const CandidateLists &candidates_list,
+                       const std::vector<map_matching::TracePoint> &trace_points,
+                       const bool allow_splitting);
+
 } // namespace osrm::engine::routing_algorithms
 
 //[1] "Hidden Markov Map Matching Through Noise and Sparseness"; P. Newson and J. Krumm; 2009; ACM
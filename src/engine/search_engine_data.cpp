@@ -1,8 +1,39 @@
 #include "engine/search_engine_data.hpp"
 
+#include "util/log.hpp"
+
+#include <thread>
+
 namespace osrm::engine
 {
 
+namespace
+{
+template <typename HeapPtr> std::size_t getMemoryUsage(const HeapPtr &heap)
+{
+    return heap ? heap->MemoryUsage() : 0;
+}
+
+// Without a budget the heaps are kept and their memory is not computed. With a budget the heap
+// memory of the thread is logged after every query.
+template <typename SearchEngineDataT>
+void releaseThreadLocalStorageOverBudget(SearchEngineDataT &search_engine_data)
+{
+    if (!search_engine_data.max_thread_local_memory_usage)
+    {
+        return;
+    }
+    const auto memory_usage = search_engine_data.GetThreadLocalMemoryUsage();
+    const bool release = memory_usage > *search_engine_data.max_thread_local_memory_usage;
+    if (release)
+    {
+        search_engine_data.ReleaseThreadLocalStorage();
+    }
+    util::Log(logDEBUG) << "[heaps][" << std::this_thread::get_id() << "] "
+                        << memory_usage / 1024 << " KiB" << (release ? ", released" : "");
+}
+} // namespace
+
 // CH heaps
 using CH = routing_algorithms::ch::Algorithm;
 thread_local SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
@@ -11,34 +42,9 @@ thread_local SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::for
 thread_local SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
 thread_local SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
 thread_local SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
-thread_local SearchEngineData<CH>::SearchEngineHeapPtr
-    SearchEngineData<CH>::map_matching_forward_heap_1;
-thread_local SearchEngineData<CH>::SearchEngineHeapPtr
-    SearchEngineData<CH>::map_matching_reverse_heap_1;
 
 thread_local SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
 
-void SearchEngineData<CH>::InitializeOrClearMapMatchingThreadLocalStorage(unsigned number_of_nodes)
-{
-    if (map_matching_forward_heap_1.get())
-    {
-        map_matching_forward_heap_1->Clear();
-    }
-    else
-    {
-        map_matching_forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (map_matching_reverse_heap_1.get())
-    {
-        map_matching_reverse_heap_1->Clear();
-    }
-    else
-    {
-        map_matching_reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-}
-
 void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
     if (forward_heap_1.get())
@@ -47,7 +53,7 @@ void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned num
     }
     else
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        forward_heap_1.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 
     if (reverse_heap_1.get())
@@ -56,7 +62,7 @@ void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned num
     }
     else
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        reverse_heap_1.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 }
 
@@ -68,7 +74,7 @@ void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned nu
     }
     else
     {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
+        forward_heap_2.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 
     if (reverse_heap_2.get())
@@ -77,7 +83,7 @@ void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned nu
     }
     else
     {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
+        reverse_heap_2.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 }
 
@@ -89,7 +95,7 @@ void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned num
     }
     else
     {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
+        forward_heap_3.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 
     if (reverse_heap_3.get())
@@ -98,7 +104,7 @@ void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned num
     }
     else
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        reverse_heap_3.reset(new QueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 }
 
@@ -110,76 +116,137 @@ void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigne
     }
     else
     {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
+        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes, MAX_ARRAY_HEAP_NODES));
     }
 }
 
+std::size_t SearchEngineData<CH>::GetThreadLocalMemoryUsage() const
+{
+    return getMemoryUsage(forward_heap_1) + getMemoryUsage(reverse_heap_1) +
+           getMemoryUsage(forward_heap_2) + getMemoryUsage(reverse_heap_2) +
+           getMemoryUsage(forward_heap_3) + getMemoryUsage(reverse_heap_3) +
+           getMemoryUsage(many_to_many_heap);
+}
+
+void SearchEngineData<CH>::ReleaseThreadLocalStorage()
+{
+    forward_heap_1.reset();
+    reverse_heap_1.reset();
+    forward_heap_2.reset();
+    reverse_heap_2.reset();
+    forward_heap_3.reset();
+    reverse_heap_3.reset();
+    many_to_many_heap.reset();
+}
+
+void SearchEngineData<CH>::ReleaseThreadLocalStorageOverBudget()
+{
+    releaseThreadLocalStorageOverBudget(*this);
+}
+
 // MLD
 using MLD = routing_algorithms::mld::Algorithm;
 thread_local SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_1;
 thread_local SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_1;
-thread_local SearchEngineData<MLD>::MapMatchingHeapPtr
-    SearchEngineData<MLD>::map_matching_forward_heap_1;
-thread_local SearchEngineData<MLD>::MapMatchingHeapPtr
-    SearchEngineData<MLD>::map_matching_reverse_heap_1;
 thread_local SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_heap;
 
-void SearchEngineData<MLD>::InitializeOrClearMapMatchingThreadLocalStorage(
+void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(
     unsigned number_of_nodes, unsigned number_of_boundary_nodes)
 {
-    if (map_matching_forward_heap_1.get())
+    if (forward_heap_1.get())
+    {
+        forward_heap_1->Clear();
+    }
+    else
+    {
+        forward_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+    }
+
+    if (reverse_heap_1.get())
     {
-        map_matching_forward_heap_1->Clear();
+        reverse_heap_1->Clear();
     }
     else
     {
-        map_matching_forward_heap_1.reset(
-            new MapMatchingQueryHeap(number_of_nodes, number_of_boundary_nodes));
+        reverse_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
     }
+}
 
-    if (map_matching_reverse_heap_1.get())
+void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(
+    unsigned number_of_nodes, unsigned number_of_boundary_nodes)
+{
+    if (many_to_many_heap.get())
     {
-        map_matching_reverse_heap_1->Clear();
+        many_to_many_heap->Clear();
     }
     else
     {
-        map_matching_reverse_heap_1.reset(
-            new MapMatchingQueryHeap(number_of_nodes, number_of_boundary_nodes));
+        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes, number_of_boundary_nodes));
     }
 }
 
-void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(
+SearchEngineData<MLD>::TaskHeaps &SearchEngineData<MLD>::InitializeOrClearTaskThreadLocalStorage(
     unsigned number_of_nodes, unsigned number_of_boundary_nodes)
 {
-    if (forward_heap_1.get())
+    auto &heaps = task_heaps.local();
+    if (heaps.forward_heap.get())
     {
-        forward_heap_1->Clear();
+        heaps.forward_heap->Clear();
     }
     else
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+        heaps.forward_heap.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
     }
 
-    if (reverse_heap_1.get())
+    if (heaps.reverse_heap.get())
     {
-        reverse_heap_1->Clear();
+        heaps.reverse_heap->Clear();
     }
     else
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
+        heaps.reverse_heap.reset(new QueryHeap(number_of_nodes, number_of_boundary_nodes));
     }
+    return heaps;
 }
 
-void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(
-    unsigned number_of_nodes, unsigned number_of_boundary_nodes)
+std::size_t SearchEngineData<MLD>::GetThreadLocalMemoryUsage() const
 {
-    if (many_to_many_heap.get())
+    const auto &heaps = task_heaps.local();
+    return getMemoryUsage(forward_heap_1) + getMemoryUsage(reverse_heap_1) +
+           getMemoryUsage(many_to_many_heap) + getMemoryUsage(heaps.forward_heap) +
+           getMemoryUsage(heaps.reverse_heap);
+}
+
+void SearchEngineData<MLD>::ReleaseThreadLocalStorage()
+{
+    forward_heap_1.reset();
+    reverse_heap_1.reset();
+    many_to_many_heap.reset();
+    auto &heaps = task_heaps.local();
+    heaps.forward_heap.reset();
+    heaps.reverse_heap.reset();
+}
+
+void SearchEngineData<MLD>::ReleaseThreadLocalStorageOverBudget()
+{
+    releaseThreadLocalStorageOverBudget(*this);
+}
+
+void SearchEngineData<MLD>::ReleaseTaskThreadLocalStorageOverBudget()
+{
+    if (!max_thread_local_memory_usage)
     {
-        many_to_many_heap->Clear();
+        return;
     }
-    else
+    auto &heaps = task_heaps.local();
+    const auto memory_usage =
+        getMemoryUsage(heaps.forward_heap) + getMemoryUsage(heaps.reverse_heap);
+    if (memory_usage > *max_thread_local_memory_usage)
     {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes, number_of_boundary_nodes));
+        heaps.forward_heap.reset();
+        heaps.reverse_heap.reset();
+        util::Log(logDEBUG) << "[heaps][" << std::this_thread::get_id() << "] released "
+                            << memory_usage / 1024 << " KiB of task heaps";
     }
 }
 } // namespace osrm::engine
\ No newline at end of file
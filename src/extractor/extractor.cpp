@@ -50,6 +50,7 @@
 #include <atomic>
 #include <bitset>
 #include <chrono>
+#include <filesystem>
 #include <memory>
 #include <thread>
 #include <tuple>
@@ -793,7 +794,8 @@ EdgeID Extractor::BuildEdgeExpandedGraph(
 /**
     \brief Building rtree-based nearest-neighbor data structure
 
-    Saves tree into '.ramIndex' and leaves into '.fileIndex'.
+    Saves tree into '.ramIndex' and leaves into '.fileIndex', optionally packed leaves
+    into '.packedIndex'.
  */
 void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                            const std::vector<util::Coordinate> &coordinates)
@@ -818,6 +820,19 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_seg
     util::StaticRTree<EdgeBasedNodeSegment> rtree(
         edge_based_node_segments, coordinates, config.GetPath(".osrm.fileIndex"));
 
+    if (config.compress_rtree_leaves)
+    {
+        rtree.PackLeaves(config.GetPath(".osrm.packedIndex"));
+        util::Log() << "Compressed r-tree leaves of "
+                    << edge_based_node_segments.size() * sizeof(EdgeBasedNodeSegment)
+                    << " bytes into " << rtree.GetPackedLeavesSizeInBytes() << " bytes";
+    }
+    else
+    {
+        // packed leaves of a previous run would be searched instead of the new leaves
+        std::filesystem::remove(config.GetPath(".osrm.packedIndex"));
+    }
+
     files::writeRamIndex(config.GetPath(".osrm.ramIndex"), rtree);
 
     TIMER_STOP(construction);
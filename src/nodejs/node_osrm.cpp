@@ -174,6 +174,9 @@ inline void async(const Napi::CallbackInfo &info,
                 result = std::move(result_str);
             }
             break;
+            case osrm::engine::api::BaseParameters::OutputFormatType::BINARY:
+                throw std::invalid_argument(
+                    "Binary output format is not supported by the Node.js bindings");
             }
         }
         catch (const std::exception &e)
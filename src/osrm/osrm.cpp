@@ -1,6 +1,8 @@
 #include "osrm/osrm.hpp"
 
 #include "engine/algorithm.hpp"
+#include "engine/api/batch_match_parameters.hpp"
+#include "engine/api/batch_route_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -80,6 +82,13 @@ Status OSRM::Table(const TableParameters &params, engine::api::ResultT &result)
     return engine_->Table(params, result);
 }
 
+Status OSRM::Table(const TableParameters &params,
+                   engine::api::ResultT &result,
+                   const engine::api::ResultStream &stream) const
+{
+    return engine_->Table(params, result, stream);
+}
+
 Status OSRM::Nearest(const engine::api::NearestParameters &params, json::Object &json_result) const
 {
     osrm::engine::api::ResultT result = json::Object();
@@ -133,4 +142,39 @@ Status OSRM::Tile(const engine::api::TileParameters &params, engine::api::Result
     return engine_->Tile(params, result);
 }
 
+Status OSRM::BatchRoute(const engine::api::BatchRouteParameters &params,
+                        json::Object &json_result) const
+{
+    osrm::engine::api::ResultT result = json::Object();
+    auto status = engine_->BatchRoute(params, result);
+    json_result = std::move(std::get<json::Object>(result));
+    return status;
+}
+
+Status OSRM::BatchRoute(const BatchRouteParameters &params, engine::api::ResultT &result) const
+{
+    return engine_->BatchRoute(params, result);
+}
+
+Status OSRM::BatchMatch(const engine::api::BatchMatchParameters &params,
+                        json::Object &json_result) const
+{
+    osrm::engine::api::ResultT result = json::Object();
+    auto status = engine_->BatchMatch(params, result);
+    json_result = std::move(std::get<json::Object>(result));
+    return status;
+}
+
+Status OSRM::BatchMatch(const BatchMatchParameters &params, engine::api::ResultT &result) const
+{
+    return engine_->BatchMatch(params, result);
+}
+
+Status OSRM::BatchMatch(const BatchMatchParameters &params,
+                        engine::api::ResultT &result,
+                        const engine::api::ResultStream &stream) const
+{
+    return engine_->BatchMatch(params, result, stream);
+}
+
 } // namespace osrm
@@ -11,6 +11,7 @@
 #include "partitioner/renumber.hpp"
 
 #include "extractor/compressed_node_based_graph_edge.hpp"
+#include "extractor/edge_based_node_segment.hpp"
 #include "extractor/files.hpp"
 
 #include "util/coordinate.hpp"
@@ -19,6 +20,7 @@
 #include "util/json_container.hpp"
 #include "util/log.hpp"
 #include "util/mmap_file.hpp"
+#include "util/static_rtree.hpp"
 #include "util/timing_util.hpp"
 
 #include <boost/assert.hpp>
@@ -134,6 +136,14 @@ int Partitioner::Run(const PartitionerConfig &config)
             config.GetPath(".osrm.fileIndex"), segment_region);
         renumber(segments, permutation);
     }
+    if (std::filesystem::exists(config.GetPath(".osrm.packedIndex")))
+    {
+        // compressed leaves are a copy of the segments and need to be packed again
+        const std::vector<util::Coordinate> coordinates;
+        util::StaticRTree<extractor::EdgeBasedNodeSegment> rtree(
+            config.GetPath(".osrm.fileIndex"), coordinates);
+        rtree.PackLeaves(config.GetPath(".osrm.packedIndex"));
+    }
     {
         extractor::EdgeBasedNodeDataContainer node_data;
         extractor::files::readNodeData(config.GetPath(".osrm.ebg_nodes"), node_data);
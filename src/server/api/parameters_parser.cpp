@@ -1,5 +1,7 @@
 #include "server/api/parameters_parser.hpp"
 
+#include "server/api/batch_match_parameter_grammar.hpp"
+#include "server/api/batch_route_parameter_grammar.hpp"
 #include "server/api/match_parameter_grammar.hpp"
 #include "server/api/nearest_parameter_grammar.hpp"
 #include "server/api/route_parameters_grammar.hpp"
@@ -22,7 +24,9 @@ using is_grammar_t =
                                std::is_same<NearestParametersGrammar<>, T>::value ||
                                std::is_same<TripParametersGrammar<>, T>::value ||
                                std::is_same<MatchParametersGrammar<>, T>::value ||
-                               std::is_same<TileParametersGrammar<>, T>::value>;
+                               std::is_same<TileParametersGrammar<>, T>::value ||
+                               std::is_same<BatchRouteParametersGrammar<>, T>::value ||
+                               std::is_same<BatchMatchParametersGrammar<>, T>::value>;
 
 template <typename ParameterT,
           typename GrammarT,
@@ -106,4 +110,20 @@ std::optional<engine::api::TileParameters> parseParameters(std::string::iterator
     return detail::parseParameters<engine::api::TileParameters, TileParametersGrammar<>>(iter, end);
 }
 
+template <>
+std::optional<engine::api::BatchRouteParameters> parseParameters(std::string::iterator &iter,
+                                                                 const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::BatchRouteParameters,
+                                   BatchRouteParametersGrammar<>>(iter, end);
+}
+
+template <>
+std::optional<engine::api::BatchMatchParameters> parseParameters(std::string::iterator &iter,
+                                                                 const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::BatchMatchParameters,
+                                   BatchMatchParametersGrammar<>>(iter, end);
+}
+
 } // namespace osrm::server::api
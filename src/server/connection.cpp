@@ -1,6 +1,8 @@
 #include "server/connection.hpp"
+#include "engine/request_deadline.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
+#include "util/exception.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/bind.hpp>
@@ -8,21 +10,58 @@
 #include <boost/iostreams/filtering_stream.hpp>
 
 #include <fmt/format.h>
+
+#include <iterator>
+#include <string>
 #include <vector>
 
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
 namespace osrm::server
 {
 
+namespace
+{
+const constexpr char chunk_trailer[] = {'\r', '\n'};
+const constexpr char last_chunk[] = {'0', '\r', '\n', '\r', '\n'};
+} // namespace
+
 Connection::Connection(boost::asio::io_context &io_context,
                        RequestHandler &handler,
-                       short keepalive_timeout)
+                       short keepalive_timeout,
+                       bool stream_responses,
+                       bool keep_half_closed_requests)
     : strand(boost::asio::make_strand(io_context)), TCP_socket(strand), timer(strand),
-      request_handler(handler), keepalive_timeout(keepalive_timeout)
+      request_handler(handler), keepalive_timeout(keepalive_timeout),
+      stream_responses(stream_responses), keep_half_closed_requests(keep_half_closed_requests)
 {
 }
 
 boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 
+bool Connection::is_closed_by_client()
+{
+#ifndef _WIN32
+    // Peeking doesn't consume pipelined requests and doesn't interfere with the asynchronous
+    // operations of the socket. A reset connection fails, a closed one reads zero bytes. Requests
+    // have no body, so like proxies do, a client that only shut down its sending side is taken to
+    // be gone as well unless half-closed connections are kept.
+    char byte;
+    const auto received = ::recv(TCP_socket.native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (received == 0)
+    {
+        return !keep_half_closed_requests;
+    }
+    return received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+#else
+    return false;
+#endif
+}
+
 /// Start the first asynchronous operation for the connection.
 void Connection::start()
 {
@@ -81,21 +120,48 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
             handle_shutdown();
             return;
         }
-        request_handler.HandleRequest(current_request, current_reply);
+        // searches of the request stop early once the client is gone
+        const engine::RequestDeadline request_deadline(std::nullopt,
+                                                       [this] { return is_closed_by_client(); });
 
-        if (boost::iequals(current_request.connection, "close"))
+        // compressed responses need the complete body, so only uncompressed ones are streamed.
+        // Chunked transfer encoding needs HTTP/1.1, HTTP/1.0 clients get the buffered reply.
+        const bool chunked_encoding_supported =
+            current_request.http_version_major > 1 ||
+            (current_request.http_version_major == 1 && current_request.http_version_minor >= 1);
+        if (stream_responses && compression_type == http::no_compression &&
+            chunked_encoding_supported)
         {
-            current_reply.headers.emplace_back("Connection", "close");
+            request_handler.HandleRequest(current_request,
+                                          current_reply,
+                                          [this](std::string_view chunk) { write_chunk(chunk); });
         }
         else
         {
-            keep_alive = true;
-            current_reply.headers.emplace_back("Connection", "keep-alive");
-            current_reply.headers.emplace_back("Keep-Alive",
-                                               "timeout=" + fmt::to_string(keepalive_timeout) +
-                                                   ", max=" + fmt::to_string(processed_requests));
+            request_handler.HandleRequest(current_request, current_reply);
+        }
+
+        if (response_streamed)
+        {
+            // the body is already partially sent, a failure can only be signalled by closing
+            if (stream_error || current_reply.status != http::reply::ok)
+            {
+                util::Log(logDEBUG) << "Aborted streamed response: " << stream_error.message();
+                handle_shutdown();
+                return;
+            }
+
+            // terminate the chunked body with a last, empty chunk
+            boost::asio::async_write(TCP_socket,
+                                     boost::asio::buffer(last_chunk),
+                                     boost::bind(&Connection::handle_write,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error));
+            return;
         }
 
+        add_keep_alive_headers();
+
         // compress the result w/ gzip/deflate if requested
         switch (compression_type)
         {
@@ -151,6 +217,80 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     }
 }
 
+void Connection::add_keep_alive_headers()
+{
+    if (boost::iequals(current_request.connection, "close"))
+    {
+        current_reply.headers.emplace_back("Connection", "close");
+    }
+    else
+    {
+        keep_alive = true;
+        current_reply.headers.emplace_back("Connection", "keep-alive");
+        current_reply.headers.emplace_back("Keep-Alive",
+                                           "timeout=" + fmt::to_string(keepalive_timeout) +
+                                               ", max=" + fmt::to_string(processed_requests));
+    }
+}
+
+void Connection::write_chunk(std::string_view chunk)
+{
+    std::string data;
+    if (!response_streamed)
+    {
+        response_streamed = true;
+        current_reply.chunked = true;
+        current_reply.headers.emplace_back("Transfer-Encoding", "chunked");
+        add_keep_alive_headers();
+        for (const auto &buffer : current_reply.headers_to_buffers())
+        {
+            data.append(static_cast<const char *>(buffer.data()), buffer.size());
+        }
+#ifndef _WIN32
+        // the request blocks this thread anyway, but a client that stops reading must not block
+        // it for longer than the keepalive timeout, see write_with_timeout
+        TCP_socket.non_blocking(true, stream_error);
+#endif
+    }
+
+    // an empty chunk would terminate the body
+    if (!chunk.empty())
+    {
+        data += fmt::format("{:x}\r\n", chunk.size());
+        data += chunk;
+        data.append(std::begin(chunk_trailer), std::end(chunk_trailer));
+    }
+    write_with_timeout(data);
+
+    if (stream_error)
+    {
+        // abort the query, the client is gone
+        throw util::exception("Connection write error: " + stream_error.message());
+    }
+}
+
+void Connection::write_with_timeout(std::string_view data)
+{
+    std::size_t written = 0;
+    while (!stream_error && written < data.size())
+    {
+        written += TCP_socket.write_some(
+            boost::asio::buffer(data.data() + written, data.size() - written), stream_error);
+#ifndef _WIN32
+        if (stream_error == boost::asio::error::would_block ||
+            stream_error == boost::asio::error::try_again)
+        {
+            stream_error.clear();
+            pollfd socket_fd{TCP_socket.native_handle(), POLLOUT, 0};
+            if (::poll(&socket_fd, 1, keepalive_timeout * 1000) <= 0)
+            {
+                stream_error = boost::asio::error::timed_out;
+            }
+        }
+#endif
+    }
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
@@ -162,6 +302,14 @@ void Connection::handle_write(const boost::system::error_code &error)
             current_request = http::request();
             current_reply = http::reply();
             request_parser = RequestParser();
+            if (response_streamed)
+            {
+                boost::system::error_code ignore_error;
+                // NOLINTNEXTLINE(bugprone-unused-return-value)
+                TCP_socket.non_blocking(false, ignore_error);
+            }
+            response_streamed = false;
+            stream_error.clear();
             incoming_data_buffer = boost::array<char, 8192>();
             output_buffer.clear();
             this->start();
@@ -12,8 +12,10 @@ const char internal_server_error_html[] =
 const char seperators[] = {':', ' '};
 const char crlf[] = {'\r', '\n'};
 const std::string http_ok_string = "HTTP/1.0 200 OK\r\n";
+const std::string http_1_1_ok_string = "HTTP/1.1 200 OK\r\n";
 const std::string http_bad_request_string = "HTTP/1.0 400 Bad Request\r\n";
 const std::string http_internal_server_error_string = "HTTP/1.0 500 Internal Server Error\r\n";
+const std::string http_service_unavailable_string = "HTTP/1.0 503 Service Unavailable\r\n";
 
 void reply::set_size(const std::size_t size)
 {
@@ -90,12 +92,16 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
 {
     if (reply::ok == status)
     {
-        return boost::asio::buffer(http_ok_string);
+        return boost::asio::buffer(chunked ? http_1_1_ok_string : http_ok_string);
     }
     if (reply::internal_server_error == status)
     {
         return boost::asio::buffer(http_internal_server_error_string);
     }
+    if (reply::service_unavailable == status)
+    {
+        return boost::asio::buffer(http_service_unavailable_string);
+    }
     return boost::asio::buffer(http_bad_request_string);
 }
 
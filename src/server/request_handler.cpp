@@ -32,18 +32,27 @@ void RequestHandler::RegisterServiceHandler(
     service_handler = std::move(service_handler_);
 }
 
-void SendResponse(ServiceHandler::ResultT &result, http::reply &current_reply)
+void AddAccessControlHeaders(http::reply &current_reply)
 {
-
     current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
     current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
     current_reply.headers.emplace_back("Access-Control-Allow-Headers",
                                        "X-Requested-With, Content-Type");
+}
+
+void AddJSONHeaders(http::reply &current_reply)
+{
+    current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+    current_reply.headers.emplace_back("Content-Disposition",
+                                       "inline; filename=\"response.json\"");
+}
+
+void SendResponse(ServiceHandler::ResultT &result, http::reply &current_reply)
+{
+    AddAccessControlHeaders(current_reply);
     if (std::holds_alternative<util::json::Object>(result))
     {
-        current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
-        current_reply.headers.emplace_back("Content-Disposition",
-                                           "inline; filename=\"response.json\"");
+        AddJSONHeaders(current_reply);
 
         util::json::render(current_reply.content, std::get<util::json::Object>(result));
     }
@@ -58,6 +67,13 @@ void SendResponse(ServiceHandler::ResultT &result, http::reply &current_reply)
         current_reply.headers.emplace_back(
             "Content-Type", "application/x-flatbuffers;schema=osrm.engine.api.fbresult");
     }
+    else if (std::holds_alternative<engine::api::BinaryBuffer>(result))
+    {
+        const auto &buffer = std::get<engine::api::BinaryBuffer>(result);
+        current_reply.content.assign(buffer.data.begin(), buffer.data.end());
+
+        current_reply.headers.emplace_back("Content-Type", "application/octet-stream");
+    }
     else
     {
         BOOST_ASSERT(std::holds_alternative<std::string>(result));
@@ -75,6 +91,13 @@ void SendResponse(ServiceHandler::ResultT &result, http::reply &current_reply)
 }
 
 void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
+{
+    HandleRequest(current_request, current_reply, {});
+}
+
+void RequestHandler::HandleRequest(const http::request &current_request,
+                                   http::reply &current_reply,
+                                   const engine::api::ResultStream &write_chunk)
 {
     if (!service_handler)
     {
@@ -98,13 +121,35 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
         ServiceHandler::ResultT result;
 
+        // headers of a streamed response have to be complete before its first chunk is written
+        bool response_streamed = false;
+        engine::api::ResultStream stream;
+        if (write_chunk)
+        {
+            stream = [&](std::string_view chunk)
+            {
+                if (!response_streamed)
+                {
+                    AddAccessControlHeaders(current_reply);
+                    AddJSONHeaders(current_reply);
+                    response_streamed = true;
+                }
+                write_chunk(chunk);
+            };
+        }
+
         // check if the was an error with the request
         if (maybe_parsed_url && api_iterator == request_string.end())
         {
 
             const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
-            if (status != engine::Status::Ok)
+                service_handler->RunQuery(*std::move(maybe_parsed_url), result, stream);
+            if (status == engine::Status::Timeout)
+            {
+                // the server ran out of time, the same request may succeed later
+                current_reply.status = http::reply::service_unavailable;
+            }
+            else if (status != engine::Status::Ok)
             {
                 // 4xx bad request return code
                 current_reply.status = http::reply::bad_request;
@@ -134,7 +179,10 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                                             std::to_string(position) + ": \"" + context + "\"";
         }
 
-        SendResponse(result, current_reply);
+        if (!response_streamed)
+        {
+            SendResponse(result, current_reply);
+        }
 
         if (!std::getenv("DISABLE_ACCESS_LOGGING"))
         {
@@ -0,0 +1,117 @@
+#include "server/service/batch_match_service.hpp"
+#include "server/service/utils.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "engine/api/batch_match_parameters.hpp"
+
+#include "util/json_container.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+namespace osrm::server::service
+{
+namespace
+{
+std::string getWrongOptionHelp(const engine::api::BatchMatchParameters &parameters)
+{
+    std::string help;
+
+    const auto coord_size = parameters.coordinates.size();
+
+    const bool param_size_mismatch =
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "hints", parameters.hints, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "bearings", parameters.bearings, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "radiuses", parameters.radiuses, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "approaches", parameters.approaches, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "timestamps", parameters.timestamps, coord_size, help);
+
+    if (param_size_mismatch)
+    {
+        return help;
+    }
+
+    if (!parameters.waypoints.empty())
+    {
+        help = "Waypoints are not supported by the batch match service.";
+    }
+    else if (parameters.session)
+    {
+        help = "Sessions are not supported by the batch match service.";
+    }
+    else if (parameters.trace_sizes.empty())
+    {
+        help = "The number of coordinates of every trace needs to be given with traces.";
+    }
+    else if (std::any_of(parameters.trace_sizes.begin(),
+                         parameters.trace_sizes.end(),
+                         [](const std::size_t size) { return size < 2; }))
+    {
+        help = "Number of coordinates of every trace needs to be at least two.";
+    }
+    else if (std::accumulate(parameters.trace_sizes.begin(),
+                             parameters.trace_sizes.end(),
+                             std::size_t{0}) != coord_size)
+    {
+        help = "Number of coordinates of the traces needs to add up to the number of coordinates.";
+    }
+
+    return help;
+}
+} // namespace
+
+engine::Status BatchMatchService::RunQuery(std::size_t prefix_length,
+                                           std::string &query,
+                                           osrm::engine::api::ResultT &result)
+{
+    return RunStreamingQuery(prefix_length, query, result, {});
+}
+
+engine::Status BatchMatchService::RunStreamingQuery(std::size_t prefix_length,
+                                                    std::string &query,
+                                                    osrm::engine::api::ResultT &result,
+                                                    const osrm::engine::api::ResultStream &stream)
+{
+    result = util::json::Object();
+    auto &json_result = std::get<util::json::Object>(result);
+
+    auto query_iterator = query.begin();
+    auto parameters =
+        api::parseParameters<engine::api::BatchMatchParameters>(query_iterator, query.end());
+    if (!parameters || query_iterator != query.end())
+    {
+        const auto position = std::distance(query.begin(), query_iterator);
+        json_result.values["code"] = "InvalidQuery";
+        json_result.values["message"] =
+            "Query string malformed close to position " + std::to_string(prefix_length + position);
+        return engine::Status::Error;
+    }
+    BOOST_ASSERT(parameters);
+
+    if (!parameters->IsValid())
+    {
+        json_result.values["code"] = "InvalidOptions";
+        json_result.values["message"] = getWrongOptionHelp(*parameters);
+        return engine::Status::Error;
+    }
+    BOOST_ASSERT(parameters->IsValid());
+
+    if (parameters->format == engine::api::BaseParameters::OutputFormatType::FLATBUFFERS)
+    {
+        json_result.values["code"] = "InvalidOptions";
+        json_result.values["message"] = "The batch match service only supports the json format.";
+        return engine::Status::Error;
+    }
+    if (stream)
+    {
+        return BaseService::routing_machine.BatchMatch(*parameters, result, stream);
+    }
+    return BaseService::routing_machine.BatchMatch(*parameters, result);
+}
+} // namespace osrm::server::service
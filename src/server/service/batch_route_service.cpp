@@ -0,0 +1,99 @@
+#include "server/service/batch_route_service.hpp"
+#include "server/service/utils.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "engine/api/batch_route_parameters.hpp"
+
+#include "util/json_container.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace osrm::server::service
+{
+namespace
+{
+std::string getWrongOptionHelp(const engine::api::BatchRouteParameters &parameters)
+{
+    std::string help;
+
+    const auto coord_size = parameters.coordinates.size();
+
+    const bool param_size_mismatch =
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "hints", parameters.hints, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "bearings", parameters.bearings, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "radiuses", parameters.radiuses, coord_size, help) ||
+        constrainParamSize(
+            PARAMETER_SIZE_MISMATCH_MSG, "approaches", parameters.approaches, coord_size, help);
+
+    if (param_size_mismatch)
+    {
+        return help;
+    }
+
+    if (parameters.coordinates.size() < 2)
+    {
+        help = "Number of coordinates needs to be at least two.";
+    }
+    else if (parameters.sources.size() != parameters.destinations.size())
+    {
+        help = "Number of sources and destinations needs to be the same.";
+    }
+    else if (parameters.sources.empty() && parameters.coordinates.size() % 2 != 0)
+    {
+        help = "Number of coordinates needs to be even without sources and destinations.";
+    }
+    else if (std::any_of(parameters.sources.begin(),
+                         parameters.sources.end(),
+                         [&](const std::size_t index) { return index >= coord_size; }) ||
+             std::any_of(parameters.destinations.begin(),
+                         parameters.destinations.end(),
+                         [&](const std::size_t index) { return index >= coord_size; }))
+    {
+        help = "Source and destination indices need to be smaller than the number of coordinates.";
+    }
+
+    return help;
+}
+} // namespace
+
+engine::Status BatchRouteService::RunQuery(std::size_t prefix_length,
+                                           std::string &query,
+                                           osrm::engine::api::ResultT &result)
+{
+    result = util::json::Object();
+    auto &json_result = std::get<util::json::Object>(result);
+
+    auto query_iterator = query.begin();
+    auto parameters =
+        api::parseParameters<engine::api::BatchRouteParameters>(query_iterator, query.end());
+    if (!parameters || query_iterator != query.end())
+    {
+        const auto position = std::distance(query.begin(), query_iterator);
+        json_result.values["code"] = "InvalidQuery";
+        json_result.values["message"] =
+            "Query string malformed close to position " + std::to_string(prefix_length + position);
+        return engine::Status::Error;
+    }
+    BOOST_ASSERT(parameters);
+
+    if (!parameters->IsValid())
+    {
+        json_result.values["code"] = "InvalidOptions";
+        json_result.values["message"] = getWrongOptionHelp(*parameters);
+        return engine::Status::Error;
+    }
+    BOOST_ASSERT(parameters->IsValid());
+
+    if (parameters->format == engine::api::BaseParameters::OutputFormatType::FLATBUFFERS)
+    {
+        json_result.values["code"] = "InvalidOptions";
+        json_result.values["message"] = "The batch service only supports the json format.";
+        return engine::Status::Error;
+    }
+    return BaseService::routing_machine.BatchRoute(*parameters, result);
+}
+} // namespace osrm::server::service
@@ -62,6 +62,16 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
         help = "scale_factor must be > 0";
     }
 
+    if (parameters.max_duration && *parameters.max_duration <= 0)
+    {
+        help = "max_duration must be > 0";
+    }
+
+    if (parameters.max_distance && *parameters.max_distance <= 0)
+    {
+        help = "max_distance must be > 0";
+    }
+
     return help;
 }
 } // namespace
@@ -69,6 +79,14 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 engine::Status TableService::RunQuery(std::size_t prefix_length,
                                       std::string &query,
                                       osrm::engine::api::ResultT &result)
+{
+    return RunStreamingQuery(prefix_length, query, result, {});
+}
+
+engine::Status TableService::RunStreamingQuery(std::size_t prefix_length,
+                                               std::string &query,
+                                               osrm::engine::api::ResultT &result,
+                                               const osrm::engine::api::ResultStream &stream)
 {
     result = util::json::Object();
     auto &json_result = std::get<util::json::Object>(result);
@@ -101,6 +119,10 @@ engine::Status TableService::RunQuery(std::size_t prefix_length,
             result = flatbuffers::FlatBufferBuilder();
         }
     }
+    if (stream)
+    {
+        return BaseService::routing_machine.Table(*parameters, result, stream);
+    }
     return BaseService::routing_machine.Table(*parameters, result);
 }
 } // namespace osrm::server::service
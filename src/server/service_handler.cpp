@@ -1,5 +1,7 @@
 #include "server/service_handler.hpp"
 
+#include "server/service/batch_match_service.hpp"
+#include "server/service/batch_route_service.hpp"
 #include "server/service/match_service.hpp"
 #include "server/service/nearest_service.hpp"
 #include "server/service/route_service.hpp"
@@ -22,10 +24,19 @@ ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(con
     service_map["trip"] = std::make_unique<service::TripService>(routing_machine);
     service_map["match"] = std::make_unique<service::MatchService>(routing_machine);
     service_map["tile"] = std::make_unique<service::TileService>(routing_machine);
+    service_map["batch_route"] = std::make_unique<service::BatchRouteService>(routing_machine);
+    service_map["batch_match"] = std::make_unique<service::BatchMatchService>(routing_machine);
 }
 
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
                                         osrm::engine::api::ResultT &result)
+{
+    return RunQuery(std::move(parsed_url), result, {});
+}
+
+engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
+                                        osrm::engine::api::ResultT &result,
+                                        const osrm::engine::api::ResultStream &stream)
 {
     const auto &service_iter = service_map.find(parsed_url.service);
     if (service_iter == service_map.end())
@@ -47,6 +58,11 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
         return engine::Status::Error;
     }
 
+    if (stream)
+    {
+        return service->RunStreamingQuery(
+            parsed_url.prefix_length, parsed_url.query, result, stream);
+    }
     return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
 }
 } // namespace osrm::server
@@ -0,0 +1,388 @@
+#include "util/json_renderer.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include "osrm/batch_match_parameters.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/storage_config.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <rapidjson/document.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct BatchMatchConfig
+{
+    std::filesystem::path base_path;
+    std::string input_path;
+    std::string output_path;
+    std::string verbosity;
+    std::size_t batch_size;
+};
+
+// A trace of the input with the id it is written back with
+struct Trace
+{
+    util::json::Value id = util::json::Null();
+    std::vector<util::Coordinate> coordinates;
+    std::vector<unsigned> timestamps;
+    std::vector<std::optional<double>> radiuses;
+};
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           BatchMatchConfig &batch_config,
+                           EngineConfig &engine_config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "verbosity,l",
+        boost::program_options::value<std::string>(&batch_config.verbosity)
+            ->default_value("INFO"),
+        std::string("Log verbosity level: " + util::LogPolicy::GetLevels()).c_str());
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("algorithm,a",
+         boost::program_options::value<EngineConfig::Algorithm>(&engine_config.algorithm)
+             ->default_value(EngineConfig::Algorithm::CH, "CH"),
+         "Algorithm to use for the data. Can be CH, MLD.") //
+        ("input-traces,t",
+         boost::program_options::value<std::string>(&batch_config.input_path)->default_value("-"),
+         "File with one trace per line as JSON object with coordinates and optional id, "
+         "timestamps and radiuses, '-' reads from stdin") //
+        ("output,o",
+         boost::program_options::value<std::string>(&batch_config.output_path)->default_value("-"),
+         "File the matchings are written to, one per line and in the order of the traces, '-' "
+         "writes to stdout") //
+        ("mmap,m",
+         boost::program_options::value<bool>(&engine_config.use_mmap)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Map data files to memory instead of loading them into memory") //
+        ("batch-size",
+         boost::program_options::value<std::size_t>(&batch_config.batch_size)
+             ->default_value(1000),
+         "Number of traces that are matched in parallel at once") //
+        ("max-matching-size",
+         boost::program_options::value<int>(&engine_config.max_locations_map_matching)
+             ->default_value(-1),
+         "Max. locations supported in a trace, -1 for no limit") //
+        ("max-matching-radius",
+         boost::program_options::value<double>(&engine_config.max_radius_map_matching)
+             ->default_value(-1.0),
+         "Max. radius size supported in map matching query, -1 for no limit");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<std::filesystem::path>(&batch_config.base_path),
+        "Input base file path");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        std::filesystem::path(executable).filename().string() + " <input.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    if (!option_variables.count("input") || batch_config.batch_size == 0)
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+// Returns the error message if the line is not a valid trace
+std::optional<std::string> parseTrace(const std::string &line, Trace &trace)
+{
+    rapidjson::Document document;
+    document.Parse(line.c_str());
+    if (document.HasParseError() || !document.IsObject())
+        return std::string("Trace is not a JSON object.");
+
+    if (document.HasMember("id"))
+    {
+        const auto &id = document["id"];
+        if (id.IsString())
+            trace.id = util::json::String(id.GetString());
+        else if (id.IsNumber())
+            trace.id = util::json::Number(id.GetDouble());
+        else
+            return std::string("Trace id needs to be a string or a number.");
+    }
+
+    if (!document.HasMember("coordinates") || !document["coordinates"].IsArray())
+        return std::string("Trace has no coordinates.");
+    for (const auto &coordinate : document["coordinates"].GetArray())
+    {
+        if (!coordinate.IsArray() || coordinate.Size() != 2 || !coordinate[0].IsNumber() ||
+            !coordinate[1].IsNumber())
+            return std::string("Coordinates need to be [longitude, latitude] pairs.");
+        trace.coordinates.emplace_back(util::FloatLongitude{coordinate[0].GetDouble()},
+                                       util::FloatLatitude{coordinate[1].GetDouble()});
+    }
+    if (trace.coordinates.size() < 2)
+        return std::string("Number of coordinates needs to be at least two.");
+
+    if (document.HasMember("timestamps"))
+    {
+        const auto &timestamps = document["timestamps"];
+        if (!timestamps.IsArray() || timestamps.Size() != trace.coordinates.size())
+            return std::string("Number of timestamps needs to match the number of coordinates.");
+        for (const auto &timestamp : timestamps.GetArray())
+        {
+            if (!timestamp.IsUint())
+                return std::string("Timestamps need to be unsigned integers.");
+            trace.timestamps.push_back(timestamp.GetUint());
+        }
+    }
+
+    trace.radiuses.resize(trace.coordinates.size());
+    if (document.HasMember("radiuses"))
+    {
+        const auto &radiuses = document["radiuses"];
+        if (!radiuses.IsArray() || radiuses.Size() != trace.coordinates.size())
+            return std::string("Number of radiuses needs to match the number of coordinates.");
+        for (rapidjson::SizeType index = 0; index < radiuses.Size(); ++index)
+        {
+            if (radiuses[index].IsNumber())
+                trace.radiuses[index] = radiuses[index].GetDouble();
+            else if (!radiuses[index].IsNull())
+                return std::string("Radiuses need to be numbers or null.");
+        }
+    }
+
+    return std::nullopt;
+}
+
+void writeLine(std::ostream &out, const util::json::Value &id, util::json::Object object)
+{
+    object.values["id"] = id;
+    std::string line;
+    util::json::render(line, object);
+    line += '\n';
+    out << line;
+}
+
+// Matches the traces with one batch request and writes their matchings in the same order
+void matchTraces(const OSRM &osrm, std::vector<Trace> &traces, std::ostream &out)
+{
+    if (traces.empty())
+        return;
+
+    BatchMatchParameters params;
+    const bool has_timestamps = !traces.front().timestamps.empty();
+    for (auto &trace : traces)
+    {
+        params.trace_sizes.push_back(trace.coordinates.size());
+        params.coordinates.insert(
+            params.coordinates.end(), trace.coordinates.begin(), trace.coordinates.end());
+        params.radiuses.insert(
+            params.radiuses.end(), trace.radiuses.begin(), trace.radiuses.end());
+        if (has_timestamps)
+            params.timestamps.insert(
+                params.timestamps.end(), trace.timestamps.begin(), trace.timestamps.end());
+    }
+
+    json::Object result;
+    const auto status = osrm.BatchMatch(params, result);
+    if (status != Status::Ok)
+    {
+        // the whole batch failed, every trace gets the error
+        for (const auto &trace : traces)
+            writeLine(out, trace.id, result);
+    }
+    else
+    {
+        auto &matchings = std::get<json::Array>(result.values["traces"]).values;
+        for (std::size_t index = 0; index < traces.size(); ++index)
+        {
+            writeLine(out, traces[index].id, std::move(std::get<json::Object>(matchings[index])));
+        }
+    }
+    traces.clear();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    BatchMatchConfig batch_config;
+    EngineConfig engine_config;
+    engine_config.use_shared_memory = false;
+
+    const auto result = parseArguments(argc, argv, batch_config, engine_config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    util::LogPolicy::GetInstance().SetLevel(batch_config.verbosity);
+
+    engine_config.storage_config = storage::StorageConfig(batch_config.base_path);
+    if (!engine_config.storage_config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+    if (!engine_config.IsValid())
+    {
+        util::Log(logERROR) << "Config provided is not valid";
+        return EXIT_FAILURE;
+    }
+
+    const OSRM osrm(engine_config);
+
+    std::ifstream input_file;
+    if (batch_config.input_path != "-")
+    {
+        input_file.open(batch_config.input_path);
+        if (!input_file)
+        {
+            util::Log(logERROR) << "Could not open " << batch_config.input_path;
+            return EXIT_FAILURE;
+        }
+    }
+    std::istream &input = batch_config.input_path != "-" ? input_file : std::cin;
+
+    std::ofstream output_file;
+    if (batch_config.output_path != "-")
+    {
+        output_file.open(batch_config.output_path);
+        if (!output_file)
+        {
+            util::Log(logERROR) << "Could not open " << batch_config.output_path;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &output = batch_config.output_path != "-" ? output_file : std::cout;
+
+    TIMER_START(batch_match);
+    std::size_t number_of_traces = 0;
+    std::vector<Trace> traces;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty())
+            continue;
+        ++number_of_traces;
+
+        Trace trace;
+        if (const auto error = parseTrace(line, trace))
+        {
+            // keep the order of the output, the traces before are written first
+            matchTraces(osrm, traces, output);
+            json::Object error_object;
+            error_object.values["code"] = "InvalidInput";
+            error_object.values["message"] = *error;
+            writeLine(output, trace.id, std::move(error_object));
+            continue;
+        }
+
+        // the traces of a batch either all have timestamps or none has
+        if (!traces.empty() && traces.front().timestamps.empty() != trace.timestamps.empty())
+        {
+            matchTraces(osrm, traces, output);
+        }
+        traces.push_back(std::move(trace));
+        if (traces.size() >= batch_config.batch_size)
+        {
+            matchTraces(osrm, traces, output);
+        }
+    }
+    matchTraces(osrm, traces, output);
+    output.flush();
+    TIMER_STOP(batch_match);
+
+    // the matchings may be written to stdout
+    const auto elapsed_seconds = TIMER_SEC(batch_match);
+    util::Log(logINFO, std::cerr) << "Matched " << number_of_traces << " traces in "
+                                  << elapsed_seconds << "s ("
+                                  << (elapsed_seconds > 0 ? number_of_traces / elapsed_seconds : 0.)
+                                  << " traces/s)";
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::bad_alloc &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    util::Log(logERROR) << "Please provide more memory or consider using a larger swapfile";
+    return EXIT_FAILURE;
+}
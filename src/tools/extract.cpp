@@ -78,7 +78,13 @@ return_code parseArguments(int argc,
         boost::program_options::bool_switch(&extractor_config.dump_nbg_graph)
             ->implicit_value(true)
             ->default_value(false),
-        "Dump raw node-based graph to *.osrm file for debug purposes.");
+        "Dump raw node-based graph to *.osrm file for debug purposes.")(
+        "compress-rtree-leaves",
+        boost::program_options::bool_switch(&extractor_config.compress_rtree_leaves)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store a compressed copy of the r-tree leaves in a .osrm.packedIndex file, which is "
+        "searched instead of the .osrm.fileIndex file.");
 
     bool dummy;
     // hidden options, will be allowed on command line, but will not be
@@ -1,5 +1,4 @@
 #include "server/server.hpp"
-#include "util/exception_utils.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
 #include "util/version.hpp"
@@ -10,7 +9,6 @@
 #include "osrm/osrm.hpp"
 #include "osrm/storage_config.hpp"
 
-#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/any.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <boost/program_options.hpp>
@@ -53,25 +51,6 @@ const static unsigned INIT_OK_START_ENGINE = 0;
 const static unsigned INIT_OK_DO_NOT_START_ENGINE = 1;
 const static unsigned INIT_FAILED = -1;
 
-namespace osrm::engine
-{
-std::istream &operator>>(std::istream &in, EngineConfig::Algorithm &algorithm)
-{
-    std::string token;
-    in >> token;
-    boost::to_lower(token);
-
-    if (token == "ch")
-        algorithm = EngineConfig::Algorithm::CH;
-    else if (token == "mld")
-        algorithm = EngineConfig::Algorithm::MLD;
-    else
-        throw util::RuntimeError(token, ErrorCode::UnknownAlgorithm, SOURCE_REF);
-    return in;
-}
-
-} // namespace osrm::engine
-
 // overload validate for the double type to allow "unlimited" as an input
 namespace boost
 {
@@ -108,7 +87,9 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              bool &trial,
                                              EngineConfig &config,
                                              int &requested_thread_num,
-                                             short &keepalive_timeout)
+                                             short &keepalive_timeout,
+                                             bool &stream_responses,
+                                             bool &keep_half_closed_requests)
 {
     using boost::program_options::value;
     using std::filesystem::path;
@@ -144,6 +125,15 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("keepalive-timeout,k",
          value<short>(&keepalive_timeout)->default_value(5),
          "Default keepalive-timeout. Default: 5 seconds.") //
+        ("stream-table-responses",
+         value<bool>(&stream_responses)->implicit_value(true)->default_value(false),
+         "Send uncompressed table responses to HTTP/1.1 requests row by row using chunked "
+         "transfer encoding. The table is computed first, only its JSON rendering is "
+         "streamed") //
+        ("keep-half-closed-requests",
+         value<bool>(&keep_half_closed_requests)->implicit_value(true)->default_value(false),
+         "Keep answering requests of clients that closed their sending side of the connection. "
+         "By default such requests are cancelled like the ones of closed connections") //
         ("shared-memory,s",
          value<bool>(&config.use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
@@ -173,12 +163,66 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("max-table-size",
          value<int>(&config.max_locations_distance_table)->default_value(100),
          "Max. locations supported in distance table query") //
+        ("parallel-table-search",
+         value<bool>(&config.use_parallel_table_search)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Run the searches of a single table query in parallel on all cores") //
+        ("parallel-alternatives-search",
+         value<bool>(&config.use_parallel_alternatives_search)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Unpack the candidate paths of a single MLD alternatives query in parallel") //
+        ("parallel-leg-search",
+         value<bool>(&config.use_parallel_leg_search)->implicit_value(true)->default_value(false),
+         "Search the legs of a single route query with waypoints in parallel, unless "
+         "continue_straight is in effect") //
+        ("min-rphast-table-destinations",
+         value<int>(&config.min_destinations_rphast_table)->default_value(1000),
+         "Use RPHAST for CH table queries with at least this many destinations, -1 disables it") //
+        ("max-table-bucket-cache-size",
+         value<int>(&config.max_table_bucket_cache_size)->default_value(0),
+         "Memory in MiB used to keep the backward searches of table targets across queries, "
+         "0 disables the cache") //
+        ("max-shortcut-cache-size",
+         value<int>(&config.max_shortcut_cache_size)->default_value(0),
+         "Memory in MiB used to keep unpacked CH shortcuts across queries, 0 disables the cache") //
+        ("max-clique-arc-cache-size",
+         value<int>(&config.max_clique_arc_cache_size)->default_value(0),
+         "Memory in MiB used to keep unpacked MLD overlay edges across queries, hit rates are "
+         "logged at debug verbosity, 0 disables the cache") //
         ("max-matching-size",
          value<int>(&config.max_locations_map_matching)->default_value(100),
          "Max. locations supported in map matching query") //
+        ("max-matching-sessions-size",
+         value<int>(&config.max_matching_sessions_size)->default_value(0),
+         "Memory in MiB used to keep the state of traces that are matched while they are "
+         "recorded, 0 disables the session parameter of match queries") //
+        ("matching-session-ttl",
+         value<int>(&config.matching_session_ttl)->default_value(300),
+         "Time in s after which a matching session without updates is dropped") //
         ("max-nearest-size",
          value<int>(&config.max_results_nearest)->default_value(100),
          "Max. results supported in nearest query") //
+        ("max-heap-memory-per-thread",
+         value<int>(&config.max_heap_memory_per_thread)->default_value(-1),
+         "Memory in MiB the search heaps of a thread may keep after a query, bigger heaps are "
+         "freed. -1 keeps them all") //
+        ("max-request-time",
+         value<int>(&config.max_request_time)->default_value(-1),
+         "Time in ms after which route, table, trip, match and batch route queries are aborted "
+         "with a Timeout error. -1 disables the limit") //
+        ("trip-local-search-time",
+         value<int>(&config.trip_local_search_time)->default_value(0),
+         "Time in ms spent on shortening the trips of trip queries with 10 or more locations "
+         "with a parallel 2-opt and Or-opt search after the farthest insertion heuristic, "
+         "0 disables the search") //
+        ("max-batch-route-size",
+         value<int>(&config.max_pairs_batch_route)->default_value(10000),
+         "Max. origin-destination pairs supported in batch route query") //
+        ("max-batch-match-size",
+         value<int>(&config.max_traces_batch_match)->default_value(1000),
+         "Max. traces supported in batch match query") //
         ("max-alternatives",
          value<int>(&config.max_alternatives)->default_value(3),
          "Max. number of alternatives supported in the MLD route query") //
@@ -271,6 +315,8 @@ try
 
     int requested_thread_num = 1;
     short keepalive_timeout = 5;
+    bool stream_responses = false;
+    bool keep_half_closed_requests = false;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
                                                               base_path,
@@ -279,7 +325,9 @@ try
                                                               trial_run,
                                                               config,
                                                               requested_thread_num,
-                                                              keepalive_timeout);
+                                                              keepalive_timeout,
+                                                              stream_responses,
+                                                              keep_half_closed_requests);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -320,6 +368,10 @@ try
     util::Log() << "IP address: " << ip_address;
     util::Log() << "IP port: " << ip_port;
     util::Log() << "Keepalive timeout: " << keepalive_timeout;
+    if (stream_responses)
+    {
+        util::Log() << "Streaming table responses";
+    }
 
 #ifndef _WIN32
     int sig = 0;
@@ -333,7 +385,12 @@ try
 
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
     auto routing_server =
-        server::Server::CreateServer(ip_address, ip_port, requested_thread_num, keepalive_timeout);
+        server::Server::CreateServer(ip_address,
+                                     ip_port,
+                                     requested_thread_num,
+                                     keepalive_timeout,
+                                     stream_responses,
+                                     keep_half_closed_requests);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
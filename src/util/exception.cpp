@@ -17,4 +17,5 @@ namespace osrm::util
 void exception::anchor() const {}
 void RuntimeError::anchor() const {}
 void DisabledDatasetException::anchor() const {}
+void TimeoutException::anchor() const {}
 } // namespace osrm::util
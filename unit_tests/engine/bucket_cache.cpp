@@ -0,0 +1,104 @@
+#include "engine/routing_algorithms/bucket_cache.hpp"
+#include "mocks/mock_datafacade.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(bucket_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+PhantomNodeCandidates makeCandidates(const NodeID node)
+{
+    PhantomNode phantom;
+    phantom.forward_segment_id = {node, true};
+    phantom.forward_weight = {10};
+    return {phantom};
+}
+
+BucketCache::Buckets makeBuckets(const std::size_t number_of_buckets, const unsigned column)
+{
+    BucketCache::Buckets buckets;
+    for (const auto node : util::irange<NodeID>(0, number_of_buckets))
+    {
+        buckets.emplace_back(node, node, column, EdgeWeight{1}, EdgeDuration{2}, EdgeDistance{3});
+    }
+    return buckets;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(find_rewrites_column)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    BucketCache cache(1024 * 1024);
+    const BucketCacheHandle handle{&cache, cache.GetGeneration()};
+
+    const auto candidates = makeCandidates(1);
+    const auto buckets = makeBuckets(3, 0);
+    handle.Insert(facade, false, candidates, buckets.begin(), buckets.end());
+
+    std::vector<NodeBucket> result;
+    BOOST_CHECK(!handle.AppendCached(facade, true, candidates, 5, result));
+    BOOST_CHECK(!handle.AppendCached(facade, false, makeCandidates(2), 5, result));
+    BOOST_CHECK(handle.AppendCached(facade, false, candidates, 5, result));
+    BOOST_REQUIRE_EQUAL(result.size(), 3);
+    for (const auto &bucket : result)
+    {
+        BOOST_CHECK_EQUAL(bucket.column_index, 5);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_drops_generation)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    BucketCache cache(1024 * 1024);
+    const BucketCacheHandle old_handle{&cache, cache.GetGeneration()};
+
+    const auto candidates = makeCandidates(1);
+    const auto buckets = makeBuckets(3, 0);
+    old_handle.Insert(facade, false, candidates, buckets.begin(), buckets.end());
+    BOOST_CHECK_GT(cache.GetSizeInBytes(), 0);
+
+    cache.Invalidate();
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+
+    // requests of the old generation neither read nor write the cache
+    std::vector<NodeBucket> result;
+    old_handle.Insert(facade, false, candidates, buckets.begin(), buckets.end());
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+
+    const BucketCacheHandle new_handle{&cache, cache.GetGeneration()};
+    BOOST_CHECK(!new_handle.AppendCached(facade, false, candidates, 0, result));
+    new_handle.Insert(facade, false, candidates, buckets.begin(), buckets.end());
+    BOOST_CHECK(!old_handle.AppendCached(facade, false, candidates, 0, result));
+    BOOST_CHECK(new_handle.AppendCached(facade, false, candidates, 0, result));
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    const auto buckets = makeBuckets(1000, 0);
+
+    // room for two entries
+    BucketCache cache(2 * 1000 * sizeof(NodeBucket) + 1000);
+    const BucketCacheHandle handle{&cache, cache.GetGeneration()};
+
+    handle.Insert(facade, false, makeCandidates(1), buckets.begin(), buckets.end());
+    handle.Insert(facade, false, makeCandidates(2), buckets.begin(), buckets.end());
+
+    std::vector<NodeBucket> result;
+    BOOST_CHECK(handle.AppendCached(facade, false, makeCandidates(1), 0, result));
+
+    handle.Insert(facade, false, makeCandidates(3), buckets.begin(), buckets.end());
+    BOOST_CHECK_LE(cache.GetSizeInBytes(), 2 * 1000 * sizeof(NodeBucket) + 1000);
+    BOOST_CHECK(handle.AppendCached(facade, false, makeCandidates(1), 0, result));
+    BOOST_CHECK(!handle.AppendCached(facade, false, makeCandidates(2), 0, result));
+    BOOST_CHECK(handle.AppendCached(facade, false, makeCandidates(3), 0, result));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+#include "engine/routing_algorithms/bucket_scan.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(bucket_scan)
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+struct Table
+{
+    explicit Table(const std::size_t number_of_targets, const bool with_distances)
+        : weights(number_of_targets, INVALID_EDGE_WEIGHT),
+          durations(number_of_targets, MAXIMAL_EDGE_DURATION),
+          distances(with_distances ? number_of_targets : 0, MAXIMAL_EDGE_DISTANCE),
+          middle_nodes(number_of_targets, SPECIAL_NODEID)
+    {
+    }
+
+    TableRow Row()
+    {
+        return {weights.data(),
+                durations.data(),
+                distances.empty() ? nullptr : distances.data(),
+                middle_nodes.data()};
+    }
+
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeDuration> durations;
+    std::vector<EdgeDistance> distances;
+    std::vector<NodeID> middle_nodes;
+};
+
+BucketArrays makeBuckets(const NodeID number_of_nodes, const unsigned number_of_targets)
+{
+    std::mt19937 g(42);
+    // few distinct values to exercise ties on the weight
+    std::uniform_int_distribution<std::int32_t> value(0, 20);
+    std::vector<unsigned> columns(number_of_targets);
+    std::iota(columns.begin(), columns.end(), 0);
+
+    std::vector<NodeBucket> buckets;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        std::shuffle(columns.begin(), columns.end(), g);
+        // varying counts to cover full vectors and the scalar tail
+        const auto count = (node * 7) % (number_of_targets + 1);
+        for (const auto index : util::irange<unsigned>(0, count))
+        {
+            buckets.emplace_back(node,
+                                 node,
+                                 columns[index],
+                                 EdgeWeight{value(g)},
+                                 EdgeDuration{value(g)},
+                                 EdgeDistance{static_cast<float>(value(g))});
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+    return BucketArrays(buckets);
+}
+
+void checkScansAgree(const bool with_distances)
+{
+    const unsigned number_of_targets = 37;
+    const auto buckets = makeBuckets(100, number_of_targets);
+
+    Table scalar(number_of_targets, with_distances);
+    Table dispatched(number_of_targets, with_distances);
+    for (const auto node : util::irange<NodeID>(0, 100))
+    {
+        const auto [first, last] = buckets.Find(node);
+        const EdgeWeight weight{static_cast<std::int32_t>(node % 3)};
+        const EdgeDuration duration{static_cast<std::int32_t>(node % 5)};
+        const EdgeDistance distance{static_cast<float>(node)};
+        scanBucketsScalar(buckets, first, last, weight, duration, distance, node, scalar.Row());
+        scanBuckets(buckets, first, last, weight, duration, distance, node, dispatched.Row());
+    }
+
+    BOOST_CHECK(scalar.weights == dispatched.weights);
+    BOOST_CHECK(scalar.durations == dispatched.durations);
+    BOOST_CHECK(scalar.distances == dispatched.distances);
+    BOOST_CHECK(scalar.middle_nodes == dispatched.middle_nodes);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(find_range_of_node)
+{
+    std::vector<NodeBucket> sorted{{1, 1, 0, {1}, {1}, {1}},
+                                   {1, 1, 1, {1}, {1}, {1}},
+                                   {3, 3, 0, {1}, {1}, {1}}};
+    std::sort(sorted.begin(), sorted.end());
+    const BucketArrays buckets(sorted);
+
+    using Range = std::pair<std::size_t, std::size_t>;
+    BOOST_CHECK(buckets.Find(0) == Range(0, 0));
+    BOOST_CHECK(buckets.Find(1) == Range(0, 2));
+    BOOST_CHECK(buckets.Find(2) == Range(2, 2));
+    BOOST_CHECK(buckets.Find(3) == Range(2, 3));
+}
+
+BOOST_AUTO_TEST_CASE(scan_updates_minimum)
+{
+    std::vector<NodeBucket> sorted{{1, 1, 0, {10}, {10}, {10}}, {1, 1, 1, {2}, {20}, {20}}};
+    const BucketArrays buckets(sorted);
+
+    Table table(2, true);
+    table.weights[0] = EdgeWeight{5};
+    table.durations[0] = EdgeDuration{5};
+    table.weights[1] = EdgeWeight{5};
+    table.durations[1] = EdgeDuration{30};
+
+    scanBuckets(buckets, 0, 2, EdgeWeight{3}, EdgeDuration{1}, EdgeDistance{1}, 1, table.Row());
+
+    // worse weight keeps the cell
+    BOOST_CHECK_EQUAL(table.weights[0], EdgeWeight{5});
+    BOOST_CHECK_EQUAL(table.middle_nodes[0], SPECIAL_NODEID);
+    // equal weight but better duration replaces the cell
+    BOOST_CHECK_EQUAL(table.weights[1], EdgeWeight{5});
+    BOOST_CHECK_EQUAL(table.durations[1], EdgeDuration{21});
+    BOOST_CHECK_EQUAL(table.distances[1], EdgeDistance{21});
+    BOOST_CHECK_EQUAL(table.middle_nodes[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(dispatched_scan_matches_scalar)
+{
+    checkScansAgree(true);
+    checkScansAgree(false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#include "engine/routing_algorithms/clique_arc_cache.hpp"
+#include "mocks/mock_datafacade.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(clique_arc_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+BOOST_AUTO_TEST_CASE(append_skips_source)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    CliqueArcCache cache(1024 * 1024);
+    const CliqueArcCacheHandle handle{&cache, cache.GetGeneration()};
+
+    handle.Insert(facade, 1, 5, 10, 13, {10, 11, 12, 13}, {100, 101, 102});
+
+    std::vector<NodeID> nodes = {9, 10};
+    std::vector<EdgeID> edges = {99};
+    BOOST_CHECK(!handle.AppendCached(facade, 2, 5, 10, 13, nodes, edges));
+    BOOST_CHECK(!handle.AppendCached(facade, 1, 6, 10, 13, nodes, edges));
+    BOOST_CHECK(!handle.AppendCached(facade, 1, 5, 13, 10, nodes, edges));
+    BOOST_CHECK(handle.AppendCached(facade, 1, 5, 10, 13, nodes, edges));
+    const std::vector<NodeID> expected_nodes = {9, 10, 11, 12, 13};
+    const std::vector<EdgeID> expected_edges = {99, 100, 101, 102};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        nodes.begin(), nodes.end(), expected_nodes.begin(), expected_nodes.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        edges.begin(), edges.end(), expected_edges.begin(), expected_edges.end());
+
+    const auto statistics = cache.GetStatistics(1);
+    BOOST_CHECK_EQUAL(statistics.hits, 1);
+    BOOST_CHECK_EQUAL(statistics.misses, 2);
+    BOOST_CHECK_EQUAL(statistics.number_of_entries, 1);
+    BOOST_CHECK_EQUAL(cache.GetStatistics(2).misses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    // find out how much memory an entry takes
+    CliqueArcCache unbounded(1024 * 1024);
+    CliqueArcCacheHandle{&unbounded, 0}.Insert(facade, 1, 0, 0, 1, {0, 1}, {0});
+    const auto entry_size = unbounded.GetSizeInBytes();
+
+    CliqueArcCache cache(2 * entry_size);
+    const CliqueArcCacheHandle handle{&cache, cache.GetGeneration()};
+    handle.Insert(facade, 1, 0, 0, 1, {0, 1}, {0});
+    handle.Insert(facade, 1, 0, 1, 2, {1, 2}, {1});
+
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+    BOOST_CHECK(handle.AppendCached(facade, 1, 0, 0, 1, nodes, edges));
+    handle.Insert(facade, 1, 0, 2, 3, {2, 3}, {2});
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 2 * entry_size);
+    BOOST_CHECK(handle.AppendCached(facade, 1, 0, 0, 1, nodes, edges));
+    BOOST_CHECK(!handle.AppendCached(facade, 1, 0, 1, 2, nodes, edges));
+    BOOST_CHECK(handle.AppendCached(facade, 1, 0, 2, 3, nodes, edges));
+
+    // the other level has nothing to evict and can't take the memory of level 1
+    handle.Insert(facade, 2, 0, 0, 1, {0, 1}, {0});
+    BOOST_CHECK(!handle.AppendCached(facade, 2, 0, 0, 1, nodes, edges));
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_drops_generation)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    CliqueArcCache cache(1024 * 1024);
+    const CliqueArcCacheHandle old_handle{&cache, cache.GetGeneration()};
+
+    old_handle.Insert(facade, 1, 0, 0, 1, {0, 1}, {0});
+    BOOST_CHECK_GT(cache.GetSizeInBytes(), 0);
+
+    cache.Invalidate();
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+    BOOST_CHECK_EQUAL(cache.GetStatistics(1).number_of_entries, 0);
+
+    // requests of the old generation neither read nor write the cache
+    std::vector<NodeID> nodes;
+    std::vector<EdgeID> edges;
+    old_handle.Insert(facade, 1, 0, 0, 1, {0, 1}, {0});
+    BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+
+    const CliqueArcCacheHandle new_handle{&cache, cache.GetGeneration()};
+    BOOST_CHECK(!new_handle.AppendCached(facade, 1, 0, 0, 1, nodes, edges));
+    new_handle.Insert(facade, 1, 0, 0, 1, {0, 1}, {0});
+    BOOST_CHECK(!old_handle.AppendCached(facade, 1, 0, 0, 1, nodes, edges));
+    BOOST_CHECK(new_handle.AppendCached(facade, 1, 0, 0, 1, nodes, edges));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+#include "engine/map_matching/matching_sessions.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(matching_sessions)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::map_matching;
+
+BOOST_AUTO_TEST_CASE(returns_session_by_id)
+{
+    MatchingSessions sessions(1024 * 1024, std::chrono::seconds(60));
+    const auto generation = sessions.GetGeneration();
+
+    const auto first = sessions.Get("vehicle-1", generation);
+    const auto second = sessions.Get("vehicle-2", generation);
+    BOOST_CHECK(first != second);
+    BOOST_CHECK(sessions.Get("vehicle-1", generation) == first);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 2);
+
+    first->state.first_sequence = 5;
+    BOOST_CHECK_EQUAL(sessions.Get("vehicle-1", generation)->state.first_sequence, 5);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    MatchingSessions sessions(1000, std::chrono::seconds(60));
+    const auto generation = sessions.GetGeneration();
+
+    const auto first = sessions.Get("a", generation);
+    sessions.Update("a", first, 400);
+    const auto second = sessions.Get("b", generation);
+    sessions.Update("b", second, 400);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 800);
+
+    // a is used more recently than b now
+    sessions.Update("a", first, 400);
+    const auto third = sessions.Get("c", generation);
+    sessions.Update("c", third, 400);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 2);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 800);
+    BOOST_CHECK(sessions.Get("a", generation) == first);
+    BOOST_CHECK(sessions.Get("c", generation) == third);
+
+    // updates of evicted sessions are ignored
+    sessions.Update("b", second, 100);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 800);
+}
+
+BOOST_AUTO_TEST_CASE(drops_sessions_that_are_too_big)
+{
+    MatchingSessions sessions(1000, std::chrono::seconds(60));
+    const auto generation = sessions.GetGeneration();
+
+    const auto small = sessions.Get("small", generation);
+    sessions.Update("small", small, 100);
+    const auto big = sessions.Get("big", generation);
+    sessions.Update("big", big, 2000);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 1);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 100);
+    BOOST_CHECK(sessions.Get("small", generation) == small);
+}
+
+BOOST_AUTO_TEST_CASE(returns_new_session_that_does_not_fit)
+{
+    MatchingSessions sessions(1, std::chrono::seconds(60));
+    const auto generation = sessions.GetGeneration();
+
+    const auto first = sessions.Get("a", generation);
+    BOOST_REQUIRE(first != nullptr);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 0);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 0);
+
+    const auto second = sessions.Get("b", generation);
+    BOOST_REQUIRE(second != nullptr);
+    BOOST_CHECK(first != second);
+}
+
+BOOST_AUTO_TEST_CASE(drops_expired_sessions)
+{
+    MatchingSessions sessions(1024 * 1024, std::chrono::milliseconds(1));
+    const auto generation = sessions.GetGeneration();
+
+    const auto expired = sessions.Get("a", generation);
+    sessions.Update("a", expired, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    BOOST_CHECK(sessions.Get("a", generation) != expired);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_drops_sessions)
+{
+    MatchingSessions sessions(1024 * 1024, std::chrono::seconds(60));
+    const auto old_generation = sessions.GetGeneration();
+    const auto old_session = sessions.Get("a", old_generation);
+    sessions.Update("a", old_session, 100);
+
+    sessions.Invalidate();
+    BOOST_CHECK(sessions.GetGeneration() != old_generation);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 0);
+    BOOST_CHECK_EQUAL(sessions.GetSizeInBytes(), 0);
+
+    // requests that started before the data was swapped don't add sessions
+    const auto outdated = sessions.Get("a", old_generation);
+    BOOST_CHECK(outdated != old_session);
+    sessions.Update("a", outdated, 100);
+    BOOST_CHECK_EQUAL(sessions.GetNumberOfSessions(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
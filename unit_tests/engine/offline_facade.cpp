@@ -376,8 +376,8 @@ BOOST_AUTO_TEST_CASE(shortest_path)
     waypoints.push_back({osrm::engine::PhantomNode{}});
     waypoints.push_back({osrm::engine::PhantomNode{}});
 
-    auto route =
-        osrm::engine::routing_algorithms::shortestPathSearch(heaps, facade, waypoints, false);
+    auto route = osrm::engine::routing_algorithms::shortestPathSearch(
+        heaps, facade, waypoints, false, false);
 
     BOOST_CHECK_EQUAL(route.shortest_path_weight, INVALID_EDGE_WEIGHT);
 }
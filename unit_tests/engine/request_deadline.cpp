@@ -0,0 +1,133 @@
+#include "engine/request_deadline.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(request_deadline)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// calls Check() until it had to look at the clock at least once
+void checkInterval()
+{
+    for (std::uint32_t count = 0; count < RequestDeadline::CHECK_INTERVAL; ++count)
+    {
+        RequestDeadline::Check();
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(no_deadline_never_throws)
+{
+    BOOST_CHECK_NO_THROW(checkInterval());
+    BOOST_CHECK_NO_THROW(RequestDeadline::CheckNow());
+
+    const RequestDeadline deadline(std::nullopt, {});
+    BOOST_CHECK_NO_THROW(checkInterval());
+}
+
+BOOST_AUTO_TEST_CASE(expired_deadline_throws)
+{
+    const RequestDeadline deadline(RequestDeadline::Clock::now() - std::chrono::seconds(1), {});
+    BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+    BOOST_CHECK_THROW(checkInterval(), util::TimeoutException);
+}
+
+BOOST_AUTO_TEST_CASE(cancellation_throws)
+{
+    bool cancelled = false;
+    const RequestDeadline deadline(std::nullopt, [&] { return cancelled; });
+    BOOST_CHECK_NO_THROW(checkInterval());
+    cancelled = true;
+    BOOST_CHECK_THROW(checkInterval(), util::TimeoutException);
+}
+
+BOOST_AUTO_TEST_CASE(scopes_keep_earlier_deadline)
+{
+    const auto now = RequestDeadline::Clock::now();
+    bool cancelled = false;
+    {
+        const RequestDeadline outer(now + std::chrono::seconds(1), [&] { return cancelled; });
+        {
+            const RequestDeadline inner(now + std::chrono::hours(1), {});
+            BOOST_CHECK(*RequestDeadline::Current().deadline == now + std::chrono::seconds(1));
+            BOOST_CHECK(RequestDeadline::Current().is_cancelled);
+        }
+        {
+            const RequestDeadline inner(now - std::chrono::seconds(1), {});
+            BOOST_CHECK(*RequestDeadline::Current().deadline == now - std::chrono::seconds(1));
+        }
+        BOOST_CHECK(*RequestDeadline::Current().deadline == now + std::chrono::seconds(1));
+
+        // tasks of parallel searches continue the request of the calling thread
+        const auto state = RequestDeadline::Current();
+        cancelled = true;
+        std::thread task(
+            [&]
+            {
+                const RequestDeadline task_deadline(state);
+                BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+            });
+        task.join();
+    }
+    BOOST_CHECK(!RequestDeadline::Current().deadline);
+    BOOST_CHECK(!RequestDeadline::Current().is_cancelled);
+}
+
+BOOST_AUTO_TEST_CASE(nested_scopes_chain_cancellation)
+{
+    bool outer_cancelled = false;
+    bool inner_cancelled = false;
+    {
+        const RequestDeadline outer(std::nullopt, [&] { return outer_cancelled; });
+        {
+            const RequestDeadline inner(std::nullopt, [&] { return inner_cancelled; });
+            BOOST_CHECK_NO_THROW(RequestDeadline::CheckNow());
+
+            outer_cancelled = true;
+            BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+            outer_cancelled = false;
+
+            inner_cancelled = true;
+            BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+        }
+        // the cancellation check of the inner scope ends with it
+        BOOST_CHECK_NO_THROW(RequestDeadline::CheckNow());
+        outer_cancelled = true;
+        BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+    }
+    BOOST_CHECK_NO_THROW(RequestDeadline::CheckNow());
+}
+
+// a thread waiting for its own parallel search may run a task of another request
+BOOST_AUTO_TEST_CASE(task_scopes_replace_the_request_of_the_thread)
+{
+    bool task_cancelled = false;
+    const RequestDeadline task_request(std::nullopt, [&] { return task_cancelled; });
+    const auto task_state = RequestDeadline::Current();
+
+    std::thread thread(
+        [&]
+        {
+            const RequestDeadline request(RequestDeadline::Clock::now() - std::chrono::seconds(1),
+                                          [] { return true; });
+            {
+                const RequestDeadline task(task_state);
+                BOOST_CHECK(!RequestDeadline::Current().deadline);
+                BOOST_CHECK_NO_THROW(RequestDeadline::CheckNow());
+                task_cancelled = true;
+                BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+            }
+            // the request of the thread continues after the task
+            BOOST_CHECK(RequestDeadline::Current().deadline);
+            BOOST_CHECK_THROW(RequestDeadline::CheckNow(), util::TimeoutException);
+        });
+    thread.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using CHData = SearchEngineData<routing_algorithms::ch::Algorithm>;
+using MLDData = SearchEngineData<routing_algorithms::mld::Algorithm>;
+
+BOOST_AUTO_TEST_CASE(heaps_without_budget_are_kept)
+{
+    CHData heaps;
+    heaps.InitializeOrClearFirstThreadLocalStorage(1000);
+    BOOST_CHECK_GT(heaps.GetThreadLocalMemoryUsage(), 0);
+
+    heaps.ReleaseThreadLocalStorageOverBudget();
+    BOOST_CHECK(CHData::forward_heap_1);
+    heaps.ReleaseThreadLocalStorage();
+}
+
+BOOST_AUTO_TEST_CASE(heaps_over_budget_are_released)
+{
+    CHData heaps;
+    heaps.InitializeOrClearFirstThreadLocalStorage(1000);
+    const auto memory_usage = heaps.GetThreadLocalMemoryUsage();
+
+    heaps.max_thread_local_memory_usage = memory_usage;
+    heaps.ReleaseThreadLocalStorageOverBudget();
+    BOOST_CHECK(CHData::forward_heap_1);
+
+    heaps.max_thread_local_memory_usage = memory_usage - 1;
+    heaps.ReleaseThreadLocalStorageOverBudget();
+    BOOST_CHECK(!CHData::forward_heap_1);
+    BOOST_CHECK(!CHData::reverse_heap_1);
+    BOOST_CHECK_EQUAL(heaps.GetThreadLocalMemoryUsage(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(only_heaps_of_calling_thread_are_released)
+{
+    CHData heaps;
+    heaps.max_thread_local_memory_usage = 0;
+    heaps.InitializeOrClearFirstThreadLocalStorage(1000);
+
+    std::thread worker(
+        [&]
+        {
+            heaps.InitializeOrClearFirstThreadLocalStorage(1000);
+            heaps.ReleaseThreadLocalStorageOverBudget();
+        });
+    worker.join();
+
+    BOOST_CHECK(CHData::forward_heap_1);
+    heaps.ReleaseThreadLocalStorageOverBudget();
+    BOOST_CHECK(!CHData::forward_heap_1);
+}
+
+BOOST_AUTO_TEST_CASE(task_heaps_are_accounted)
+{
+    MLDData heaps;
+    heaps.InitializeOrClearFirstThreadLocalStorage(1000, 100);
+    const auto memory_usage = heaps.GetThreadLocalMemoryUsage();
+
+    auto &task_heaps = heaps.InitializeOrClearTaskThreadLocalStorage(1000, 100);
+    BOOST_CHECK(task_heaps.forward_heap);
+    BOOST_CHECK_GT(heaps.GetThreadLocalMemoryUsage(), memory_usage);
+
+    // only the task heaps are freed, the heaps of the request are still in use
+    heaps.max_thread_local_memory_usage = 0;
+    heaps.ReleaseTaskThreadLocalStorageOverBudget();
+    BOOST_CHECK(!task_heaps.forward_heap);
+    BOOST_CHECK(!task_heaps.reverse_heap);
+    BOOST_CHECK(MLDData::forward_heap_1);
+    BOOST_CHECK_EQUAL(heaps.GetThreadLocalMemoryUsage(), memory_usage);
+
+    heaps.InitializeOrClearTaskThreadLocalStorage(1000, 100);
+    heaps.ReleaseThreadLocalStorageOverBudget();
+    BOOST_CHECK(!task_heaps.forward_heap);
+    BOOST_CHECK(!MLDData::forward_heap_1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+#include "engine/routing_algorithms/shortcut_cache.hpp"
+#include "mocks/mock_datafacade.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(shortcut_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+std::vector<ShortcutCache::UnpackedEdge> makeEdges(const std::size_t number_of_edges)
+{
+    std::vector<ShortcutCache::UnpackedEdge> edges;
+    for (const auto index : util::irange<std::size_t>(0, number_of_edges))
+    {
+        edges.emplace_back(static_cast<NodeID>(index + 1), static_cast<EdgeID>(index + 100));
+    }
+    return edges;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(find_appends_edges)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    ShortcutCache cache(1024 * 1024);
+    const ShortcutCacheHandle handle{&cache, cache.GetGeneration()};
+
+    const auto edges = makeEdges(3);
+    handle.Insert(facade, 7, false, edges.begin(), edges.end());
+
+    std::vector<ShortcutCache::UnpackedEdge> result = {{0, 0}};
+    BOOST_CHECK(!handle.Find(facade, 7, true, result));
+    BOOST_CHECK(!handle.Find(facade, 8, false, result));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK(handle.Find(facade, 7, false, result));
+    BOOST_REQUIRE_EQUAL(result.size(), 4);
+    BOOST_CHECK(std::equal(edges.begin(), edges.end(), result.begin() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(long_shortcuts_are_not_stored)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    ShortcutCache cache(1024 * 1024);
+    const ShortcutCacheHandle handle{&cache, cache.GetGeneration()};
+
+    const auto edges = makeEdges(ShortcutCache::MAX_UNPACKED_EDGES + 1);
+    handle.Insert(facade, 7, false, edges.begin(), edges.end());
+
+    std::vector<ShortcutCache::UnpackedEdge> result;
+    BOOST_CHECK(!handle.Find(facade, 7, false, result));
+    BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(insert_replaces_slot)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    // a single slot, every shortcut replaces the previous one
+    ShortcutCache cache(0);
+    const ShortcutCacheHandle handle{&cache, cache.GetGeneration()};
+
+    const auto edges = makeEdges(2);
+    handle.Insert(facade, 7, false, edges.begin(), edges.end());
+    handle.Insert(facade, 8, false, edges.begin(), edges.begin() + 1);
+
+    std::vector<ShortcutCache::UnpackedEdge> result;
+    BOOST_CHECK(!handle.Find(facade, 7, false, result));
+    BOOST_CHECK(handle.Find(facade, 8, false, result));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_drops_generation)
+{
+    const test::MockDataFacade<ch::Algorithm> facade{};
+    ShortcutCache cache(1024 * 1024);
+    const ShortcutCacheHandle old_handle{&cache, cache.GetGeneration()};
+
+    const auto edges = makeEdges(3);
+    old_handle.Insert(facade, 7, false, edges.begin(), edges.end());
+    cache.Invalidate();
+
+    // requests of the old generation still use the old facade and may read its shortcuts,
+    // but don't add any
+    std::vector<ShortcutCache::UnpackedEdge> result;
+    BOOST_CHECK(old_handle.Find(facade, 7, false, result));
+    old_handle.Insert(facade, 8, false, edges.begin(), edges.end());
+
+    const ShortcutCacheHandle new_handle{&cache, cache.GetGeneration()};
+    BOOST_CHECK(!new_handle.Find(facade, 7, false, result));
+    BOOST_CHECK(!new_handle.Find(facade, 8, false, result));
+    new_handle.Insert(facade, 7, false, edges.begin(), edges.end());
+    BOOST_CHECK(!old_handle.Find(facade, 7, false, result));
+    BOOST_CHECK(new_handle.Find(facade, 7, false, result));
+}
+
+BOOST_AUTO_TEST_CASE(scope_restores_handle)
+{
+    ShortcutCache cache(1024);
+    BOOST_CHECK(!ShortcutCacheScope::Current());
+    {
+        const ShortcutCacheScope outer({&cache, 1});
+        BOOST_CHECK_EQUAL(ShortcutCacheScope::Current().generation, 1);
+        {
+            const ShortcutCacheScope inner({});
+            BOOST_CHECK(!ShortcutCacheScope::Current());
+        }
+        BOOST_CHECK_EQUAL(ShortcutCacheScope::Current().generation, 1);
+    }
+    BOOST_CHECK(!ShortcutCacheScope::Current());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,69 @@
+#include "engine/routing_algorithms/target_buckets.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(target_buckets)
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+BOOST_AUTO_TEST_CASE(find_buckets_of_node)
+{
+    TargetBuckets buckets({{7, 1, {1}, {1}, {1}}, {3, 0, {2}, {2}, {2}}, {7, 0, {3}, {3}, {3}}});
+
+    BOOST_CHECK(buckets.Find(5).empty());
+    BOOST_CHECK_EQUAL(buckets.Find(3).size(), 1);
+    const auto range = buckets.Find(7);
+    BOOST_REQUIRE_EQUAL(range.size(), 2);
+    BOOST_CHECK_EQUAL(range.front().column_index, 0);
+    BOOST_CHECK_EQUAL(range.back().column_index, 1);
+}
+
+BOOST_AUTO_TEST_CASE(reached_buckets_are_not_pending)
+{
+    TargetBuckets buckets({{7, 0, {1}, {1}, {1}}, {7, 1, {1}, {1}, {1}}});
+    BOOST_CHECK_EQUAL(buckets.NumberOfPendingBuckets(), 2);
+
+    buckets.MarkReached(buckets.Find(7).front());
+    BOOST_CHECK_EQUAL(buckets.NumberOfPendingBuckets(), 1);
+    BOOST_CHECK(buckets.HasPendingBucket(7));
+
+    buckets.MarkReached(buckets.Find(7).back());
+    BOOST_CHECK_EQUAL(buckets.NumberOfPendingBuckets(), 0);
+    BOOST_CHECK(!buckets.HasPendingBucket(7));
+    // reached buckets are still found
+    BOOST_CHECK_EQUAL(buckets.Find(7).size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(filter_keeps_all_buckets)
+{
+    std::mt19937 g(42);
+    std::uniform_int_distribution<NodeID> node(0, 1 << 20);
+    std::vector<TargetBucket> bucket_list;
+    std::set<NodeID> nodes;
+    for (const auto index : util::irange<std::uint32_t>(0, 1000))
+    {
+        bucket_list.push_back({node(g), index, {1}, {1}, {1}});
+        nodes.insert(bucket_list.back().node);
+    }
+    TargetBuckets buckets(bucket_list);
+
+    for (const auto bucket_node : nodes)
+    {
+        BOOST_CHECK(buckets.HasPendingBucket(bucket_node));
+    }
+    for (const auto index : util::irange<std::uint32_t>(0, 10000))
+    {
+        (void)index;
+        const auto other_node = node(g);
+        BOOST_CHECK_EQUAL(buckets.HasPendingBucket(other_node), nodes.count(other_node) > 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
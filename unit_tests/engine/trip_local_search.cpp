@@ -0,0 +1,159 @@
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search)
+
+using namespace osrm;
+using namespace osrm::engine::trip;
+
+namespace
+{
+const auto NO_END = TripLocalSearch::Clock::time_point::max();
+
+// locations on a circle, the shortest round trip visits them in order
+util::DistTableWrapper<EdgeDuration> makeCircleTable(const std::size_t number_of_locations)
+{
+    const double pi = std::acos(-1.);
+    std::vector<EdgeDuration> table;
+    for (const auto from : util::irange<std::size_t>(0UL, number_of_locations))
+    {
+        for (const auto to : util::irange<std::size_t>(0UL, number_of_locations))
+        {
+            const auto angle = pi * (static_cast<double>(from) - static_cast<double>(to)) /
+                               static_cast<double>(number_of_locations);
+            table.push_back(EdgeDuration{static_cast<std::int32_t>(
+                std::round(20000 * std::abs(std::sin(angle))))});
+        }
+    }
+    return util::DistTableWrapper<EdgeDuration>(std::move(table), number_of_locations);
+}
+
+util::DistTableWrapper<EdgeDuration> makeRandomTable(const std::size_t number_of_locations)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> duration(1, 1000);
+    std::vector<EdgeDuration> table(number_of_locations * number_of_locations);
+    for (auto &value : table)
+    {
+        value = EdgeDuration{duration(generator)};
+    }
+    return util::DistTableWrapper<EdgeDuration>(std::move(table), number_of_locations);
+}
+
+bool isPermutation(std::vector<NodeID> trip)
+{
+    std::sort(trip.begin(), trip.end());
+    for (const auto index : util::irange<std::size_t>(0UL, trip.size()))
+    {
+        if (trip[index] != index)
+            return false;
+    }
+    return true;
+}
+
+std::vector<NodeID> makeShuffledTrip(const std::size_t number_of_locations)
+{
+    std::vector<NodeID> trip(number_of_locations);
+    std::iota(trip.begin(), trip.end(), 0);
+    std::shuffle(trip.begin(), trip.end(), std::mt19937(7));
+    return trip;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(two_opt_untangles_crossing)
+{
+    const auto table = makeCircleTable(6);
+    TripLocalSearch search(table);
+
+    std::vector<NodeID> trip{0, 1, 4, 3, 2, 5};
+    std::vector<NodeID> shortest{0, 1, 2, 3, 4, 5};
+    BOOST_CHECK(search.TwoOpt(trip, NO_END));
+    BOOST_CHECK_EQUAL(search.TripDuration(trip), search.TripDuration(shortest));
+    BOOST_CHECK(!search.TwoOpt(trip, NO_END));
+}
+
+BOOST_AUTO_TEST_CASE(or_opt_moves_location)
+{
+    const auto table = makeCircleTable(8);
+    TripLocalSearch search(table);
+
+    std::vector<NodeID> trip{0, 1, 2, 6, 3, 4, 5, 7};
+    std::vector<NodeID> shortest{0, 1, 2, 3, 4, 5, 6, 7};
+    BOOST_CHECK(search.OrOpt(trip, NO_END));
+    BOOST_CHECK(isPermutation(trip));
+    BOOST_CHECK_EQUAL(search.Improve(trip, NO_END), search.TripDuration(shortest));
+}
+
+BOOST_AUTO_TEST_CASE(moves_shorten_asymmetric_trip)
+{
+    const auto table = makeRandomTable(40);
+    TripLocalSearch search(table);
+
+    auto trip = makeShuffledTrip(40);
+    auto duration = search.TripDuration(trip);
+    // every applied move has to shorten the trip, even if the reversed parts get longer
+    for (bool improved = true; improved;)
+    {
+        improved = false;
+        if (search.TwoOpt(trip, NO_END))
+        {
+            BOOST_CHECK_LT(search.TripDuration(trip), duration);
+            duration = search.TripDuration(trip);
+            improved = true;
+        }
+        if (search.OrOpt(trip, NO_END))
+        {
+            BOOST_CHECK_LT(search.TripDuration(trip), duration);
+            duration = search.TripDuration(trip);
+            improved = true;
+        }
+        BOOST_REQUIRE(isPermutation(trip));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(avoids_invalid_durations)
+{
+    auto table = makeRandomTable(20);
+    // as for trips with a fixed start 0 and end 19
+    for (const auto to : util::irange<NodeID>(0, 20))
+    {
+        table.SetValue(19, to, INVALID_EDGE_DURATION);
+    }
+    table.SetValue(19, 0, {0});
+    table.SetValue(0, 19, INVALID_EDGE_DURATION);
+
+    const auto start = FarthestInsertionTrip(20, table);
+    const auto trip = LocalSearchTrip(table, start, NO_END, 100);
+
+    BOOST_CHECK(isPermutation(trip));
+    const auto destination = std::find(trip.begin(), trip.end(), 19);
+    BOOST_CHECK_EQUAL(destination == trip.end() - 1 ? trip.front() : *(destination + 1), 0);
+
+    TripLocalSearch search(table);
+    BOOST_CHECK_LE(search.TripDuration(trip), search.TripDuration(start));
+}
+
+BOOST_AUTO_TEST_CASE(finds_shortest_trip_on_circle)
+{
+    const auto table = makeCircleTable(60);
+    TripLocalSearch search(table);
+    std::vector<NodeID> shortest(60);
+    std::iota(shortest.begin(), shortest.end(), 0);
+
+    const auto start = makeShuffledTrip(60);
+    const auto trip = LocalSearchTrip(table, start, NO_END, 100);
+
+    BOOST_CHECK(isPermutation(trip));
+    BOOST_CHECK_EQUAL(search.TripDuration(trip), search.TripDuration(shortest));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
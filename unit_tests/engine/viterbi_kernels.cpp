@@ -0,0 +1,162 @@
+#include "engine/map_matching/viterbi_kernels.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(viterbi_kernels)
+
+using namespace osrm;
+using namespace osrm::engine::map_matching;
+
+namespace
+{
+struct Column
+{
+    explicit Column(std::vector<double> emission_log_probabilities_)
+        : emission_log_probabilities(std::move(emission_log_probabilities_)),
+          viterbi(emission_log_probabilities.size(), IMPOSSIBLE_LOG_PROB),
+          parents(emission_log_probabilities.size()),
+          path_distances(emission_log_probabilities.size(), 0),
+          pruned(emission_log_probabilities.size(), true)
+    {
+    }
+
+    LatticeColumn Lattice()
+    {
+        return {emission_log_probabilities.size(),
+                emission_log_probabilities.data(),
+                viterbi.data(),
+                parents.data(),
+                path_distances.data(),
+                pruned.data()};
+    }
+
+    std::vector<double> emission_log_probabilities;
+    std::vector<double> viterbi;
+    std::vector<std::pair<unsigned, unsigned>> parents;
+    std::vector<float> path_distances;
+    std::vector<std::uint8_t> pruned;
+};
+
+void checkRelaxationsAgree(const std::size_t number_of_candidates)
+{
+    std::mt19937 g(42);
+    std::uniform_real_distribution<double> candidate_distance(0, 50);
+    // few distinct values to exercise ties on the path value
+    std::uniform_int_distribution<int> network_distance(0, 40);
+
+    const EmissionLogProbability emission(5);
+    std::vector<double> emission_log_probabilities(number_of_candidates);
+    for (auto &value : emission_log_probabilities)
+    {
+        value = candidate_distance(g);
+    }
+    computeEmissionLogProbabilitiesScalar(
+        emission, emission_log_probabilities.data(), number_of_candidates);
+
+    const TransitionLogProbability transition(2);
+    Column scalar(emission_log_probabilities);
+    Column dispatched(emission_log_probabilities);
+    bool scalar_improved = false;
+    bool dispatched_improved = false;
+    for (const auto s : util::irange<unsigned>(0, 8))
+    {
+        std::vector<EdgeDistance> row(number_of_candidates);
+        for (auto &distance : row)
+        {
+            const auto value = network_distance(g);
+            // some candidates are unreachable from the source
+            distance = value == 0 ? MAXIMAL_EDGE_DISTANCE : EdgeDistance{value * 10.f};
+        }
+        const double source_viterbi = -static_cast<double>(s % 3);
+        scalar_improved = relaxTransitionsScalar(transition,
+                                                 source_viterbi,
+                                                 {1, s},
+                                                 row.data(),
+                                                 200,
+                                                 150,
+                                                 scalar.Lattice()) ||
+                          scalar_improved;
+        dispatched_improved = relaxTransitions(transition,
+                                               source_viterbi,
+                                               {1, s},
+                                               row.data(),
+                                               200,
+                                               150,
+                                               dispatched.Lattice()) ||
+                              dispatched_improved;
+    }
+
+    BOOST_CHECK_EQUAL(scalar_improved, dispatched_improved);
+    BOOST_CHECK(scalar.viterbi == dispatched.viterbi);
+    BOOST_CHECK(scalar.parents == dispatched.parents);
+    BOOST_CHECK(scalar.path_distances == dispatched.path_distances);
+    BOOST_CHECK(scalar.pruned == dispatched.pruned);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(emission_log_probabilities)
+{
+    const EmissionLogProbability emission(5);
+    std::vector<double> distances{0., 1.5, 3., 7.25, 10., 12.5, 20., 33.};
+
+    auto scalar = distances;
+    computeEmissionLogProbabilitiesScalar(emission, scalar.data(), scalar.size());
+    for (const auto index : util::irange<std::size_t>(0UL, distances.size()))
+    {
+        BOOST_CHECK_EQUAL(scalar[index], emission(distances[index]));
+    }
+
+    // every length to cover full vectors and the scalar tail
+    for (const auto size : util::irange<std::size_t>(0UL, distances.size() + 1))
+    {
+        auto dispatched = distances;
+        computeEmissionLogProbabilities(emission, dispatched.data(), size);
+        for (const auto index : util::irange<std::size_t>(0UL, distances.size()))
+        {
+            BOOST_CHECK_EQUAL(dispatched[index], index < size ? scalar[index] : distances[index]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(relaxation_keeps_best_path)
+{
+    const TransitionLogProbability transition(2);
+    Column column({-1., -1., -1.});
+    column.viterbi[1] = 0;
+    column.pruned[1] = false;
+
+    const std::vector<EdgeDistance> row{
+        EdgeDistance{100}, EdgeDistance{100}, MAXIMAL_EDGE_DISTANCE};
+    BOOST_CHECK(relaxTransitions(transition, -2, {3, 4}, row.data(), 100, 50, column.Lattice()));
+
+    // a worse path keeps the candidate
+    BOOST_CHECK_EQUAL(column.viterbi[1], 0);
+    BOOST_CHECK(column.parents[1] == std::make_pair(0u, 0u));
+    BOOST_CHECK(!column.pruned[1]);
+    // a better path replaces the candidate
+    BOOST_CHECK_EQUAL(column.viterbi[0], -3 + transition(0));
+    BOOST_CHECK(column.parents[0] == std::make_pair(3u, 4u));
+    BOOST_CHECK_EQUAL(column.path_distances[0], 100);
+    BOOST_CHECK(!column.pruned[0]);
+    // unreachable candidates stay pruned
+    BOOST_CHECK_EQUAL(column.viterbi[2], IMPOSSIBLE_LOG_PROB);
+    BOOST_CHECK(column.pruned[2]);
+
+    // transitions with too large a distance difference are pruned
+    BOOST_CHECK(!relaxTransitions(transition, 0, {5, 6}, row.data(), 10, 50, column.Lattice()));
+}
+
+BOOST_AUTO_TEST_CASE(dispatched_relaxation_matches_scalar)
+{
+    for (const auto number_of_candidates : {1UL, 4UL, 7UL, 13UL, 32UL})
+    {
+        checkRelaxationsAgree(number_of_candidates);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/batch_match_parameters.hpp"
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/match_parameters.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include "util/json_renderer.hpp"
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(batch_match)
+
+void test_batch_match_matches_match(osrm::EngineConfig::Algorithm algorithm,
+                                    const std::string &path)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(path, algorithm);
+
+    BatchMatchParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    params.trace_sizes.push_back(params.coordinates.size());
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.trace_sizes.push_back(params.coordinates.size() - params.trace_sizes.front());
+    params.overview = MatchParameters::OverviewType::Full;
+
+    json::Object json_result;
+    BOOST_REQUIRE(osrm.BatchMatch(params, json_result) == Status::Ok);
+    BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value, "Ok");
+
+    const auto &traces = std::get<json::Array>(json_result.values.at("traces")).values;
+    BOOST_REQUIRE_EQUAL(traces.size(), params.NumberOfTraces());
+
+    const auto trace_params = params.SplitTraces();
+    for (std::size_t trace_index = 0; trace_index < traces.size(); ++trace_index)
+    {
+        json::Object match_result;
+        osrm.Match(trace_params[trace_index], match_result);
+
+        const auto &batch_trace = std::get<json::Object>(traces[trace_index]).values;
+        BOOST_CHECK_EQUAL(std::get<json::String>(batch_trace.at("code")).value,
+                          std::get<json::String>(match_result.values.at("code")).value);
+        BOOST_CHECK(batch_trace.find("data_version") == batch_trace.end());
+        if (std::get<json::String>(batch_trace.at("code")).value != "Ok")
+            continue;
+
+        const auto &batch_matchings = std::get<json::Array>(batch_trace.at("matchings")).values;
+        const auto &matchings = std::get<json::Array>(match_result.values.at("matchings")).values;
+        BOOST_REQUIRE_EQUAL(batch_matchings.size(), matchings.size());
+        for (std::size_t index = 0; index < matchings.size(); ++index)
+        {
+            const auto &batch_matching = std::get<json::Object>(batch_matchings[index]).values;
+            const auto &matching = std::get<json::Object>(matchings[index]).values;
+            BOOST_CHECK_EQUAL(std::get<json::Number>(batch_matching.at("distance")).value,
+                              std::get<json::Number>(matching.at("distance")).value);
+            BOOST_CHECK_EQUAL(std::get<json::String>(batch_matching.at("geometry")).value,
+                              std::get<json::String>(matching.at("geometry")).value);
+        }
+    }
+}
+BOOST_AUTO_TEST_CASE(test_batch_match_matches_match_ch)
+{
+    test_batch_match_matches_match(osrm::EngineConfig::Algorithm::CH,
+                                   OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_batch_match_matches_match_mld)
+{
+    test_batch_match_matches_match(osrm::EngineConfig::Algorithm::MLD,
+                                   OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_match_stream)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    BatchMatchParameters params;
+    const auto locations = get_split_trace_locations();
+    params.coordinates.insert(params.coordinates.end(), locations.begin(), locations.end());
+    params.coordinates.insert(params.coordinates.end(), locations.begin(), locations.end());
+    params.trace_sizes = {locations.size(), locations.size()};
+
+    engine::api::ResultT result = json::Object();
+    std::string response;
+    const auto rc = osrm.BatchMatch(
+        params, result, [&](const std::string_view chunk) { response.append(chunk); });
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    // the response is only written to the stream
+    BOOST_CHECK(std::get<json::Object>(result).values.empty());
+    BOOST_CHECK_EQUAL(response.rfind("{\"code\":\"Ok\"", 0), 0);
+    BOOST_CHECK(response.find("\"traces\":[{") != std::string::npos);
+    BOOST_CHECK_EQUAL(response.substr(response.size() - 2), "]}");
+}
+
+// the traces are matched in parallel, but streamed in their order
+BOOST_AUTO_TEST_CASE(test_batch_match_stream_order)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    BatchMatchParameters params;
+    const auto split_trace = get_split_trace_locations();
+    const auto big_component = get_locations_in_big_component();
+    for (std::size_t trace_index = 0; trace_index < 500; ++trace_index)
+    {
+        const auto &locations = trace_index % 3 == 0 ? split_trace : big_component;
+        params.coordinates.insert(params.coordinates.end(), locations.begin(), locations.end());
+        params.trace_sizes.push_back(locations.size());
+    }
+
+    json::Object json_result;
+    BOOST_REQUIRE(osrm.BatchMatch(params, json_result) == Status::Ok);
+    std::string expected_traces;
+    util::json::Renderer renderer(expected_traces);
+    renderer(std::get<json::Array>(json_result.values.at("traces")));
+
+    engine::api::ResultT result = json::Object();
+    std::string response;
+    BOOST_REQUIRE(osrm.BatchMatch(params,
+                                  result,
+                                  [&](const std::string_view chunk) { response.append(chunk); }) ==
+                  Status::Ok);
+    const auto traces_begin = response.find("\"traces\":[");
+    BOOST_REQUIRE(traces_begin != std::string::npos);
+    const auto streamed_traces =
+        response.substr(traces_begin + 9, response.size() - 1 - (traces_begin + 9));
+    BOOST_CHECK_EQUAL(streamed_traces, expected_traces);
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_match_too_big)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_traces_batch_match = 1; });
+
+    BatchMatchParameters params;
+    params.coordinates = get_split_trace_locations();
+    params.trace_sizes = {2, params.coordinates.size() - 2};
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.BatchMatch(params, json_result) == Status::Error);
+    BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value, "TooBig");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/batch_route_parameters.hpp"
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(batch_route)
+
+void test_batch_route_matches_route(osrm::EngineConfig::Algorithm algorithm,
+                                    const std::string &path)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(path, algorithm);
+
+    BatchRouteParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    // duplicated locations are only snapped once
+    params.coordinates.push_back(params.coordinates.front());
+    params.overview = BatchRouteParameters::OverviewType::Full;
+
+    for (const auto source : {0UL, 3UL, 7UL})
+    {
+        for (const auto target : {1UL, 2UL, 5UL, 7UL})
+        {
+            params.sources.push_back(source);
+            params.destinations.push_back(target);
+        }
+    }
+
+    json::Object json_result;
+    BOOST_REQUIRE(osrm.BatchRoute(params, json_result) == Status::Ok);
+    BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value, "Ok");
+
+    const auto &waypoints = std::get<json::Array>(json_result.values.at("waypoints")).values;
+    BOOST_CHECK_EQUAL(waypoints.size(), params.coordinates.size());
+    const auto location = [](const json::Value &waypoint)
+    {
+        const auto &values = std::get<json::Array>(
+                                 std::get<json::Object>(waypoint).values.at("location"))
+                                 .values;
+        return std::make_pair(std::get<json::Number>(values[0]).value,
+                              std::get<json::Number>(values[1]).value);
+    };
+    BOOST_CHECK(location(waypoints.front()) == location(waypoints.back()));
+
+    const auto &routes = std::get<json::Array>(json_result.values.at("routes")).values;
+    BOOST_REQUIRE_EQUAL(routes.size(), params.sources.size());
+
+    for (std::size_t pair_index = 0; pair_index < routes.size(); ++pair_index)
+    {
+        RouteParameters route_params;
+        route_params.coordinates = {params.coordinates[params.sources[pair_index]],
+                                    params.coordinates[params.destinations[pair_index]]};
+        route_params.overview = RouteParameters::OverviewType::Full;
+
+        json::Object route_result;
+        const auto rc = osrm.Route(route_params, route_result);
+        if (rc != Status::Ok)
+        {
+            BOOST_CHECK(std::holds_alternative<json::Null>(routes[pair_index]));
+            continue;
+        }
+
+        const auto &batch_route = std::get<json::Object>(routes[pair_index]).values;
+        const auto &route = std::get<json::Object>(
+                                std::get<json::Array>(route_result.values.at("routes")).values[0])
+                                .values;
+        BOOST_CHECK_EQUAL(std::get<json::Number>(batch_route.at("duration")).value,
+                          std::get<json::Number>(route.at("duration")).value);
+        BOOST_CHECK_EQUAL(std::get<json::Number>(batch_route.at("distance")).value,
+                          std::get<json::Number>(route.at("distance")).value);
+        BOOST_CHECK_EQUAL(std::get<json::String>(batch_route.at("geometry")).value,
+                          std::get<json::String>(route.at("geometry")).value);
+    }
+}
+BOOST_AUTO_TEST_CASE(test_batch_route_matches_route_ch)
+{
+    test_batch_route_matches_route(osrm::EngineConfig::Algorithm::CH,
+                                   OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_batch_route_matches_route_mld)
+{
+    test_batch_route_matches_route(osrm::EngineConfig::Algorithm::MLD,
+                                   OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_route_consecutive_pairs)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    BatchRouteParameters params;
+    params.coordinates = get_split_trace_locations();
+    params.skip_waypoints = true;
+
+    json::Object json_result;
+    BOOST_REQUIRE(osrm.BatchRoute(params, json_result) == Status::Ok);
+    BOOST_CHECK(json_result.values.find("waypoints") == json_result.values.end());
+
+    const auto &routes = std::get<json::Array>(json_result.values.at("routes")).values;
+    BOOST_REQUIRE_EQUAL(routes.size(), 2);
+    for (const auto &route : routes)
+    {
+        const auto &values = std::get<json::Object>(route).values;
+        BOOST_CHECK(values.find("geometry") == values.end());
+        BOOST_CHECK_GT(std::get<json::Number>(values.at("distance")).value, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_route_too_big)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_pairs_batch_route = 1; });
+
+    BatchRouteParameters params;
+    params.coordinates = get_split_trace_locations();
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.BatchRoute(params, json_result) == Status::Error);
+    BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value, "TooBig");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
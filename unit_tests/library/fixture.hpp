@@ -21,4 +21,20 @@ getOSRM(const std::string &base_path,
     return osrm::OSRM{config};
 }
 
+// Same as above, but the config can be changed before the engine is created, e.g. to enable the
+// option under test
+template <typename ConfigMutator>
+inline osrm::OSRM getOSRM(const std::string &base_path,
+                          osrm::EngineConfig::Algorithm algorithm,
+                          ConfigMutator &&mutate_config)
+{
+    osrm::EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    mutate_config(config);
+
+    return osrm::OSRM{config};
+}
+
 #endif
@@ -6,12 +6,23 @@
 #include "waypoint_check.hpp"
 
 #include "osrm/match_parameters.hpp"
+#include "osrm/table_parameters.hpp"
 
 #include "osrm/coordinate.hpp"
 #include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "engine/request_deadline.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 osrm::Status run_match_json(const osrm::OSRM &osrm,
                             const osrm::MatchParameters &params,
                             osrm::json::Object &json_result,
@@ -29,6 +40,27 @@ osrm::Status run_match_json(const osrm::OSRM &osrm,
     return rc;
 }
 
+// locations of the tracepoints that could be matched
+std::vector<osrm::util::Coordinate> get_tracepoint_locations(const osrm::json::Object &result)
+{
+    using namespace osrm;
+
+    std::vector<util::Coordinate> locations;
+    for (const auto &tracepoint : std::get<json::Array>(result.values.at("tracepoints")).values)
+    {
+        if (std::holds_alternative<json::Null>(tracepoint))
+        {
+            continue;
+        }
+        const auto &location =
+            std::get<json::Array>(std::get<json::Object>(tracepoint).values.at("location")).values;
+        locations.push_back(
+            util::Coordinate{util::FloatLongitude{std::get<json::Number>(location.at(0)).value},
+                             util::FloatLatitude{std::get<json::Number>(location.at(1)).value}});
+    }
+    return locations;
+}
+
 BOOST_AUTO_TEST_SUITE(match)
 
 void test_match(bool use_json_only_api)
@@ -157,6 +189,147 @@ void test_match_split(bool use_json_only_api)
 BOOST_AUTO_TEST_CASE(test_match_split_old_api) { test_match_split(true); }
 BOOST_AUTO_TEST_CASE(test_match_split_new_api) { test_match_split(false); }
 
+// The transitions are computed by the table searches, so the distance of a matched leg has to
+// agree with the table distance between its tracepoints
+void test_match_leg_distances_match_table(osrm::EngineConfig::Algorithm algorithm,
+                                          const std::string &path)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(path, algorithm);
+
+    MatchParameters params;
+    params.coordinates = get_locations_in_big_component();
+    params.timestamps = {0, 60, 120};
+
+    json::Object json_result;
+    BOOST_REQUIRE(osrm.Match(params, json_result) == Status::Ok);
+    const auto &tracepoints = std::get<json::Array>(json_result.values.at("tracepoints")).values;
+    const auto &matchings = std::get<json::Array>(json_result.values.at("matchings")).values;
+
+    const auto get_location = [](const json::Object &tracepoint)
+    {
+        const auto &location = std::get<json::Array>(tracepoint.values.at("location")).values;
+        return Location{Longitude{std::get<json::Number>(location.at(0)).value},
+                        Latitude{std::get<json::Number>(location.at(1)).value}};
+    };
+    const auto get_index = [](const json::Object &tracepoint, const char *key)
+    { return static_cast<std::size_t>(std::get<json::Number>(tracepoint.values.at(key)).value); };
+
+    std::size_t number_of_legs = 0;
+    for (std::size_t index = 1; index < tracepoints.size(); ++index)
+    {
+        if (!std::holds_alternative<json::Object>(tracepoints[index - 1]) ||
+            !std::holds_alternative<json::Object>(tracepoints[index]))
+        {
+            continue;
+        }
+        const auto &from = std::get<json::Object>(tracepoints[index - 1]);
+        const auto &to = std::get<json::Object>(tracepoints[index]);
+        const auto matchings_index = get_index(to, "matchings_index");
+        if (get_index(from, "matchings_index") != matchings_index)
+        {
+            continue;
+        }
+        const auto &legs =
+            std::get<json::Array>(
+                std::get<json::Object>(matchings.at(matchings_index)).values.at("legs"))
+                .values;
+        const auto &leg = std::get<json::Object>(legs.at(get_index(from, "waypoint_index")));
+        const auto leg_distance = std::get<json::Number>(leg.values.at("distance")).value;
+
+        TableParameters table_params;
+        table_params.coordinates = {get_location(from), get_location(to)};
+        table_params.sources = {0};
+        table_params.destinations = {1};
+        table_params.annotations = TableParameters::AnnotationsType::Distance;
+        json::Object table_result;
+        BOOST_REQUIRE(osrm.Table(table_params, table_result) == Status::Ok);
+        const auto &distances = std::get<json::Array>(table_result.values.at("distances")).values;
+        const auto table_distance =
+            std::get<json::Number>(std::get<json::Array>(distances.at(0)).values.at(0)).value;
+
+        // the table sums up the segment distances, the leg measures its geometry
+        BOOST_CHECK_CLOSE(table_distance, leg_distance, 1.);
+        ++number_of_legs;
+    }
+    BOOST_CHECK_GT(number_of_legs, 0);
+}
+BOOST_AUTO_TEST_CASE(test_match_leg_distances_match_table_ch)
+{
+    test_match_leg_distances_match_table(osrm::EngineConfig::Algorithm::CH,
+                                         OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_match_leg_distances_match_table_mld)
+{
+    test_match_leg_distances_match_table(osrm::EngineConfig::Algorithm::MLD,
+                                         OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+// The transition searches are bounded by the distance that the pruning by max_distance_delta
+// accepts, i.e. step time * 180 km/h of the car profile, instead of by a minimum speed
+void test_match_transition_distance_bound(osrm::EngineConfig::Algorithm algorithm,
+                                          const std::string &path)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(path, algorithm);
+
+    const auto locations = get_split_trace_locations();
+    const auto match_leg_distance = [&](unsigned step_time) -> std::optional<double>
+    {
+        MatchParameters params;
+        params.coordinates = {locations[0], locations[1]};
+        params.timestamps = {0, step_time};
+
+        json::Object json_result;
+        if (osrm.Match(params, json_result) != Status::Ok)
+        {
+            return std::nullopt;
+        }
+        const auto &matchings = std::get<json::Array>(json_result.values.at("matchings")).values;
+        if (matchings.size() != 1)
+        {
+            return std::nullopt;
+        }
+        const auto &legs =
+            std::get<json::Array>(std::get<json::Object>(matchings.front()).values.at("legs"))
+                .values;
+        return std::get<json::Number>(std::get<json::Object>(legs.at(0)).values.at("distance"))
+            .value;
+    };
+
+    const double max_speed = 180 / 3.6;
+    const auto haversine_distance =
+        util::coordinate_calculation::greatCircleDistance(locations[0], locations[1]);
+
+    // a minute allows detours of several kilometers
+    const auto slow_distance = match_leg_distance(60);
+    BOOST_REQUIRE(slow_distance);
+
+    // within a second only paths close to the haversine distance are accepted
+    const auto fast_distance = match_leg_distance(1);
+    if (fast_distance)
+    {
+        BOOST_CHECK_LE(std::abs(*fast_distance - haversine_distance), 1.01 * max_speed);
+    }
+    if (std::abs(*slow_distance - haversine_distance) < 0.99 * max_speed)
+    {
+        BOOST_REQUIRE(fast_distance);
+        BOOST_CHECK_CLOSE(*fast_distance, *slow_distance, 1.);
+    }
+}
+BOOST_AUTO_TEST_CASE(test_match_transition_distance_bound_ch)
+{
+    test_match_transition_distance_bound(osrm::EngineConfig::Algorithm::CH,
+                                         OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_match_transition_distance_bound_mld)
+{
+    test_match_transition_distance_bound(osrm::EngineConfig::Algorithm::MLD,
+                                         OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
 BOOST_AUTO_TEST_CASE(test_match_fb_serialization)
 {
     using namespace osrm;
@@ -223,4 +396,167 @@ BOOST_AUTO_TEST_CASE(test_match_fb_serialization_skip_waypoints)
     BOOST_CHECK(fb->waypoints() == nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(test_match_session_disabled)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    MatchParameters params;
+    params.coordinates = get_split_trace_locations();
+    params.session = "vehicle";
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Match(params, json_result) == Status::Error);
+    BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value,
+                      "InvalidOptions");
+}
+
+BOOST_AUTO_TEST_CASE(test_match_session)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_matching_sessions_size = 1; });
+
+    const auto locations = get_split_trace_locations();
+    std::size_t number_of_tracepoints = 0;
+    for (std::size_t index = 0; index < locations.size(); ++index)
+    {
+        MatchParameters params;
+        params.coordinates = {locations[index]};
+        params.timestamps = {static_cast<unsigned>(10 * index)};
+        params.session = "vehicle";
+
+        json::Object json_result;
+        BOOST_REQUIRE(osrm.Match(params, json_result) == Status::Ok);
+        number_of_tracepoints +=
+            std::get<json::Array>(json_result.values.at("tracepoints")).values.size();
+    }
+    // the first tracepoint of a response may repeat the last one of the previous response
+    BOOST_CHECK_LE(number_of_tracepoints, 2 * locations.size());
+
+    // repeated coordinates are skipped
+    MatchParameters repeated;
+    repeated.coordinates = {locations.back()};
+    repeated.timestamps = {static_cast<unsigned>(10 * (locations.size() - 1))};
+    repeated.session = "vehicle";
+    json::Object repeated_result;
+    BOOST_REQUIRE(osrm.Match(repeated, repeated_result) == Status::Ok);
+    BOOST_CHECK(std::get<json::Array>(repeated_result.values.at("tracepoints")).values.empty());
+}
+
+// sessions snap their points like a match request with the same parameters
+BOOST_AUTO_TEST_CASE(test_match_session_snapping_exclude)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_matching_sessions_size = 1; });
+
+    MatchParameters params;
+    params.coordinates = get_split_trace_locations();
+    for (std::size_t index = 0; index < params.coordinates.size(); ++index)
+    {
+        params.timestamps.push_back(static_cast<unsigned>(10 * index));
+    }
+    params.snapping = MatchParameters::SnappingType::Any;
+    params.exclude = {"motorway"};
+
+    json::Object match_result;
+    BOOST_REQUIRE(osrm.Match(params, match_result) == Status::Ok);
+    const auto match_locations = get_tracepoint_locations(match_result);
+
+    params.session = "vehicle";
+    json::Object session_result;
+    BOOST_REQUIRE(osrm.Match(params, session_result) == Status::Ok);
+    const auto session_locations = get_tracepoint_locations(session_result);
+
+    BOOST_CHECK(!session_locations.empty());
+    for (const auto &location : session_locations)
+    {
+        BOOST_CHECK(std::find(match_locations.begin(), match_locations.end(), location) !=
+                    match_locations.end());
+    }
+
+    // an unknown exclude class is rejected like for a match request
+    params.exclude = {"unknown"};
+    json::Object invalid_result;
+    BOOST_CHECK(osrm.Match(params, invalid_result) == Status::Error);
+}
+
+// a session update that times out leaves the session as it was, so the request can be retried
+BOOST_AUTO_TEST_CASE(test_match_session_retry_after_timeout)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_matching_sessions_size = 1; });
+
+    const auto locations = get_split_trace_locations();
+    const auto match = [&](const std::string &session, const std::size_t index, json::Object &result)
+    {
+        MatchParameters params;
+        params.coordinates = {locations[index]};
+        params.timestamps = {static_cast<unsigned>(10 * index)};
+        params.session = session;
+        return osrm.Match(params, result);
+    };
+
+    std::size_t number_of_timeouts = 0;
+    for (std::size_t index = 0; index < locations.size(); ++index)
+    {
+        json::Object reference_result;
+        BOOST_REQUIRE(match("reference", index, reference_result) == Status::Ok);
+
+        json::Object result;
+        auto status = Status::Ok;
+        {
+            // cancels the request after the check at its start, the searches of the request
+            // then stop at their next check
+            bool started = false;
+            const engine::RequestDeadline cancellation(std::nullopt,
+                                                       [&] { return std::exchange(started, true); });
+            status = match("retried", index, result);
+        }
+        if (status == Status::Timeout)
+        {
+            ++number_of_timeouts;
+            result = json::Object();
+            status = match("retried", index, result);
+        }
+        BOOST_REQUIRE(status == Status::Ok);
+
+        BOOST_CHECK(get_tracepoint_locations(result) ==
+                    get_tracepoint_locations(reference_result));
+    }
+    BOOST_CHECK_GT(number_of_timeouts, 0);
+}
+
+// repeated points of a session are recognized by their timestamps, so they are required
+BOOST_AUTO_TEST_CASE(test_match_session_without_timestamps)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                              EngineConfig::Algorithm::CH,
+                              [](EngineConfig &config) { config.max_matching_sessions_size = 1; });
+
+    const auto locations = get_split_trace_locations();
+    for (const auto &coordinates : {Locations{locations.front()}, locations})
+    {
+        MatchParameters params;
+        params.coordinates = coordinates;
+        params.session = "vehicle";
+
+        json::Object json_result;
+        BOOST_CHECK(osrm.Match(params, json_result) == Status::Error);
+        BOOST_CHECK_EQUAL(std::get<json::String>(json_result.values.at("code")).value,
+                          "InvalidOptions");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
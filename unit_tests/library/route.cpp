@@ -15,6 +15,8 @@
 #include "osrm/route_parameters.hpp"
 #include "osrm/status.hpp"
 
+#include "util/json_renderer.hpp"
+
 osrm::Status run_route_json(const osrm::OSRM &osrm,
                             const osrm::RouteParameters &params,
                             osrm::json::Object &json_result,
@@ -737,4 +739,174 @@ BOOST_AUTO_TEST_CASE(test_route_serialize_fb_skip_waypoints)
     }
 }
 
+void test_route_released_heaps(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    // a budget of 0 frees the heaps after every query, they have to be recreated by the next one
+    const auto osrm = getOSRM(
+        path, algorithm, [](EngineConfig &config) { config.max_heap_memory_per_thread = 0; });
+
+    RouteParameters params;
+    params.coordinates = get_locations_in_big_component();
+
+    json::Object first_result;
+    BOOST_REQUIRE(osrm.Route(params, first_result) == Status::Ok);
+    json::Object second_result;
+    BOOST_REQUIRE(osrm.Route(params, second_result) == Status::Ok);
+
+    const auto &first_route = std::get<json::Object>(
+        std::get<json::Array>(first_result.values.at("routes")).values.at(0));
+    const auto &second_route = std::get<json::Object>(
+        std::get<json::Array>(second_result.values.at("routes")).values.at(0));
+    BOOST_CHECK_EQUAL(std::get<json::Number>(first_route.values.at("duration")).value,
+                      std::get<json::Number>(second_route.values.at("duration")).value);
+    BOOST_CHECK_EQUAL(std::get<json::Number>(first_route.values.at("distance")).value,
+                      std::get<json::Number>(second_route.values.at("distance")).value);
+}
+BOOST_AUTO_TEST_CASE(test_route_released_heaps_ch)
+{
+    test_route_released_heaps(osrm::EngineConfig::Algorithm::CH,
+                              OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_route_released_heaps_mld)
+{
+    test_route_released_heaps(osrm::EngineConfig::Algorithm::MLD,
+                              OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+void test_route_unpacking_cache(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto uncached_osrm = getOSRM(path, algorithm);
+    // each cache is only used by its algorithm
+    const auto cached_osrm = getOSRM(path,
+                                     algorithm,
+                                     [](EngineConfig &config)
+                                     {
+                                         config.max_shortcut_cache_size = 1;
+                                         config.max_clique_arc_cache_size = 1;
+                                     });
+
+    RouteParameters params;
+    params.coordinates = get_locations_in_big_component();
+    params.overview = RouteParameters::OverviewType::Full;
+    params.alternatives = true;
+
+    const auto render_routes = [](const json::Object &result)
+    {
+        std::string routes;
+        util::json::Renderer renderer(routes);
+        renderer(std::get<json::Array>(result.values.at("routes")));
+        return routes;
+    };
+
+    json::Object uncached_result;
+    BOOST_REQUIRE(uncached_osrm.Route(params, uncached_result) == Status::Ok);
+
+    // the second query finds the unpacked edges of the first one in the cache
+    json::Object first_result;
+    BOOST_REQUIRE(cached_osrm.Route(params, first_result) == Status::Ok);
+    json::Object second_result;
+    BOOST_REQUIRE(cached_osrm.Route(params, second_result) == Status::Ok);
+
+    BOOST_CHECK_EQUAL(render_routes(uncached_result), render_routes(first_result));
+    BOOST_CHECK_EQUAL(render_routes(uncached_result), render_routes(second_result));
+}
+BOOST_AUTO_TEST_CASE(test_route_unpacking_cache_ch)
+{
+    test_route_unpacking_cache(osrm::EngineConfig::Algorithm::CH,
+                               OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_route_unpacking_cache_mld)
+{
+    test_route_unpacking_cache(osrm::EngineConfig::Algorithm::MLD,
+                               OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_route_parallel_alternatives_mld)
+{
+    using namespace osrm;
+
+    const auto sequential_osrm =
+        getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD);
+    const auto parallel_osrm =
+        getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                EngineConfig::Algorithm::MLD,
+                [](EngineConfig &config) { config.use_parallel_alternatives_search = true; });
+
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::Full;
+    params.number_of_alternatives = 3;
+    params.alternatives = true;
+
+    const auto locations = get_locations_in_big_component();
+    for (const auto &source : locations)
+    {
+        for (const auto &target : locations)
+        {
+            params.coordinates = {source, target};
+
+            json::Object sequential_result;
+            json::Object parallel_result;
+            const auto sequential_status = sequential_osrm.Route(params, sequential_result);
+            BOOST_CHECK(parallel_osrm.Route(params, parallel_result) == sequential_status);
+            if (sequential_status != Status::Ok)
+                continue;
+
+            std::string sequential_routes;
+            std::string parallel_routes;
+            util::json::Renderer sequential_renderer(sequential_routes);
+            util::json::Renderer parallel_renderer(parallel_routes);
+            sequential_renderer(std::get<json::Array>(sequential_result.values.at("routes")));
+            parallel_renderer(std::get<json::Array>(parallel_result.values.at("routes")));
+            BOOST_CHECK_EQUAL(sequential_routes, parallel_routes);
+        }
+    }
+}
+
+void test_route_parallel_legs(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto sequential_osrm = getOSRM(path, algorithm);
+    const auto parallel_osrm = getOSRM(
+        path, algorithm, [](EngineConfig &config) { config.use_parallel_leg_search = true; });
+
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::Full;
+    params.steps = true;
+    params.continue_straight = false;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+
+    json::Object sequential_result;
+    json::Object parallel_result;
+    BOOST_CHECK(sequential_osrm.Route(params, sequential_result) == Status::Ok);
+    BOOST_CHECK(parallel_osrm.Route(params, parallel_result) == Status::Ok);
+
+    std::string sequential_routes;
+    std::string parallel_routes;
+    util::json::Renderer sequential_renderer(sequential_routes);
+    util::json::Renderer parallel_renderer(parallel_routes);
+    sequential_renderer(std::get<json::Array>(sequential_result.values.at("routes")));
+    parallel_renderer(std::get<json::Array>(parallel_result.values.at("routes")));
+    BOOST_CHECK_EQUAL(sequential_routes, parallel_routes);
+}
+
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_ch)
+{
+    test_route_parallel_legs(osrm::EngineConfig::Algorithm::CH,
+                             OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_mld)
+{
+    test_route_parallel_legs(osrm::EngineConfig::Algorithm::MLD,
+                             OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,15 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/half_float.hpp"
+#include "util/json_renderer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
 osrm::Status run_table_json(const osrm::OSRM &osrm,
                             const osrm::TableParameters &params,
                             osrm::json::Object &json_result,
@@ -387,4 +396,409 @@ BOOST_AUTO_TEST_CASE(test_table_serialiaze_fb_no_waypoints)
     BOOST_CHECK(fb->waypoints() == nullptr);
 }
 
+void test_table_parallel_search(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto sequential_osrm = getOSRM(path, algorithm);
+    const auto parallel_osrm = getOSRM(
+        path, algorithm, [](EngineConfig &config) { config.use_parallel_table_search = true; });
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.sources = {0, 1, 2};
+    params.destinations = {1, 3, 4, 5, 6};
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object sequential_result;
+    json::Object parallel_result;
+    BOOST_CHECK(sequential_osrm.Table(params, sequential_result) == Status::Ok);
+    BOOST_CHECK(parallel_osrm.Table(params, parallel_result) == Status::Ok);
+
+    for (const auto annotation : {"durations", "distances"})
+    {
+        const auto &sequential_rows =
+            std::get<json::Array>(sequential_result.values.at(annotation)).values;
+        const auto &parallel_rows =
+            std::get<json::Array>(parallel_result.values.at(annotation)).values;
+        BOOST_REQUIRE_EQUAL(sequential_rows.size(), parallel_rows.size());
+        for (std::size_t row = 0; row < sequential_rows.size(); ++row)
+        {
+            const auto &sequential_row = std::get<json::Array>(sequential_rows[row]).values;
+            const auto &parallel_row = std::get<json::Array>(parallel_rows[row]).values;
+            BOOST_REQUIRE_EQUAL(sequential_row.size(), parallel_row.size());
+            for (std::size_t column = 0; column < sequential_row.size(); ++column)
+            {
+                BOOST_CHECK_EQUAL(std::get<json::Number>(sequential_row[column]).value,
+                                  std::get<json::Number>(parallel_row[column]).value);
+            }
+        }
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_parallel_search_ch)
+{
+    test_table_parallel_search(osrm::EngineConfig::Algorithm::CH,
+                               OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_table_parallel_search_mld)
+{
+    test_table_parallel_search(osrm::EngineConfig::Algorithm::MLD,
+                               OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+void test_table_deadline(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(
+        path, algorithm, [](EngineConfig &config) { config.use_parallel_table_search = true; });
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+
+    params.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+    json::Object result;
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+
+    params.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    json::Object timeout_result;
+    BOOST_CHECK(osrm.Table(params, timeout_result) == Status::Timeout);
+    BOOST_CHECK_EQUAL(std::get<json::String>(timeout_result.values.at("code")).value, "Timeout");
+    BOOST_CHECK(timeout_result.values.count("durations") == 0);
+}
+BOOST_AUTO_TEST_CASE(test_table_deadline_ch)
+{
+    test_table_deadline(osrm::EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_table_deadline_mld)
+{
+    test_table_deadline(osrm::EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+void test_table_bucket_cache(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto uncached_osrm = getOSRM(path, algorithm);
+    const auto cached_osrm = getOSRM(
+        path, algorithm, [](EngineConfig &config) { config.max_table_bucket_cache_size = 16; });
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    // the second query reuses the destinations of the first one, the third one reverses roles
+    for (const auto &[sources, destinations] :
+         std::vector<std::pair<std::vector<std::size_t>, std::vector<std::size_t>>>{
+             {{0, 1}, {3, 4, 5}}, {{0, 2, 6}, {3, 4, 5, 1}}, {{3, 4, 5}, {0, 1}}})
+    {
+        params.sources = sources;
+        params.destinations = destinations;
+
+        json::Object uncached_result;
+        json::Object cached_result;
+        BOOST_CHECK(uncached_osrm.Table(params, uncached_result) == Status::Ok);
+        BOOST_CHECK(cached_osrm.Table(params, cached_result) == Status::Ok);
+
+        for (const auto annotation : {"durations", "distances"})
+        {
+            std::string uncached_rows;
+            std::string cached_rows;
+            util::json::Renderer uncached_renderer(uncached_rows);
+            util::json::Renderer cached_renderer(cached_rows);
+            uncached_renderer(std::get<json::Array>(uncached_result.values.at(annotation)));
+            cached_renderer(std::get<json::Array>(cached_result.values.at(annotation)));
+            BOOST_CHECK_EQUAL(uncached_rows, cached_rows);
+        }
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_bucket_cache_ch)
+{
+    test_table_bucket_cache(osrm::EngineConfig::Algorithm::CH,
+                            OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_table_bucket_cache_mld)
+{
+    test_table_bucket_cache(osrm::EngineConfig::Algorithm::MLD,
+                            OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+void test_table_rphast(const bool parallel_search)
+{
+    using namespace osrm;
+
+    const auto get_osrm = [parallel_search](const int min_destinations_rphast_table)
+    {
+        return getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                       EngineConfig::Algorithm::CH,
+                       [&](EngineConfig &config)
+                       {
+                           config.use_parallel_table_search = parallel_search;
+                           config.min_destinations_rphast_table = min_destinations_rphast_table;
+                       });
+    };
+    const auto bucket_osrm = get_osrm(-1);
+    const auto rphast_osrm = get_osrm(1);
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    for (const auto &[sources, destinations] :
+         std::vector<std::pair<std::vector<std::size_t>, std::vector<std::size_t>>>{
+             {{}, {}}, {{0}, {1, 2, 3, 4, 5, 6}}, {{1, 2, 3, 4}, {0}}, {{0, 0, 2}, {0, 2, 6}}})
+    {
+        params.sources = sources;
+        params.destinations = destinations;
+
+        json::Object bucket_result;
+        json::Object rphast_result;
+        BOOST_CHECK(bucket_osrm.Table(params, bucket_result) == Status::Ok);
+        BOOST_CHECK(rphast_osrm.Table(params, rphast_result) == Status::Ok);
+
+        for (const auto annotation : {"durations", "distances"})
+        {
+            std::string bucket_rows;
+            std::string rphast_rows;
+            util::json::Renderer bucket_renderer(bucket_rows);
+            util::json::Renderer rphast_renderer(rphast_rows);
+            bucket_renderer(std::get<json::Array>(bucket_result.values.at(annotation)));
+            rphast_renderer(std::get<json::Array>(rphast_result.values.at(annotation)));
+            BOOST_CHECK_EQUAL(bucket_rows, rphast_rows);
+        }
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_rphast_sequential) { test_table_rphast(false); }
+BOOST_AUTO_TEST_CASE(test_table_rphast_parallel) { test_table_rphast(true); }
+
+void test_table_streamed_response(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(path, algorithm);
+
+    TableParameters params;
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    std::string streamed;
+    std::size_t number_of_chunks = 0;
+    engine::api::ResultT result = json::Object();
+    const auto rc = osrm.Table(params,
+                               result,
+                               [&](std::string_view chunk)
+                               {
+                                   streamed.append(chunk);
+                                   ++number_of_chunks;
+                               });
+    BOOST_CHECK(rc == Status::Ok);
+    BOOST_CHECK_GE(number_of_chunks, 1);
+    BOOST_CHECK_EQUAL(streamed.rfind("{\"code\":\"Ok\"", 0), 0);
+    BOOST_CHECK_EQUAL(streamed.back(), '}');
+
+    for (const auto annotation : {"durations", "distances"})
+    {
+        std::string rendered_rows;
+        util::json::Renderer renderer(rendered_rows);
+        renderer(std::get<json::Array>(json_result.values.at(annotation)));
+        BOOST_CHECK(streamed.find("\"" + std::string(annotation) + "\":" + rendered_rows) !=
+                    std::string::npos);
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_streamed_response_ch)
+{
+    test_table_streamed_response(osrm::EngineConfig::Algorithm::CH,
+                                 OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_table_streamed_response_mld)
+{
+    test_table_streamed_response(osrm::EngineConfig::Algorithm::MLD,
+                                 OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
+void test_table_binary_response(osrm::TableParameters::BinaryEncodingType encoding)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.sources = {0, 1};
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    params.format = engine::api::BaseParameters::OutputFormatType::BINARY;
+    params.binary_encoding = encoding;
+    engine::api::ResultT result = json::Object();
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+    BOOST_REQUIRE(std::holds_alternative<engine::api::BinaryBuffer>(result));
+    const auto &data = std::get<engine::api::BinaryBuffer>(result).data;
+
+    const auto read = [&data](const std::size_t offset, const std::size_t bytes)
+    {
+        std::uint32_t value = 0;
+        for (std::size_t byte = 0; byte < bytes; ++byte)
+            value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + byte]))
+                     << (8 * byte);
+        return value;
+    };
+
+    const bool float16 = encoding == TableParameters::BinaryEncodingType::Float16;
+    const std::size_t rows = 2;
+    const std::size_t columns = params.coordinates.size();
+    const std::size_t value_size = float16 ? 2 : 4;
+    BOOST_REQUIRE_EQUAL(data.size(), 16 + 2 * rows * columns * value_size);
+    BOOST_CHECK_EQUAL(data.substr(0, 4), "OSRT");
+    BOOST_CHECK_EQUAL(read(4, 1), 1);
+    BOOST_CHECK_EQUAL(read(5, 1), float16 ? 1 : 0);
+    BOOST_CHECK_EQUAL(read(6, 1), 3);
+    BOOST_CHECK_EQUAL(read(8, 4), rows);
+    BOOST_CHECK_EQUAL(read(12, 4), columns);
+
+    const auto &durations = std::get<json::Array>(json_result.values.at("durations")).values;
+    const auto &distances = std::get<json::Array>(json_result.values.at("distances")).values;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        const auto &duration_row = std::get<json::Array>(durations[row]).values;
+        const auto &distance_row = std::get<json::Array>(distances[row]).values;
+        for (std::size_t column = 0; column < columns; ++column)
+        {
+            const auto index = row * columns + column;
+            const auto duration_offset = 16 + index * value_size;
+            const auto distance_offset = 16 + (rows * columns + index) * value_size;
+            const auto duration = std::get<json::Number>(duration_row[column]).value;
+            const auto distance = std::get<json::Number>(distance_row[column]).value;
+            if (float16)
+            {
+                const auto binary_duration =
+                    util::fromHalfFloat(static_cast<std::uint16_t>(read(duration_offset, 2)));
+                const auto binary_distance =
+                    util::fromHalfFloat(static_cast<std::uint16_t>(read(distance_offset, 2)));
+                BOOST_CHECK_LE(std::abs(binary_duration - duration), duration / 1024 + 0.01);
+                BOOST_CHECK_LE(std::abs(binary_distance - distance), distance / 1024 + 0.1);
+            }
+            else
+            {
+                const auto binary_duration = static_cast<std::int32_t>(read(duration_offset, 4));
+                const auto binary_distance = static_cast<std::int32_t>(read(distance_offset, 4));
+                BOOST_CHECK_EQUAL(binary_duration, std::lround(duration * 10));
+                BOOST_CHECK_EQUAL(binary_distance, std::lround(distance * 10));
+            }
+        }
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_binary_response_int32)
+{
+    test_table_binary_response(osrm::TableParameters::BinaryEncodingType::Int32);
+}
+BOOST_AUTO_TEST_CASE(test_table_binary_response_float16)
+{
+    test_table_binary_response(osrm::TableParameters::BinaryEncodingType::Float16);
+}
+
+void test_table_limits(osrm::EngineConfig::Algorithm algorithm, const std::string &path)
+{
+    using namespace osrm;
+
+    const auto osrm = getOSRM(path, algorithm);
+
+    TableParameters params;
+    for (const auto &location : get_split_trace_locations())
+        params.coordinates.push_back(location);
+    for (const auto &location : get_locations_in_big_component())
+        params.coordinates.push_back(location);
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object unbounded_result;
+    BOOST_REQUIRE(osrm.Table(params, unbounded_result) == Status::Ok);
+
+    const double max_duration = 120;
+    const double max_distance = 1500;
+    params.max_duration = max_duration;
+    params.max_distance = max_distance;
+
+    // one-to-many and many-to-many searches
+    for (const auto &sources : std::vector<std::vector<std::size_t>>{{0}, {}})
+    {
+        params.sources = sources;
+        json::Object bounded_result;
+        BOOST_REQUIRE(osrm.Table(params, bounded_result) == Status::Ok);
+
+        const auto &unbounded_durations =
+            std::get<json::Array>(unbounded_result.values.at("durations")).values;
+        const auto &unbounded_distances =
+            std::get<json::Array>(unbounded_result.values.at("distances")).values;
+        const auto &bounded_durations =
+            std::get<json::Array>(bounded_result.values.at("durations")).values;
+        const auto &bounded_distances =
+            std::get<json::Array>(bounded_result.values.at("distances")).values;
+
+        std::size_t number_of_reachable_cells = 0;
+        for (std::size_t row = 0; row < bounded_durations.size(); ++row)
+        {
+            const auto &unbounded_duration_row =
+                std::get<json::Array>(unbounded_durations[row]).values;
+            const auto &unbounded_distance_row =
+                std::get<json::Array>(unbounded_distances[row]).values;
+            const auto &bounded_duration_row = std::get<json::Array>(bounded_durations[row]).values;
+            const auto &bounded_distance_row = std::get<json::Array>(bounded_distances[row]).values;
+            for (std::size_t column = 0; column < bounded_duration_row.size(); ++column)
+            {
+                const auto *unbounded_duration =
+                    std::get_if<json::Number>(&unbounded_duration_row[column]);
+                const auto *unbounded_distance =
+                    std::get_if<json::Number>(&unbounded_distance_row[column]);
+                const auto *bounded_duration =
+                    std::get_if<json::Number>(&bounded_duration_row[column]);
+                const auto *bounded_distance =
+                    std::get_if<json::Number>(&bounded_distance_row[column]);
+
+                BOOST_CHECK_EQUAL(bounded_duration == nullptr, bounded_distance == nullptr);
+                if (bounded_duration)
+                {
+                    BOOST_CHECK_LE(bounded_duration->value, max_duration);
+                    BOOST_CHECK_LE(bounded_distance->value, max_distance);
+                }
+
+                // routes within the limits are the same as without limits
+                if (unbounded_duration && unbounded_duration->value <= max_duration &&
+                    unbounded_distance->value <= max_distance)
+                {
+                    ++number_of_reachable_cells;
+                    BOOST_REQUIRE(bounded_duration);
+                    BOOST_CHECK_EQUAL(bounded_duration->value, unbounded_duration->value);
+                    BOOST_CHECK_EQUAL(bounded_distance->value, unbounded_distance->value);
+                }
+            }
+        }
+        BOOST_CHECK_GT(number_of_reachable_cells, 0);
+    }
+}
+BOOST_AUTO_TEST_CASE(test_table_limits_ch)
+{
+    test_table_limits(osrm::EngineConfig::Algorithm::CH, OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+}
+BOOST_AUTO_TEST_CASE(test_table_limits_mld)
+{
+    test_table_limits(osrm::EngineConfig::Algorithm::MLD, OSRM_TEST_DATA_DIR "/mld/monaco.osrm");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 #include "parameters_io.hpp"
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/batch_match_parameters.hpp"
+#include "engine/api/batch_route_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -115,6 +117,7 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?annotations=durations&scale_factor=-1"), 28UL);
     BOOST_CHECK_EQUAL(
         testInvalidOptions<TableParameters>("1,2;3,4?annotations=durations&scale_factor=0"), 28UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?max_duration=foo"), 21UL);
     BOOST_CHECK_EQUAL(
         testInvalidOptions<TableParameters>("1,2;3,4?annotations=durations&fallback_speed=0"),
         28UL);
@@ -637,6 +640,21 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_9.sources, result_9->sources);
     CHECK_EQUAL_RANGE(reference_9.destinations, result_9->destinations);
 
+    auto result_binary =
+        parseParameters<TableParameters>("1,2;3,4.0.binary?binary_encoding=float16");
+    BOOST_CHECK(result_binary);
+    BOOST_CHECK(result_binary->format == engine::api::BaseParameters::OutputFormatType::BINARY);
+    BOOST_CHECK(result_binary->binary_encoding ==
+                TableParameters::BinaryEncodingType::Float16);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_binary->coordinates);
+
+    auto result_limits =
+        parseParameters<TableParameters>("1,2;3,4?max_duration=1800&max_distance=12500.5");
+    BOOST_CHECK(result_limits);
+    BOOST_CHECK(result_limits->max_duration && *result_limits->max_duration == 1800);
+    BOOST_CHECK(result_limits->max_distance && *result_limits->max_distance == 12500.5);
+    BOOST_CHECK(!result_1->max_duration && !result_1->max_distance);
+
     TableParameters reference_10{};
     reference_10.coordinates = coords_1;
     auto result_10 = parseParameters<TableParameters>(
@@ -699,6 +717,25 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_3.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_3.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
+
+    MatchParameters reference_4{};
+    reference_4.coordinates = coords_1;
+    reference_4.timestamps = {5, 6};
+    reference_4.session = "truck-42_a.b~c";
+    auto result_4 =
+        parseParameters<MatchParameters>("1,2;3,4?timestamps=5;6&session=truck-42_a.b~c");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(reference_4.session == result_4->session);
+    CHECK_EQUAL_RANGE(reference_4.timestamps, result_4->timestamps);
+    CHECK_EQUAL_RANGE(reference_4.coordinates, result_4->coordinates);
+
+    // sessions can be continued with a single coordinate
+    auto result_5 = parseParameters<MatchParameters>("1,2?session=a");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->IsValid());
+    auto result_6 = parseParameters<MatchParameters>("1,2");
+    BOOST_CHECK(result_6);
+    BOOST_CHECK(!result_6->IsValid());
 }
 
 BOOST_AUTO_TEST_CASE(invalid_match_urls)
@@ -724,6 +761,8 @@ BOOST_AUTO_TEST_CASE(invalid_match_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0,4"), 19UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=x;4"), 18UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?waypoints=0;3.5"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?session="), 16UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?session=a/b"), 17UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -823,4 +862,95 @@ BOOST_AUTO_TEST_CASE(valid_trip_urls)
     BOOST_CHECK_EQUAL(param_fail_2, 33UL);
 }
 
+BOOST_AUTO_TEST_CASE(valid_batch_route_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}},
+                                              {util::FloatLongitude{3}, util::FloatLatitude{4}}};
+
+    BatchRouteParameters reference_1{};
+    reference_1.coordinates = coords_1;
+    auto result_1 = parseParameters<BatchRouteParameters>("1,2;3,4");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    CHECK_EQUAL_RANGE(reference_1.sources, result_1->sources);
+    CHECK_EQUAL_RANGE(reference_1.destinations, result_1->destinations);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_1->coordinates);
+    BOOST_CHECK(result_1->overview == BatchRouteParameters::OverviewType::False);
+    BOOST_CHECK_EQUAL(result_1->NumberOfPairs(), 1);
+
+    std::vector<std::size_t> sources_2 = {0, 0, 1};
+    std::vector<std::size_t> destinations_2 = {1, 0, 0};
+    auto result_2 = parseParameters<BatchRouteParameters>(
+        "1,2;3,4?sources=0;0;1&destinations=1;0;0&overview=full&geometries=geojson");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(result_2->IsValid());
+    CHECK_EQUAL_RANGE(sources_2, result_2->sources);
+    CHECK_EQUAL_RANGE(destinations_2, result_2->destinations);
+    BOOST_CHECK(result_2->overview == BatchRouteParameters::OverviewType::Full);
+    BOOST_CHECK(result_2->geometries == BatchRouteParameters::GeometriesType::GeoJSON);
+    BOOST_CHECK_EQUAL(result_2->NumberOfPairs(), 3);
+    BOOST_CHECK((result_2->GetPair(2) == std::pair<std::size_t, std::size_t>{1, 0}));
+
+    // pairs need a source and a destination
+    auto result_3 = parseParameters<BatchRouteParameters>("1,2;3,4;5,6");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(!result_3->IsValid());
+    auto result_4 = parseParameters<BatchRouteParameters>("1,2;3,4?sources=0;1&destinations=1");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(!result_4->IsValid());
+    auto result_5 = parseParameters<BatchRouteParameters>("1,2;3,4?sources=0&destinations=2");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(!result_5->IsValid());
+
+    BOOST_CHECK_EQUAL(testInvalidOptions<BatchRouteParameters>("1,2;3,4?overview=none"), 17UL);
+}
+
+BOOST_AUTO_TEST_CASE(valid_batch_match_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}},
+                                              {util::FloatLongitude{3}, util::FloatLatitude{4}},
+                                              {util::FloatLongitude{5}, util::FloatLatitude{6}},
+                                              {util::FloatLongitude{7}, util::FloatLatitude{8}},
+                                              {util::FloatLongitude{9}, util::FloatLatitude{10}}};
+    std::vector<std::size_t> trace_sizes_1 = {2, 3};
+    std::vector<unsigned> timestamps_1 = {5, 6, 7, 8, 9};
+
+    auto result_1 = parseParameters<BatchMatchParameters>(
+        "1,2;3,4;5,6;7,8;9,10?traces=2;3&timestamps=5;6;7;8;9&gaps=ignore&overview=full");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    CHECK_EQUAL_RANGE(coords_1, result_1->coordinates);
+    CHECK_EQUAL_RANGE(trace_sizes_1, result_1->trace_sizes);
+    CHECK_EQUAL_RANGE(timestamps_1, result_1->timestamps);
+    BOOST_CHECK(result_1->gaps == MatchParameters::GapsType::Ignore);
+    BOOST_CHECK(result_1->overview == MatchParameters::OverviewType::Full);
+    BOOST_CHECK_EQUAL(result_1->NumberOfTraces(), 2);
+
+    const auto traces_1 = result_1->SplitTraces();
+    BOOST_REQUIRE_EQUAL(traces_1.size(), 2);
+    BOOST_CHECK_EQUAL(traces_1[0].coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(traces_1[1].coordinates.size(), 3);
+    BOOST_CHECK_EQUAL(traces_1[1].coordinates[0], coords_1[2]);
+    BOOST_CHECK_EQUAL(traces_1[1].timestamps[2], 9);
+    BOOST_CHECK(traces_1[1].radiuses.empty());
+    BOOST_CHECK(traces_1[1].gaps == MatchParameters::GapsType::Ignore);
+    BOOST_CHECK(traces_1[1].IsValid());
+
+    // every coordinate belongs to a trace of at least two coordinates
+    auto result_2 = parseParameters<BatchMatchParameters>("1,2;3,4;5,6?traces=2");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(!result_2->IsValid());
+    auto result_3 = parseParameters<BatchMatchParameters>("1,2;3,4;5,6?traces=1;2");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(!result_3->IsValid());
+    auto result_4 = parseParameters<BatchMatchParameters>("1,2;3,4");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(!result_4->IsValid());
+    auto result_5 = parseParameters<BatchMatchParameters>("1,2;3,4?traces=2&session=a");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(!result_5->IsValid());
+
+    BOOST_CHECK_EQUAL(testInvalidOptions<BatchMatchParameters>("1,2;3,4?traces=a"), 15UL);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
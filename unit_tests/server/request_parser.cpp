@@ -0,0 +1,49 @@
+#include "server/request_parser.hpp"
+#include "server/http/request.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+RequestParser::RequestStatus parse(http::request &request, std::string input)
+{
+    RequestParser parser;
+    return std::get<0>(parser.parse(request, input.data(), input.data() + input.size()));
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(http_version)
+{
+    http::request request;
+    BOOST_CHECK(parse(request, "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\n\r\n") ==
+                RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(request.uri, "/route/v1/driving/1,2;3,4");
+    BOOST_CHECK_EQUAL(request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 1);
+
+    request = http::request();
+    BOOST_CHECK(parse(request, "GET / HTTP/1.0\r\nConnection: close\r\n\r\n") ==
+                RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 0);
+
+    request = http::request();
+    BOOST_CHECK(parse(request, "GET / HTTP/12.34\r\n\r\n") == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(request.http_version_major, 12);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 34);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_http_version)
+{
+    http::request request;
+    BOOST_CHECK(parse(request, "GET / HTTP/x.1\r\n\r\n") == RequestParser::RequestStatus::invalid);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -130,6 +130,16 @@ BOOST_AUTO_TEST_CASE(valid_urls)
     BOOST_CHECK_EQUAL(reference_9.profile, result_9->profile);
     CHECK_EQUAL_RANGE(reference_9.query, result_9->query);
     BOOST_CHECK_EQUAL(reference_9.prefix_length, result_9->prefix_length);
+
+    // service with an underscore
+    api::ParsedURL reference_10{"batch_route", 1, "profile", "0,1;2,3?sources=0", 24UL};
+    auto result_10 = api::parseURL("/batch_route/v1/profile/0,1;2,3?sources=0");
+    BOOST_CHECK(result_10);
+    BOOST_CHECK_EQUAL(reference_10.service, result_10->service);
+    BOOST_CHECK_EQUAL(reference_10.version, result_10->version);
+    BOOST_CHECK_EQUAL(reference_10.profile, result_10->profile);
+    CHECK_EQUAL_RANGE(reference_10.query, result_10->query);
+    BOOST_CHECK_EQUAL(reference_10.prefix_length, result_10->prefix_length);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,53 @@
+#include "util/half_float.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(half_float_test)
+
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(exact_values)
+{
+    BOOST_CHECK_EQUAL(toHalfFloat(0.f), 0x0000);
+    BOOST_CHECK_EQUAL(toHalfFloat(-0.f), 0x8000);
+    BOOST_CHECK_EQUAL(toHalfFloat(1.f), 0x3C00);
+    BOOST_CHECK_EQUAL(toHalfFloat(-2.f), 0xC000);
+    BOOST_CHECK_EQUAL(toHalfFloat(0.5f), 0x3800);
+    BOOST_CHECK_EQUAL(toHalfFloat(65504.f), 0x7BFF);
+    // smallest subnormal
+    BOOST_CHECK_EQUAL(toHalfFloat(std::ldexp(1.f, -24)), 0x0001);
+}
+
+BOOST_AUTO_TEST_CASE(rounding)
+{
+    // 2049 is halfway between 2048 and 2050, ties to even
+    BOOST_CHECK_EQUAL(toHalfFloat(2049.f), toHalfFloat(2048.f));
+    BOOST_CHECK_EQUAL(toHalfFloat(2051.f), toHalfFloat(2052.f));
+    BOOST_CHECK_EQUAL(fromHalfFloat(toHalfFloat(123.46f)), 123.4375f);
+}
+
+BOOST_AUTO_TEST_CASE(special_values)
+{
+    BOOST_CHECK_EQUAL(toHalfFloat(65520.f), 0x7C00);
+    BOOST_CHECK_EQUAL(toHalfFloat(1e9f), 0x7C00);
+    BOOST_CHECK_EQUAL(toHalfFloat(-INFINITY), 0xFC00);
+    BOOST_CHECK(std::isnan(fromHalfFloat(toHalfFloat(NAN))));
+    BOOST_CHECK(std::isinf(fromHalfFloat(0x7C00)));
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    for (std::uint32_t half = 0; half < 0x10000; ++half)
+    {
+        const auto value = fromHalfFloat(static_cast<std::uint16_t>(half));
+        if (!std::isnan(value))
+        {
+            BOOST_CHECK_EQUAL(toHalfFloat(value), half);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,8 +22,17 @@ struct TestData
 using TestNodeID = NodeID;
 using TestKey = int;
 using TestWeight = int;
-using storage_types =
-    boost::mpl::list<ArrayStorage<TestNodeID, TestKey>, UnorderedMapStorage<TestNodeID, TestKey>>;
+using storage_types = boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
+                                       UnorderedMapStorage<TestNodeID, TestKey>,
+                                       GenerationArrayStorage<TestNodeID, TestKey>>;
+
+template <template <typename> class PriorityQueue> struct PriorityQueueType
+{
+    template <typename T> using type = PriorityQueue<T>;
+};
+using priority_queue_types = boost::mpl::list<PriorityQueueType<BoostDAryHeap>,
+                                              PriorityQueueType<DAryHeap>,
+                                              PriorityQueueType<RadixHeap>>;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
 {
@@ -154,4 +163,163 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned round = 0; round < 3; ++round)
+    {
+        for (unsigned idx : order)
+        {
+            BOOST_CHECK(!heap.WasInserted(ids[idx]));
+            heap.Insert(ids[idx], weights[idx] + round, data[idx]);
+        }
+        for (auto id : ids)
+        {
+            BOOST_CHECK_EQUAL(heap.GetKey(id), weights[id] + round);
+        }
+        heap.Clear();
+        BOOST_CHECK(heap.Empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(array_or_map_storage_test)
+{
+    using Heap = QueryHeap<TestNodeID,
+                           TestKey,
+                           TestWeight,
+                           TestData,
+                           ArrayOrMapStorage<TestNodeID, TestKey>>;
+
+    for (const auto max_array_size : {0u, NUM_NODES})
+    {
+        Heap heap(NUM_NODES, max_array_size);
+
+        heap.Insert(7, 10, TestData{1});
+        heap.Insert(3, 5, TestData{2});
+        BOOST_CHECK(heap.WasInserted(7));
+        BOOST_CHECK(!heap.WasInserted(4));
+        BOOST_CHECK_EQUAL(heap.Min(), 3);
+        BOOST_CHECK_EQUAL(heap.GetData(7).value, 1);
+
+        heap.Clear();
+        BOOST_CHECK(!heap.WasInserted(7));
+        BOOST_CHECK(!heap.WasInserted(3));
+
+        // nodes beyond the initial size are accepted, the graph can grow on a data reload
+        heap.Insert(NUM_NODES + 5, 1, TestData{3});
+        BOOST_CHECK(heap.WasInserted(NUM_NODES + 5));
+        BOOST_CHECK_EQUAL(heap.GetData(NUM_NODES + 5).value, 3);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(priority_queue_delete_min_test,
+                                 T,
+                                 priority_queue_types,
+                                 RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID,
+              TestKey,
+              TestWeight,
+              TestData,
+              ArrayStorage<TestNodeID, TestKey>,
+              T::template type>
+        heap(NUM_NODES);
+
+    for (unsigned round = 0; round < 2; ++round)
+    {
+        heap.Clear();
+        for (unsigned idx : order)
+        {
+            heap.Insert(ids[idx], weights[idx], data[idx]);
+        }
+        BOOST_CHECK_EQUAL(heap.Size(), NUM_NODES);
+
+        for (auto id : ids)
+        {
+            BOOST_CHECK(!heap.WasRemoved(id));
+            BOOST_CHECK_EQUAL(heap.Min(), id);
+            BOOST_CHECK_EQUAL(heap.MinKey(), weights[id]);
+            BOOST_CHECK_EQUAL(id, heap.DeleteMin());
+            BOOST_CHECK(heap.WasRemoved(id));
+        }
+        BOOST_CHECK(heap.Empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(priority_queue_search_test, T, priority_queue_types)
+{
+    // Dijkstra on a random graph, every priority queue has to settle the same weights
+    constexpr unsigned NUM_GRAPH_NODES = 1000;
+    constexpr unsigned DEGREE = 5;
+    std::mt19937 g(42);
+    std::uniform_int_distribution<TestNodeID> random_node(0, NUM_GRAPH_NODES - 1);
+    std::uniform_int_distribution<TestWeight> random_weight(0, 100);
+    std::vector<std::pair<TestNodeID, TestWeight>> edges;
+    for (unsigned i = 0; i < NUM_GRAPH_NODES * DEGREE; ++i)
+    {
+        edges.emplace_back(random_node(g), random_weight(g));
+    }
+
+    auto search = [&](auto &heap)
+    {
+        std::vector<TestWeight> settled(NUM_GRAPH_NODES, std::numeric_limits<TestWeight>::max());
+        heap.Clear();
+        heap.Insert(0, -10, TestData{0});
+        while (!heap.Empty())
+        {
+            const auto weight = heap.MinKey();
+            const auto node = heap.DeleteMin();
+            settled[node] = weight;
+            for (unsigned edge = node * DEGREE; edge < (node + 1) * DEGREE; ++edge)
+            {
+                const auto [to, edge_weight] = edges[edge];
+                const auto to_weight = weight + edge_weight;
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_weight, TestData{node});
+                }
+                else if (!heap.WasRemoved(to) && to_weight < heap.GetKey(to))
+                {
+                    heap.GetData(to).value = node;
+                    heap.DecreaseKey(to, to_weight);
+                }
+            }
+        }
+        return settled;
+    };
+
+    QueryHeap<TestNodeID,
+              TestKey,
+              TestWeight,
+              TestData,
+              ArrayStorage<TestNodeID, TestKey>,
+              T::template type>
+        heap(NUM_GRAPH_NODES);
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, ArrayStorage<TestNodeID, TestKey>>
+        reference_heap(NUM_GRAPH_NODES);
+
+    const auto reference = search(reference_heap);
+    BOOST_CHECK(search(heap) == reference);
+    // clearing has to reset the state of the priority queue
+    BOOST_CHECK(search(heap) == reference);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(memory_usage_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    const auto initial_usage = heap.MemoryUsage();
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    const auto filled_usage = heap.MemoryUsage();
+    BOOST_CHECK_GT(filled_usage, initial_usage);
+
+    // clearing keeps the allocated memory for the next search
+    heap.Clear();
+    BOOST_CHECK_GT(heap.MemoryUsage(), initial_usage);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/std_hash.hpp"
 #include "util/typedefs.hpp"
@@ -273,6 +274,131 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", *this);
 }
 
+BOOST_FIXTURE_TEST_CASE(batch_nearest_test, TestRandomGraphFixture_MultipleLevels)
+{
+    TemporaryFile tmp;
+    auto rtree = make_rtree<TestStaticRTree>(tmp.path, *this);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+    // duplicates share all leaves
+    queries.push_back(queries.front());
+
+    // every query asks for a different number of results
+    const auto batch_results = rtree.BatchNearest(
+        queries,
+        [](const std::size_t, const TestStaticRTree::CandidateSegment &)
+        { return std::make_pair(true, true); },
+        [](const std::size_t query,
+           const std::size_t num_results,
+           const TestStaticRTree::CandidateSegment &) { return num_results > query % 10; });
+    BOOST_REQUIRE_EQUAL(batch_results.size(), queries.size());
+
+    for (const auto query : util::irange<std::size_t>(0, queries.size()))
+    {
+        const auto results = rtree.Nearest(
+            queries[query],
+            [](const TestStaticRTree::CandidateSegment &) { return std::make_pair(true, true); },
+            [query](const std::size_t num_results, const TestStaticRTree::CandidateSegment &)
+            { return num_results > query % 10; });
+        BOOST_REQUIRE_EQUAL(batch_results[query].size(), results.size());
+        for (const auto i : util::irange<std::size_t>(0, results.size()))
+        {
+            BOOST_CHECK(batch_results[query][i].fixed_projected_coordinate ==
+                        results[i].fixed_projected_coordinate);
+            BOOST_CHECK_EQUAL(batch_results[query][i].data.u, results[i].data.u);
+            BOOST_CHECK_EQUAL(batch_results[query][i].data.v, results[i].data.v);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(packed_leaves_test, TestRandomGraphFixture_MultipleLevels)
+{
+    // give the segments ids with gaps and disabled directions
+    for (const auto i : util::irange<std::size_t>(0, edges.size()))
+    {
+        edges[i].forward_segment_id = {static_cast<NodeID>(3 * i), true};
+        edges[i].reverse_segment_id = {i % 3 == 0 ? SPECIAL_SEGMENTID : static_cast<NodeID>(i),
+                                       i % 3 != 0};
+        edges[i].fwd_segment_position = i % 7;
+        edges[i].is_startpoint = i % 5 != 0;
+    }
+
+    TemporaryFile tmp;
+    auto rtree = make_rtree<TestStaticRTree>(tmp.path, *this);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+
+    std::vector<std::vector<TestStaticRTree::CandidateSegment>> expected;
+    for (const auto &query : queries)
+    {
+        expected.push_back(rtree.Nearest(query, 5));
+    }
+    const RectangleInt2D box{FixedLongitude{WORLD_MIN_LON / 2},
+                             FixedLongitude{WORLD_MAX_LON / 2},
+                             FixedLatitude{WORLD_MIN_LAT / 2},
+                             FixedLatitude{WORLD_MAX_LAT / 2}};
+    const auto expected_in_box = rtree.SearchInBox(box);
+
+    TemporaryFile packed_tmp;
+    rtree.PackLeaves(packed_tmp.path);
+    BOOST_REQUIRE(rtree.HasPackedLeaves());
+    BOOST_CHECK_LT(rtree.GetPackedLeavesSizeInBytes(), edges.size() * sizeof(TestData));
+
+    const auto check_equal = [](const TestData &lhs, const TestData &rhs)
+    {
+        BOOST_CHECK_EQUAL(lhs.forward_segment_id.id, rhs.forward_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs.forward_segment_id.enabled, rhs.forward_segment_id.enabled);
+        BOOST_CHECK_EQUAL(lhs.reverse_segment_id.id, rhs.reverse_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs.reverse_segment_id.enabled, rhs.reverse_segment_id.enabled);
+        BOOST_CHECK_EQUAL(lhs.u, rhs.u);
+        BOOST_CHECK_EQUAL(lhs.v, rhs.v);
+        BOOST_CHECK_EQUAL(lhs.fwd_segment_position, rhs.fwd_segment_position);
+        BOOST_CHECK_EQUAL(lhs.is_startpoint, rhs.is_startpoint);
+    };
+
+    for (const auto query : util::irange<std::size_t>(0, queries.size()))
+    {
+        const auto results = rtree.Nearest(queries[query], 5);
+        BOOST_REQUIRE_EQUAL(results.size(), expected[query].size());
+        for (const auto i : util::irange<std::size_t>(0, results.size()))
+        {
+            BOOST_CHECK(results[i].fixed_projected_coordinate ==
+                        expected[query][i].fixed_projected_coordinate);
+            check_equal(results[i].data, expected[query][i].data);
+        }
+    }
+
+    const auto in_box = rtree.SearchInBox(box);
+    BOOST_REQUIRE_EQUAL(in_box.size(), expected_in_box.size());
+    for (const auto i : util::irange<std::size_t>(0, in_box.size()))
+    {
+        check_equal(in_box[i], expected_in_box[i]);
+    }
+
+    // packed leaves of other segments are rejected
+    auto renumbered_edges = edges;
+    std::reverse(renumbered_edges.begin(), renumbered_edges.end());
+    BOOST_CHECK_THROW(PackedRTreeLeaves<TestData>(packed_tmp.path, renumbered_edges),
+                      util::exception);
+    renumbered_edges.pop_back();
+    BOOST_CHECK_THROW(PackedRTreeLeaves<TestData>(packed_tmp.path, renumbered_edges),
+                      util::exception);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -531,4 +657,119 @@ BOOST_AUTO_TEST_CASE(bbox_search_tests)
     }
 }
 
+namespace
+{
+using TreeNode = TestStaticRTree::TreeNode;
+
+TreeNode makeTreeNode(const std::int32_t min_lon,
+                      const std::int32_t max_lon,
+                      const std::int32_t min_lat,
+                      const std::int32_t max_lat)
+{
+    return TreeNode{RectangleInt2D{FixedLongitude{min_lon},
+                                   FixedLongitude{max_lon},
+                                   FixedLatitude{min_lat},
+                                   FixedLatitude{max_lat}}};
+}
+
+// The kernels have to agree with the distance of every single rectangle, the AVX2 kernel is only
+// checked on CPUs that support it
+void checkMinSquaredDists(const std::vector<TreeNode> &nodes, const Coordinate location)
+{
+    std::vector<std::uint64_t> expected;
+    for (const auto &node : nodes)
+    {
+        expected.push_back(node.minimum_bounding_rectangle.GetMinSquaredDist(location));
+    }
+
+    std::vector<std::uint64_t> scalar(nodes.size());
+    TestStaticRTree::GetMinSquaredDistsScalar(nodes.data(), nodes.size(), location, scalar.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(scalar.begin(), scalar.end(), expected.begin(), expected.end());
+
+#ifdef OSRM_STATIC_RTREE_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        std::vector<std::uint64_t> avx2(nodes.size());
+        TestStaticRTree::GetMinSquaredDistsAVX2(nodes.data(), nodes.size(), location, avx2.data());
+        BOOST_CHECK_EQUAL_COLLECTIONS(avx2.begin(), avx2.end(), expected.begin(), expected.end());
+    }
+#endif
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(min_squared_dists_random_rectangles)
+{
+    std::mt19937 g(RANDOM_SEED);
+    // projected coordinates of both axes stay within +-180 degrees
+    std::uniform_int_distribution<std::int32_t> coordinate(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::uniform_int_distribution<std::int32_t> size(0, 10 * COORDINATE_PRECISION);
+
+    // all remainders of the eight rectangles per iteration of the AVX2 kernel
+    for (const std::size_t count : {1, 7, 8, 9, 15, 16, 64, 67})
+    {
+        std::vector<TreeNode> nodes;
+        for (const auto index : irange<std::size_t>(0, count))
+        {
+            (void)index;
+            const auto min_lon = coordinate(g);
+            const auto min_lat = coordinate(g);
+            nodes.push_back(makeTreeNode(min_lon,
+                                         std::min(min_lon + size(g), WORLD_MAX_LON),
+                                         min_lat,
+                                         std::min(min_lat + size(g), WORLD_MAX_LON)));
+        }
+        for (const auto index : irange<std::size_t>(0, 100))
+        {
+            (void)index;
+            checkMinSquaredDists(nodes, Coordinate{FixedLongitude{coordinate(g)},
+                                                   FixedLatitude{coordinate(g)}});
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(min_squared_dists_edge_cases)
+{
+    const std::int32_t degree = COORDINATE_PRECISION;
+    const std::vector<TreeNode> nodes = {
+        makeTreeNode(-degree, degree, -degree, degree),
+        makeTreeNode(0, 0, 0, 0),
+        makeTreeNode(5 * degree, 5 * degree, -degree, degree),
+        makeTreeNode(WORLD_MIN_LON, WORLD_MAX_LON, WORLD_MIN_LON, WORLD_MAX_LON),
+        makeTreeNode(WORLD_MIN_LON, WORLD_MIN_LON + degree, -degree, degree),
+        makeTreeNode(WORLD_MAX_LON - degree, WORLD_MAX_LON, -degree, degree),
+        makeTreeNode(WORLD_MIN_LON, WORLD_MIN_LON + degree, WORLD_MIN_LON, WORLD_MIN_LON + degree),
+        makeTreeNode(WORLD_MAX_LON - degree, WORLD_MAX_LON, WORLD_MAX_LON - degree, WORLD_MAX_LON),
+        makeTreeNode(-3 * degree, -2 * degree, 2 * degree, 3 * degree)};
+
+    std::vector<Coordinate> locations;
+    for (const auto &node : nodes)
+    {
+        // inside, on the corners and edges and just outside of every rectangle
+        const auto &rectangle = node.minimum_bounding_rectangle;
+        locations.push_back(rectangle.Centroid());
+        for (const auto lon : {rectangle.min_lon, rectangle.max_lon})
+        {
+            for (const auto lat : {rectangle.min_lat, rectangle.max_lat})
+            {
+                locations.push_back(Coordinate{lon, lat});
+                locations.push_back(Coordinate{lon + FixedLongitude{1}, lat - FixedLatitude{1}});
+                locations.push_back(Coordinate{lon - FixedLongitude{1}, lat + FixedLatitude{1}});
+            }
+            locations.push_back(Coordinate{lon, rectangle.Centroid().lat});
+        }
+    }
+    // across the antimeridian from the rectangles at the other end of the longitudes
+    locations.push_back(Coordinate{FixedLongitude{WORLD_MAX_LON}, FixedLatitude{0}});
+    locations.push_back(Coordinate{FixedLongitude{WORLD_MIN_LON}, FixedLatitude{0}});
+    locations.push_back(
+        Coordinate{FixedLongitude{WORLD_MAX_LON}, FixedLatitude{WORLD_MIN_LON}});
+    locations.push_back(
+        Coordinate{FixedLongitude{WORLD_MIN_LON}, FixedLatitude{WORLD_MAX_LON}});
+
+    for (const auto &location : locations)
+    {
+        checkMinSquaredDists(nodes, location);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()